@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+# Benchmark regression gate. 'record' runs the Codon benchmarks in this
+# directory and stores wall time and peak RSS keyed by the current commit;
+# 'compare' checks the current commit's results against a recorded baseline
+# and exits non-zero when a benchmark regresses beyond noise bounds, so
+# performance regressions fail CI instead of shipping.
+#
+# Usage:
+#   bench/regress.py record  [--store results.json] [--repeat N]
+#   bench/regress.py compare [--store results.json] [--baseline <commit>]
+#                            [--time-threshold PCT] [--rss-threshold PCT]
+#
+# Environment variables: EXE_CODON (default: build/codon), and DATA_TAQ /
+# DATA_WORD_COUNT for the data-driven benchmarks (skipped when unset), as
+# with bench.sh.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+CODON = os.environ.get('EXE_CODON', 'build/codon')
+
+# benchmark name -> (source file, arguments); mirrors bench.sh
+BENCHMARKS = {
+    'sum': ('sum/sum.py', []),
+    'float': ('float/float.py', []),
+    'go': ('go/go.codon', []),
+    'nbody': ('nbody/nbody.py', ['1000000']),
+    'chaos': ('chaos/chaos.codon', ['/dev/null']),
+    'spectral_norm': ('spectral_norm/spectral_norm.py', []),
+    'set_partition': ('set_partition/set_partition.py', ['15']),
+    'primes': ('primes/primes.codon', ['30000']),
+    'binary_trees': ('binary_trees/binary_trees.codon', ['20']),
+    'fannkuch': ('fannkuch/fannkuch.codon', ['11']),
+    'mandelbrot': ('mandelbrot/mandelbrot.codon', []),
+}
+if os.environ.get('DATA_WORD_COUNT'):
+    BENCHMARKS['word_count'] = ('word_count/word_count.py',
+                                [os.environ['DATA_WORD_COUNT']])
+if os.environ.get('DATA_TAQ'):
+    BENCHMARKS['taq'] = ('taq/taq.py', [os.environ['DATA_TAQ']])
+
+
+def commit():
+    return subprocess.check_output(['git', 'rev-parse', 'HEAD'],
+                                   cwd=BENCH_DIR).decode().strip()
+
+
+def load(store):
+    if os.path.exists(store):
+        with open(store) as f:
+            return json.load(f)
+    return {}
+
+
+def measure(source, args):
+    # Returns (wall time in seconds, peak RSS in bytes) of one run.
+    cmd = [CODON, 'run', '-release', os.path.join(BENCH_DIR, source)] + args
+    t0 = time.monotonic()
+    pid = subprocess.Popen(cmd, stdout=subprocess.DEVNULL).pid
+    _, status, rusage = os.wait4(pid, 0)
+    elapsed = time.monotonic() - t0
+    if status != 0:
+        raise RuntimeError(f'benchmark failed: {" ".join(cmd)}')
+    # ru_maxrss is KB on Linux, bytes on macOS
+    rss = rusage.ru_maxrss * (1 if sys.platform == 'darwin' else 1024)
+    return elapsed, rss
+
+
+def record(args):
+    results = load(args.store)
+    entry = results.setdefault(commit(), {})
+    for name, (source, bench_args) in BENCHMARKS.items():
+        times, rss = [], 0
+        for _ in range(args.repeat):
+            elapsed, peak = measure(source, bench_args)
+            times.append(elapsed)
+            rss = max(rss, peak)
+        entry[name] = {'time': times, 'rss': rss,
+                       'date': time.strftime('%Y-%m-%dT%H:%M:%S')}
+        print(f'{name:<16} {min(times):8.3f}s  {rss / (1 << 20):8.1f} MB')
+    with open(args.store, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+
+def compare(args):
+    results = load(args.store)
+    head = commit()
+    if head not in results:
+        sys.exit(f'no recorded results for {head[:12]}; '
+                 f'run "bench/regress.py record" first')
+    baseline = args.baseline
+    if baseline is None:
+        # most recently recorded commit other than HEAD
+        others = [(max(b['date'] for b in bench.values()), c)
+                  for c, bench in results.items() if c != head and bench]
+        if not others:
+            sys.exit('no baseline commit in the results store')
+        baseline = max(others)[1]
+    if baseline not in results:
+        sys.exit(f'no recorded results for baseline {baseline[:12]}')
+
+    print(f'comparing {head[:12]} against {baseline[:12]}')
+    failures = []
+    for name, base in sorted(results[baseline].items()):
+        cur = results[head].get(name)
+        if cur is None:
+            continue
+        base_time, cur_time = min(base['time']), min(cur['time'])
+        # Widen the threshold to twice the baseline's observed spread so a
+        # noisy benchmark does not fail the gate on jitter alone.
+        noise = (max(base['time']) - base_time) / base_time
+        threshold = max(args.time_threshold / 100.0, 2 * noise)
+        time_delta = (cur_time - base_time) / base_time
+        rss_delta = (cur['rss'] - base['rss']) / base['rss']
+        status = 'ok'
+        if time_delta > threshold:
+            status = 'TIME REGRESSION'
+            failures.append(name)
+        elif rss_delta > args.rss_threshold / 100.0:
+            status = 'RSS REGRESSION'
+            failures.append(name)
+        print(f'{name:<16} time {time_delta:+7.1%} (bound {threshold:.1%})  '
+              f'rss {rss_delta:+7.1%}  {status}')
+
+    if failures:
+        sys.exit(f'{len(failures)} benchmark(s) regressed: '
+                 f'{", ".join(failures)}')
+    print('no regressions')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('record', help='run benchmarks and store results')
+    p.add_argument('--store', default=os.path.join(BENCH_DIR, 'results.json'))
+    p.add_argument('--repeat', type=int, default=3)
+    p.set_defaults(func=record)
+
+    p = sub.add_parser('compare', help='compare HEAD against a baseline')
+    p.add_argument('--store', default=os.path.join(BENCH_DIR, 'results.json'))
+    p.add_argument('--baseline', help='baseline commit (default: most recent)')
+    p.add_argument('--time-threshold', type=float, default=10.0,
+                   help='allowed slowdown in percent (default: 10)')
+    p.add_argument('--rss-threshold', type=float, default=20.0,
+                   help='allowed peak-RSS growth in percent (default: 20)')
+    p.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
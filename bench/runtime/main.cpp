@@ -0,0 +1,198 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+// Microbenchmark harness for runtime primitives in libcodonrt. Each benchmark
+// runs a warmup pass followed by a fixed number of timed repetitions and
+// reports per-operation timing statistics as JSON, so runtime changes come
+// with numbers instead of anecdotes. Usage:
+//
+//   codon_bench [-o <output.json>] [<name substring filter>]
+//
+// Whole-program benchmarks live in bench/ and are driven by bench/bench.sh;
+// this target covers the C/C++ primitives underneath them.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "codon/runtime/lib.h"
+
+// From codon/runtime/re.cpp, which has no public header.
+struct Span {
+  seq_int_t start;
+  seq_int_t end;
+};
+extern "C" void *seq_re_compile(seq_str_t p, seq_int_t flags);
+extern "C" Span seq_re_match_one(void *re, seq_int_t anchor, seq_str_t s,
+                                 seq_int_t pos, seq_int_t endpos);
+
+namespace {
+const int WARMUP_REPS = 2;
+const int TIMED_REPS = 10;
+
+// Accumulating into a volatile sink keeps the optimizer from discarding
+// benchmark bodies whose results are otherwise unused.
+volatile uint64_t sink = 0;
+
+seq_str_t str(const char *s) { return {(seq_int_t)strlen(s), (char *)s}; }
+
+struct Stats {
+  double min;
+  double median;
+  double mean;
+  double stddev;
+};
+
+Stats stats(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  const size_t n = samples.size();
+  double mean = 0.0;
+  for (double s : samples)
+    mean += s;
+  mean /= n;
+  double var = 0.0;
+  for (double s : samples)
+    var += (s - mean) * (s - mean);
+  var /= n;
+  const double median =
+      (n % 2) ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+  return {samples.front(), median, mean, std::sqrt(var)};
+}
+
+struct Result {
+  std::string name;
+  int64_t iters;
+  Stats nsPerOp;
+};
+
+std::vector<Result> results;
+std::string filter;
+
+void benchmark(const std::string &name, int64_t iters,
+               const std::function<void(int64_t)> &body) {
+  if (!filter.empty() && name.find(filter) == std::string::npos)
+    return;
+
+  std::vector<double> samples;
+  for (int rep = 0; rep < WARMUP_REPS + TIMED_REPS; rep++) {
+    const auto start = std::chrono::steady_clock::now();
+    body(iters);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (rep >= WARMUP_REPS)
+      samples.push_back(
+          (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count() /
+          iters);
+  }
+  results.push_back({name, iters, stats(samples)});
+  fmt::print(stderr, "{:<24} {:>12.2f} ns/op (median of {})\n", name,
+             results.back().nsPerOp.median, TIMED_REPS);
+}
+
+void benchAlloc() {
+  for (size_t size : {16, 64, 256, 4096}) {
+    benchmark(fmt::format("alloc/{}", size), 1000000, [size](int64_t iters) {
+      for (int64_t i = 0; i < iters; i++)
+        sink += (uintptr_t)seq_alloc(size);
+    });
+    benchmark(fmt::format("alloc_atomic/{}", size), 1000000,
+              [size](int64_t iters) {
+                for (int64_t i = 0; i < iters; i++)
+                  sink += (uintptr_t)seq_alloc_atomic(size);
+              });
+  }
+}
+
+void benchStrConv() {
+  benchmark("str_int_buf", 1000000, [](int64_t iters) {
+    char buf[32];
+    for (int64_t i = 0; i < iters; i++)
+      sink += seq_str_int_buf(i * 2654435761, buf);
+  });
+  benchmark("str_float_buf", 1000000, [](int64_t iters) {
+    char buf[32];
+    for (int64_t i = 0; i < iters; i++)
+      sink += seq_str_float_buf(i * 0.3330001, buf);
+  });
+  benchmark("fast_atoi", 1000000, [](int64_t iters) {
+    bool ok;
+    const seq_str_t s = str("123456789");
+    for (int64_t i = 0; i < iters; i++)
+      sink += seq_fast_atoi(s, &ok);
+  });
+  benchmark("fast_atof", 1000000, [](int64_t iters) {
+    bool ok;
+    const seq_str_t s = str("3.14159265358979");
+    for (int64_t i = 0; i < iters; i++)
+      sink += (uint64_t)seq_fast_atof(s, &ok);
+  });
+}
+
+void benchRegex() {
+  void *re = seq_re_compile(str("[a-z]+[0-9]{2,4}"), 0);
+  const seq_str_t s = str("......some text with a match abcdef1234 in the middle");
+  benchmark("re_match_one", 200000, [re, s](int64_t iters) {
+    for (int64_t i = 0; i < iters; i++)
+      sink += (uint64_t)seq_re_match_one(re, /*anchor=*/0, s, 0, s.len).start;
+  });
+  void *miss = seq_re_compile(str("zzz[0-9]+qqq"), 0);
+  benchmark("re_match_one/miss", 200000, [miss, s](int64_t iters) {
+    for (int64_t i = 0; i < iters; i++)
+      sink += (uint64_t)seq_re_match_one(miss, /*anchor=*/0, s, 0, s.len).start;
+  });
+}
+
+std::string json() {
+  std::string out = "[\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &r = results[i];
+    out += fmt::format("  {{\"name\": \"{}\", \"iterations\": {}, "
+                       "\"repetitions\": {}, \"ns_per_op\": {{\"min\": {:.3f}, "
+                       "\"median\": {:.3f}, \"mean\": {:.3f}, \"stddev\": "
+                       "{:.3f}}}}}{}\n",
+                       r.name, r.iters, TIMED_REPS, r.nsPerOp.min,
+                       r.nsPerOp.median, r.nsPerOp.mean, r.nsPerOp.stddev,
+                       (i + 1 < results.size()) ? "," : "");
+  }
+  out += "]\n";
+  return out;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string output;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      output = argv[++i];
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  seq_init(/*flags=*/0);
+
+  benchAlloc();
+  benchStrConv();
+  benchRegex();
+
+  if (output.empty()) {
+    std::cout << json();
+  } else {
+    std::ofstream out(output);
+    if (!out) {
+      fmt::print(stderr, "cannot write benchmark results to {}\n", output);
+      return EXIT_FAILURE;
+    }
+    out << json();
+  }
+  return EXIT_SUCCESS;
+}
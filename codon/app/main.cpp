@@ -15,6 +15,7 @@
 #include "codon/compiler/error.h"
 #include "codon/compiler/jit.h"
 #include "codon/parser/common.h"
+#include "codon/runtime/lib.h"
 #include "codon/util/common.h"
 #include "codon/util/jupyter.h"
 #include "llvm/Support/CommandLine.h"
@@ -88,7 +89,7 @@ void initLogFlags(const llvm::cl::opt<std::string> &log) {
 }
 
 enum BuildKind { LLVM, Bitcode, Object, Executable, Library, PyExtension, Detect };
-enum OptMode { Debug, Release };
+enum OptMode { Debug, Fast, Release };
 enum Numerics { C, Python };
 } // namespace
 
@@ -148,6 +149,9 @@ std::unique_ptr<codon::Compiler> processSource(
       llvm::cl::values(
           clEnumValN(Debug, regs.find("debug") != regs.end() ? "default" : "debug",
                      "Turn off compiler optimizations and show backtraces"),
+          clEnumValN(Fast, "fast",
+                     "Turn on quick compiler optimizations for "
+                     "edit-compile-test iteration"),
           clEnumValN(Release, "release",
                      "Turn on compiler optimizations and disable debug info")),
       llvm::cl::init(Debug));
@@ -159,6 +163,9 @@ std::unique_ptr<codon::Compiler> processSource(
   llvm::cl::list<std::string> plugins("plugin",
                                       llvm::cl::desc("Load specified plugin"));
   llvm::cl::opt<std::string> log("log", llvm::cl::desc("Enable given log streams"));
+  llvm::cl::opt<std::string> profileCompile(
+      "profile-compile",
+      llvm::cl::desc("Write a JSON compile-time profile to the specified file"));
   llvm::cl::opt<Numerics> numerics(
       "numerics", llvm::cl::desc("numerical semantics"),
       llvm::cl::values(
@@ -170,6 +177,7 @@ std::unique_ptr<codon::Compiler> processSource(
 
   llvm::cl::ParseCommandLineOptions(args.size(), args.data());
   initLogFlags(log);
+  codon::getProfiler().enabled = !profileCompile.empty();
 
   std::unordered_map<std::string, std::string> defmap;
   for (const auto &define : defines) {
@@ -190,10 +198,13 @@ std::unique_ptr<codon::Compiler> processSource(
     defmap.emplace(name, value);
   }
 
-  const bool isDebug = (optMode == OptMode::Debug);
+  auto mode = optMode == OptMode::Debug
+                  ? codon::Compiler::Mode::DEBUG
+                  : (optMode == OptMode::Fast ? codon::Compiler::Mode::FAST
+                                              : codon::Compiler::Mode::RELEASE);
   std::vector<std::string> disabledOptsVec(disabledOpts);
   auto compiler = std::make_unique<codon::Compiler>(
-      args[0], isDebug, disabledOptsVec,
+      args[0], mode, disabledOptsVec,
       /*isTest=*/false, (numerics == Numerics::Python), pyExtension());
   compiler->getLLVMVisitor()->setStandalone(standalone);
 
@@ -227,12 +238,23 @@ std::unique_ptr<codon::Compiler> processSource(
     TIME("compile");
     llvm::cantFail(compiler->compile());
   }
+  if (!profileCompile.empty()) {
+    std::ofstream out(profileCompile);
+    if (out)
+      out << codon::getProfiler().json();
+    else
+      codon::compilationWarning("cannot write compile profile to " + profileCompile);
+  }
   return compiler;
 }
 
 int runMode(const std::vector<const char *> &args) {
   llvm::cl::list<std::string> libs(
       "l", llvm::cl::desc("Load and link the specified library"));
+  llvm::cl::opt<std::string> profile(
+      "profile", llvm::cl::desc("Sample the running program and write a "
+                                "flamegraph-compatible (folded stacks) profile "
+                                "to the specified file"));
   llvm::cl::list<std::string> progArgs(llvm::cl::ConsumeAfter,
                                        llvm::cl::desc("<program arguments>..."));
   auto compiler = processSource(args, /*standalone=*/false);
@@ -241,7 +263,14 @@ int runMode(const std::vector<const char *> &args) {
   std::vector<std::string> libsVec(libs);
   std::vector<std::string> argsVec(progArgs);
   argsVec.insert(argsVec.begin(), compiler->getInput());
+  if (!profile.empty())
+    seq_profile_start(/*interval=*/1000);
   compiler->getLLVMVisitor()->run(argsVec, libsVec);
+  if (!profile.empty()) {
+    const std::string &out = profile;
+    if (!seq_profile_dump(seq_str_t{(seq_int_t)out.size(), (char *)out.data()}))
+      codon::compilationWarning("cannot write profile to " + out);
+  }
   return EXIT_SUCCESS;
 }
 
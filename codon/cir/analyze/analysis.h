@@ -31,6 +31,16 @@ public:
   /// @param module the module
   virtual std::unique_ptr<Result> run(const Module *module) = 0;
 
+  /// Execute the analysis, given the result invalidated by the last pass.
+  /// Analyses that can tell which functions actually changed may salvage
+  /// per-function pieces of the stale result instead of recomputing the
+  /// whole module; the default ignores the stale result.
+  /// @param module the module
+  /// @param stale the invalidated previous result, or null if none
+  virtual std::unique_ptr<Result> run(const Module *module, Result *stale) {
+    return run(module);
+  }
+
   /// Sets the manager.
   /// @param mng the new manager
   void setManager(transform::PassManager *mng) { manager = mng; }
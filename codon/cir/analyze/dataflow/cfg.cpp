@@ -2,10 +2,15 @@
 
 #include "cfg.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include "codon/cir/dsl/codegen.h"
 #include "codon/cir/dsl/nodes.h"
+#include "codon/cir/util/operator.h"
+#include "codon/util/parallel.h"
 
 namespace codon {
 namespace ir {
@@ -99,6 +104,38 @@ int SyntheticPhiInstr::doReplaceUsedValue(id_t id, Value *newValue) {
 
 CFGraph::CFGraph(const BodiedFunc *f) : func(f) { newBlock("entry", true); }
 
+void CFGraph::computeReversePostOrder() {
+  // Every downstream dataflow analysis iterates the blocks in (reverse)
+  // post-order, so the numbering is computed once here rather than by
+  // each analysis. Unreachable blocks are appended at the end so every
+  // block is still processed.
+  rpo.clear();
+  std::unordered_set<id_t> visited;
+  std::vector<std::pair<CFBlock *, std::vector<CFBlock *>::iterator>> stack;
+
+  auto *entry = getEntryBlock();
+  visited.insert(entry->getId());
+  stack.emplace_back(entry, entry->successors_begin());
+  while (!stack.empty()) {
+    auto &top = stack.back();
+    if (top.second == top.first->successors_end()) {
+      rpo.push_back(top.first);
+      stack.pop_back();
+    } else {
+      auto *next = *top.second++;
+      if (visited.insert(next->getId()).second)
+        stack.emplace_back(next, next->successors_begin());
+    }
+  }
+  std::reverse(rpo.begin(), rpo.end());
+  numReachable = unsigned(rpo.size());
+
+  for (auto *blk : *this) {
+    if (visited.insert(blk->getId()).second)
+      rpo.push_back(blk);
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const CFGraph &cfg) {
   os << "digraph \"" << cfg.func->getName() << "\" {\n";
   for (auto *block : cfg) {
@@ -129,20 +166,80 @@ std::unique_ptr<CFGraph> buildCFGraph(const BodiedFunc *f) {
   auto ret = std::make_unique<CFGraph>(f);
   CFVisitor v(ret.get());
   v.process(f);
+  ret->computeReversePostOrder();
   return ret;
 }
 
+namespace {
+/// Order-sensitive structural hash of a function body. Rewrites in this IR
+/// materialize new nodes (with new IDs) or re-point children, so hashing the
+/// traversal's node and used-variable IDs detects any change that could
+/// affect control flow.
+struct FingerprintVisitor : public util::Operator {
+  uint64_t hash = 14695981039346656037ULL;
+
+  void preHook(Node *node) override {
+    combine(uint64_t(node->getId()));
+    for (auto *v : node->getUsedVariables())
+      combine(uint64_t(v->getId()));
+  }
+
+  void combine(uint64_t v) { hash = (hash ^ v) * 1099511628211ULL; }
+};
+
+uint64_t fingerprint(const BodiedFunc *f) {
+  FingerprintVisitor v;
+  v.process(const_cast<BodiedFunc *>(f));
+  return v.hash;
+}
+} // namespace
+
 const std::string CFAnalysis::KEY = "core-analyses-cfg";
 
-std::unique_ptr<Result> CFAnalysis::run(const Module *m) {
+std::unique_ptr<Result> CFAnalysis::run(const Module *m) { return run(m, nullptr); }
+
+std::unique_ptr<Result> CFAnalysis::run(const Module *m, Result *stale) {
+  static std::atomic<uint64_t> generation(0);
+  auto gen = ++generation;
+
   auto res = std::make_unique<CFResult>();
-  if (const auto *main = cast<BodiedFunc>(m->getMainFunc())) {
-    res->graphs.insert(std::make_pair(main->getId(), buildCFGraph(main)));
-  }
+  auto *old = static_cast<CFResult *>(stale);
+  std::vector<const BodiedFunc *> funcs;
+  if (const auto *main = cast<BodiedFunc>(m->getMainFunc()))
+    funcs.push_back(main);
 
   for (const auto *var : *m) {
-    if (const auto *f = cast<BodiedFunc>(var)) {
-      res->graphs.insert(std::make_pair(f->getId(), buildCFGraph(f)));
+    if (const auto *f = cast<BodiedFunc>(var))
+      funcs.push_back(f);
+  }
+
+  // Graph construction only reads the module and builds function-private
+  // structures, so build each function's graph on a worker thread; functions
+  // whose fingerprint matches the invalidated result carry their graph over
+  // instead of rebuilding it.
+  std::vector<std::unique_ptr<CFGraph>> graphs(funcs.size());
+  std::vector<uint64_t> prints(funcs.size());
+  util::parallelFor(funcs.size(), [&](size_t i) {
+    auto id = funcs[i]->getId();
+    prints[i] = fingerprint(funcs[i]);
+    if (old) {
+      auto it = old->fingerprints.find(id);
+      if (it != old->fingerprints.end() && it->second == prints[i] &&
+          old->graphs.find(id) != old->graphs.end())
+        return; // unchanged; carried over below
+    }
+    graphs[i] = buildCFGraph(funcs[i]);
+  });
+
+  for (size_t i = 0; i < funcs.size(); i++) {
+    auto id = funcs[i]->getId();
+    res->fingerprints[id] = prints[i];
+    if (graphs[i]) {
+      res->graphs[id] = std::move(graphs[i]);
+      res->built[id] = gen;
+    } else {
+      res->graphs[id] = std::move(old->graphs[id]);
+      res->built[id] = old->built[id];
     }
   }
   return res;
@@ -2,11 +2,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "codon/cir/analyze/analysis.h"
 #include "codon/cir/cir.h"
@@ -26,10 +30,10 @@ class CFBlock : public IdMixin {
 private:
   /// the in-order list of values in this block
   std::list<const Value *> values;
-  /// an un-ordered list of successor blocks
-  std::unordered_set<CFBlock *> successors;
-  /// an un-ordered list of successor blocks
-  std::unordered_set<CFBlock *> predecessors;
+  /// successor blocks, in insertion order; inserts deduplicate
+  std::vector<CFBlock *> successors;
+  /// predecessor blocks, in insertion order; inserts deduplicate
+  std::vector<CFBlock *> predecessors;
   /// the block's name
   std::string name;
   /// the graph
@@ -87,18 +91,23 @@ public:
   auto successors_begin() const { return successors.begin(); }
   /// @return an iterator beyond the last successor
   auto successors_end() const { return successors.end(); }
-  /// Inserts a successor at some position.
+  /// Inserts a successor, if not already present.
   /// @param v the new successor
-  /// @return an iterator to the new successor
-  auto successors_insert(CFBlock *v) {
-    successors.insert(v);
-    v->predecessors.insert(this);
+  void successors_insert(CFBlock *v) {
+    if (std::find(successors.begin(), successors.end(), v) == successors.end()) {
+      successors.push_back(v);
+      v->predecessors.push_back(this);
+    }
   }
   /// Removes a given successor.
   /// @param v the successor to remove
-  auto successors_erase(CFBlock *v) {
-    successors.erase(v);
-    v->predecessors.erase(this);
+  void successors_erase(CFBlock *v) {
+    auto it = std::find(successors.begin(), successors.end(), v);
+    if (it != successors.end()) {
+      successors.erase(it);
+      auto pIt = std::find(v->predecessors.begin(), v->predecessors.end(), this);
+      v->predecessors.erase(pIt);
+    }
   }
 
   /// @return an iterator to the first predecessor
@@ -281,8 +290,15 @@ protected:
 
 class CFGraph {
 private:
-  /// owned list of blocks
-  std::list<std::unique_ptr<CFBlock>> blocks;
+  /// arena of blocks, stored contiguously in construction order
+  std::deque<CFBlock> arena;
+  /// blocks in construction order (pointers into the arena)
+  std::vector<CFBlock *> blocks;
+  /// blocks in reverse post-order, computed once after construction;
+  /// unreachable blocks are appended after the reachable prefix
+  std::vector<CFBlock *> rpo;
+  /// number of reachable blocks (the reverse post-order prefix)
+  unsigned numReachable = 0;
   /// the current block
   CFBlock *cur = nullptr;
   /// the function being analyzed
@@ -301,13 +317,13 @@ public:
   explicit CFGraph(const BodiedFunc *f);
 
   /// @return an iterator to the first block
-  auto begin() { return util::raw_ptr_adaptor(blocks.begin()); }
+  auto begin() { return blocks.begin(); }
   /// @return an iterator beyond the last block
-  auto end() { return util::raw_ptr_adaptor(blocks.end()); }
+  auto end() { return blocks.end(); }
   /// @return an iterator to the first block
-  auto begin() const { return util::raw_ptr_adaptor(blocks.begin()); }
+  auto begin() const { return blocks.begin(); }
   /// @return an iterator beyond the last block
-  auto end() const { return util::raw_ptr_adaptor(blocks.end()); }
+  auto end() const { return blocks.end(); }
 
   /// @return an iterator to the synthetic value
   auto synth_begin() { return util::raw_ptr_adaptor(syntheticValues.begin()); }
@@ -319,9 +335,9 @@ public:
   auto synth_end() const { return util::raw_ptr_adaptor(syntheticValues.end()); }
 
   /// @return the entry block
-  CFBlock *getEntryBlock() { return blocks.front().get(); }
+  CFBlock *getEntryBlock() { return blocks.front(); }
   /// @return the entry block
-  const CFBlock *getEntryBlock() const { return blocks.front().get(); }
+  const CFBlock *getEntryBlock() const { return blocks.front(); }
 
   /// @return the entry block
   CFBlock *getCurrentBlock() { return cur; }
@@ -365,13 +381,24 @@ public:
   /// @param setCur true if the block should be made the current one
   /// @return a newly inserted block
   CFBlock *newBlock(std::string name = "", bool setCur = false) {
-    auto *ret = new CFBlock(this, std::move(name));
-    blocks.emplace_back(ret);
+    arena.emplace_back(this, std::move(name));
+    auto *ret = &arena.back();
+    blocks.push_back(ret);
     if (setCur)
       setCurrentBlock(ret);
     return ret;
   }
 
+  /// @return blocks in reverse post-order, with unreachable blocks appended
+  ///         after the reachable prefix; computed once by buildCFGraph
+  const std::vector<CFBlock *> &getReversePostOrder() const { return rpo; }
+  /// @return the number of reachable blocks (the reverse post-order prefix)
+  unsigned getNumReachableBlocks() const { return numReachable; }
+
+  /// Computes the reverse post-order numbering of the blocks. Called once
+  /// after construction, when the edge structure is final.
+  void computeReversePostOrder();
+
   template <typename NodeType, typename... Args> NodeType *N(Args &&...args) {
     auto *ret = new NodeType(std::forward<Args>(args)...);
     reg(ret);
@@ -419,6 +446,13 @@ std::unique_ptr<CFGraph> buildCFGraph(const BodiedFunc *f);
 struct CFResult : public Result {
   /// map from function id to control-flow graph
   std::unordered_map<id_t, std::unique_ptr<CFGraph>> graphs;
+  /// map from function id to the structural fingerprint the graph was built
+  /// from, used to carry unchanged graphs across invalidations
+  std::unordered_map<id_t, uint64_t> fingerprints;
+  /// map from function id to the run generation in which the graph object
+  /// was built; dependent analyses record this to tell whether the graph
+  /// they analyzed is still the live object
+  std::unordered_map<id_t, uint64_t> built;
 };
 
 /// Control-flow analysis that runs on all functions.
@@ -428,6 +462,7 @@ public:
   std::string getKey() const override { return KEY; }
 
   std::unique_ptr<Result> run(const Module *m) override;
+  std::unique_ptr<Result> run(const Module *m, Result *stale) override;
 };
 
 class CFVisitor : public util::ConstVisitor {
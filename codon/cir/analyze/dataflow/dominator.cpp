@@ -2,42 +2,91 @@
 
 #include "dominator.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "codon/util/parallel.h"
+
 namespace codon {
 namespace ir {
 namespace analyze {
 namespace dataflow {
 
+namespace {
+constexpr unsigned UNDEF = std::numeric_limits<unsigned>::max();
+} // namespace
+
 void DominatorInspector::analyze() {
+  // reachable blocks in reverse post-order (the prefix of the graph's
+  // precomputed numbering; unreachable blocks have no dominators)
+  const auto &rpo = cfg->getReversePostOrder();
+  std::vector<CFBlock *> order(rpo.begin(),
+                               rpo.begin() + cfg->getNumReachableBlocks());
+
+  auto n = unsigned(order.size());
+  rpoIndex.reserve(n);
+  for (unsigned i = 0; i < n; i++)
+    rpoIndex[order[i]->getId()] = i;
+
+  // iterative immediate-dominator computation over reverse post-order
+  // ("a simple, fast dominance algorithm"); converges in a few sweeps
+  idom.assign(n, UNDEF);
+  idom[0] = 0;
+  auto intersect = [&](unsigned a, unsigned b) {
+    while (a != b) {
+      while (a > b)
+        a = idom[a];
+      while (b > a)
+        b = idom[b];
+    }
+    return a;
+  };
+
   auto changed = true;
   while (changed) {
     changed = false;
-    for (auto *blk : *cfg) {
-      auto init = false;
-      std::set<id_t> old = sets[blk->getId()];
-      std::set<id_t> working;
-
+    for (unsigned i = 1; i < n; i++) {
+      auto newIdom = UNDEF;
+      auto *blk = order[i];
       for (auto it = blk->predecessors_begin(); it != blk->predecessors_end(); ++it) {
-        auto &predDoms = sets[(*it)->getId()];
-        if (!init) {
-          init = true;
-          working = std::set<id_t>(predDoms.begin(), predDoms.end());
-        }
-
-        std::set<id_t> newWorking;
-        std::set_intersection(working.begin(), working.end(), predDoms.begin(),
-                              predDoms.end(),
-                              std::inserter(newWorking, newWorking.begin()));
-        working = newWorking;
+        auto pIt = rpoIndex.find((*it)->getId());
+        if (pIt == rpoIndex.end() || idom[pIt->second] == UNDEF)
+          continue; // unreachable or not yet processed
+        newIdom = (newIdom == UNDEF) ? pIt->second : intersect(newIdom, pIt->second);
       }
-
-      working.insert(blk->getId());
-
-      if (working != old) {
+      if (newIdom != UNDEF && idom[i] != newIdom) {
+        idom[i] = newIdom;
         changed = true;
-        sets[blk->getId()] = working;
       }
     }
   }
+
+  // DFS intervals over the dominator tree give O(1) dominance queries
+  std::vector<std::vector<unsigned>> children(n);
+  for (unsigned i = 1; i < n; i++) {
+    if (idom[i] != UNDEF)
+      children[idom[i]].push_back(i);
+  }
+  treeIn.assign(n, 0);
+  treeOut.assign(n, 0);
+  if (n == 0)
+    return;
+  unsigned clock = 0;
+  std::vector<std::pair<unsigned, size_t>> stack = {{0, 0}};
+  treeIn[0] = clock++;
+  while (!stack.empty()) {
+    auto node = stack.back().first;
+    auto child = stack.back().second++;
+    if (child < children[node].size()) {
+      auto c = children[node][child];
+      treeIn[c] = clock++;
+      stack.emplace_back(c, 0);
+    } else {
+      treeOut[node] = clock++;
+      stack.pop_back();
+    }
+  }
 }
 
 bool DominatorInspector::isDominated(const Value *v, const Value *dominator) {
@@ -52,19 +101,49 @@ bool DominatorInspector::isDominated(const Value *v, const Value *dominator) {
     return dDist <= vDist;
   }
 
-  return sets[vBlock->getId()].find(dBlock->getId()) != sets[vBlock->getId()].end();
+  auto vIt = rpoIndex.find(vBlock->getId());
+  auto dIt = rpoIndex.find(dBlock->getId());
+  if (vIt == rpoIndex.end() || dIt == rpoIndex.end())
+    return false; // unreachable blocks neither dominate nor are dominated
+  return treeIn[dIt->second] <= treeIn[vIt->second] &&
+         treeOut[vIt->second] <= treeOut[dIt->second];
 }
 
 const std::string DominatorAnalysis::KEY = "core-analyses-dominator";
 
 std::unique_ptr<Result> DominatorAnalysis::run(const Module *m) {
+  return run(m, nullptr);
+}
+
+std::unique_ptr<Result> DominatorAnalysis::run(const Module *m, Result *stale) {
   auto *cfgResult = getAnalysisResult<CFResult>(cfAnalysisKey);
+  auto *old = static_cast<DominatorResult *>(stale);
   auto ret = std::make_unique<DominatorResult>(cfgResult);
+  // each function's result depends only on its own graph, so carry over
+  // stale inspectors whose graph object survived the CFG recompute and run
+  // the remaining per-function slices across worker threads
+  std::vector<CFGraph *> graphs;
   for (const auto &graph : cfgResult->graphs) {
-    auto inspector = std::make_unique<DominatorInspector>(graph.second.get());
-    inspector->analyze();
-    ret->results[graph.first] = std::move(inspector);
+    auto id = graph.first;
+    ret->builtOn[id] = cfgResult->built.at(id);
+    if (old) {
+      auto bIt = old->builtOn.find(id);
+      auto rIt = old->results.find(id);
+      if (bIt != old->builtOn.end() && bIt->second == ret->builtOn[id] &&
+          rIt != old->results.end()) {
+        ret->results[id] = std::move(rIt->second);
+        continue;
+      }
+    }
+    graphs.push_back(graph.second.get());
   }
+  std::vector<std::unique_ptr<DominatorInspector>> inspectors(graphs.size());
+  util::parallelFor(graphs.size(), [&](size_t i) {
+    inspectors[i] = std::make_unique<DominatorInspector>(graphs[i]);
+    inspectors[i]->analyze();
+  });
+  for (size_t i = 0; i < graphs.size(); i++)
+    ret->results[graphs[i]->getFunc()->getId()] = std::move(inspectors[i]);
   return ret;
 }
 
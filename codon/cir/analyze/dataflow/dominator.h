@@ -2,9 +2,9 @@
 
 #pragma once
 
-#include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "codon/cir/analyze/analysis.h"
 #include "codon/cir/analyze/dataflow/cfg.h"
@@ -14,10 +14,19 @@ namespace ir {
 namespace analyze {
 namespace dataflow {
 
-/// Helper to query the dominators of a particular function.
+/// Helper to query the dominators of a particular function. Builds an
+/// immediate-dominator tree over the CFG and answers dominance queries in
+/// O(1) via DFS intervals on that tree.
 class DominatorInspector {
 private:
-  std::unordered_map<id_t, std::set<id_t>> sets;
+  /// map from block id to reverse post-order position (reachable blocks only)
+  std::unordered_map<id_t, unsigned> rpoIndex;
+  /// immediate dominator of each block, as a reverse post-order position
+  std::vector<unsigned> idom;
+  /// dominator-tree DFS entry times, indexed by reverse post-order position
+  std::vector<unsigned> treeIn;
+  /// dominator-tree DFS exit times, indexed by reverse post-order position
+  std::vector<unsigned> treeOut;
   CFGraph *cfg;
 
 public:
@@ -38,6 +47,9 @@ struct DominatorResult : public Result {
   const CFResult *cfgResult;
   /// the dominator inspectors
   std::unordered_map<id_t, std::unique_ptr<DominatorInspector>> results;
+  /// map from function id to the CFG build generation each inspector was
+  /// computed against (see CFResult::built)
+  std::unordered_map<id_t, uint64_t> builtOn;
 
   explicit DominatorResult(const CFResult *cfgResult) : cfgResult(cfgResult) {}
 };
@@ -59,6 +71,7 @@ public:
   std::string getKey() const override { return KEY; }
 
   std::unique_ptr<Result> run(const Module *m) override;
+  std::unique_ptr<Result> run(const Module *m, Result *stale) override;
 };
 
 } // namespace dataflow
@@ -0,0 +1,189 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "liveness.h"
+
+#include <deque>
+#include <vector>
+
+#include "codon/util/parallel.h"
+
+namespace codon {
+namespace ir {
+namespace {
+id_t getKilled(const Value *val) {
+  if (auto *assign = cast<AssignInstr>(val)) {
+    return assign->getLhs()->getId();
+  } else if (auto *synthAssign = cast<analyze::dataflow::SyntheticAssignInstr>(val)) {
+    return synthAssign->getLhs()->getId();
+  }
+  return -1;
+}
+
+template <typename T> struct WorkList {
+  std::unordered_set<id_t> have;
+  std::deque<T *> queue;
+
+  void push(T *a) {
+    auto id = a->getId();
+    if (have.count(id))
+      return;
+    have.insert(id);
+    queue.push_back(a);
+  }
+
+  T *pop() {
+    if (queue.empty())
+      return nullptr;
+    auto *a = queue.front();
+    queue.pop_front();
+    have.erase(a->getId());
+    return a;
+  }
+
+  template <typename S> WorkList(S *x) : have(), queue() {
+    for (T *a : *x) {
+      push(a);
+    }
+  }
+};
+} // namespace
+
+namespace analyze {
+namespace dataflow {
+
+void LivenessInspector::analyze() {
+  std::unordered_map<id_t, std::unordered_set<id_t>> use, def, liveIn;
+
+  // construct upward-exposed use and definition sets
+  for (auto *blk : *cfg) {
+    auto &u = use[blk->getId()];
+    auto &d = def[blk->getId()];
+    for (auto *val : *blk) {
+      // vars that are used by pointer may be read at any time, so don't track them
+      if (auto *ptr = cast<PointerValue>(val)) {
+        invalid.insert(ptr->getVar()->getId());
+        continue;
+      }
+
+      auto k = getKilled(val);
+      if (k != -1) {
+        // assignments only define; any value they consume appears
+        // earlier in the block as its own entry
+        d.insert(k);
+        continue;
+      }
+
+      for (auto *var : val->getUsedVariables()) {
+        if (d.find(var->getId()) == d.end())
+          u.insert(var->getId());
+      }
+    }
+  }
+
+  // worklist iteration in post-order propagates most liveness backward in
+  // a single sweep
+  const auto &rpo = cfg->getReversePostOrder();
+  std::vector<CFBlock *> order(rpo.rbegin(), rpo.rend());
+  WorkList<CFBlock> worklist(&order);
+  while (auto *blk = worklist.pop()) {
+    auto id = blk->getId();
+
+    // OUT[blk] = U IN[succ], for all successors succ
+    auto &out = liveOut[id];
+    out.clear();
+    for (auto it = blk->successors_begin(); it != blk->successors_end(); ++it) {
+      auto &in = liveIn[(*it)->getId()];
+      out.insert(in.begin(), in.end());
+    }
+
+    // IN[blk] = USE[blk] U (OUT[blk] - DEF[blk])
+    auto in = out;
+    for (auto v : def[id])
+      in.erase(v);
+    auto &u = use[id];
+    in.insert(u.begin(), u.end());
+
+    // if IN changed, add all predecessors to worklist
+    auto &oldin = liveIn[id];
+    if (in != oldin) {
+      oldin = std::move(in);
+      for (auto it = blk->predecessors_begin(); it != blk->predecessors_end(); ++it) {
+        worklist.push(*it);
+      }
+    }
+  }
+}
+
+bool LivenessInspector::isLiveAfter(const Var *var, const Value *loc) const {
+  if (var->isGlobal() || invalid.find(var->getId()) != invalid.end())
+    return true;
+
+  auto *blk = cfg->getBlock(loc);
+  if (!blk)
+    return true;
+
+  auto after = false;
+  for (auto *val : *blk) {
+    if (!after) {
+      if (val->getId() == loc->getId())
+        after = true;
+      continue;
+    }
+
+    auto killed = getKilled(val);
+    if (killed == var->getId())
+      return false;
+    if (killed == -1) {
+      for (auto *used : val->getUsedVariables()) {
+        if (used->getId() == var->getId())
+          return true;
+      }
+    }
+  }
+
+  auto it = liveOut.find(blk->getId());
+  return it != liveOut.end() && it->second.count(var->getId()) != 0;
+}
+
+const std::string LivenessAnalysis::KEY = "core-analyses-liveness";
+
+std::unique_ptr<Result> LivenessAnalysis::run(const Module *m) {
+  return run(m, nullptr);
+}
+
+std::unique_ptr<Result> LivenessAnalysis::run(const Module *m, Result *stale) {
+  auto *cfgResult = getAnalysisResult<CFResult>(cfAnalysisKey);
+  auto *old = static_cast<LivenessResult *>(stale);
+  auto ret = std::make_unique<LivenessResult>(cfgResult);
+  // each function's result depends only on its own graph, so carry over
+  // stale inspectors whose graph object survived the CFG recompute and run
+  // the remaining per-function slices across worker threads
+  std::vector<CFGraph *> graphs;
+  for (const auto &graph : cfgResult->graphs) {
+    auto id = graph.first;
+    ret->builtOn[id] = cfgResult->built.at(id);
+    if (old) {
+      auto bIt = old->builtOn.find(id);
+      auto rIt = old->results.find(id);
+      if (bIt != old->builtOn.end() && bIt->second == ret->builtOn[id] &&
+          rIt != old->results.end()) {
+        ret->results[id] = std::move(rIt->second);
+        continue;
+      }
+    }
+    graphs.push_back(graph.second.get());
+  }
+  std::vector<std::unique_ptr<LivenessInspector>> inspectors(graphs.size());
+  util::parallelFor(graphs.size(), [&](size_t i) {
+    inspectors[i] = std::make_unique<LivenessInspector>(graphs[i]);
+    inspectors[i]->analyze();
+  });
+  for (size_t i = 0; i < graphs.size(); i++)
+    ret->results[graphs[i]->getFunc()->getId()] = std::move(inspectors[i]);
+  return ret;
+}
+
+} // namespace dataflow
+} // namespace analyze
+} // namespace ir
+} // namespace codon
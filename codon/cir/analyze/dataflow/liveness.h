@@ -0,0 +1,79 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "codon/cir/analyze/analysis.h"
+#include "codon/cir/analyze/dataflow/cfg.h"
+
+namespace codon {
+namespace ir {
+namespace analyze {
+namespace dataflow {
+
+/// Helper to query variable liveness within a particular function.
+class LivenessInspector {
+private:
+  /// vars that are used by pointer; they may be read at any time,
+  /// so they are never reported dead
+  std::unordered_set<id_t> invalid;
+  /// per-block live-out variable ids, keyed by block id
+  std::unordered_map<id_t, std::unordered_set<id_t>> liveOut;
+  CFGraph *cfg;
+
+public:
+  explicit LivenessInspector(CFGraph *cfg) : cfg(cfg) {}
+
+  /// Do the analysis.
+  void analyze();
+
+  /// Checks if a variable may be read after a given location before
+  /// being reassigned.
+  /// @param var the variable being inspected
+  /// @param loc the location
+  /// @return true if the variable is live directly after the location
+  bool isLiveAfter(const Var *var, const Value *loc) const;
+
+  bool isInvalid(const Var *var) const { return invalid.count(var->getId()) != 0; }
+};
+
+/// Result of a liveness analysis.
+struct LivenessResult : public Result {
+  /// the corresponding control flow result
+  const CFResult *cfgResult;
+  /// the liveness inspectors
+  std::unordered_map<id_t, std::unique_ptr<LivenessInspector>> results;
+  /// map from function id to the CFG build generation each inspector was
+  /// computed against (see CFResult::built)
+  std::unordered_map<id_t, uint64_t> builtOn;
+
+  explicit LivenessResult(const CFResult *cfgResult) : cfgResult(cfgResult) {}
+};
+
+/// Backward liveness analysis. Must have control-flow graph available.
+class LivenessAnalysis : public Analysis {
+private:
+  /// the control-flow analysis key
+  std::string cfAnalysisKey;
+
+public:
+  static const std::string KEY;
+
+  /// Initializes a liveness analysis.
+  /// @param cfAnalysisKey the control-flow analysis key
+  explicit LivenessAnalysis(std::string cfAnalysisKey)
+      : cfAnalysisKey(std::move(cfAnalysisKey)) {}
+
+  std::string getKey() const override { return KEY; }
+
+  std::unique_ptr<Result> run(const Module *m) override;
+  std::unique_ptr<Result> run(const Module *m, Result *stale) override;
+};
+
+} // namespace dataflow
+} // namespace analyze
+} // namespace ir
+} // namespace codon
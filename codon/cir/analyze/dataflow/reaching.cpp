@@ -2,8 +2,12 @@
 
 #include "reaching.h"
 
+#include <algorithm>
 #include <deque>
 #include <tuple>
+#include <vector>
+
+#include "codon/util/parallel.h"
 
 namespace codon {
 namespace ir {
@@ -187,7 +191,10 @@ void RDInspector::analyze() {
                                           std::move(in), std::move(out)));
   }
 
-  WorkList<CFBlock> worklist(cfg);
+  // worklist iteration in reverse post-order propagates most definitions
+  // in a single sweep
+  auto &rpo = cfg->getReversePostOrder();
+  WorkList<CFBlock> worklist(&rpo);
   while (auto *blk = worklist.pop()) {
     auto &data = bitsets.find(blk->getId())->second;
 
@@ -212,18 +219,31 @@ void RDInspector::analyze() {
     }
   }
 
-  // reconstruct final sets in more convenient format
-  for (auto &elem : bitsets) {
-    auto &data = elem.second;
-    auto &entry = sets[data.blk->getId()];
+  // keep the dense IN sets; they are expanded per block on first query, so
+  // blocks that are never inspected pay nothing
+  defSites = std::move(ordering);
+  for (auto &elem : bitsets)
+    inBits[elem.first] = std::move(elem.second.in.words);
+}
 
-    for (unsigned i = 0; i < n; i++) {
-      if (data.in.get(i)) {
-        auto g = getGenerated(ordering[i]);
+RDInspector::BlockData &RDInspector::getData(const CFBlock *blk) {
+  auto id = blk->getId();
+  auto it = sets.find(id);
+  if (it != sets.end())
+    return it->second;
+
+  auto &entry = sets[id];
+  auto wIt = inBits.find(id);
+  if (wIt != inBits.end()) {
+    auto &words = wIt->second;
+    for (unsigned i = 0; i < defSites.size(); i++) {
+      if (words[i / BitSet::B] & (1UL << (i % BitSet::B))) {
+        auto g = getGenerated(defSites[i]);
         entry.in[g.first].insert(g.second);
       }
     }
   }
+  return entry;
 }
 
 std::unordered_set<id_t> RDInspector::getReachingDefinitions(const Var *var,
@@ -234,8 +254,14 @@ std::unordered_set<id_t> RDInspector::getReachingDefinitions(const Var *var,
   auto *blk = cfg->getBlock(loc);
   if (!blk)
     return {};
-  auto &entry = sets[blk->getId()];
-  auto defs = entry.in[var->getId()];
+  std::unordered_set<id_t> defs;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto &entry = getData(blk);
+    auto it = entry.in.find(var->getId());
+    if (it != entry.in.end())
+      defs = it->second;
+  }
   if (blk->getId() == cfg->getEntryBlock()->getId())
     defs.insert(-1);
 
@@ -262,14 +288,37 @@ std::unordered_set<id_t> RDInspector::getReachingDefinitions(const Var *var,
 
 const std::string RDAnalysis::KEY = "core-analyses-rd";
 
-std::unique_ptr<Result> RDAnalysis::run(const Module *m) {
+std::unique_ptr<Result> RDAnalysis::run(const Module *m) { return run(m, nullptr); }
+
+std::unique_ptr<Result> RDAnalysis::run(const Module *m, Result *stale) {
   auto *cfgResult = getAnalysisResult<CFResult>(cfAnalysisKey);
+  auto *old = static_cast<RDResult *>(stale);
   auto ret = std::make_unique<RDResult>(cfgResult);
+  // each function's result depends only on its own graph, so carry over
+  // stale inspectors whose graph object survived the CFG recompute and run
+  // the remaining per-function slices across worker threads
+  std::vector<CFGraph *> graphs;
   for (const auto &graph : cfgResult->graphs) {
-    auto inspector = std::make_unique<RDInspector>(graph.second.get());
-    inspector->analyze();
-    ret->results[graph.first] = std::move(inspector);
+    auto id = graph.first;
+    ret->builtOn[id] = cfgResult->built.at(id);
+    if (old) {
+      auto bIt = old->builtOn.find(id);
+      auto rIt = old->results.find(id);
+      if (bIt != old->builtOn.end() && bIt->second == ret->builtOn[id] &&
+          rIt != old->results.end()) {
+        ret->results[id] = std::move(rIt->second);
+        continue;
+      }
+    }
+    graphs.push_back(graph.second.get());
   }
+  std::vector<std::unique_ptr<RDInspector>> inspectors(graphs.size());
+  util::parallelFor(graphs.size(), [&](size_t i) {
+    inspectors[i] = std::make_unique<RDInspector>(graphs[i]);
+    inspectors[i]->analyze();
+  });
+  for (size_t i = 0; i < graphs.size(); i++)
+    ret->results[graphs[i]->getFunc()->getId()] = std::move(inspectors[i]);
   return ret;
 }
 
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include "codon/cir/analyze/analysis.h"
 #include "codon/cir/analyze/dataflow/cfg.h"
@@ -20,9 +22,19 @@ private:
     BlockData() = default;
   };
   std::unordered_set<id_t> invalid;
+  /// per-block reaching sets, materialized lazily from the bitvectors
   std::unordered_map<id_t, BlockData> sets;
+  /// numbered definition sites, in numbering order
+  std::vector<const Value *> defSites;
+  /// dense per-block IN bitvectors (64-bit words), keyed by block id
+  std::unordered_map<id_t, std::vector<uint64_t>> inBits;
+  /// guards lazy materialization; queries may come from worker threads
+  std::mutex lock;
   CFGraph *cfg;
 
+  /// Expands a block's IN bitvector into id-keyed sets on first query.
+  BlockData &getData(const CFBlock *blk);
+
 public:
   explicit RDInspector(CFGraph *cfg) : cfg(cfg) {}
 
@@ -44,6 +56,9 @@ struct RDResult : public Result {
   const CFResult *cfgResult;
   /// the reaching definition inspectors
   std::unordered_map<id_t, std::unique_ptr<RDInspector>> results;
+  /// map from function id to the CFG build generation each inspector was
+  /// computed against (see CFResult::built)
+  std::unordered_map<id_t, uint64_t> builtOn;
 
   explicit RDResult(const CFResult *cfgResult) : cfgResult(cfgResult) {}
 };
@@ -65,6 +80,7 @@ public:
   std::string getKey() const override { return KEY; }
 
   std::unique_ptr<Result> run(const Module *m) override;
+  std::unique_ptr<Result> run(const Module *m, Result *stale) override;
 };
 
 } // namespace dataflow
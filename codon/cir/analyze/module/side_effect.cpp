@@ -2,12 +2,16 @@
 
 #include "side_effect.h"
 
+#include <algorithm>
+#include <limits>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "codon/cir/analyze/dataflow/capture.h"
 #include "codon/cir/util/irtools.h"
 #include "codon/cir/util/operator.h"
+#include "codon/util/parallel.h"
 
 namespace codon {
 namespace ir {
@@ -35,6 +39,24 @@ struct VarUseAnalyzer : public util::Operator {
   void handle(AssignInstr *v) override { ++varAssignCounts[v->getLhs()->getId()]; }
 };
 
+/// Per-function walk collecting var-use counts and call graph edges in one
+/// pass; the per-function instances are merged into a VarUseAnalyzer.
+struct FuncWalk : public VarUseAnalyzer {
+  std::vector<const Func *> callees;
+
+  void handle(CallInstr *v) override {
+    if (auto *f = util::getFunc(v->getCallee()))
+      callees.push_back(f);
+  }
+
+  void handle(PipelineFlow *v) override {
+    for (auto &stage : *v) {
+      if (auto *f = util::getFunc(stage.getCallee()))
+        callees.push_back(f);
+    }
+  }
+};
+
 struct SideEfectAnalyzer : public util::ConstVisitor {
   using Status = util::SideEffectStatus;
 
@@ -74,6 +96,9 @@ struct SideEfectAnalyzer : public util::ConstVisitor {
   dataflow::CaptureResult *cr;
   bool globalAssignmentHasSideEffects;
   std::unordered_map<id_t, Status> result;
+  /// read-only statuses of already-finalized functions (bottom-up call graph
+  /// processing); consulted before walking a node
+  const std::unordered_map<id_t, Status> *base = nullptr;
   std::vector<const BodiedFunc *> funcStack;
   Status exprStatus;
   Status funcStatus;
@@ -89,7 +114,8 @@ struct SideEfectAnalyzer : public util::ConstVisitor {
         funcStack(), exprStatus(Status::PURE), funcStatus(Status::PURE) {}
 
   template <typename T> bool has(const T *v) {
-    return result.find(v->getId()) != result.end();
+    return result.find(v->getId()) != result.end() ||
+           (base && base->find(v->getId()) != base->end());
   }
 
   template <typename T> void set(const T *v, Status expr, Status func = Status::PURE) {
@@ -100,8 +126,14 @@ struct SideEfectAnalyzer : public util::ConstVisitor {
   template <typename T> Status process(const T *v) {
     if (!v)
       return Status::PURE;
-    if (has(v))
-      return result[v->getId()];
+    auto it = result.find(v->getId());
+    if (it != result.end())
+      return it->second;
+    if (base) {
+      auto bIt = base->find(v->getId());
+      if (bIt != base->end())
+        return bIt->second;
+    }
     v->accept(*this);
     seqassertn(has(v), "node not added to results");
     return result[v->getId()];
@@ -357,11 +389,142 @@ bool SideEffectResult::hasSideEffect(const Value *v) const {
 
 std::unique_ptr<Result> SideEffectAnalysis::run(const Module *m) {
   auto *capResult = getAnalysisResult<dataflow::CaptureResult>(capAnalysisKey);
+
+  std::vector<const Func *> funcs;
+  if (const auto *mainFunc = cast<Func>(m->getMainFunc()))
+    funcs.push_back(mainFunc);
+  for (const auto *var : *m) {
+    if (const auto *f = cast<Func>(var))
+      funcs.push_back(f);
+  }
+  auto n = funcs.size();
+
+  // one walk per function, across worker threads: var-use counts and explicit
+  // call graph edges come out of the same pass
+  std::vector<FuncWalk> walks(n);
+  util::parallelFor(
+      n, [&](size_t i) { walks[i].process(const_cast<Func *>(funcs[i])); });
+
   VarUseAnalyzer vua;
-  const_cast<Module *>(m)->accept(vua);
-  SideEfectAnalyzer sea(vua, capResult, globalAssignmentHasSideEffects);
-  m->accept(sea);
-  return std::make_unique<SideEffectResult>(sea.result);
+  std::unordered_map<id_t, size_t> funcIndex;
+  for (size_t i = 0; i < n; i++)
+    funcIndex[funcs[i]->getId()] = i;
+  std::vector<std::vector<size_t>> callees(n);
+  for (size_t i = 0; i < n; i++) {
+    for (auto &entry : walks[i].varCounts)
+      vua.varCounts[entry.first] += entry.second;
+    for (auto &entry : walks[i].varAssignCounts)
+      vua.varAssignCounts[entry.first] += entry.second;
+    for (const auto *c : walks[i].callees) {
+      auto it = funcIndex.find(c->getId());
+      if (it != funcIndex.end())
+        callees[i].push_back(it->second);
+    }
+    std::sort(callees[i].begin(), callees[i].end());
+    callees[i].erase(std::unique(callees[i].begin(), callees[i].end()),
+                     callees[i].end());
+  }
+
+  // Tarjan's algorithm (iterative); emits SCCs in reverse topological order
+  // of the condensation, i.e. callees before callers
+  constexpr unsigned UNSEEN = std::numeric_limits<unsigned>::max();
+  std::vector<unsigned> index(n, UNSEEN), low(n, 0);
+  std::vector<size_t> sccOf(n, 0);
+  std::vector<std::vector<size_t>> sccs;
+  std::vector<size_t> tarjanStack;
+  std::vector<bool> onStack(n, false);
+  unsigned counter = 0;
+
+  struct Frame {
+    size_t v;
+    size_t edge;
+  };
+  for (size_t root = 0; root < n; root++) {
+    if (index[root] != UNSEEN)
+      continue;
+    std::vector<Frame> frames = {{root, 0}};
+    index[root] = low[root] = counter++;
+    tarjanStack.push_back(root);
+    onStack[root] = true;
+    while (!frames.empty()) {
+      auto &fr = frames.back();
+      if (fr.edge < callees[fr.v].size()) {
+        auto w = callees[fr.v][fr.edge++];
+        if (index[w] == UNSEEN) {
+          index[w] = low[w] = counter++;
+          tarjanStack.push_back(w);
+          onStack[w] = true;
+          frames.push_back({w, 0});
+        } else if (onStack[w]) {
+          low[fr.v] = std::min(low[fr.v], index[w]);
+        }
+      } else {
+        auto v = fr.v;
+        if (low[v] == index[v]) {
+          std::vector<size_t> scc;
+          size_t w;
+          do {
+            w = tarjanStack.back();
+            tarjanStack.pop_back();
+            onStack[w] = false;
+            sccOf[w] = sccs.size();
+            scc.push_back(w);
+          } while (w != v);
+          sccs.push_back(std::move(scc));
+        }
+        frames.pop_back();
+        if (!frames.empty())
+          low[frames.back().v] = std::min(low[frames.back().v], low[v]);
+      }
+    }
+  }
+
+  // group SCCs into levels such that every callee SCC is in a lower level;
+  // SCCs within a level are independent and can be analyzed in parallel
+  std::vector<size_t> level(sccs.size(), 0);
+  size_t maxLevel = 0;
+  for (size_t s = 0; s < sccs.size(); s++) {
+    for (auto fi : sccs[s]) {
+      for (auto w : callees[fi]) {
+        if (sccOf[w] != s)
+          level[s] = std::max(level[s], level[sccOf[w]] + 1);
+      }
+    }
+    maxLevel = std::max(maxLevel, level[s]);
+  }
+  std::vector<std::vector<size_t>> levels(maxLevel + 1);
+  for (size_t s = 0; s < sccs.size(); s++)
+    levels[level[s]].push_back(s);
+
+  // bottom-up: when an SCC is analyzed, all of its callees' summaries are
+  // final and frozen in `summaries`, so workers read it without locking
+  std::unordered_map<id_t, util::SideEffectStatus> finalResult;
+  std::unordered_map<id_t, util::SideEffectStatus> summaries;
+  for (auto &lvl : levels) {
+    std::vector<std::unordered_map<id_t, util::SideEffectStatus>> partial(
+        lvl.size());
+    util::parallelFor(lvl.size(), [&](size_t i) {
+      SideEfectAnalyzer sea(vua, capResult, globalAssignmentHasSideEffects);
+      sea.base = &summaries;
+      for (auto fi : sccs[lvl[i]])
+        sea.process(funcs[fi]);
+      partial[i] = std::move(sea.result);
+    });
+    for (size_t i = 0; i < lvl.size(); i++) {
+      for (auto &entry : partial[i])
+        finalResult[entry.first] = entry.second;
+      for (auto fi : sccs[lvl[i]])
+        summaries[funcs[fi]->getId()] = finalResult[funcs[fi]->getId()];
+    }
+  }
+
+  // plain variables are side effect-free, as before
+  for (const auto *var : *m) {
+    if (!isA<Func>(var))
+      finalResult.emplace(var->getId(), util::SideEffectStatus::PURE);
+  }
+
+  return std::make_unique<SideEffectResult>(finalResult);
 }
 
 } // namespace module
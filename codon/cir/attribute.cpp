@@ -10,6 +10,22 @@
 namespace codon {
 namespace ir {
 
+int builtinAttributeId(const std::string &key) {
+  static const std::unordered_map<std::string, int> ids = {
+      {SrcInfoAttribute::AttributeName, SrcInfoAttribute::AttributeID},
+      {DocstringAttribute::AttributeName, DocstringAttribute::AttributeID},
+      {KeyValueAttribute::AttributeName, KeyValueAttribute::AttributeID},
+      {MemberAttribute::AttributeName, MemberAttribute::AttributeID},
+      {TupleLiteralAttribute::AttributeName, TupleLiteralAttribute::AttributeID},
+      {ListLiteralAttribute::AttributeName, ListLiteralAttribute::AttributeID},
+      {SetLiteralAttribute::AttributeName, SetLiteralAttribute::AttributeID},
+      {DictLiteralAttribute::AttributeName, DictLiteralAttribute::AttributeID},
+      {PartialFunctionAttribute::AttributeName, PartialFunctionAttribute::AttributeID},
+  };
+  auto it = ids.find(key);
+  return it != ids.end() ? it->second : -1;
+}
+
 const std::string KeyValueAttribute::AttributeName = "kvAttribute";
 
 bool KeyValueAttribute::has(const std::string &key) const {
@@ -21,6 +21,17 @@ namespace util {
 class CloneVisitor;
 }
 
+/// Number of fixed attribute slots on each node. The attributes the compiler
+/// itself attaches carry a constant AttributeID indexing one of these slots,
+/// so their lookups are array accesses; attributes added by plugins and DSLs
+/// have no ID and fall back to the node's string-keyed store.
+constexpr int NUM_ATTRIBUTE_SLOTS = 9;
+
+/// Maps a built-in attribute name to its slot.
+/// @param key the attribute name
+/// @return the slot index, or -1 if the attribute is not built in
+int builtinAttributeId(const std::string &key);
+
 /// Base for CIR attributes.
 struct Attribute {
   virtual ~Attribute() noexcept = default;
@@ -47,6 +58,7 @@ private:
 /// Attribute containing SrcInfo
 struct SrcInfoAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 0;
 
   /// source info
   codon::SrcInfo info;
@@ -67,6 +79,7 @@ private:
 /// Attribute containing docstring from source
 struct DocstringAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 1;
 
   /// the docstring
   std::string docstring;
@@ -87,6 +100,7 @@ private:
 /// Attribute containing function information
 struct KeyValueAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 2;
 
   /// attributes map
   std::map<std::string, std::string> attributes;
@@ -117,6 +131,7 @@ private:
 /// Attribute containing type member information
 struct MemberAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 3;
 
   /// member source info map
   std::map<std::string, SrcInfo> memberSrcInfo;
@@ -138,6 +153,7 @@ private:
 /// Attribute attached to IR structures corresponding to tuple literals
 struct TupleLiteralAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 4;
 
   /// values contained in tuple literal
   std::vector<Value *> elements;
@@ -163,6 +179,7 @@ struct LiteralElement {
 /// Attribute attached to IR structures corresponding to list literals
 struct ListLiteralAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 5;
 
   /// elements contained in list literal
   std::vector<LiteralElement> elements;
@@ -180,6 +197,7 @@ private:
 /// Attribute attached to IR structures corresponding to set literals
 struct SetLiteralAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 6;
 
   /// elements contained in set literal
   std::vector<LiteralElement> elements;
@@ -204,6 +222,7 @@ struct DictLiteralAttribute : public Attribute {
   };
 
   static const std::string AttributeName;
+  static constexpr int AttributeID = 7;
 
   /// keys and values contained in dict literal
   std::vector<KeyValuePair> elements;
@@ -221,6 +240,7 @@ private:
 /// Attribute attached to IR structures corresponding to partial functions
 struct PartialFunctionAttribute : public Attribute {
   static const std::string AttributeName;
+  static constexpr int AttributeID = 8;
 
   /// base name of the function being used in the partial
   std::string name;
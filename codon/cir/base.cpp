@@ -10,7 +10,7 @@
 namespace codon {
 namespace ir {
 
-id_t IdMixin::currentId = 0;
+std::atomic<id_t> IdMixin::currentId(0);
 
 void IdMixin::resetId() { currentId = 0; }
 
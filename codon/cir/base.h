@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -12,6 +14,7 @@
 #include "codon/cir/util/iterators.h"
 #include "codon/cir/util/visitor.h"
 #include "codon/util/common.h"
+#include "codon/util/pool.h"
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
@@ -26,8 +29,9 @@ class Module;
 /// Mixin class for IR nodes that need ids.
 class IdMixin {
 private:
-  /// the global id counter
-  static id_t currentId;
+  /// the global id counter; atomic so analyses building synthetic nodes
+  /// (e.g. CFG construction) can run across threads
+  static std::atomic<id_t> currentId;
 
 protected:
   /// the instance's id
@@ -48,7 +52,11 @@ class Node {
 private:
   /// the node's name
   std::string name;
-  /// key-value attribute store
+  /// fixed slots for the compiler's own attributes, indexed by AttributeID;
+  /// source info and literal attributes are set on nearly every node, and
+  /// slot accesses avoid a map node allocation and string compare per lookup
+  std::array<std::unique_ptr<Attribute>, NUM_ATTRIBUTE_SLOTS> builtinAttributes;
+  /// key-value store for plugin and DSL attributes only
   std::map<std::string, std::unique_ptr<Attribute>> attributes;
   /// the module
   Module *module = nullptr;
@@ -65,6 +73,17 @@ public:
   /// @param name the node's name
   explicit Node(std::string name = "") : name(std::move(name)) {}
 
+  /// IR nodes are allocated from a slab pool: pass pipelines churn through
+  /// millions of short-lived nodes, and pooling removes per-node malloc/free
+  /// and keeps nodes together for cache locality. The sized delete dispatches
+  /// on the dynamic type, so derived nodes return to the right size class.
+  static void *operator new(size_t bytes) {
+    return codon::util::MemoryPool::get().allocate(bytes);
+  }
+  static void operator delete(void *p, size_t bytes) {
+    codon::util::MemoryPool::get().deallocate(p, bytes);
+  }
+
   /// See LLVM documentation.
   static const void *nodeId() { return &NodeId; }
   /// See LLVM documentation.
@@ -99,33 +118,65 @@ public:
   /// @param v the visitor
   virtual void accept(util::ConstVisitor &v) const = 0;
 
+  /// Sets an attribute in a built-in slot.
+  /// @param value the attribute
+  /// @param id the attribute's slot
+  void setAttribute(std::unique_ptr<Attribute> value, int id) {
+    getActual()->builtinAttributes[id] = std::move(value);
+  }
   /// Sets an attribute
   /// @param the attribute key
   /// @param value the attribute
   void setAttribute(std::unique_ptr<Attribute> value, const std::string &key) {
-    getActual()->attributes[key] = std::move(value);
+    auto id = builtinAttributeId(key);
+    if (id >= 0) {
+      setAttribute(std::move(value), id);
+    } else {
+      getActual()->attributes[key] = std::move(value);
+    }
   }
   /// Sets an attribute
   /// @param value the attribute
   template <typename AttributeType>
   void setAttribute(std::unique_ptr<AttributeType> value) {
-    setAttribute(std::move(value), AttributeType::AttributeName);
+    setAttribute(std::move(value), AttributeType::AttributeID);
   }
 
+  /// @param id the slot
+  /// @return true if the built-in slot is occupied
+  bool hasAttribute(int id) const {
+    return bool(getActual()->builtinAttributes[id]);
+  }
   /// @param n the name
   /// @return true if the attribute is in the store
   bool hasAttribute(const std::string &n) const {
+    auto id = builtinAttributeId(n);
+    if (id >= 0)
+      return hasAttribute(id);
     auto *actual = getActual();
     return actual->attributes.find(n) != actual->attributes.end();
   }
   /// @return true if the attribute is in the store
   template <typename AttributeType> bool hasAttribute() const {
-    return hasAttribute(AttributeType::AttributeName);
+    return hasAttribute(AttributeType::AttributeID);
   }
 
+  /// Gets the attribute in a built-in slot.
+  /// @param id the slot
+  Attribute *getAttribute(int id) {
+    return getActual()->builtinAttributes[id].get();
+  }
+  /// Gets the attribute in a built-in slot.
+  /// @param id the slot
+  const Attribute *getAttribute(int id) const {
+    return getActual()->builtinAttributes[id].get();
+  }
   /// Gets the appropriate attribute.
   /// @param key the attribute key
   Attribute *getAttribute(const std::string &key) {
+    auto id = builtinAttributeId(key);
+    if (id >= 0)
+      return getAttribute(id);
     auto *actual = getActual();
 
     auto it = actual->attributes.find(key);
@@ -134,6 +185,9 @@ public:
   /// Gets the appropriate attribute.
   /// @param key the attribute key
   const Attribute *getAttribute(const std::string &key) const {
+    auto id = builtinAttributeId(key);
+    if (id >= 0)
+      return getAttribute(id);
     auto *actual = getActual();
 
     auto it = actual->attributes.find(key);
@@ -142,26 +196,26 @@ public:
   /// Gets the appropriate attribute.
   /// @tparam AttributeType the return type
   template <typename AttributeType> AttributeType *getAttribute() {
-    return static_cast<AttributeType *>(getAttribute(AttributeType::AttributeName));
+    return static_cast<AttributeType *>(getAttribute(AttributeType::AttributeID));
   }
   /// Gets the appropriate attribute.
   /// @tparam AttributeType the return type
   template <typename AttributeType> const AttributeType *getAttribute() const {
     return static_cast<const AttributeType *>(
-        getAttribute(AttributeType::AttributeName));
+        getAttribute(AttributeType::AttributeID));
   }
 
-  /// @return iterator to the first attribute
+  /// @return iterator to the first non-built-in attribute
   auto attributes_begin() {
     return util::map_key_adaptor(getActual()->attributes.begin());
   }
-  /// @return iterator beyond the last attribute
+  /// @return iterator beyond the last non-built-in attribute
   auto attributes_end() { return util::map_key_adaptor(getActual()->attributes.end()); }
-  /// @return iterator to the first attribute
+  /// @return iterator to the first non-built-in attribute
   auto attributes_begin() const {
     return util::const_map_key_adaptor(getActual()->attributes.begin());
   }
-  /// @return iterator beyond the last attribute
+  /// @return iterator beyond the last non-built-in attribute
   auto attributes_end() const {
     return util::const_map_key_adaptor(getActual()->attributes.end());
   }
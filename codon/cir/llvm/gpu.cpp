@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 
+#include "codon/compiler/compilation_cache.h"
 #include "codon/util/common.h"
 
 namespace codon {
@@ -664,7 +665,38 @@ void applyGPUTransformations(llvm::Module *M, const std::string &ptxFilename) {
   llvm::sys::path::replace_extension(path, "ptx");
   filename = path.str();
 
-  moduleToPTX(clone.get(), filename, kernels);
+  // PTX cache: device codegen (NVPTX pipeline plus libdevice linking) is
+  // skipped when an identical kernel module was already compiled. The key
+  // covers the cloned device module, the target arch/features and the
+  // libdevice path, so host-only edits reuse the cached PTX.
+  const std::string gpuCPU = "sm_30";
+  const std::string gpuFeatures = "+ptx42";
+  CompilationCache cache(fmt::format("{}-{}", CODON_VERSION, GPU_TRIPLE));
+  std::string cacheKey, cachedPTX;
+  bool cacheHit = false;
+  if (cache.isEnabled()) {
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    clone->print(os, nullptr);
+    cacheKey = cache.combineKeys(
+        cache.getKey(ir),
+        fmt::format("{}-{}-{}", gpuCPU, gpuFeatures, libdevice.getValue()));
+    cacheHit = cache.lookup("ptx", cacheKey, cachedPTX);
+  }
+
+  if (cacheHit) {
+    std::error_code errcode;
+    llvm::raw_fd_ostream out(filename, errcode, llvm::sys::fs::OF_Text);
+    if (errcode)
+      compilationError(errcode.message());
+    out << cachedPTX;
+  } else {
+    moduleToPTX(clone.get(), filename, kernels, gpuCPU, gpuFeatures);
+    if (cache.isEnabled()) {
+      if (auto buf = llvm::MemoryBuffer::getFile(filename))
+        cache.store("ptx", cacheKey, (*buf)->getBuffer().str());
+    }
+  }
   cleanUpIntrinsics(M);
   addInitCall(M, filename);
 }
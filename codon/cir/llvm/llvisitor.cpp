@@ -3,29 +3,38 @@
 #include "llvisitor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstdlib>
 #include <fmt/args.h>
 #include <sys/wait.h>
+#include <thread>
 #include <unistd.h>
 #include <utility>
 
 #include "codon/cir/dsl/codegen.h"
 #include "codon/cir/llvm/optimize.h"
 #include "codon/cir/util/irtools.h"
+#include "codon/compiler/compilation_cache.h"
 #include "codon/compiler/debug_listener.h"
 #include "codon/compiler/memory_manager.h"
 #include "codon/parser/common.h"
 #include "codon/runtime/lib.h"
 #include "codon/util/common.h"
 
+#ifdef CODON_ENABLE_LLD
+#include "lld/Common/Driver.h"
+#endif
+
 namespace codon {
 namespace ir {
 namespace {
 const std::string EXPORT_ATTR = "std.internal.attributes.export";
 const std::string INLINE_ATTR = "std.internal.attributes.inline";
 const std::string NOINLINE_ATTR = "std.internal.attributes.noinline";
+const std::string MULTIVERSION_ATTR = "std.internal.attributes.multiversion";
 const std::string GPU_KERNEL_ATTR = "std.gpu.kernel";
+const std::string SIMD_LOOP_ATTR = "std.openmp.simd";
 
 const std::string MAIN_UNCLASH = ".main.unclash";
 const std::string MAIN_CTOR = ".main.ctor";
@@ -139,13 +148,22 @@ void LLVMVisitor::registerGlobal(const Var *var) {
           getNameForVar(var));
       insertVar(var, storage);
 
+      // Globals of pointer-free types can never hold heap references, so
+      // group them into one section that the runtime excludes from the
+      // collector's static root set (ELF gives us __start_/__stop_ symbols
+      // for the range). Skipped under the JIT, whose globals are looked up
+      // by name across modules.
+      if (!external && !db.jit && var->getType()->isAtomic() &&
+          llvm::Triple(M->getTargetTriple()).isOSBinFormatELF())
+        storage->setSection("codon_atomic_data");
+
       if (external) {
         if (db.jit) {
           storage->setDSOLocal(true);
         } else {
           storage->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Local);
         }
-      } else {
+      } else if (db.debug) {
         // debug info
         auto *srcInfo = getSrcInfo(var);
         llvm::DIFile *file = db.getFile(srcInfo->file);
@@ -160,6 +178,68 @@ void LLVMVisitor::registerGlobal(const Var *var) {
   }
 }
 
+llvm::GlobalVariable *LLVMVisitor::getStringStorage(const std::string &s) {
+  auto it = strings.find(s);
+  if (it != strings.end())
+    return it->second;
+  auto *strVar = new llvm::GlobalVariable(
+      *M, llvm::ArrayType::get(B->getInt8Ty(), s.length() + 1),
+      /*isConstant=*/true, llvm::GlobalValue::PrivateLinkage,
+      llvm::ConstantDataArray::getString(*context, s), ".str");
+  strVar->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+  strings.emplace(s, strVar);
+  return strVar;
+}
+
+llvm::Constant *LLVMVisitor::getLiteralInitializer(const Value *rhs) {
+  if (auto *x = cast<IntConst>(rhs))
+    return B->getInt64(x->getVal());
+  if (auto *x = cast<FloatConst>(rhs))
+    return llvm::ConstantFP::get(B->getDoubleTy(), x->getVal());
+  if (auto *x = cast<BoolConst>(rhs))
+    return B->getInt8(x->getVal() ? 1 : 0);
+  if (auto *x = cast<StringConst>(rhs)) {
+    const std::string &s = x->getVal();
+    auto *strType = llvm::StructType::get(B->getInt64Ty(), B->getInt8PtrTy());
+    return llvm::ConstantStruct::get(
+        strType,
+        {B->getInt64(s.length()),
+         llvm::ConstantExpr::getBitCast(getStringStorage(s), B->getInt8PtrTy())});
+  }
+  return nullptr;
+}
+
+void LLVMVisitor::foldConstantGlobalInits(const BodiedFunc *main) {
+  auto *body = cast<SeriesFlow>(main->getBody());
+  if (!body)
+    return;
+
+  // Only the leading run of literal assignments can be folded: once an
+  // arbitrary statement executes at startup it may read any global, so
+  // the stores after it must stay in program order.
+  for (const auto *stmt : *body) {
+    auto *assign = cast<AssignInstr>(stmt);
+    if (!assign)
+      break;
+    auto *init = getLiteralInitializer(assign->getRhs());
+    if (!init)
+      break;
+
+    auto *lhs = assign->getLhs();
+    if (!lhs->isGlobal())
+      continue; // literal store to a local; safe to scan past
+    if (lhs->isExternal())
+      break;
+
+    auto *storage = llvm::dyn_cast_or_null<llvm::GlobalVariable>(getVar(lhs));
+    if (!storage || !storage->hasInitializer() ||
+        storage->getValueType() != init->getType())
+      break;
+    storage->setInitializer(init);
+    foldedGlobalInits.insert(assign->getId());
+  }
+}
+
 llvm::Value *LLVMVisitor::getVar(const Var *var) {
   auto it = vars.find(var->getId());
   if (db.jit && var->isGlobal()) {
@@ -177,16 +257,18 @@ llvm::Value *LLVMVisitor::getVar(const Var *var) {
                                                  /*Initializer=*/nullptr, privName);
         storage->setExternallyInitialized(true);
 
-        // debug info
-        auto *srcInfo = getSrcInfo(var);
-        llvm::DIFile *file = db.getFile(srcInfo->file);
-        llvm::DIScope *scope = db.unit;
-        llvm::DIGlobalVariableExpression *debugVar =
-            db.builder->createGlobalVariableExpression(
-                scope, getDebugNameForVariable(var), name, file, srcInfo->line,
-                getDIType(var->getType()),
-                /*IsLocalToUnit=*/true);
-        storage->addDebugInfo(debugVar);
+        if (db.debug) {
+          // debug info
+          auto *srcInfo = getSrcInfo(var);
+          llvm::DIFile *file = db.getFile(srcInfo->file);
+          llvm::DIScope *scope = db.unit;
+          llvm::DIGlobalVariableExpression *debugVar =
+              db.builder->createGlobalVariableExpression(
+                  scope, getDebugNameForVariable(var), name, file, srcInfo->line,
+                  getDIType(var->getType()),
+                  /*IsLocalToUnit=*/true);
+          storage->addDebugInfo(debugVar);
+        }
         insertVar(var, storage);
         return storage;
       }
@@ -250,10 +332,14 @@ std::unique_ptr<llvm::Module> LLVMVisitor::makeModule(llvm::LLVMContext &context
   // debug info setup
   db.builder = std::make_unique<llvm::DIBuilder>(*M);
   llvm::DIFile *file = db.getFile(srcInfo->file);
-  db.unit = db.builder->createCompileUnit(llvm::dwarf::DW_LANG_C, file,
-                                          ("codon version " CODON_VERSION), !db.debug,
-                                          db.flags,
-                                          /*RV=*/0);
+  db.unit = db.builder->createCompileUnit(
+      llvm::dwarf::DW_LANG_C, file, ("codon version " CODON_VERSION), !db.debug,
+      db.flags,
+      /*RV=*/0, /*SplitName=*/"",
+      // Release builds carry only the address-to-line tables tracebacks
+      // need; full scopes, types and variables are debug-only.
+      db.debug ? llvm::DICompileUnit::DebugEmissionKind::FullDebug
+               : llvm::DICompileUnit::DebugEmissionKind::LineTablesOnly);
   M->addModuleFlag(llvm::Module::Warning, "Debug Info Version",
                    llvm::DEBUG_METADATA_VERSION);
   // darwin only supports dwarf2
@@ -288,6 +374,8 @@ void LLVMVisitor::clearLLVMData() {
     }
   }
 
+  strings.clear();
+  foldedGlobalInits.clear();
   coro.reset();
   loops.clear();
   trycatch.clear();
@@ -359,31 +447,203 @@ void LLVMVisitor::runLLVMPipeline() {
   optimize(M.get(), db.debug, db.jit, plugins);
 }
 
-void LLVMVisitor::writeToObjectFile(const std::string &filename, bool pic) {
-  runLLVMPipeline();
-
+namespace {
+// Number of parallel codegen jobs; when greater than 1, executable builds
+// split the optimized module and emit machine code on this many threads.
+unsigned getCodegenJobs() {
+  if (const char *env = getenv("CODON_CODEGEN_JOBS")) {
+    auto n = atoi(env);
+    if (n > 0)
+      return (unsigned)n;
+  }
+  return 1;
+}
+
+// Incremental builds (CODON_INCREMENTAL) split the module before
+// optimization and cache per-part object files, so edits that leave most
+// parts unchanged skip most of the LLVM work on rebuilds at the cost of
+// cross-part inlining.
+bool incrementalBuildEnabled() {
+  const char *env = getenv("CODON_INCREMENTAL");
+  return env && *env && *env != '0';
+}
+
+// Emits the given module as a native object file. On failure, sets *error
+// if given (for use off the main thread), else reports a compilation error.
+void emitObjectFile(llvm::Module *module, const std::string &filename, bool pic,
+                    std::string *error = nullptr) {
   std::error_code err;
   auto out =
       std::make_unique<llvm::ToolOutputFile>(filename, err, llvm::sys::fs::OF_None);
-  if (err)
+  if (err) {
+    if (error) {
+      *error = err.message();
+      return;
+    }
     compilationError(err.message());
+  }
   llvm::raw_pwrite_stream *os = &out->os();
 
-  auto machine = getTargetMachine(M.get(), /*setFunctionAttributes=*/false, pic);
+  auto machine = getTargetMachine(module, /*setFunctionAttributes=*/false, pic);
   auto &llvmtm = static_cast<llvm::LLVMTargetMachine &>(*machine);
   auto *mmiwp = new llvm::MachineModuleInfoWrapperPass(&llvmtm);
   llvm::legacy::PassManager pm;
 
-  llvm::TargetLibraryInfoImpl tlii(llvm::Triple(M->getTargetTriple()));
+  llvm::TargetLibraryInfoImpl tlii(llvm::Triple(module->getTargetTriple()));
   pm.add(new llvm::TargetLibraryInfoWrapperPass(tlii));
   seqassertn(!machine->addPassesToEmitFile(pm, *os, nullptr, llvm::CGFT_ObjectFile,
                                            /*DisableVerify=*/true, mmiwp),
              "could not add passes");
   const_cast<llvm::TargetLoweringObjectFile *>(llvmtm.getObjFileLowering())
       ->Initialize(mmiwp->getMMI().getContext(), *machine);
-  pm.run(*M);
+  pm.run(*module);
   out->keep();
 }
+} // namespace
+
+void LLVMVisitor::writeToObjectFile(const std::string &filename, bool pic) {
+  runLLVMPipeline();
+  emitObjectFile(M.get(), filename, pic);
+}
+
+std::vector<std::string> LLVMVisitor::writeToObjectFiles(const std::string &base,
+                                                         bool pic) {
+  auto jobs = getCodegenJobs();
+  if (incrementalBuildEnabled() && !db.debug)
+    return writeToObjectFilesIncremental(base, pic, std::max(jobs, 1u));
+
+  if (jobs <= 1 || db.debug) {
+    writeToObjectFile(base, pic);
+    return {base};
+  }
+
+  runLLVMPipeline();
+
+  // Split the module along function boundaries and emit machine code for
+  // the parts on separate threads. The interprocedural pipeline above has
+  // already run on the whole module, so splitting only divides backend
+  // work; parts are moved to fresh contexts via bitcode, since a context
+  // cannot be used concurrently.
+  std::vector<llvm::SmallString<0>> parts;
+  llvm::SplitModule(
+      *M, jobs,
+      [&](std::unique_ptr<llvm::Module> part) {
+        parts.emplace_back();
+        llvm::raw_svector_ostream os(parts.back());
+        llvm::WriteBitcodeToFile(*part, os);
+      },
+      /*PreserveLocals=*/true);
+
+  std::vector<std::string> files(parts.size());
+  std::vector<std::string> errors(parts.size());
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < parts.size(); i++) {
+    files[i] = fmt::format("{}.{}", base, i);
+    threads.emplace_back([&, i]() {
+      llvm::LLVMContext ctx;
+      llvm::MemoryBufferRef buf(llvm::StringRef(parts[i].data(), parts[i].size()),
+                                "split");
+      auto part = llvm::parseBitcodeFile(buf, ctx);
+      if (!part) {
+        errors[i] = llvm::toString(part.takeError());
+        return;
+      }
+      emitObjectFile(part.get().get(), files[i], pic, &errors[i]);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  for (auto &error : errors) {
+    if (!error.empty())
+      compilationError(error);
+  }
+  return files;
+}
+
+std::vector<std::string>
+LLVMVisitor::writeToObjectFilesIncremental(const std::string &base, bool pic,
+                                           unsigned jobs) {
+  db.builder->finalize();
+
+  CompilationCache cache(fmt::format("{}-release-{}-{}{}", CODON_VERSION,
+                                     M->getTargetTriple(),
+                                     llvm::sys::getHostCPUName().str(),
+                                     pic ? "-pic" : ""));
+  if (!cache.isEnabled()) {
+    writeToObjectFile(base, pic);
+    return {base};
+  }
+
+  // Split the unoptimized module along function boundaries. SplitModule
+  // assigns functions to parts by name hash, so a function that did not
+  // change lands in the same part across builds, and a part's bitcode
+  // digest only changes when one of its functions does. Finer splits mean
+  // finer invalidation, so use more parts than codegen threads.
+  auto numParts = std::max(jobs, 16u);
+  std::vector<llvm::SmallString<0>> parts;
+  llvm::SplitModule(
+      *M, numParts,
+      [&](std::unique_ptr<llvm::Module> part) {
+        parts.emplace_back();
+        llvm::raw_svector_ostream os(parts.back());
+        llvm::WriteBitcodeToFile(*part, os);
+      },
+      /*PreserveLocals=*/true);
+
+  std::vector<std::string> files(parts.size());
+  std::vector<std::string> errors(parts.size());
+  std::atomic<unsigned> next(0);
+  std::atomic<unsigned> hits(0);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < std::min(jobs, (unsigned)parts.size()); t++) {
+    threads.emplace_back([&]() {
+      for (unsigned i = next++; i < parts.size(); i = next++) {
+        files[i] = fmt::format("{}.{}", base, i);
+        auto key =
+            cache.getKey(std::string(parts[i].data(), parts[i].size()));
+
+        std::string cached;
+        if (cache.lookup("obj", key, cached)) {
+          std::error_code err;
+          llvm::raw_fd_ostream out(files[i], err, llvm::sys::fs::OF_None);
+          if (err)
+            errors[i] = err.message();
+          else
+            out << cached;
+          ++hits;
+          continue;
+        }
+
+        // Miss: optimize and emit just this part, then publish the object.
+        // Each part is optimized on its own, so cross-part inlining is
+        // lost relative to a regular build -- the tradeoff incremental
+        // mode opts into.
+        llvm::LLVMContext ctx;
+        llvm::MemoryBufferRef buf(
+            llvm::StringRef(parts[i].data(), parts[i].size()), "split");
+        auto part = llvm::parseBitcodeFile(buf, ctx);
+        if (!part) {
+          errors[i] = llvm::toString(part.takeError());
+          continue;
+        }
+        optimize(part.get().get(), db.debug, /*jit=*/false, plugins);
+        emitObjectFile(part.get().get(), files[i], pic, &errors[i]);
+        if (errors[i].empty()) {
+          if (auto obj = llvm::MemoryBuffer::getFile(files[i]))
+            cache.store("obj", key, (*obj)->getBuffer().str());
+        }
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (auto &error : errors) {
+    if (!error.empty())
+      compilationError(error);
+  }
+  LOG_USER("incremental build: {}/{} parts reused", hits.load(), parts.size());
+  return files;
+}
 
 void LLVMVisitor::writeToBitcodeFile(const std::string &filename) {
   runLLVMPipeline();
@@ -428,6 +688,126 @@ void executeCommand(const std::vector<std::string> &args) {
     }
   }
 }
+
+#if defined(CODON_ENABLE_LLD) && defined(__linux__)
+/// Directories searched for the C runtime startup objects and default
+/// system libraries when linking in-process.
+std::vector<std::string> systemLibDirs() {
+  const std::string dirs[] = {
+#if defined(__x86_64__)
+    "/usr/lib/x86_64-linux-gnu",
+    "/lib/x86_64-linux-gnu",
+#elif defined(__aarch64__)
+    "/usr/lib/aarch64-linux-gnu",
+    "/lib/aarch64-linux-gnu",
+#endif
+    "/usr/lib64",
+    "/lib64",
+    "/usr/lib",
+    "/lib",
+  };
+  std::vector<std::string> found;
+  for (const auto &dir : dirs) {
+    if (llvm::sys::fs::is_directory(dir))
+      found.push_back(dir);
+  }
+  return found;
+}
+
+std::string findInDirs(const std::vector<std::string> &dirs, const std::string &name) {
+  for (const auto &dir : dirs) {
+    llvm::SmallString<128> path(dir);
+    llvm::sys::path::append(path, name);
+    if (llvm::sys::fs::exists(path))
+      return std::string(path);
+  }
+  return "";
+}
+
+std::string defaultDynamicLinker() {
+#if defined(__x86_64__)
+  return "/lib64/ld-linux-x86-64.so.2";
+#elif defined(__aarch64__)
+  return "/lib/ld-linux-aarch64.so.1";
+#else
+  return "";
+#endif
+}
+
+/// Links in-process with the embedded lld, avoiding the process spawn and
+/// driver overhead of an external link. Returns false (without reporting
+/// an error) if the system pieces the driver would normally supply cannot
+/// be located, in which case the caller falls back to the external driver.
+bool executeLLDLink(const std::vector<std::string> &objFiles,
+                    const std::string &filename, bool library,
+                    const std::vector<std::string> &rpaths,
+                    const std::vector<std::string> &libArgs,
+                    const std::vector<std::string> &userFlags) {
+  auto dirs = systemLibDirs();
+  auto dynLinker = defaultDynamicLinker();
+  auto crti = findInDirs(dirs, "crti.o");
+  auto crtn = findInDirs(dirs, "crtn.o");
+  auto crt1 = findInDirs(dirs, "Scrt1.o");
+  if (crt1.empty())
+    crt1 = findInDirs(dirs, "crt1.o");
+  if (dynLinker.empty() || !llvm::sys::fs::exists(dynLinker) || crti.empty() ||
+      crtn.empty() || (!library && crt1.empty()))
+    return false;
+
+  std::vector<std::string> args = {"ld.lld", "--eh-frame-hdr"};
+  if (library) {
+    args.push_back("-shared");
+  } else {
+    args.push_back("-no-pie");
+    args.push_back("-dynamic-linker");
+    args.push_back(dynLinker);
+    args.push_back(crt1);
+  }
+  args.push_back(crti);
+  // profile-guided objects carry per-function sections plus a call-graph
+  // profile; ask lld to cluster callers with their hot callees (its
+  // default, but spelled out so the layout does not hinge on it)
+  if (isProfileGuided())
+    args.push_back("--call-graph-profile-sort");
+  for (const auto &obj : objFiles)
+    args.push_back(obj);
+  for (const auto &rpath : rpaths) {
+    if (!rpath.empty()) {
+      args.push_back("-L" + rpath);
+      args.push_back("-rpath=" + rpath);
+    }
+  }
+  for (const auto &dir : dirs)
+    args.push_back("-L" + dir);
+  for (const auto &lib : libArgs)
+    args.push_back(lib);
+  args.push_back("--as-needed");
+  args.push_back("-lgcc_s");
+  args.push_back("--no-as-needed");
+  for (const auto &uflag : userFlags) {
+    // translate the handful of driver spellings users pass via -linker-flags
+    if (uflag.rfind("-Wl,", 0) == 0) {
+      llvm::SmallVector<llvm::StringRef> sub;
+      llvm::StringRef(uflag).substr(4).split(sub, ",", /*MaxSplit=*/-1,
+                                             /*KeepEmpty=*/false);
+      for (const auto &s : sub)
+        args.push_back(s.str());
+    } else {
+      args.push_back(uflag);
+    }
+  }
+  args.push_back(crtn);
+  args.push_back("-o");
+  args.push_back(filename);
+
+  std::vector<const char *> cArgs;
+  for (const auto &arg : args)
+    cArgs.push_back(arg.c_str());
+  LOG_USER("Linking in-process: '{}'", fmt::join(cArgs, " "));
+  return lld::elf::link(cArgs, llvm::outs(), llvm::errs(), /*exitEarly=*/false,
+                        /*disableOutput=*/false);
+}
+#endif // CODON_ENABLE_LLD && __linux__
 } // namespace
 
 void LLVMVisitor::setupGlobalCtorForSharedLibrary() {
@@ -476,7 +856,7 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
     setupGlobalCtorForSharedLibrary();
 
   const std::string objFile = filename + ".o";
-  writeToObjectFile(objFile, /*pic=*/library);
+  auto objFiles = writeToObjectFiles(objFile, /*pic=*/library);
 
   const std::string base = ast::executable_path(argv0.c_str());
   auto path = llvm::SmallString<128>(llvm::sys::path::parent_path(base));
@@ -500,7 +880,8 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
   // Avoid "argument unused during compilation" warning
   command.push_back("-Wno-unused-command-line-argument");
   // MUST go before -llib to compile on Linux
-  command.push_back(objFile);
+  for (const auto &obj : objFiles)
+    command.push_back(obj);
 
   if (library)
     command.push_back("-shared");
@@ -522,14 +903,16 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
       llvm::sys::fs::make_absolute(rpath0);
       llvm::StringRef rpath = rpath0.str();
       if (!rpath.empty()) {
+        rpaths.push_back(rpath.str());
         command.push_back("-L" + rpath.str());
         command.push_back("-Wl,-rpath," + rpath.str());
       }
     }
   }
 
+  std::vector<std::string> libArgs;
   for (const auto &lib : libs) {
-    command.push_back("-l" + lib);
+    libArgs.push_back("-l" + lib);
   }
 
   if (plugins) {
@@ -543,27 +926,35 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
         if (stem.startswith("lib"))
           stem = stem.substr(3);
 
-        command.push_back("-l" + stem.str());
+        libArgs.push_back("-l" + stem.str());
       } else {
         for (auto &l : plugin->info.linkArgs)
-          command.push_back(l);
+          libArgs.push_back(l);
       }
     }
   }
 
-  std::vector<std::string> extraArgs = {
-      "-lcodonrt", "-lomp", "-lpthread", "-ldl", "-lz", "-lm", "-lc", "-o", filename};
+  for (const auto &lib :
+       {"-lcodonrt", "-lomp", "-lpthread", "-ldl", "-lz", "-lm", "-lc"})
+    libArgs.push_back(lib);
 
-  for (const auto &arg : extraArgs) {
+  for (const auto &arg : libArgs) {
     command.push_back(arg);
   }
+  command.push_back("-o");
+  command.push_back(filename);
 
   llvm::SmallVector<llvm::StringRef> userFlags(16);
   llvm::StringRef(lflags).split(userFlags, " ", /*MaxSplit=*/-1, /*KeepEmpty=*/false);
 
+  std::vector<std::string> userFlagArgs;
   for (const auto &uflag : userFlags) {
     if (!uflag.empty())
-      command.push_back(uflag.str());
+      userFlagArgs.push_back(uflag.str());
+  }
+
+  for (const auto &uflag : userFlagArgs) {
+    command.push_back(uflag);
   }
 
   // Avoid "relocation R_X86_64_32 against `.bss' can not be used when making a PIE
@@ -571,6 +962,17 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
   if (!library)
     command.push_back("-no-pie");
 
+#if defined(CODON_ENABLE_LLD) && defined(__linux__)
+  // Link in-process with the embedded lld unless the user opts out; fall
+  // back to the external driver if the system link inputs cannot be found
+  // or the in-process link fails.
+  if (!getenv("CODON_SYSTEM_LINKER")) {
+    if (executeLLDLink(objFiles, filename, library, rpaths, libArgs, userFlagArgs))
+      return;
+    LOG_USER("in-process link unavailable; falling back to '{}'", command[0]);
+  }
+#endif
+
   executeCommand(command);
 
 #if __APPLE__
@@ -578,7 +980,8 @@ void LLVMVisitor::writeToExecutable(const std::string &filename,
     executeCommand({"dsymutil", filename});
 #endif
 
-  llvm::sys::fs::remove(objFile);
+  for (const auto &obj : objFiles)
+    llvm::sys::fs::remove(obj);
 }
 
 namespace {
@@ -1218,7 +1621,27 @@ void LLVMVisitor::compile(const std::string &filename, const std::string &argv0,
 
 void LLVMVisitor::run(const std::vector<std::string> &args,
                       const std::vector<std::string> &libs, const char *const *envp) {
-  runLLVMPipeline();
+  // Object cache: release-mode runs of an identical module are served from
+  // a cached object file, skipping the LLVM pipeline and codegen entirely.
+  // The key covers the full (unoptimized) module, so any source, flag or
+  // version change produces a different key.
+  CompilationCache cache(fmt::format("{}-{}-{}-{}", CODON_VERSION,
+                                     db.debug ? "debug" : "release",
+                                     M->getTargetTriple(),
+                                     llvm::sys::getHostCPUName().str()));
+  std::string cacheKey, cachedObj;
+  bool cacheHit = false;
+  if (cache.isEnabled() && !db.debug) {
+    Timer t0("llvm/objcache_key");
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    M->print(os, nullptr);
+    cacheKey = cache.getKey(ir);
+    cacheHit = cache.lookup("obj", cacheKey, cachedObj);
+  }
+
+  if (!cacheHit)
+    runLLVMPipeline();
 
   Timer t1("llvm/jitlink");
   for (auto &lib : libs) {
@@ -1256,10 +1679,35 @@ void LLVMVisitor::run(const std::vector<std::string> &args,
       llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
           jit->getDataLayout().getGlobalPrefix())));
 
-  llvm::cantFail(jit->addIRModule({std::move(M), std::move(context)}));
+  if (cacheHit) {
+    llvm::cantFail(jit->addObjectFile(
+        llvm::MemoryBuffer::getMemBufferCopy(cachedObj, "codon-objcache")));
+  } else {
+    if (cache.isEnabled() && !db.debug) {
+      jit->getObjTransformLayer().setTransform(
+          [&cache, cacheKey](std::unique_ptr<llvm::MemoryBuffer> buf)
+              -> llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> {
+            cache.store("obj", cacheKey,
+                        std::string(buf->getBufferStart(), buf->getBufferSize()));
+            return std::move(buf);
+          });
+    }
+    llvm::cantFail(jit->addIRModule({std::move(M), std::move(context)}));
+  }
   clearLLVMData();
   auto mainAddr = llvm::cantFail(jit->lookup("main"));
 
+  runtime::setProfileSymbolizer([dbp](uintptr_t pc) -> std::string {
+    auto src = dbp->symbolize(pc);
+    if (!src) {
+      llvm::consumeError(src.takeError());
+      return "";
+    }
+    if (src->FunctionName == "<invalid>")
+      return "";
+    return fmt::format("{} ({}:{})", src->FunctionName, src->FileName, src->Line);
+  });
+
   if (db.debug) {
     runtime::setJITErrorCallback([dbp](const runtime::JITError &e) {
       fmt::print(stderr, "{}\n{}", e.getOutput(),
@@ -1344,6 +1792,8 @@ llvm::FunctionCallee LLVMVisitor::makeExcAllocFunc() {
                                   B->getInt8PtrTy());
   auto *g = cast<llvm::Function>(f.getCallee());
   g->setDoesNotThrow();
+  // throw setup only runs on exception paths; keep it out of hot layout
+  g->addFnAttr(llvm::Attribute::AttrKind::Cold);
   return f;
 }
 
@@ -1351,6 +1801,7 @@ llvm::FunctionCallee LLVMVisitor::makeThrowFunc() {
   auto f = M->getOrInsertFunction("seq_throw", B->getVoidTy(), B->getInt8PtrTy());
   auto *g = cast<llvm::Function>(f.getCallee());
   g->setDoesNotReturn();
+  g->addFnAttr(llvm::Attribute::AttrKind::Cold);
   return f;
 }
 
@@ -1358,6 +1809,7 @@ llvm::FunctionCallee LLVMVisitor::makeTerminateFunc() {
   auto f = M->getOrInsertFunction("seq_terminate", B->getVoidTy(), B->getInt8PtrTy());
   auto *g = cast<llvm::Function>(f.getCallee());
   g->setDoesNotReturn();
+  g->addFnAttr(llvm::Attribute::AttrKind::Cold);
   return f;
 }
 
@@ -1486,6 +1938,14 @@ void LLVMVisitor::visit(const Module *x) {
     registerGlobal(var);
   }
 
+  // Fold leading literal global assignments of the top-level code into
+  // static initializers, so they cost nothing at startup. Skipped under
+  // the JIT, where globals live across inputs and are stored externally.
+  if (!db.jit) {
+    if (auto *main = cast<BodiedFunc>(x->getMainFunc()))
+      foldConstantGlobalInits(main);
+  }
+
   // process functions
   for (auto *var : *x) {
     if (auto *f = cast<Func>(var)) {
@@ -1633,9 +2093,18 @@ void LLVMVisitor::visit(const Module *x) {
 llvm::DISubprogram *LLVMVisitor::getDISubprogramForFunc(const Func *x) {
   auto *srcInfo = getSrcInfo(x);
   llvm::DIFile *file = db.getFile(srcInfo->file);
-  auto *derivedType = llvm::cast<llvm::DIDerivedType>(getDIType(x->getType()));
-  auto *subroutineType =
-      llvm::cast<llvm::DISubroutineType>(derivedType->getRawBaseType());
+  llvm::DISubroutineType *subroutineType = nullptr;
+  if (db.debug) {
+    auto *derivedType = llvm::cast<llvm::DIDerivedType>(getDIType(x->getType()));
+    subroutineType =
+        llvm::cast<llvm::DISubroutineType>(derivedType->getRawBaseType());
+  } else {
+    // Line tables only: an empty signature avoids building the DI type
+    // graph for every monomorphized function while keeping the scope
+    // that line locations (and hence backtraces) hang off.
+    subroutineType =
+        db.builder->createSubroutineType(db.builder->getOrCreateTypeArray({}));
+  }
 
   std::string baseName = x->getUnmangledName();
   if (auto *parent = x->getParentType())
@@ -1939,6 +2408,9 @@ void LLVMVisitor::visit(const BodiedFunc *x) {
   if (fnAttributes && fnAttributes->has(NOINLINE_ATTR)) {
     func->addFnAttr(llvm::Attribute::AttrKind::NoInline);
   }
+  if (fnAttributes && fnAttributes->has(MULTIVERSION_ATTR)) {
+    func->addFnAttr(llvm::Attribute::get(*context, "multiversion"));
+  }
   if (fnAttributes && fnAttributes->has(GPU_KERNEL_ATTR)) {
     func->addFnAttr(llvm::Attribute::AttrKind::NoInline);
     func->addFnAttr(llvm::Attribute::get(*context, "kernel"));
@@ -1966,17 +2438,19 @@ void LLVMVisitor::visit(const BodiedFunc *x) {
     B->CreateStore(argIter, storage);
     insertVar(var, storage);
 
-    // debug info
-    auto *srcInfo = getSrcInfo(var);
-    llvm::DIFile *file = db.getFile(srcInfo->file);
-    llvm::DISubprogram *scope = func->getSubprogram();
-    llvm::DILocalVariable *debugVar = db.builder->createParameterVariable(
-        scope, getDebugNameForVariable(var), argIdx, file, srcInfo->line,
-        getDIType(var->getType()), db.debug);
-    db.builder->insertDeclare(
-        storage, debugVar, db.builder->createExpression(),
-        llvm::DILocation::get(*context, srcInfo->line, srcInfo->col, scope),
-        entryBlock);
+    if (db.debug) {
+      // debug info
+      auto *srcInfo = getSrcInfo(var);
+      llvm::DIFile *file = db.getFile(srcInfo->file);
+      llvm::DISubprogram *scope = func->getSubprogram();
+      llvm::DILocalVariable *debugVar = db.builder->createParameterVariable(
+          scope, getDebugNameForVariable(var), argIdx, file, srcInfo->line,
+          getDIType(var->getType()), db.debug);
+      db.builder->insertDeclare(
+          storage, debugVar, db.builder->createExpression(),
+          llvm::DILocation::get(*context, srcInfo->line, srcInfo->col, scope),
+          entryBlock);
+    }
 
     ++argIter;
     ++argIdx;
@@ -1990,17 +2464,19 @@ void LLVMVisitor::visit(const BodiedFunc *x) {
       llvm::Value *storage = B->CreateAlloca(llvmType);
       insertVar(var, storage);
 
-      // debug info
-      auto *srcInfo = getSrcInfo(var);
-      llvm::DIFile *file = db.getFile(srcInfo->file);
-      llvm::DISubprogram *scope = func->getSubprogram();
-      llvm::DILocalVariable *debugVar = db.builder->createAutoVariable(
-          scope, getDebugNameForVariable(var), file, srcInfo->line,
-          getDIType(var->getType()), db.debug);
-      db.builder->insertDeclare(
-          storage, debugVar, db.builder->createExpression(),
-          llvm::DILocation::get(*context, srcInfo->line, srcInfo->col, scope),
-          entryBlock);
+      if (db.debug) {
+        // debug info
+        auto *srcInfo = getSrcInfo(var);
+        llvm::DIFile *file = db.getFile(srcInfo->file);
+        llvm::DISubprogram *scope = func->getSubprogram();
+        llvm::DILocalVariable *debugVar = db.builder->createAutoVariable(
+            scope, getDebugNameForVariable(var), file, srcInfo->line,
+            getDIType(var->getType()), db.debug);
+        db.builder->insertDeclare(
+            storage, debugVar, db.builder->createExpression(),
+            llvm::DILocation::get(*context, srcInfo->line, srcInfo->col, scope),
+            entryBlock);
+      }
     }
   }
 
@@ -2128,6 +2604,24 @@ void LLVMVisitor::visit(const PointerValue *x) {
  * Types
  */
 
+namespace {
+// Unions whose members are all non-polymorphic reference classes (at most 8 of
+// them) are packed into a single pointer with the tag stored in the low bits;
+// reference objects are always at least 8-byte aligned. Must agree with the
+// union_all_by_ref static check used by the union intrinsics in internal.codon.
+bool isTaggedPointerUnion(types::UnionType *x) {
+  auto count = std::distance(x->begin(), x->end());
+  if (count < 1 || count > 8)
+    return false;
+  for (auto *t : *x) {
+    auto *ref = cast<types::RefType>(t);
+    if (!ref || ref->isPolymorphic())
+      return false;
+  }
+  return true;
+}
+} // namespace
+
 llvm::Type *LLVMVisitor::getLLVMType(types::Type *t) {
   if (auto *x = cast<types::IntType>(t)) {
     return B->getInt64Ty();
@@ -2187,7 +2681,9 @@ llvm::Type *LLVMVisitor::getLLVMType(types::Type *t) {
   }
 
   if (auto *x = cast<types::OptionalType>(t)) {
-    if (cast<types::RefType>(x->getBase())) {
+    // references and raw pointers use null as the None sentinel
+    if (cast<types::RefType>(x->getBase()) ||
+        cast<types::PointerType>(x->getBase())) {
       return getLLVMType(x->getBase());
     } else {
       return llvm::StructType::get(B->getInt1Ty(), getLLVMType(x->getBase()));
@@ -2212,6 +2708,9 @@ llvm::Type *LLVMVisitor::getLLVMType(types::Type *t) {
   }
 
   if (auto *x = cast<types::UnionType>(t)) {
+    if (isTaggedPointerUnion(x))
+      return B->getInt8PtrTy();
+
     auto &layout = M->getDataLayout();
     llvm::Type *largest = nullptr;
     size_t maxSize = 0;
@@ -2393,7 +2892,8 @@ llvm::DIType *LLVMVisitor::getDITypeHelper(
   }
 
   if (auto *x = cast<types::OptionalType>(t)) {
-    if (cast<types::RefType>(x->getBase())) {
+    if (cast<types::RefType>(x->getBase()) ||
+        cast<types::PointerType>(x->getBase())) {
       return getDITypeHelper(x->getBase(), cache);
     } else {
       auto *baseType = getLLVMType(x->getBase());
@@ -2497,11 +2997,11 @@ void LLVMVisitor::visit(const BoolConst *x) {
 void LLVMVisitor::visit(const StringConst *x) {
   B->SetInsertPoint(block);
   std::string s = x->getVal();
-  auto *strVar =
-      new llvm::GlobalVariable(*M, llvm::ArrayType::get(B->getInt8Ty(), s.length() + 1),
-                               /*isConstant=*/true, llvm::GlobalValue::PrivateLinkage,
-                               llvm::ConstantDataArray::getString(*context, s), ".str");
-  strVar->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+  // Intern literals module-wide: repeated strings (log prefixes, format
+  // fragments, dict keys) multiply across monomorphized instantiations,
+  // so one shared global per distinct literal cuts both data-section
+  // size and the number of GC roots the memory manager registers.
+  llvm::GlobalVariable *strVar = getStringStorage(s);
   auto *strType = llvm::StructType::get(B->getInt64Ty(), B->getInt8PtrTy());
   llvm::Value *ptr = B->CreateBitCast(strVar, B->getInt8PtrTy());
   llvm::Value *len = B->getInt64(s.length());
@@ -2603,6 +3103,10 @@ void LLVMVisitor::visit(const ForFlow *x) {
 
   process(x->getIter());
   llvm::Value *iter = value;
+  // The loop owns this generator: the handle never escapes and is always
+  // destroyed at cleanup, so mark the producing call for frame elision.
+  if (auto *call = llvm::dyn_cast<llvm::CallInst>(iter))
+    call->setMetadata("codon.coro.owned", llvm::MDNode::get(*context, {}));
   B->SetInsertPoint(block);
   B->CreateBr(condBlock);
 
@@ -2678,7 +3182,23 @@ void LLVMVisitor::visit(const ImperativeForFlow *x) {
 
   B->SetInsertPoint(updateBlock);
   phi->addIncoming(B->CreateAdd(phi, B->getInt64(x->getStep())), updateBlock);
-  B->CreateBr(condBlock);
+  auto *latch = B->CreateBr(condBlock);
+
+  if (x->hasAttribute(SIMD_LOOP_ATTR)) {
+    // force the loop vectorizer on this loop, using predicated (masked)
+    // vector instructions; LLVM warns when the transformation fails
+    auto *enable = llvm::MDNode::get(
+        *context,
+        {llvm::MDString::get(*context, "llvm.loop.vectorize.enable"),
+         llvm::ConstantAsMetadata::get(llvm::ConstantInt::getTrue(*context))});
+    auto *predicate = llvm::MDNode::get(
+        *context,
+        {llvm::MDString::get(*context, "llvm.loop.vectorize.predicate.enable"),
+         llvm::ConstantAsMetadata::get(llvm::ConstantInt::getTrue(*context))});
+    auto *loopID = llvm::MDNode::getDistinct(*context, {nullptr, enable, predicate});
+    loopID->replaceOperandWith(0, loopID);
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+  }
 
   block = exitBlock;
 }
@@ -3071,6 +3591,10 @@ void LLVMVisitor::codegenPipeline(
         llvm::Intrinsic::getDeclaration(M.get(), llvm::Intrinsic::coro_destroy);
 
     llvm::Value *iter = value;
+    // As in for-loops, the stage owns this generator, so mark the producing
+    // call for frame elision.
+    if (auto *call = llvm::dyn_cast<llvm::CallInst>(iter))
+      call->setMetadata("codon.coro.owned", llvm::MDNode::get(*context, {}));
     B->SetInsertPoint(block);
     B->CreateBr(condBlock);
 
@@ -3124,6 +3648,8 @@ void LLVMVisitor::visit(const dsl::CustomFlow *x) {
  */
 
 void LLVMVisitor::visit(const AssignInstr *x) {
+  if (foldedGlobalInits.count(x->getId()))
+    return; // already a static initializer; no runtime store needed
   llvm::Value *var = getVar(x->getLhs());
   seqassertn(var, "could not find {} var", *x->getLhs());
   process(x->getRhs());
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -141,6 +142,10 @@ private:
   std::unordered_map<id_t, llvm::Value *> vars;
   /// LLVM functions corresponding to IR functions
   std::unordered_map<id_t, llvm::Function *> funcs;
+  /// Interned string literals of the current module (content to global)
+  std::unordered_map<std::string, llvm::GlobalVariable *> strings;
+  /// Assignments folded into static global initializers; no runtime store
+  std::unordered_set<id_t> foldedGlobalInits;
   /// Coroutine data, if current function is a coroutine
   CoroData coro;
   /// Loop data stack, containing break/continue blocks
@@ -209,6 +214,14 @@ private:
   // LLVM passes
   void runLLVMPipeline();
 
+  /// Interned storage for a string literal's bytes
+  llvm::GlobalVariable *getStringStorage(const std::string &s);
+  /// Static initializer for a literal constant, or null if not a literal
+  llvm::Constant *getLiteralInitializer(const Value *rhs);
+  /// Folds leading literal global assignments of the main function into
+  /// static initializers of the corresponding LLVM globals
+  void foldConstantGlobalInits(const BodiedFunc *main);
+
   llvm::Value *getVar(const Var *var);
   void insertVar(const Var *var, llvm::Value *x) { vars.emplace(var->getId(), x); }
   llvm::Function *getFunc(const Func *func);
@@ -334,6 +347,27 @@ public:
   /// @param filename the .o file to write to
   /// @param pic true to write position-independent code
   void writeToObjectFile(const std::string &filename, bool pic = false);
+  /// Writes module as one or more native object files. When the
+  /// CODON_CODEGEN_JOBS environment variable is greater than 1, the
+  /// optimized module is split along function boundaries and machine
+  /// code for the parts is emitted on that many threads.
+  /// @param base base name for the .o files
+  /// @param pic true to write position-independent code
+  /// @return the object files written
+  std::vector<std::string> writeToObjectFiles(const std::string &base,
+                                              bool pic = false);
+  /// Writes module as cached per-part native object files for incremental
+  /// builds (CODON_INCREMENTAL). The unoptimized module is split along
+  /// function boundaries, each part is keyed by a digest of its bitcode,
+  /// and only parts whose digest changed since the last build are
+  /// optimized and re-emitted; unchanged parts are served from the object
+  /// cache and the final link picks up the mix.
+  /// @param base base name for the .o files
+  /// @param pic true to write position-independent code
+  /// @param jobs number of parallel codegen threads
+  /// @return the object files written
+  std::vector<std::string> writeToObjectFilesIncremental(const std::string &base,
+                                                         bool pic, unsigned jobs);
   /// Writes module as LLVM bitcode file.
   /// @param filename the .bc file to write to
   void writeToBitcodeFile(const std::string &filename);
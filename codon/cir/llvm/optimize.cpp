@@ -4,12 +4,33 @@
 
 #include <algorithm>
 #include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include "codon/cir/llvm/gpu.h"
 #include "codon/util/common.h"
 
 static llvm::codegen::RegisterCodeGenFlags CFG;
 
+namespace {
+llvm::cl::opt<bool>
+    PGOInstrument("pgo-instrument",
+                  llvm::cl::desc("Instrument code to collect a PGO profile; "
+                                 "the program writes it on exit (see "
+                                 "LLVM_PROFILE_FILE)"),
+                  llvm::cl::init(false));
+
+llvm::cl::opt<std::string>
+    PGOUse("pgo-use",
+           llvm::cl::desc("Optimize using the given profile data "
+                          "(.profdata, from llvm-profdata merge)"),
+           llvm::cl::init(""));
+
+// Set by the fast build tier; see codon::ir::setFastOptimization().
+bool FastOpt = false;
+} // namespace
+
 namespace codon {
 namespace ir {
 
@@ -30,12 +51,20 @@ getTargetMachine(llvm::Triple triple, llvm::StringRef cpuStr,
       llvm::codegen::getExplicitCodeModel(), llvm::CodeGenOpt::Aggressive));
 }
 
+bool isProfileGuided() { return !PGOUse.empty(); }
+
 std::unique_ptr<llvm::TargetMachine>
 getTargetMachine(llvm::Module *module, bool setFunctionAttributes, bool pic) {
   llvm::Triple moduleTriple(module->getTargetTriple());
   std::string cpuStr, featuresStr;
-  const llvm::TargetOptions options =
+  llvm::TargetOptions options =
       llvm::codegen::InitTargetOptionsFromCodeGenFlags(moduleTriple);
+  // With a profile, emit each function in its own section so the linker
+  // can lay out the text segment by call-graph clustering (lld reads the
+  // .llvm.call-graph-profile section the optimizer emits); GNU ld still
+  // groups the .text.hot/.text.unlikely prefixes its default script knows.
+  if (isProfileGuided())
+    options.FunctionSections = true;
   llvm::TargetLibraryInfoImpl tlii(moduleTriple);
 
   if (moduleTriple.getArch()) {
@@ -751,6 +780,140 @@ struct AllocationHoister : public llvm::PassInfoMixin<AllocationHoister> {
   }
 };
 
+/// Emits CPU-dispatched clones of functions marked with the 'multiversion'
+/// attribute (the @multiversion decorator). On x86-64, each marked function
+/// gets AVX2 and AVX-512 clones whose bodies are re-optimized with the wider
+/// feature sets, plus a dispatcher that resolves the best clone once at first
+/// call via the runtime's CPUID probe and tail-calls through a cached pointer
+/// thereafter. One shipped binary then uses wide vectors where the host
+/// supports them while still running on baseline x86-64.
+struct FunctionMultiVersioner : public llvm::PassInfoMixin<FunctionMultiVersioner> {
+  static constexpr const char *AVX2_FEATURES = "+avx,+avx2,+fma,+bmi,+bmi2";
+  static constexpr const char *AVX512_FEATURES =
+      "+avx,+avx2,+fma,+bmi,+bmi2,+avx512f,+avx512bw,+avx512cd,+avx512dq,+avx512vl";
+
+  static llvm::Function *cloneWithFeatures(llvm::Function *func,
+                                           const std::string &name,
+                                           const std::string &features) {
+    llvm::ValueToValueMapTy vmap;
+    auto *clone = llvm::CloneFunction(func, vmap);
+    clone->setName(name);
+    clone->setLinkage(llvm::GlobalValue::PrivateLinkage);
+    std::string merged = features;
+    if (clone->hasFnAttribute("target-features")) {
+      merged = clone->getFnAttribute("target-features").getValueAsString().str() +
+               "," + features;
+      clone->removeFnAttr("target-features");
+    }
+    clone->addFnAttr("target-features", merged);
+    return clone;
+  }
+
+  static void processFunction(llvm::Function *func, llvm::Module &M) {
+    auto &context = M.getContext();
+    const std::string name = func->getName().str();
+    const auto linkage = func->getLinkage();
+
+    func->removeFnAttr("multiversion");
+    func->setName(name + ".generic");
+
+    auto *dispatcher =
+        llvm::Function::Create(func->getFunctionType(), linkage, name, M);
+    dispatcher->setCallingConv(func->getCallingConv());
+    dispatcher->setAttributes(func->getAttributes());
+    func->setLinkage(llvm::GlobalValue::PrivateLinkage);
+    func->replaceAllUsesWith(dispatcher);
+
+    auto *avx2 = cloneWithFeatures(func, name + ".avx2", AVX2_FEATURES);
+    auto *avx512 = cloneWithFeatures(func, name + ".avx512", AVX512_FEATURES);
+
+    llvm::IRBuilder<> B(context);
+    auto *ptr = B.getPtrTy();
+    auto *fnptr = new llvm::GlobalVariable(M, ptr, /*isConstant=*/false,
+                                           llvm::GlobalValue::PrivateLinkage,
+                                           llvm::ConstantPointerNull::get(ptr),
+                                           name + ".fnptr");
+
+    auto *entry = llvm::BasicBlock::Create(context, "entry", dispatcher);
+    auto *resolve = llvm::BasicBlock::Create(context, "resolve", dispatcher);
+    auto *dispatch = llvm::BasicBlock::Create(context, "dispatch", dispatcher);
+
+    B.SetInsertPoint(entry);
+    auto *cached = B.CreateLoad(ptr, fnptr);
+    B.CreateCondBr(B.CreateIsNull(cached), resolve, dispatch);
+
+    B.SetInsertPoint(resolve);
+    auto probe = M.getOrInsertFunction("seq_cpu_feature_level", B.getInt64Ty());
+    auto *level = B.CreateCall(probe);
+    auto *best = B.CreateSelect(
+        B.CreateICmpSGE(level, B.getInt64(2)), avx512,
+        B.CreateSelect(B.CreateICmpSGE(level, B.getInt64(1)), avx2, func));
+    B.CreateStore(best, fnptr);
+    B.CreateBr(dispatch);
+
+    B.SetInsertPoint(dispatch);
+    auto *phi = B.CreatePHI(ptr, 2);
+    phi->addIncoming(cached, entry);
+    phi->addIncoming(best, resolve);
+
+    std::vector<llvm::Value *> args;
+    for (auto &arg : dispatcher->args())
+      args.push_back(&arg);
+    auto *call = B.CreateCall(dispatcher->getFunctionType(), phi, args);
+    call->setTailCallKind(llvm::CallInst::TCK_Tail);
+    call->setCallingConv(dispatcher->getCallingConv());
+    if (dispatcher->getReturnType()->isVoidTy())
+      B.CreateRetVoid();
+    else
+      B.CreateRet(call);
+  }
+
+  llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &am) {
+    llvm::Triple triple(M.getTargetTriple());
+    if (triple.getArch() != llvm::Triple::x86_64)
+      return llvm::PreservedAnalyses::all();
+
+    std::vector<llvm::Function *> work;
+    for (auto &F : M) {
+      if (!F.isDeclaration() && F.hasFnAttribute("multiversion"))
+        work.push_back(&F);
+    }
+    for (auto *F : work)
+      processFunction(F, M);
+    return work.empty() ? llvm::PreservedAnalyses::all()
+                        : llvm::PreservedAnalyses::none();
+  }
+};
+
+/// Forces coroutine frame elision for generators whose lifetime is bounded
+/// by their consumer. Codegen tags generator calls whose handle never escapes
+/// the consuming loop with "codon.coro.owned" metadata; for such calls the
+/// ramp function is marked always-inline at the call site, so once the
+/// coroutine is split, the ramp lands in the consumer and CoroElide can see
+/// begin and destroy together and replace the heap frame with an alloca.
+/// LLVM's own inlining heuristics frequently skip the ramp, which is what
+/// leaves these frames on the heap.
+struct CoroFrameElider : public llvm::PassInfoMixin<CoroFrameElider> {
+  llvm::PreservedAnalyses run(llvm::Function &func,
+                              llvm::FunctionAnalysisManager &am) {
+    bool changed = false;
+    for (auto &block : func) {
+      for (auto &ins : block) {
+        auto *call = llvm::dyn_cast<llvm::CallInst>(&ins);
+        if (!call || !call->getMetadata("codon.coro.owned"))
+          continue;
+        auto *callee = call->getCalledFunction();
+        if (!callee || !callee->isPresplitCoroutine() ||
+            callee->hasFnAttribute(llvm::Attribute::NoInline))
+          continue;
+        call->addFnAttr(llvm::Attribute::AlwaysInline);
+        changed = true;
+      }
+    }
+    return changed ? llvm::PreservedAnalyses::none() : llvm::PreservedAnalyses::all();
+  }
+};
+
 /// Sometimes coroutine lowering produces hard-to-analyze loops involving
 /// function pointer comparisons. This pass puts them into a somewhat
 /// easier-to-analyze form.
@@ -826,57 +989,164 @@ struct CoroBranchSimplifier : public llvm::PassInfoMixin<CoroBranchSimplifier> {
   }
 };
 
-void runLLVMOptimizationPasses(llvm::Module *module, bool debug, bool jit,
-                               PluginManager *plugins) {
-  applyDebugTransformations(module, debug, jit);
-
+/// Fully-constructed LLVM optimization pipeline: target machine, pass
+/// builder, analysis-manager stack and the built module pass manager.
+/// Setting all of this up costs on the order of 100ms — more than the
+/// actual optimization time of a typical REPL input — so JIT sessions
+/// keep instances alive (see \c PipelinePool) and re-run them, while
+/// ahead-of-time compilation constructs one per module as before.
+class OptimizationPipeline {
+private:
   llvm::LoopAnalysisManager lam;
   llvm::FunctionAnalysisManager fam;
   llvm::CGSCCAnalysisManager cgam;
   llvm::ModuleAnalysisManager mam;
-  auto machine = getTargetMachine(module, /*setFunctionAttributes=*/true);
-  llvm::PassBuilder pb(machine.get());
+  std::unique_ptr<llvm::TargetMachine> machine;
+  llvm::TargetLibraryInfoImpl tlii;
+  std::unique_ptr<llvm::PassBuilder> pb;
+  llvm::ModulePassManager mpm;
+
+public:
+  OptimizationPipeline(llvm::Module *module, bool debug, PluginManager *plugins,
+                       bool applyPGO)
+      : machine(getTargetMachine(module, /*setFunctionAttributes=*/false)),
+        tlii(llvm::Triple(module->getTargetTriple())) {
+    // PGO only applies to the first optimization round, so the module is not
+    // instrumented (or profile-annotated) twice.
+    std::optional<llvm::PGOOptions> pgo;
+    if (applyPGO && !debug) {
+      if (PGOInstrument)
+        pgo = llvm::PGOOptions("", "", "", "", llvm::vfs::getRealFileSystem(),
+                               llvm::PGOOptions::IRInstr);
+      else if (!PGOUse.empty())
+        pgo = llvm::PGOOptions(PGOUse, "", "", "", llvm::vfs::getRealFileSystem(),
+                               llvm::PGOOptions::IRUse);
+    }
+    llvm::PipelineTuningOptions pto;
+    // Monomorphization leaves many byte-identical functions behind --
+    // generated tuple and partial methods (__eq__, __hash__, iteration)
+    // in particular -- so fold structural duplicates instead of carrying
+    // each copy through codegen.
+    pto.MergeFunctions = !debug && !FastOpt;
+    pb = std::make_unique<llvm::PassBuilder>(machine.get(), pto, pgo);
+
+    fam.registerPass([this] { return llvm::TargetLibraryAnalysis(tlii); });
+
+    pb->registerModuleAnalyses(mam);
+    pb->registerCGSCCAnalyses(cgam);
+    pb->registerFunctionAnalyses(fam);
+    pb->registerLoopAnalyses(lam);
+    pb->crossRegisterProxies(lam, fam, cgam, mam);
+
+    pb->registerPipelineStartEPCallback(
+        [&](llvm::ModulePassManager &pm, llvm::OptimizationLevel opt) {
+          if (opt.isOptimizingForSpeed()) {
+            if (!FastOpt)
+              pm.addPass(FunctionMultiVersioner());
+            pm.addPass(llvm::createModuleToFunctionPassAdaptor(CoroFrameElider()));
+          }
+        });
+
+    pb->registerOptimizerLastEPCallback(
+        [&](llvm::ModulePassManager &pm, llvm::OptimizationLevel opt) {
+          // Exception paths are seeded cold by codegen (cold throw/alloc-exc
+          // callees), so splitting moves landing-pad and cleanup code out of
+          // the hot function body and into .text.unlikely.
+          if (opt.isOptimizingForSpeed() && !FastOpt)
+            pm.addPass(llvm::HotColdSplittingPass());
+        });
+
+    pb->registerLateLoopOptimizationsEPCallback(
+        [&](llvm::LoopPassManager &pm, llvm::OptimizationLevel opt) {
+          if (opt.isOptimizingForSpeed())
+            pm.addPass(CoroBranchSimplifier());
+        });
+
+    pb->registerPeepholeEPCallback(
+        [&](llvm::FunctionPassManager &pm, llvm::OptimizationLevel opt) {
+          if (opt.isOptimizingForSpeed()) {
+            pm.addPass(AllocationRemover());
+            pm.addPass(llvm::LoopSimplifyPass());
+            pm.addPass(llvm::LCSSAPass());
+            pm.addPass(AllocationHoister());
+          }
+        });
 
-  llvm::Triple moduleTriple(module->getTargetTriple());
-  llvm::TargetLibraryInfoImpl tlii(moduleTriple);
-  fam.registerPass([&] { return llvm::TargetLibraryAnalysis(tlii); });
-
-  pb.registerModuleAnalyses(mam);
-  pb.registerCGSCCAnalyses(cgam);
-  pb.registerFunctionAnalyses(fam);
-  pb.registerLoopAnalyses(lam);
-  pb.crossRegisterProxies(lam, fam, cgam, mam);
-
-  pb.registerLateLoopOptimizationsEPCallback(
-      [&](llvm::LoopPassManager &pm, llvm::OptimizationLevel opt) {
-        if (opt.isOptimizingForSpeed())
-          pm.addPass(CoroBranchSimplifier());
-      });
-
-  pb.registerPeepholeEPCallback(
-      [&](llvm::FunctionPassManager &pm, llvm::OptimizationLevel opt) {
-        if (opt.isOptimizingForSpeed()) {
-          pm.addPass(AllocationRemover());
-          pm.addPass(llvm::LoopSimplifyPass());
-          pm.addPass(llvm::LCSSAPass());
-          pm.addPass(AllocationHoister());
-        }
-      });
+    if (plugins) {
+      for (auto *plugin : *plugins) {
+        plugin->dsl->addLLVMPasses(pb.get(), debug);
+      }
+    }
 
-  if (plugins) {
-    for (auto *plugin : *plugins) {
-      plugin->dsl->addLLVMPasses(&pb, debug);
+    if (debug) {
+      mpm = pb->buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+    } else if (FastOpt) {
+      mpm = pb->buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O1);
+    } else {
+      mpm = pb->buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
     }
   }
 
-  if (debug) {
-    llvm::ModulePassManager mpm =
-        pb.buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+  void run(llvm::Module *module) {
+    llvm::codegen::setFunctionAttributes(llvm::codegen::getCPUStr(),
+                                         llvm::codegen::getFeaturesStr(), *module);
     mpm.run(*module, mam);
+    // Cached analyses are keyed by IR-unit address; drop them so results
+    // for this module are never picked up by a later one that happens to
+    // be allocated at the same place.
+    mam.clear();
+    cgam.clear();
+    fam.clear();
+    lam.clear();
+  }
+};
+
+/// Pool of reusable optimization pipelines for JIT sessions, keyed by the
+/// (debug, PGO) configuration. Pipelines are checked out for the duration
+/// of one module run since the lazy compiler may optimize several modules
+/// concurrently (see CODON_JIT_THREADS).
+class PipelinePool {
+private:
+  std::map<std::pair<bool, bool>, std::vector<std::unique_ptr<OptimizationPipeline>>>
+      free;
+  std::mutex mutex;
+
+public:
+  std::unique_ptr<OptimizationPipeline> acquire(llvm::Module *module, bool debug,
+                                                PluginManager *plugins,
+                                                bool applyPGO) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto &avail = free[{debug, applyPGO}];
+      if (!avail.empty()) {
+        auto pipeline = std::move(avail.back());
+        avail.pop_back();
+        return pipeline;
+      }
+    }
+    return std::make_unique<OptimizationPipeline>(module, debug, plugins, applyPGO);
+  }
+
+  void release(bool debug, bool applyPGO,
+               std::unique_ptr<OptimizationPipeline> pipeline) {
+    std::lock_guard<std::mutex> guard(mutex);
+    free[{debug, applyPGO}].push_back(std::move(pipeline));
+  }
+};
+
+void runLLVMOptimizationPasses(llvm::Module *module, bool debug, bool jit,
+                               PluginManager *plugins, bool applyPGO) {
+  applyDebugTransformations(module, debug, jit);
+
+  if (jit) {
+    // The session never changes target or plugins, so incremental inputs
+    // reuse the same pipeline instead of paying setup on every cell.
+    static PipelinePool pool;
+    auto pipeline = pool.acquire(module, debug, plugins, applyPGO);
+    pipeline->run(module);
+    pool.release(debug, applyPGO, std::move(pipeline));
   } else {
-    llvm::ModulePassManager mpm =
-        pb.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
-    mpm.run(*module, mam);
+    OptimizationPipeline(module, debug, plugins, applyPGO).run(module);
   }
 
   applyDebugTransformations(module, debug, jit);
@@ -893,11 +1163,11 @@ void optimize(llvm::Module *module, bool debug, bool jit, PluginManager *plugins
   verify(module);
   {
     TIME("llvm/opt1");
-    runLLVMOptimizationPasses(module, debug, jit, plugins);
+    runLLVMOptimizationPasses(module, debug, jit, plugins, /*applyPGO=*/true);
   }
-  if (!debug) {
+  if (!debug && !FastOpt) {
     TIME("llvm/opt2");
-    runLLVMOptimizationPasses(module, debug, jit, plugins);
+    runLLVMOptimizationPasses(module, debug, jit, plugins, /*applyPGO=*/false);
   }
   {
     TIME("llvm/gpu");
@@ -906,5 +1176,7 @@ void optimize(llvm::Module *module, bool debug, bool jit, PluginManager *plugins
   verify(module);
 }
 
+void setFastOptimization(bool fast) { FastOpt = fast; }
+
 } // namespace ir
 } // namespace codon
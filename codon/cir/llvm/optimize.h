@@ -9,6 +9,9 @@
 
 namespace codon {
 namespace ir {
+/// @return true if a PGO profile was supplied (-pgo-use)
+bool isProfileGuided();
+
 std::unique_ptr<llvm::TargetMachine>
 getTargetMachine(llvm::Triple triple, llvm::StringRef cpuStr,
                  llvm::StringRef featuresStr, const llvm::TargetOptions &options,
@@ -20,5 +23,10 @@ getTargetMachine(llvm::Module *module, bool setFunctionAttributes = false,
 
 void optimize(llvm::Module *module, bool debug, bool jit = false,
               PluginManager *plugins = nullptr);
+
+/// Selects the quick optimization tier for all subsequent optimize() calls:
+/// LLVM O1 in a single round, no multi-versioning, hot/cold splitting or
+/// function merging. Used by the fast build mode for edit-compile-test loops.
+void setFastOptimization(bool fast = true);
 } // namespace ir
 } // namespace codon
@@ -54,6 +54,26 @@ translateArgs(codon::ast::Cache *cache, std::vector<types::Type *> &types) {
   }
   return ret;
 }
+
+std::string realizationKey(const std::string &name,
+                           const std::vector<types::Type *> &args,
+                           const std::vector<types::Generic> &generics) {
+  auto key = name;
+  for (auto *t : args) {
+    key += '|';
+    key += t->getName();
+  }
+  for (const auto &g : generics) {
+    key += ';';
+    if (g.isStatic())
+      key += std::to_string(g.getStaticValue());
+    else if (g.isStaticStr())
+      key += g.getStaticStringValue();
+    else
+      key += g.getTypeValue()->getName();
+  }
+  return key;
+}
 } // namespace
 
 const std::string Module::VOID_NAME = "void";
@@ -152,6 +172,11 @@ void Module::parseCode(const std::string &code) { cache->parseCode(code); }
 Func *Module::getOrRealizeMethod(types::Type *parent, const std::string &methodName,
                                  std::vector<types::Type *> args,
                                  std::vector<types::Generic> generics) {
+  auto key = realizationKey(
+      fmt::format(FMT_STRING("{}.{}"), parent->getName(), methodName), args, generics);
+  auto memo = funcRealizationCache.find(key);
+  if (memo != funcRealizationCache.end())
+    return memo->second;
 
   auto cls =
       std::const_pointer_cast<ast::types::Type>(parent->getAstType())->getClass();
@@ -159,8 +184,13 @@ Func *Module::getOrRealizeMethod(types::Type *parent, const std::string &methodN
   if (!method)
     return nullptr;
   try {
-    return cache->realizeFunction(method, translateArgs(cache, args),
-                                  translateGenerics(cache, generics), cls);
+    auto *ret = cache->realizeFunction(method, translateArgs(cache, args),
+                                       translateGenerics(cache, generics), cls);
+    // failures are not memoized; a later frontend batch (e.g. a JIT cell)
+    // may add a matching overload
+    if (ret)
+      funcRealizationCache.emplace(key, ret);
+    return ret;
   } catch (const exc::ParserException &e) {
     for (int i = 0; i < e.messages.size(); i++)
       LOG_IR("getOrRealizeMethod parser error at {}: {}", e.locations[i],
@@ -175,13 +205,20 @@ Func *Module::getOrRealizeFunc(const std::string &funcName,
                                const std::string &module) {
   auto fqName =
       module.empty() ? funcName : fmt::format(FMT_STRING("{}.{}"), module, funcName);
+  auto key = realizationKey(fqName, args, generics);
+  auto memo = funcRealizationCache.find(key);
+  if (memo != funcRealizationCache.end())
+    return memo->second;
   auto func = cache->findFunction(fqName);
   if (!func)
     return nullptr;
   auto arg = translateArgs(cache, args);
   auto gens = translateGenerics(cache, generics);
   try {
-    return cache->realizeFunction(func, arg, gens);
+    auto *ret = cache->realizeFunction(func, arg, gens);
+    if (ret)
+      funcRealizationCache.emplace(key, ret);
+    return ret;
   } catch (const exc::ParserException &e) {
     for (int i = 0; i < e.messages.size(); i++)
       LOG_IR("getOrRealizeFunc parser error at {}: {}", e.locations[i], e.messages[i]);
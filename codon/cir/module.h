@@ -128,6 +128,11 @@ private:
   /// the type-checker cache
   ast::Cache *cache = nullptr;
 
+  /// memoized getOrRealizeFunc/getOrRealizeMethod results, keyed by the
+  /// qualified name plus argument and generic identities; lets IR passes
+  /// re-request the same helper without re-entering the typechecker
+  std::unordered_map<std::string, Func *> funcRealizationCache;
+
 public:
   static const char NodeId;
 
@@ -0,0 +1,82 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "dead_store.h"
+
+#include "codon/cir/analyze/dataflow/liveness.h"
+#include "codon/cir/analyze/module/side_effect.h"
+#include "codon/cir/util/cloning.h"
+#include "codon/cir/util/irtools.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace cleanup {
+namespace {
+/// Returns true if the value is a call of the autogenerated argument-less
+/// class allocator (same shape that stack promotion accepts): its only
+/// effect is the allocation itself, so a store of it that is never read
+/// can be deleted along with the allocation.
+bool isPlainAllocation(const Value *v) {
+  auto *call = cast<CallInstr>(v);
+  if (!call || call->numArgs() != 0)
+    return false;
+  auto *func = cast<BodiedFunc>(util::getFunc(call->getCallee()));
+  if (!func || func->getUnmangledName() != Module::NEW_MAGIC_NAME)
+    return false;
+  auto *body = cast<SeriesFlow>(func->getBody());
+  if (!body || std::distance(body->begin(), body->end()) != 1)
+    return false;
+  auto *ret = cast<ReturnInstr>(body->front());
+  if (!ret)
+    return false;
+  auto *inner = cast<CallInstr>(ret->getValue());
+  if (!inner || inner->numArgs() != 0)
+    return false;
+  auto *innerFunc = util::getFunc(inner->getCallee());
+  return innerFunc && innerFunc->getUnmangledName() == "new";
+}
+} // namespace
+
+const std::string DeadStoreCleanupPass::KEY = "core-cleanup-dse";
+
+void DeadStoreCleanupPass::run(Module *m) {
+  numReplacements = 0;
+  OperatorPass::run(m);
+}
+
+void DeadStoreCleanupPass::handle(AssignInstr *v) {
+  auto *lhs = v->getLhs();
+  if (lhs->isGlobal())
+    return;
+  auto *func = cast<BodiedFunc>(getParentFunc());
+  if (!func)
+    return;
+
+  auto *r = getAnalysisResult<analyze::dataflow::LivenessResult>(livenessKey);
+  auto it = r->results.find(func->getId());
+  if (it == r->results.end())
+    return;
+  auto *liveness = it->second.get();
+  if (liveness->isInvalid(lhs) || liveness->isLiveAfter(lhs, v))
+    return;
+
+  auto *se = getAnalysisResult<analyze::module::SideEffectResult>(sideEffectsKey);
+  auto *M = v->getModule();
+  auto *rhs = v->getRhs();
+  numReplacements++;
+  if (!se->hasSideEffect(rhs) || isPlainAllocation(rhs)) {
+    LOG_IR("[{}] store never read, deleting: {}", KEY, *v);
+    v->replaceAll(M->Nr<SeriesFlow>());
+  } else {
+    // the stored value is never read, but computing it is observable;
+    // keep the right-hand side as a bare expression
+    LOG_IR("[{}] store never read, keeping effects: {}", KEY, *v);
+    util::CloneVisitor cv(M);
+    v->replaceAll(cv.clone(rhs));
+  }
+}
+
+} // namespace cleanup
+} // namespace transform
+} // namespace ir
+} // namespace codon
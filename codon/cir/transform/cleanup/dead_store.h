@@ -0,0 +1,49 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace cleanup {
+
+/// Cleanup pass that removes stores whose values are provably never
+/// read. Assignments to local, non-address-taken variables that are
+/// dead by liveness are dropped; side-effecting right-hand sides are
+/// kept as bare expressions, while pure ones and plain class
+/// allocations are deleted outright.
+class DeadStoreCleanupPass : public OperatorPass {
+private:
+  /// the liveness analysis' key
+  std::string livenessKey;
+  /// the side effect analysis' key
+  std::string sideEffectsKey;
+  /// number of removed stores
+  int numReplacements;
+
+public:
+  static const std::string KEY;
+
+  /// Constructs a dead store elimination pass.
+  /// @param livenessKey the liveness analysis' key
+  /// @param sideEffectsKey the side effect analysis' key
+  DeadStoreCleanupPass(std::string livenessKey, std::string sideEffectsKey)
+      : OperatorPass(), livenessKey(std::move(livenessKey)),
+        sideEffectsKey(std::move(sideEffectsKey)), numReplacements(0) {}
+
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  void handle(AssignInstr *v) override;
+
+  /// @return the number of removed stores
+  int getNumReplacements() const { return numReplacements; }
+};
+
+} // namespace cleanup
+} // namespace transform
+} // namespace ir
+} // namespace codon
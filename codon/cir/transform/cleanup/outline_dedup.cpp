@@ -0,0 +1,86 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "outline_dedup.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/matching.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace cleanup {
+namespace {
+
+bool isOutlined(BodiedFunc *f) {
+  return f && f->getBody() && !f->isGenerator() &&
+         f->getName().rfind("__outlined", 0) == 0;
+}
+
+// Replaces the duplicate's body with a tail call to the shared copy. The
+// duplicate keeps its symbol, so call sites and function-pointer uses
+// stay valid, but shrinks to a forwarder that LLVM collapses.
+void forwardTo(BodiedFunc *dup, BodiedFunc *shared) {
+  auto *M = dup->getModule();
+  std::vector<Value *> args;
+  for (auto it = dup->arg_begin(); it != dup->arg_end(); ++it)
+    args.push_back(M->Nr<VarValue>(*it));
+  auto *call = util::call(shared, args);
+
+  auto *body = M->Nr<SeriesFlow>();
+  if (call->getType()->is(M->getVoidType())) {
+    body->push_back(call);
+    body->push_back(M->Nr<ReturnInstr>());
+  } else {
+    body->push_back(M->Nr<ReturnInstr>(call));
+  }
+  dup->setBody(body);
+}
+
+} // namespace
+
+const std::string OutlineDeduplicationPass::KEY = "core-cleanup-outline-dedup";
+
+void OutlineDeduplicationPass::run(Module *module) {
+  numDuplicates = 0;
+
+  // Bucket candidates by a cheap structural fingerprint; only candidates
+  // that land in the same bucket are compared exactly.
+  std::unordered_map<uint64_t, std::vector<BodiedFunc *>> buckets;
+  for (auto *var : *module) {
+    auto *f = cast<BodiedFunc>(var);
+    if (!isOutlined(f))
+      continue;
+    auto hash = util::structuralHash(f->getBody()) ^
+                std::hash<std::string>()(f->getType()->getName());
+    buckets[hash].push_back(f);
+  }
+
+  for (auto &bucket : buckets) {
+    // The first function of each structurally distinct kind becomes the
+    // shared copy; later duplicates forward to it.
+    std::vector<BodiedFunc *> shared;
+    for (auto *f : bucket.second) {
+      BodiedFunc *found = nullptr;
+      for (auto *s : shared) {
+        if (util::matchFuncsInterchangeable(f, s)) {
+          found = s;
+          break;
+        }
+      }
+      if (found) {
+        forwardTo(f, found);
+        ++numDuplicates;
+      } else {
+        shared.push_back(f);
+      }
+    }
+  }
+}
+
+} // namespace cleanup
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,40 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace cleanup {
+
+/// Deduplicates structurally identical outlined functions. Parallel
+/// regions are outlined into a fresh function per site, and generic code
+/// expanded over many types produces large numbers of identical bodies.
+/// This pass buckets outlined functions by structural fingerprint,
+/// verifies candidates with an exact variable-bijection match, and turns
+/// each duplicate into a thin forwarder to one shared copy, shrinking
+/// code size and instruction-cache footprint.
+class OutlineDeduplicationPass : public Pass {
+private:
+  /// number of duplicates merged into a shared copy
+  int numDuplicates;
+
+public:
+  static const std::string KEY;
+
+  /// Constructs an outlined-function deduplication pass
+  OutlineDeduplicationPass() : Pass(), numDuplicates(0) {}
+
+  std::string getKey() const override { return KEY; }
+  void run(Module *module) override;
+
+  /// @return number of duplicates merged into a shared copy
+  int getNumDuplicates() const { return numDuplicates; }
+};
+
+} // namespace cleanup
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,136 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "devirt.h"
+
+#include <unordered_set>
+
+#include "codon/cir/util/irtools.h"
+#include "codon/parser/cache.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace devirt {
+
+const std::string DevirtualizationPass::KEY = "core-devirtualize";
+
+void DevirtualizationPass::run(Module *m) {
+  classOfType.clear();
+  numDevirtualized = 0;
+
+  auto *cache = m->getCache();
+  if (!cache)
+    return;
+
+  for (const auto &[clsName, cls] : cache->classes) {
+    for (const auto &[realName, real] : cls.realizations) {
+      if (real->ir)
+        classOfType[real->ir] = clsName;
+    }
+  }
+
+  OperatorPass::run(m);
+}
+
+void DevirtualizationPass::handle(CallInstr *v) {
+  auto *M = v->getModule();
+  auto *cache = M->getCache();
+  if (!cache)
+    return;
+
+  // virtual calls have the form
+  //   Function[...](class_get_rtti_vtable(self)[vid])(self, args...)
+  auto *fnNew = cast<CallInstr>(v->getCallee());
+  if (!fnNew || fnNew->numArgs() != 1)
+    return;
+  auto *newFunc = util::getFunc(fnNew->getCallee());
+  if (!newFunc || newFunc->getUnmangledName() != Module::NEW_MAGIC_NAME)
+    return;
+
+  auto *getItem = cast<CallInstr>(fnNew->front());
+  if (!getItem || getItem->numArgs() != 2)
+    return;
+  auto *getItemFunc = util::getFunc(getItem->getCallee());
+  if (!getItemFunc || getItemFunc->getUnmangledName() != Module::GETITEM_MAGIC_NAME)
+    return;
+  auto *vid = cast<IntConst>(getItem->back());
+  if (!vid)
+    return;
+
+  auto *vt = cast<CallInstr>(getItem->front());
+  if (!vt || vt->numArgs() != 1)
+    return;
+  auto *vtFunc = util::getFunc(vt->getCallee());
+  if (!vtFunc || vtFunc->getUnmangledName() != "class_get_rtti_vtable")
+    return;
+
+  // the receiver must be the call's first argument; dropping the vtable
+  // load then drops only a duplicate read of the same variable
+  auto *self = cast<VarValue>(vt->front());
+  if (!self || v->numArgs() == 0)
+    return;
+  auto *selfArg = cast<VarValue>(v->front());
+  if (!selfArg || selfArg->getVar()->getId() != self->getVar()->getId())
+    return;
+
+  auto typeIt = classOfType.find(self->getType());
+  if (typeIt == classOfType.end())
+    return;
+  const auto &baseName = typeIt->second;
+  auto &baseCls = cache->classes[baseName];
+
+  // vtables for this base are keyed by its canonical or realized name
+  std::unordered_set<std::string> baseKeys = {baseName};
+  for (const auto &r : baseCls.realizations)
+    baseKeys.insert(r.first);
+
+  // collect the distinct implementations of this slot over the base class
+  // and everything deriving from it
+  std::unordered_set<std::string> targetNames;
+  ast::types::FuncTypePtr target = nullptr;
+  for (const auto &[clsName, cls] : cache->classes) {
+    bool inHierarchy = (clsName == baseName);
+    if (!inHierarchy) {
+      for (const auto &m : cls.mro) {
+        if (m->type && m->type->getClass() && m->type->getClass()->name == baseName) {
+          inHierarchy = true;
+          break;
+        }
+      }
+    }
+    if (!inHierarchy)
+      continue;
+
+    for (const auto &[realName, real] : cls.realizations) {
+      for (const auto &[vtKey, vtable] : real->vtables) {
+        if (baseKeys.find(vtKey) == baseKeys.end())
+          continue;
+        for (const auto &[slotKey, slot] : vtable.table) {
+          if (slot.first && static_cast<int64_t>(slot.second) == vid->getVal()) {
+            targetNames.insert(slot.first->realizedName());
+            target = slot.first;
+          }
+        }
+      }
+    }
+  }
+
+  if (targetNames.size() != 1 || !target)
+    return;
+
+  auto funcIt = cache->functions.find(target->ast->name);
+  if (funcIt == cache->functions.end())
+    return;
+  auto realIt = funcIt->second.realizations.find(target->realizedName());
+  if (realIt == funcIt->second.realizations.end() || !realIt->second->ir)
+    return;
+
+  LOG_IR("[{}] devirtualizing: {}", KEY, *v);
+  v->setCallee(M->Nr<VarValue>(realIt->second->ir));
+  ++numDevirtualized;
+}
+
+} // namespace devirt
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,43 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace devirt {
+
+/// Class-hierarchy-analysis devirtualization pass. Virtual calls are
+/// emitted as loads of a function pointer from the receiver's vtable; the
+/// type checker's cache records every realized implementation of each
+/// vtable slot, so when a slot has exactly one implementation across the
+/// whole program the load is replaced with a direct call, which LLVM can
+/// then inline. Only safe for ahead-of-time compilation, where the class
+/// hierarchy is closed.
+class DevirtualizationPass : public OperatorPass {
+private:
+  /// maps a realized class' CIR type to its canonical class name
+  std::unordered_map<types::Type *, std::string> classOfType;
+  /// number of devirtualized calls
+  int numDevirtualized = 0;
+
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+  void handle(CallInstr *v) override;
+
+  /// @return the number of devirtualized calls
+  int getNumDevirtualized() const { return numDevirtualized; }
+};
+
+} // namespace devirt
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,130 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "escape.h"
+
+#include <utility>
+#include <vector>
+
+#include "codon/cir/analyze/dataflow/capture.h"
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/operator.h"
+#include "codon/parser/cache.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace escape {
+namespace {
+/// Returns true if the function is the autogenerated class allocator,
+/// whose body is a lone `return __magic__.new(T)`; a user-defined
+/// __new__ will not match and is left alone.
+bool isPlainAllocator(BodiedFunc *func) {
+  auto *body = cast<SeriesFlow>(func->getBody());
+  if (!body || std::distance(body->begin(), body->end()) != 1)
+    return false;
+  auto *ret = cast<ReturnInstr>(body->front());
+  if (!ret)
+    return false;
+  auto *inner = cast<CallInstr>(ret->getValue());
+  if (!inner || inner->numArgs() != 0)
+    return false;
+  auto *innerFunc = util::getFunc(inner->getCallee());
+  return innerFunc && innerFunc->getUnmangledName() == "new";
+}
+
+/// Collects class allocations that are eligible for stack promotion
+/// before any rewriting happens, so the capture analysis is only ever
+/// queried against the IR it was computed on.
+struct AllocationCollector : public util::Operator {
+  std::vector<std::pair<BodiedFunc *, CallInstr *>> allocs;
+
+  void handle(CallInstr *v) override {
+    if (v->numArgs() != 0)
+      return;
+    auto *func = cast<BodiedFunc>(util::getFunc(v->getCallee()));
+    if (!func || func->getUnmangledName() != Module::NEW_MAGIC_NAME)
+      return;
+    auto *ref = cast<types::RefType>(v->getType());
+    if (!ref || ref->isPolymorphic() || !isPlainAllocator(func))
+      return;
+    auto *parent = cast<BodiedFunc>(getParentFunc());
+    if (!parent || parent->isGenerator())
+      return;
+    // the slot is emitted once in the entry block, so an allocation
+    // inside a loop would reuse it across iterations
+    for (int i = 0; i < depth(); i++) {
+      auto *p = getParent(i);
+      if (isA<WhileFlow>(p) || isA<ForFlow>(p) || isA<ImperativeForFlow>(p))
+        return;
+    }
+    allocs.emplace_back(parent, v);
+  }
+};
+
+/// Replaces the allocation with a stack slot reinterpreted as the class.
+bool promote(CallInstr *v) {
+  auto *M = v->getModule();
+  auto *ref = cast<types::RefType>(v->getType());
+  auto *arrType = M->getArrayType(ref->getContents());
+  if (!arrType)
+    return false;
+
+  auto *buf = M->Nr<StackAllocInstr>(arrType, 1);
+  auto *ptr = M->Nr<ExtractInstr>(buf, "ptr");
+  auto *asByte = M->getOrRealizeMethod(ptr->getType(), "as_byte", {ptr->getType()});
+  auto *fromStack =
+      M->getOrRealizeFunc("class_from_stack", {M->getPointerType(M->getByteType())},
+                          {ref}, "__internal__");
+  if (!asByte || !fromStack)
+    return false;
+
+  v->replaceAll(util::call(fromStack, {util::call(asByte, {ptr})}));
+  return true;
+}
+} // namespace
+
+const std::string StackPromotionPass::KEY = "core-stack-promotion";
+
+void StackPromotionPass::run(Module *m) {
+  numPromoted = 0;
+  classOfType.clear();
+
+  auto *cache = m->getCache();
+  auto *capResult =
+      getAnalysisResult<analyze::dataflow::CaptureResult>(capAnalysisKey);
+  if (!cache || !capResult)
+    return;
+
+  for (const auto &[clsName, cls] : cache->classes) {
+    for (const auto &[realName, real] : cls.realizations) {
+      if (real->ir)
+        classOfType[real->ir] = clsName;
+    }
+  }
+
+  AllocationCollector collector;
+  collector.process(m);
+
+  for (auto &[func, call] : collector.allocs) {
+    // classes with a __del__ method need the GC finalizer, so their
+    // allocations stay on the heap
+    auto it = classOfType.find(call->getType());
+    if (it == classOfType.end() ||
+        cache->classes[it->second].methods.find("__del__") !=
+            cache->classes[it->second].methods.end())
+      continue;
+
+    if (analyze::dataflow::escapes(func, call, capResult))
+      continue;
+
+    if (promote(call)) {
+      LOG_IR("[{}] promoted allocation to stack: {}", KEY, *call);
+      ++numPromoted;
+    }
+  }
+}
+
+} // namespace escape
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,51 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace escape {
+
+/// Escape-analysis-driven stack promotion of class allocations. A class
+/// construction whose object provably never escapes its frame -- per the
+/// capture analysis: not returned, not stored in another argument, not
+/// assigned to a global -- is rewritten to interpret an entry-block stack
+/// slot as the object instead of calling into the GC allocator. Only
+/// allocations outside of loops are promoted, since the slot is emitted
+/// once per frame, and polymorphic classes and classes with a __del__
+/// method are left alone as they need an RTTI header or a finalizer.
+class StackPromotionPass : public Pass {
+private:
+  /// the capture analysis' key
+  std::string capAnalysisKey;
+  /// maps a realized class' CIR type to its canonical class name
+  std::unordered_map<types::Type *, std::string> classOfType;
+  /// number of promoted allocations
+  int numPromoted = 0;
+
+public:
+  static const std::string KEY;
+
+  /// Constructs a stack promotion pass.
+  /// @param capAnalysisKey the capture analysis' key
+  explicit StackPromotionPass(const std::string &capAnalysisKey)
+      : capAnalysisKey(capAnalysisKey) {}
+
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of promoted allocations
+  int getNumPromoted() const { return numPromoted; }
+};
+
+} // namespace escape
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,140 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "arg_prop.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "codon/cir/util/cloning.h"
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/operator.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace folding {
+namespace {
+const std::string EXPORT_ATTR = "std.internal.attributes.export";
+
+/// Returns true if the value is a literal constant whose value can be
+/// compared across call sites.
+bool isLiteral(const Value *v) {
+  return isA<IntConst>(v) || isA<FloatConst>(v) || isA<BoolConst>(v) ||
+         isA<StringConst>(v);
+}
+
+bool sameLiteral(const Value *a, const Value *b) {
+  if (auto *ai = cast<IntConst>(a)) {
+    auto *bi = cast<IntConst>(b);
+    return bi && ai->getVal() == bi->getVal();
+  } else if (auto *af = cast<FloatConst>(a)) {
+    auto *bf = cast<FloatConst>(b);
+    return bf && af->getVal() == bf->getVal();
+  } else if (auto *ab = cast<BoolConst>(a)) {
+    auto *bb = cast<BoolConst>(b);
+    return bb && ab->getVal() == bb->getVal();
+  } else if (auto *as = cast<StringConst>(a)) {
+    auto *bs = cast<StringConst>(b);
+    return bs && as->getVal() == bs->getVal();
+  }
+  return false;
+}
+
+/// Gathers, for every directly called bodied function, the literal
+/// arguments its call sites agree on, and whether the function is ever
+/// referenced outside of a direct call.
+struct CallSiteCollector : public util::Operator {
+  struct Info {
+    /// number of direct call sites seen
+    int64_t calls = 0;
+    /// per-argument agreed literal; null once any site disagrees
+    std::vector<Value *> args;
+    /// true if the function is referenced outside of a direct call
+    bool escapes = false;
+  };
+
+  /// call information, keyed by function id
+  std::unordered_map<id_t, Info> infos;
+  /// ids of function references that are direct-call callees; calls are
+  /// handled before their children, so this is filled before the callee's
+  /// VarValue is visited on its own
+  std::unordered_set<id_t> calleeUses;
+
+  void handle(CallInstr *v) override {
+    auto *callee = cast<VarValue>(v->getCallee());
+    auto *func = callee ? cast<BodiedFunc>(callee->getVar()) : nullptr;
+    if (!func)
+      return;
+    calleeUses.insert(callee->getId());
+    auto &info = infos[func->getId()];
+    if (info.calls++ == 0) {
+      for (auto *arg : *v)
+        info.args.push_back(isLiteral(arg) ? arg : nullptr);
+    } else {
+      unsigned i = 0;
+      for (auto *arg : *v) {
+        if (i < info.args.size() && info.args[i] &&
+            !(isLiteral(arg) && sameLiteral(info.args[i], arg)))
+          info.args[i] = nullptr;
+        ++i;
+      }
+    }
+  }
+
+  void handle(VarValue *v) override {
+    if (auto *func = cast<BodiedFunc>(v->getVar())) {
+      if (calleeUses.find(v->getId()) == calleeUses.end())
+        infos[func->getId()].escapes = true;
+    }
+  }
+
+  void handle(PointerValue *v) override {
+    if (auto *func = cast<BodiedFunc>(v->getVar()))
+      infos[func->getId()].escapes = true;
+  }
+};
+} // namespace
+
+const std::string ArgumentPropPass::KEY = "core-folding-arg-prop";
+
+void ArgumentPropPass::run(Module *m) {
+  numReplacements = 0;
+  CallSiteCollector collector;
+  collector.process(m);
+
+  util::CloneVisitor cv(m);
+  for (auto *var : *m) {
+    auto *f = cast<BodiedFunc>(var);
+    if (!f)
+      continue;
+    auto it = collector.infos.find(f->getId());
+    if (it == collector.infos.end())
+      continue;
+    auto &info = it->second;
+    if (info.escapes || info.calls == 0 || f->isJIT() ||
+        util::hasAttribute(f, EXPORT_ATTR))
+      continue;
+    auto *body = cast<SeriesFlow>(f->getBody());
+    if (!body)
+      continue;
+
+    unsigned i = 0;
+    for (auto argIt = f->arg_begin(); argIt != f->arg_end(); ++argIt, ++i) {
+      if (i >= info.args.size() || !info.args[i])
+        continue;
+      // pin the argument to its unique call-site value; the folding
+      // group then propagates it through the body and deletes the
+      // branches it disables
+      auto *assign = m->Nr<AssignInstr>(*argIt, cv.clone(info.args[i]));
+      body->insert(body->begin(), assign);
+      LOG_IR("[{}] pinned call-site-constant argument: {}", KEY, *assign);
+      ++numReplacements;
+    }
+  }
+}
+
+} // namespace folding
+} // namespace transform
+} // namespace ir
+} // namespace codon
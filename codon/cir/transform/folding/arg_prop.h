@@ -0,0 +1,36 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace folding {
+
+/// Interprocedural constant argument propagation pass. Scans all direct
+/// call sites in the module; when every caller passes the same literal
+/// for an argument, the argument is pinned to that value at the top of
+/// the callee's body, so the regular folding group can propagate it and
+/// delete the code paths it disables. Functions whose reference escapes
+/// a direct call (stored, passed as a value, exported) are left alone.
+class ArgumentPropPass : public Pass {
+private:
+  /// number of pinned arguments
+  int numReplacements = 0;
+
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of pinned arguments
+  int getNumReplacements() const { return numReplacements; }
+};
+
+} // namespace folding
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -93,6 +93,81 @@ public:
   }
 };
 
+/// Strength reduction for int division, modulo and power by constants.
+/// Under Python numerics, floor division and modulo by a positive power
+/// of two are exactly an arithmetic right shift and a mask, for negative
+/// operands included, so the sign-adjustment branches of the generic
+/// paths disappear before LLVM ever sees a division. Under C numerics
+/// the plain division instruction survives to LLVM, which already
+/// strength-reduces it, so only power expansion applies there. Powers
+/// with small constant exponents become multiply chains when the base is
+/// a variable reference (and hence safe to duplicate).
+class IntStrengthReductionRule : public RewriteRule {
+private:
+  /// the int type
+  types::Type *intType;
+  /// true if // and % follow Python floor semantics
+  bool pyNumerics;
+
+public:
+  IntStrengthReductionRule(types::Type *intType, bool pyNumerics)
+      : intType(intType), pyNumerics(pyNumerics) {}
+
+  virtual ~IntStrengthReductionRule() noexcept = default;
+
+  void visit(CallInstr *v) override {
+    if (v->numArgs() != 2)
+      return;
+    auto *rightConst = cast<IntConst>(v->back());
+    if (!rightConst || isA<Const>(v->front()))
+      return; // two-constant cases are folded outright
+    auto c = rightConst->getVal();
+    auto *M = v->getModule();
+
+    auto powerOfTwo = (c > 0) && !(c & (c - 1));
+    if (pyNumerics && powerOfTwo &&
+        util::isCallOf(v, Module::FLOOR_DIV_MAGIC_NAME, {intType, intType}, intType,
+                       /*method=*/true)) {
+      int64_t shift = 0;
+      while ((int64_t(1) << shift) < c)
+        ++shift;
+      auto *fn =
+          M->getOrRealizeMethod(intType, Module::RSHIFT_MAGIC_NAME, {intType, intType});
+      if (fn)
+        setResult(util::call(fn, {v->front(), M->getInt(shift)}));
+      return;
+    }
+
+    if (pyNumerics && powerOfTwo &&
+        util::isCallOf(v, Module::MOD_MAGIC_NAME, {intType, intType}, intType,
+                       /*method=*/true)) {
+      auto *fn =
+          M->getOrRealizeMethod(intType, Module::AND_MAGIC_NAME, {intType, intType});
+      if (fn)
+        setResult(util::call(fn, {v->front(), M->getInt(c - 1)}));
+      return;
+    }
+
+    if (c >= 0 && c <= 4 && isA<VarValue>(v->front()) &&
+        util::isCallOf(v, Module::POW_MAGIC_NAME, {intType, intType}, intType,
+                       /*method=*/true)) {
+      if (c == 0)
+        return setResult(M->getInt(1));
+      if (c == 1)
+        return setResult(v->front());
+      auto *fn =
+          M->getOrRealizeMethod(intType, Module::MUL_MAGIC_NAME, {intType, intType});
+      if (!fn)
+        return;
+      util::CloneVisitor cv(M);
+      auto *result = v->front();
+      for (int64_t i = 1; i < c; i++)
+        result = util::call(fn, {result, cv.clone(v->front())});
+      setResult(result);
+    }
+  }
+};
+
 auto id_val(Module *m) {
   return [=](Value *v) -> Value * {
     util::CloneVisitor cv(m);
@@ -275,6 +350,10 @@ void FoldingPass::registerStandardRules(Module *m) {
                  intToIntBinaryNoZeroRHS(m, BINOP(%), Module::MOD_MAGIC_NAME));
   }
 
+  // binary, single constant RHS, int->int strength reduction
+  registerRule("int-strength-reduction", std::make_unique<IntStrengthReductionRule>(
+                                             m->getIntType(), pyNumerics));
+
   // binary, double constant, int->bool
   registerRule("int-constant-eq", intToBoolBinary(m, BINOP(==), Module::EQ_MAGIC_NAME));
   registerRule("int-constant-ne", intToBoolBinary(m, BINOP(!=), Module::NE_MAGIC_NAME));
@@ -4,6 +4,7 @@
 
 #include "codon/cir/transform/folding/const_fold.h"
 #include "codon/cir/transform/folding/const_prop.h"
+#include "codon/cir/transform/folding/sccp.h"
 
 namespace codon {
 namespace ir {
@@ -21,11 +22,13 @@ FoldingPassGroup::FoldingPassGroup(const std::string &sideEffectsPass,
                                     : std::unique_ptr<cleanup::GlobalDemotionPass>();
   auto canonUnique = std::make_unique<cleanup::CanonicalizationPass>(sideEffectsPass);
   auto fpUnique = std::make_unique<FoldingPass>(pyNumerics);
+  auto sccpUnique = std::make_unique<SCCPPass>();
   auto dceUnique = std::make_unique<cleanup::DeadCodeCleanupPass>(sideEffectsPass);
 
   gd = gdUnique.get();
   canon = canonUnique.get();
   fp = fpUnique.get();
+  sccp = sccpUnique.get();
   dce = dceUnique.get();
 
   if (runGlobalDemotion)
@@ -33,13 +36,15 @@ FoldingPassGroup::FoldingPassGroup(const std::string &sideEffectsPass,
   push_back(std::make_unique<ConstPropPass>(reachingDefPass, globalVarPass));
   push_back(std::move(canonUnique));
   push_back(std::move(fpUnique));
+  push_back(std::move(sccpUnique));
   push_back(std::move(dceUnique));
 }
 
 bool FoldingPassGroup::shouldRepeat(int num) const {
   return PassGroup::shouldRepeat(num) &&
          ((gd && gd->getNumDemotions() != 0) || canon->getNumReplacements() != 0 ||
-          fp->getNumReplacements() != 0 || dce->getNumReplacements() != 0);
+          fp->getNumReplacements() != 0 || sccp->getNumReplacements() != 0 ||
+          dce->getNumReplacements() != 0);
 }
 
 } // namespace folding
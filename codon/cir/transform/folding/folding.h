@@ -13,6 +13,7 @@ namespace transform {
 namespace folding {
 
 class FoldingPass;
+class SCCPPass;
 
 /// Group of constant folding passes.
 class FoldingPassGroup : public PassGroup {
@@ -20,6 +21,7 @@ private:
   cleanup::GlobalDemotionPass *gd;
   cleanup::CanonicalizationPass *canon;
   FoldingPass *fp;
+  SCCPPass *sccp;
   cleanup::DeadCodeCleanupPass *dce;
 
 public:
@@ -34,7 +36,7 @@ public:
   /// @param pyNumerics whether to use Python (vs. C) semantics when folding
   FoldingPassGroup(const std::string &sideEffectsPass,
                    const std::string &reachingDefPass, const std::string &globalVarPass,
-                   int repeat = 5, bool runGlobalDemotion = true,
+                   int repeat = 3, bool runGlobalDemotion = true,
                    bool pyNumerics = false);
 
   bool shouldRepeat(int num) const override;
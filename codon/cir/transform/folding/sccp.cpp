@@ -0,0 +1,265 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "sccp.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "codon/cir/util/cloning.h"
+#include "codon/cir/util/operator.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace folding {
+namespace {
+/// maps a variable id to the constant it is known to hold; a missing
+/// entry means the variable's value is unknown at this point
+using Env = std::unordered_map<id_t, Value *>;
+
+bool okConst(Value *v) {
+  return v && (isA<IntConst>(v) || isA<FloatConst>(v) || isA<BoolConst>(v));
+}
+
+bool equalConsts(Value *a, Value *b) {
+  if (auto *ai = cast<IntConst>(a)) {
+    auto *bi = cast<IntConst>(b);
+    return bi && ai->getVal() == bi->getVal();
+  }
+  if (auto *af = cast<FloatConst>(a)) {
+    auto *bf = cast<FloatConst>(b);
+    return bf && af->getVal() == bf->getVal();
+  }
+  if (auto *ab = cast<BoolConst>(a)) {
+    auto *bb = cast<BoolConst>(b);
+    return bb && ab->getVal() == bb->getVal();
+  }
+  return false;
+}
+
+/// Keeps only the entries on which both environments agree.
+void meetInto(Env &a, const Env &b) {
+  for (auto it = a.begin(); it != a.end();) {
+    auto jt = b.find(it->first);
+    if (jt == b.end() || !equalConsts(it->second, jt->second)) {
+      it = a.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/// Gathers everything that makes a variable untrackable or a function
+/// unanalyzable: address-taken variables and custom DSL nodes, whose
+/// control flow the pass cannot see.
+struct Prescan : public util::Operator {
+  std::unordered_set<id_t> banned;
+  bool hasCustom = false;
+
+  void handle(PointerValue *v) override { banned.insert(v->getVar()->getId()); }
+  void handle(dsl::CustomFlow *v) override { hasCustom = true; }
+  void handle(dsl::CustomInstr *v) override { hasCustom = true; }
+};
+
+/// Collects every variable assigned within a subtree, including loop and
+/// catch variables.
+struct AssignCollector : public util::Operator {
+  std::unordered_set<id_t> assigned;
+
+  void handle(AssignInstr *v) override { assigned.insert(v->getLhs()->getId()); }
+  void handle(ForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(ImperativeForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(TryCatchFlow *v) override {
+    for (auto &c : *v) {
+      if (auto *var = c.getVar())
+        assigned.insert(var->getId());
+    }
+  }
+};
+
+class SCCPContext {
+private:
+  Module *M;
+  /// address-taken variables, never tracked
+  std::unordered_set<id_t> banned;
+  /// branches decided during the walk, replaced innermost-first afterwards;
+  /// null replacement means an empty series
+  std::vector<std::pair<Value *, Value *>> decided;
+  /// number of replacements made
+  int replacements = 0;
+
+public:
+  SCCPContext(Module *M, std::unordered_set<id_t> banned)
+      : M(M), banned(std::move(banned)) {}
+
+  int getNumReplacements() const { return replacements; }
+
+  /// Returns the constant the value is known to evaluate to, if any.
+  Value *evalConst(Value *v, Env &env) {
+    if (okConst(v))
+      return v;
+    if (auto *vv = cast<VarValue>(v)) {
+      auto it = env.find(vv->getVar()->getId());
+      if (it != env.end())
+        return it->second;
+    }
+    return nullptr;
+  }
+
+  void invalidate(Env &env, const std::unordered_set<id_t> &vars) {
+    for (auto id : vars)
+      env.erase(id);
+  }
+
+  std::unordered_set<id_t> assignedIn(Value *v) {
+    AssignCollector c;
+    c.process(v);
+    return std::move(c.assigned);
+  }
+
+  void process(Value *v, Env &env) {
+    if (!v)
+      return;
+
+    if (auto *series = cast<SeriesFlow>(v)) {
+      for (auto *x : *series)
+        process(x, env);
+    } else if (auto *assign = cast<AssignInstr>(v)) {
+      process(assign->getRhs(), env);
+      auto *lhs = assign->getLhs();
+      if (lhs->isGlobal() || banned.find(lhs->getId()) != banned.end())
+        return;
+      if (auto *c = evalConst(assign->getRhs(), env)) {
+        env[lhs->getId()] = c;
+      } else {
+        env.erase(lhs->getId());
+      }
+    } else if (auto *iff = cast<IfFlow>(v)) {
+      process(iff->getCond(), env);
+      if (auto *c = cast<BoolConst>(evalConst(iff->getCond(), env))) {
+        Flow *taken = c->getVal() ? iff->getTrueBranch() : iff->getFalseBranch();
+        decided.push_back({iff, taken});
+        process(taken, env);
+      } else {
+        Env trueEnv = env;
+        process(iff->getTrueBranch(), trueEnv);
+        if (auto *f = iff->getFalseBranch())
+          process(f, env);
+        meetInto(env, trueEnv);
+      }
+    } else if (auto *ternary = cast<TernaryInstr>(v)) {
+      process(ternary->getCond(), env);
+      if (auto *c = cast<BoolConst>(evalConst(ternary->getCond(), env))) {
+        auto *taken = c->getVal() ? ternary->getTrueValue() : ternary->getFalseValue();
+        decided.push_back({ternary, taken});
+        process(taken, env);
+      } else {
+        Env trueEnv = env;
+        process(ternary->getTrueValue(), trueEnv);
+        process(ternary->getFalseValue(), env);
+        meetInto(env, trueEnv);
+      }
+    } else if (auto *wf = cast<WhileFlow>(v)) {
+      // anything assigned in the loop is unknown on entry to any iteration
+      invalidate(env, assignedIn(wf));
+      process(wf->getCond(), env);
+      Env bodyEnv = env;
+      process(wf->getBody(), bodyEnv);
+      meetInto(env, bodyEnv);
+    } else if (auto *ff = cast<ForFlow>(v)) {
+      process(ff->getIter(), env);
+      invalidate(env, assignedIn(ff));
+      Env bodyEnv = env;
+      process(ff->getBody(), bodyEnv);
+      meetInto(env, bodyEnv);
+    } else if (auto *iff = cast<ImperativeForFlow>(v)) {
+      process(iff->getStart(), env);
+      process(iff->getEnd(), env);
+      invalidate(env, assignedIn(iff));
+      Env bodyEnv = env;
+      process(iff->getBody(), bodyEnv);
+      meetInto(env, bodyEnv);
+    } else if (auto *tc = cast<TryCatchFlow>(v)) {
+      // an exception can strike between any two assignments in the body, so
+      // handlers and the join see everything assigned inside as unknown
+      invalidate(env, assignedIn(tc));
+      Env bodyEnv = env;
+      process(tc->getBody(), bodyEnv);
+      std::vector<Env> catchEnvs;
+      for (auto &c : *tc) {
+        catchEnvs.push_back(env);
+        process(c.getHandler(), catchEnvs.back());
+      }
+      if (auto *fin = tc->getFinally()) {
+        process(fin, env);
+      } else {
+        env = std::move(bodyEnv);
+        for (auto &ce : catchEnvs)
+          meetInto(env, ce);
+      }
+    } else if (auto *fi = cast<FlowInstr>(v)) {
+      process(fi->getFlow(), env);
+      process(fi->getValue(), env);
+    } else if (auto *vv = cast<VarValue>(v)) {
+      auto it = env.find(vv->getVar()->getId());
+      if (it != env.end()) {
+        util::CloneVisitor cv(M);
+        vv->replaceAll(cv.clone(it->second));
+        ++replacements;
+      }
+    } else {
+      for (auto *x : v->getUsedValues())
+        process(x, env);
+    }
+  }
+
+  /// Replaces decided branches with their taken arms, innermost first so
+  /// that replacements within an arm are visible when the arm is cloned.
+  void applyDecisions() {
+    for (auto it = decided.rbegin(); it != decided.rend(); ++it) {
+      auto *victim = it->first;
+      auto *taken = it->second;
+      LOG_IR("[{}] branch decided: {}", SCCPPass::KEY, *victim);
+      util::CloneVisitor cv(M);
+      victim->replaceAll(taken ? cv.clone(taken)
+                               : static_cast<Value *>(M->Nr<SeriesFlow>()));
+      ++replacements;
+    }
+    decided.clear();
+  }
+};
+
+int processFunc(Module *M, BodiedFunc *f) {
+  if (!f || !f->getBody())
+    return 0;
+
+  Prescan pre;
+  pre.process(f->getBody());
+  if (pre.hasCustom)
+    return 0;
+
+  SCCPContext ctx(M, std::move(pre.banned));
+  Env env;
+  ctx.process(f->getBody(), env);
+  ctx.applyDecisions();
+  return ctx.getNumReplacements();
+}
+} // namespace
+
+const std::string SCCPPass::KEY = "core-folding-sccp";
+
+void SCCPPass::run(Module *m) {
+  numReplacements = 0;
+  numReplacements += processFunc(m, cast<BodiedFunc>(m->getMainFunc()));
+  for (auto *var : *m) {
+    if (auto *f = cast<BodiedFunc>(var))
+      numReplacements += processFunc(m, f);
+  }
+}
+
+} // namespace folding
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,37 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace folding {
+
+/// Sparse conditional constant propagation pass. Walks each function body
+/// once, tracking which variables hold known constants along the structured
+/// control flow: constants propagate through copies, branch arms are joined
+/// by meeting their environments, and a branch whose condition is known is
+/// replaced by its taken arm without analyzing the dead one. This converges
+/// constants through branches in a single pass, where plain reaching-def
+/// propagation needed one group iteration per level of branching.
+class SCCPPass : public Pass {
+private:
+  /// number of replacements
+  int numReplacements = 0;
+
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of replacements
+  int getNumReplacements() const { return numReplacements; }
+};
+
+} // namespace folding
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,383 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "gvn.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "codon/cir/analyze/module/side_effect.h"
+#include "codon/cir/util/cloning.h"
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/operator.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace gvn {
+namespace {
+util::SideEffectStatus statusOf(const analyze::module::SideEffectResult *se,
+                                const Value *v) {
+  auto it = se->result.find(v->getId());
+  return it != se->result.end() ? it->second : util::SideEffectStatus::UNKNOWN;
+}
+
+/// Finds address-taken variables, which can change without an assignment.
+struct Prescan : public util::Operator {
+  std::unordered_set<id_t> banned;
+  void handle(PointerValue *v) override { banned.insert(v->getVar()->getId()); }
+};
+
+/// Per-statement scan: variables the statement assigns and whether it can
+/// write memory (or otherwise defeat reuse across it).
+struct StmtScan : public util::Operator {
+  const analyze::module::SideEffectResult *se;
+  std::unordered_set<id_t> assigned;
+  bool barrier = false;
+
+  explicit StmtScan(const analyze::module::SideEffectResult *se) : se(se) {}
+
+  void handle(AssignInstr *v) override { assigned.insert(v->getLhs()->getId()); }
+  void handle(ForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(ImperativeForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(TryCatchFlow *v) override {
+    for (auto &c : *v) {
+      if (auto *var = c.getVar())
+        assigned.insert(var->getId());
+    }
+  }
+  void handle(CallInstr *v) override {
+    // a call that is neither pure nor merely nondeterministic may store
+    if (statusOf(se, v) > util::SideEffectStatus::NO_SIDE_EFFECT)
+      barrier = true;
+  }
+  void handle(InsertInstr *v) override { barrier = true; }
+  void handle(YieldInstr *v) override { barrier = true; }
+  void handle(YieldInInstr *v) override { barrier = true; }
+  void handle(PipelineFlow *v) override { barrier = true; }
+  void handle(dsl::CustomFlow *v) override { barrier = true; }
+  void handle(dsl::CustomInstr *v) override { barrier = true; }
+};
+
+/// an expression available for reuse: the variable holding its value and
+/// the variables the expression reads
+struct AvailableValue {
+  Var *var;
+  std::unordered_set<id_t> deps;
+};
+
+class GVNContext {
+private:
+  Module *M;
+  BodiedFunc *func;
+  const analyze::module::SideEffectResult *se;
+  /// address-taken variables, never numbered
+  std::unordered_set<id_t> banned;
+  /// how often each value number occurs in the function; numbers seen once
+  /// are not worth a temporary
+  std::unordered_map<std::string, int> counts;
+  /// scoped table of available expressions
+  std::vector<std::unordered_map<std::string, AvailableValue>> scopes;
+  /// number of reuses
+  int replacements = 0;
+
+public:
+  GVNContext(Module *M, BodiedFunc *func,
+             const analyze::module::SideEffectResult *se,
+             std::unordered_set<id_t> banned)
+      : M(M), func(func), se(se), banned(std::move(banned)) {}
+
+  int getNumReplacements() const { return replacements; }
+
+  void run() {
+    countExpr(func->getBody());
+    scopes.emplace_back();
+    processFlow(func->getBody());
+    scopes.pop_back();
+  }
+
+private:
+  void pushScope() { scopes.emplace_back(); }
+  void popScope() { scopes.pop_back(); }
+
+  void clearAll() {
+    for (auto &scope : scopes)
+      scope.clear();
+  }
+
+  void invalidate(const std::unordered_set<id_t> &vars) {
+    if (vars.empty())
+      return;
+    for (auto &scope : scopes) {
+      for (auto it = scope.begin(); it != scope.end();) {
+        bool stale = false;
+        for (auto id : vars) {
+          if (it->second.deps.find(id) != it->second.deps.end()) {
+            stale = true;
+            break;
+          }
+        }
+        it = stale ? scope.erase(it) : ++it;
+      }
+    }
+  }
+
+  AvailableValue *lookup(const std::string &key) {
+    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+      auto jt = it->find(key);
+      if (jt != it->end())
+        return &jt->second;
+    }
+    return nullptr;
+  }
+
+  /// Builds the value number of an eligible pure call, or an empty string.
+  /// Eligible calls are pure, return a non-void, non-generator value, and
+  /// take only constants, trackable variables and eligible calls.
+  std::string callKey(CallInstr *call, std::unordered_set<id_t> *deps) {
+    if (statusOf(se, call) != util::SideEffectStatus::PURE)
+      return "";
+    auto *f = util::getFunc(call->getCallee());
+    if (!f)
+      return "";
+    auto *type = call->getType();
+    if (!type || type->is(M->getVoidType()) || type->is(M->getNoneType()) ||
+        isA<types::GeneratorType>(type))
+      return "";
+
+    std::string key = "c" + std::to_string(f->getId()) + "(";
+    for (auto *arg : *call) {
+      auto sub = exprKey(arg, deps);
+      if (sub.empty())
+        return "";
+      key += sub + ",";
+    }
+    return key + ")";
+  }
+
+  std::string exprKey(Value *v, std::unordered_set<id_t> *deps) {
+    if (auto *c = cast<IntConst>(v))
+      return "i" + std::to_string(c->getVal());
+    if (auto *c = cast<FloatConst>(v)) {
+      // key by exact bit pattern; decimal formatting rounds nearby doubles
+      // to the same key
+      uint64_t bits;
+      auto val = c->getVal();
+      std::memcpy(&bits, &val, sizeof(bits));
+      return "f" + std::to_string(bits);
+    }
+    if (auto *c = cast<BoolConst>(v))
+      return c->getVal() ? "b1" : "b0";
+    if (auto *c = cast<StringConst>(v))
+      // length-prefixed so payload bytes cannot mimic key structure
+      return "s" + std::to_string(c->getVal().size()) + ":" + c->getVal();
+    if (auto *vv = cast<VarValue>(v)) {
+      auto id = vv->getVar()->getId();
+      if (banned.find(id) != banned.end())
+        return "";
+      if (deps)
+        deps->insert(id);
+      return "v" + std::to_string(id);
+    }
+    if (auto *call = cast<CallInstr>(v))
+      return callKey(call, deps);
+    return "";
+  }
+
+  /// Counts value numbers of all eligible calls in a subtree.
+  void countExpr(Value *v) {
+    if (!v)
+      return;
+    if (auto *tern = cast<TernaryInstr>(v)) {
+      countExpr(tern->getCond());
+      return;
+    }
+    if (auto *call = cast<CallInstr>(v)) {
+      auto key = callKey(call, nullptr);
+      if (!key.empty())
+        ++counts[key];
+    }
+    for (auto *x : v->getUsedValues())
+      countExpr(x);
+  }
+
+  /// Numbers the calls in one statement's expression tree, in evaluation
+  /// order. Reused and newly computed values are materialized just before
+  /// the statement, which is safe because eligible calls are pure.
+  void processExpr(Value *v, SeriesFlow *parent,
+                   std::list<Value *>::iterator insertIt,
+                   const std::unordered_set<id_t> &stmtAssigned) {
+    if (!v || isA<Flow>(v) || isA<FlowInstr>(v))
+      return;
+
+    // A ternary evaluates only one arm, so materializing an arm's calls
+    // before the statement would speculate them past their guard — pure
+    // calls may still trap (a raw load, a division). Only the condition
+    // is evaluated unconditionally.
+    if (auto *tern = cast<TernaryInstr>(v)) {
+      processExpr(tern->getCond(), parent, insertIt, stmtAssigned);
+      return;
+    }
+
+    if (auto *call = cast<CallInstr>(v)) {
+      for (auto *arg : *call)
+        processExpr(arg, parent, insertIt, stmtAssigned);
+
+      std::unordered_set<id_t> deps;
+      auto key = callKey(call, &deps);
+      if (key.empty())
+        return;
+      // operands reassigned within this statement may change before the call
+      for (auto id : deps) {
+        if (stmtAssigned.find(id) != stmtAssigned.end())
+          return;
+      }
+
+      if (auto *av = lookup(key)) {
+        LOG_IR("[{}] reusing: {}", GVNPass::KEY, *call);
+        call->replaceAll(M->Nr<VarValue>(av->var));
+        ++replacements;
+      } else if (counts[key] >= 2) {
+        auto *tmp = M->Nr<Var>(call->getType());
+        func->push_back(tmp);
+        util::CloneVisitor cv(M);
+        parent->insert(insertIt, M->Nr<AssignInstr>(tmp, cv.clone(call)));
+        call->replaceAll(M->Nr<VarValue>(tmp));
+        scopes.back()[key] = {tmp, std::move(deps)};
+      }
+      return;
+    }
+
+    for (auto *x : v->getUsedValues())
+      processExpr(x, parent, insertIt, stmtAssigned);
+  }
+
+  void processStmt(Value *stmt, SeriesFlow *parent,
+                   std::list<Value *>::iterator it) {
+    if (auto *series = cast<SeriesFlow>(stmt)) {
+      processFlow(series);
+    } else if (auto *iff = cast<IfFlow>(stmt)) {
+      StmtScan scan(se);
+      scan.process(iff->getCond());
+      if (scan.barrier) {
+        clearAll();
+      } else {
+        if (parent)
+          processExpr(iff->getCond(), parent, it, scan.assigned);
+        invalidate(scan.assigned);
+      }
+      pushScope();
+      processFlow(iff->getTrueBranch());
+      popScope();
+      if (auto *f = iff->getFalseBranch()) {
+        pushScope();
+        processFlow(f);
+        popScope();
+      }
+      afterCompound(iff);
+    } else if (auto *wf = cast<WhileFlow>(stmt)) {
+      clearAll();
+      pushScope();
+      processFlow(wf->getBody());
+      popScope();
+      clearAll();
+    } else if (auto *ff = cast<ForFlow>(stmt)) {
+      clearAll();
+      pushScope();
+      processFlow(ff->getBody());
+      popScope();
+      clearAll();
+    } else if (auto *iff = cast<ImperativeForFlow>(stmt)) {
+      clearAll();
+      pushScope();
+      processFlow(iff->getBody());
+      popScope();
+      clearAll();
+    } else if (auto *tc = cast<TryCatchFlow>(stmt)) {
+      clearAll();
+      pushScope();
+      processFlow(tc->getBody());
+      popScope();
+      for (auto &c : *tc) {
+        pushScope();
+        processFlow(c.getHandler());
+        popScope();
+      }
+      if (auto *fin = tc->getFinally()) {
+        pushScope();
+        processFlow(fin);
+        popScope();
+      }
+      clearAll();
+    } else {
+      StmtScan scan(se);
+      scan.process(stmt);
+      if (scan.barrier) {
+        clearAll();
+      } else {
+        if (parent)
+          processExpr(stmt, parent, it, scan.assigned);
+        invalidate(scan.assigned);
+      }
+    }
+  }
+
+  /// Invalidates everything a compound statement may have changed.
+  void afterCompound(Value *stmt) {
+    StmtScan scan(se);
+    scan.process(stmt);
+    if (scan.barrier) {
+      clearAll();
+    } else {
+      invalidate(scan.assigned);
+    }
+  }
+
+  void processFlow(Flow *flow) {
+    if (!flow)
+      return;
+    if (auto *series = cast<SeriesFlow>(flow)) {
+      for (auto it = series->begin(); it != series->end(); ++it)
+        processStmt(*it, series, it);
+    } else {
+      processStmt(flow, nullptr, {});
+    }
+  }
+};
+
+int processFunc(Module *M, BodiedFunc *f,
+                const analyze::module::SideEffectResult *se) {
+  if (!f || !f->getBody())
+    return 0;
+
+  Prescan pre;
+  pre.process(f->getBody());
+
+  GVNContext ctx(M, f, se, std::move(pre.banned));
+  ctx.run();
+  return ctx.getNumReplacements();
+}
+} // namespace
+
+const std::string GVNPass::KEY = "core-gvn";
+
+void GVNPass::run(Module *m) {
+  auto *se = getAnalysisResult<analyze::module::SideEffectResult>(sideEffectsKey);
+  if (!se)
+    return;
+
+  numReplacements = 0;
+  numReplacements += processFunc(m, cast<BodiedFunc>(m->getMainFunc()), se);
+  for (auto *var : *m) {
+    if (auto *f = cast<BodiedFunc>(var))
+      numReplacements += processFunc(m, f, se);
+  }
+}
+
+} // namespace gvn
+} // namespace transform
+} // namespace ir
+} // namespace codon
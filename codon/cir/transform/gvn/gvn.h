@@ -0,0 +1,46 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace gvn {
+
+/// Value numbering pass that eliminates redundant pure calls. Each function
+/// body is walked once with a scoped table of available expressions: a pure
+/// call keyed by its callee and operand value numbers is computed into a
+/// fresh variable at its first occurrence, and later occurrences of the
+/// same number reuse that variable. Tables are scoped along the structured
+/// control flow, so an expression is only reused where its first occurrence
+/// dominates; assignments invalidate entries depending on the assigned
+/// variable, and anything that may write memory invalidates everything.
+class GVNPass : public Pass {
+private:
+  /// the side effect analysis' key
+  std::string sideEffectsKey;
+  /// number of replacements
+  int numReplacements = 0;
+
+public:
+  static const std::string KEY;
+
+  /// Constructs a GVN pass.
+  /// @param sideEffectsKey the side effect analysis' key
+  explicit GVNPass(const std::string &sideEffectsKey)
+      : sideEffectsKey(sideEffectsKey) {}
+
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of replacements
+  int getNumReplacements() const { return numReplacements; }
+};
+
+} // namespace gvn
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,80 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "hit_counters.h"
+
+#include <fmt/format.h>
+
+#include "codon/cir/util/irtools.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace instrument {
+
+const std::string HitCounterInstrumentation::KEY = "core-instrument-hit-counters";
+
+void HitCounterInstrumentation::insertCounter(Flow *body, const std::string &name) {
+  auto *series = cast<SeriesFlow>(body);
+  if (!series)
+    return;
+
+  auto *M = body->getModule();
+  auto *hit =
+      M->getOrRealizeFunc("_hit_count", {M->getIntType()}, {}, "std.internal.builtin");
+  if (!hit)
+    return;
+
+  const auto site = (int64_t)sites.size();
+  sites.emplace_back(site, name);
+  series->insert(series->begin(), util::call(hit, {M->getInt(site)}));
+}
+
+void HitCounterInstrumentation::visit(BodiedFunc *f) {
+  funcName = f->getUnmangledName();
+  if (f->getBody())
+    insertCounter(f->getBody(), funcName);
+  OperatorPass::visit(f);
+}
+
+void HitCounterInstrumentation::handle(WhileFlow *v) {
+  insertCounter(v->getBody(),
+                fmt::format("{}:{}", funcName, v->getSrcInfo().line));
+}
+
+void HitCounterInstrumentation::handle(ForFlow *v) {
+  insertCounter(v->getBody(),
+                fmt::format("{}:{}", funcName, v->getSrcInfo().line));
+}
+
+void HitCounterInstrumentation::handle(ImperativeForFlow *v) {
+  insertCounter(v->getBody(),
+                fmt::format("{}:{}", funcName, v->getSrcInfo().line));
+}
+
+void HitCounterInstrumentation::run(Module *module) {
+  sites.clear();
+  OperatorPass::run(module);
+  if (sites.empty())
+    return;
+
+  // Register site names before anything runs so the runtime can size its
+  // counter blocks and label the exit report.
+  auto *main = cast<BodiedFunc>(module->getMainFunc());
+  auto *body = main ? cast<SeriesFlow>(main->getBody()) : nullptr;
+  auto *reg = module->getOrRealizeFunc(
+      "_hit_register", {module->getIntType(), module->getStringType()}, {},
+      "std.internal.builtin");
+  if (!body || !reg)
+    return;
+
+  auto it = body->begin();
+  for (const auto &site : sites)
+    it = ++body->insert(
+        it, util::call(reg, {module->getInt(site.first),
+                             module->getString(site.second)}));
+}
+
+} // namespace instrument
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,46 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace instrument {
+
+/// Inserts per-function and per-loop hit counters for production
+/// profiling on hosts without perf access. Each instrumented site gets
+/// an integer id and a seq_hit(id) increment (thread-local, cache-line
+/// padded counters on the runtime side); site names are registered at
+/// the top of main and a per-site report is written to stderr at exit.
+/// Cheap enough to leave on in production; opt-in at compile time via
+/// the CODON_HIT_COUNTERS environment variable.
+class HitCounterInstrumentation : public OperatorPass {
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *module) override;
+
+  void visit(BodiedFunc *f) override;
+  void handle(WhileFlow *v) override;
+  void handle(ForFlow *v) override;
+  void handle(ImperativeForFlow *v) override;
+
+private:
+  /// (site id, human-readable name) of every instrumented site
+  std::vector<std::pair<int64_t, std::string>> sites;
+  /// unmangled name of the function being visited
+  std::string funcName;
+
+  void insertCounter(Flow *body, const std::string &name);
+};
+
+} // namespace instrument
+} // namespace transform
+} // namespace ir
+} // namespace codon
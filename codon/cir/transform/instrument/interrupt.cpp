@@ -0,0 +1,46 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "interrupt.h"
+
+#include "codon/cir/util/irtools.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace instrument {
+
+const std::string InterruptCheckInsertion::KEY = "core-instrument-interrupt-check";
+
+void InterruptCheckInsertion::insertCheck(Flow *body) {
+  auto *series = cast<SeriesFlow>(body);
+  if (!series)
+    return;
+
+  auto *M = body->getModule();
+  auto *check = M->getOrRealizeFunc("_interrupt_check", {}, {}, "std.internal.builtin");
+  if (!check)
+    return;
+
+  // Don't instrument the same loop twice.
+  if (series->begin() != series->end()) {
+    if (auto *call = cast<CallInstr>(series->front())) {
+      if (util::getFunc(call->getCallee()) == check)
+        return;
+    }
+  }
+
+  series->insert(series->begin(), util::call(check, {}));
+}
+
+void InterruptCheckInsertion::handle(WhileFlow *v) { insertCheck(v->getBody()); }
+
+void InterruptCheckInsertion::handle(ForFlow *v) { insertCheck(v->getBody()); }
+
+void InterruptCheckInsertion::handle(ImperativeForFlow *v) {
+  insertCheck(v->getBody());
+}
+
+} // namespace instrument
+} // namespace transform
+} // namespace ir
+} // namespace codon
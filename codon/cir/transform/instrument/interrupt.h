@@ -0,0 +1,33 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace instrument {
+
+/// Inserts a cooperative interruption check at the top of every loop
+/// body. The check raises KeyboardInterrupt once an embedder (e.g. a
+/// Jupyter kernel running cells off the main thread) has requested
+/// cancellation via seq_set_interrupt(), letting long-running code be
+/// stopped without killing the process.
+class InterruptCheckInsertion : public OperatorPass {
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void handle(WhileFlow *v) override;
+  void handle(ForFlow *v) override;
+  void handle(ImperativeForFlow *v) override;
+
+private:
+  void insertCheck(Flow *body);
+};
+
+} // namespace instrument
+} // namespace transform
+} // namespace ir
+} // namespace codon
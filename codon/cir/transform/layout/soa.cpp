@@ -0,0 +1,424 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "soa.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/operator.h"
+#include "codon/parser/cache.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace layout {
+namespace {
+static const std::string LIST = "std.internal.types.ptr.List";
+static const std::string SOA_ATTR = "soa";
+
+/// A local list variable eligible for field-wise splitting.
+struct Candidate {
+  /// the function owning the variable
+  BodiedFunc *func;
+  /// the variable's `List[E]` type
+  types::Type *listType;
+  /// the element record `E`
+  types::RecordType *elemType;
+};
+
+/// Realized helpers for one element record: the per-field list types and
+/// the list/record methods the rewrite emits calls to.
+struct FieldLowering {
+  std::vector<std::string> names;
+  std::vector<types::Type *> listTypes;
+  std::vector<Func *> newFns, initFns, initCapFns, getFns, setFns, appendFns;
+  Func *lenFn = nullptr;
+  Func *boolFn = nullptr;
+  Func *elemNew = nullptr;
+  bool ok = false;
+};
+
+/// Returns the element record of a `List[E]` type if `E` is a tuple class
+/// marked `@soa`, and null otherwise.
+types::RecordType *
+getSoAElement(types::Type *t,
+              const std::unordered_map<types::Type *, std::string> &classOfType,
+              ast::Cache *cache) {
+  auto *ref = cast<types::RefType>(t);
+  if (!ref || t->getName().rfind(LIST + "[", 0) != 0)
+    return nullptr;
+  auto *contents = cast<types::RecordType>(ref->getContents());
+  auto *arr = contents ? cast<types::RecordType>(contents->getMemberType("arr"))
+                       : nullptr;
+  auto *ptr = arr ? cast<types::PointerType>(arr->getMemberType("ptr")) : nullptr;
+  auto *elem = ptr ? cast<types::RecordType>(ptr->getBase()) : nullptr;
+  if (!elem || elem->begin() == elem->end())
+    return nullptr;
+  auto it = classOfType.find(elem);
+  if (it == classOfType.end())
+    return nullptr;
+  auto cls = cache->classes.find(it->second);
+  if (cls == cache->classes.end() || !cls->second.ast ||
+      !cls->second.ast->attributes.has(SOA_ATTR))
+    return nullptr;
+  return elem;
+}
+
+/// Collects every use of each candidate variable and classifies it. A
+/// candidate whose total `VarValue` count differs from its recognized-use
+/// count has an unaccounted-for use (escapes into a call, is returned,
+/// is iterated, ...) and is dropped along with everything it aliases.
+struct UseCollector : public util::Operator {
+  enum Kind { New, Copy, CopyFlow, Init, GetItem, SetItem, Len, Bool, Append };
+
+  struct Use {
+    Kind kind;
+    Value *node;
+    Var *var;
+    /// aliased source variable for Copy/CopyFlow
+    Var *other;
+  };
+
+  std::unordered_map<id_t, Candidate> *candidates;
+  std::unordered_map<id_t, int> uses, okUses;
+  std::unordered_set<id_t> bad;
+  /// union-find over aliased candidates
+  std::unordered_map<id_t, id_t> rep;
+  std::vector<Use> plan;
+
+  explicit UseCollector(std::unordered_map<id_t, Candidate> *candidates)
+      : util::Operator(), candidates(candidates) {}
+
+  bool isCandidate(const Var *v) const {
+    return candidates->find(v->getId()) != candidates->end();
+  }
+
+  id_t find(id_t x) {
+    auto it = rep.find(x);
+    if (it == rep.end()) {
+      rep[x] = x;
+      return x;
+    }
+    while (it->second != x) {
+      x = it->second;
+      it = rep.find(x);
+    }
+    return x;
+  }
+
+  void merge(id_t a, id_t b) { rep[find(a)] = find(b); }
+
+  void handle(VarValue *v) override {
+    if (isCandidate(v->getVar()))
+      ++uses[v->getVar()->getId()];
+  }
+
+  void handle(PointerValue *v) override {
+    if (isCandidate(v->getVar()))
+      bad.insert(v->getVar()->getId());
+  }
+
+  void handle(AssignInstr *v) override {
+    auto *lhs = v->getLhs();
+    auto it = candidates->find(lhs->getId());
+    if (it == candidates->end())
+      return;
+
+    auto *rhs = v->getRhs();
+    if (auto *call = cast<CallInstr>(rhs)) {
+      auto *f = util::getFunc(call->getCallee());
+      if (f && f->getUnmangledName() == Module::NEW_MAGIC_NAME &&
+          call->numArgs() == 0 && call->getType() == it->second.listType) {
+        plan.push_back({New, v, lhs, nullptr});
+        return;
+      }
+    } else if (auto *vv = cast<VarValue>(rhs)) {
+      auto *w = vv->getVar();
+      if (isCandidate(w) && w->getType() == it->second.listType) {
+        merge(lhs->getId(), w->getId());
+        ++okUses[w->getId()];
+        plan.push_back({Copy, v, lhs, w});
+        return;
+      }
+    } else if (auto *fi = cast<FlowInstr>(rhs)) {
+      if (auto *vv = cast<VarValue>(fi->getValue())) {
+        auto *w = vv->getVar();
+        if (isCandidate(w) && w->getType() == it->second.listType) {
+          merge(lhs->getId(), w->getId());
+          ++okUses[w->getId()];
+          plan.push_back({CopyFlow, v, lhs, w});
+          return;
+        }
+      }
+    }
+    bad.insert(lhs->getId());
+  }
+
+  void handle(CallInstr *v) override {
+    if (v->numArgs() == 0)
+      return;
+    auto *self = cast<VarValue>(v->front());
+    if (!self)
+      return;
+    auto it = candidates->find(self->getVar()->getId());
+    if (it == candidates->end())
+      return;
+    auto *f = util::getFunc(v->getCallee());
+    if (!f)
+      return;
+
+    auto *M = v->getModule();
+    auto *intType = M->getIntType();
+    auto *elem = it->second.elemType;
+    auto name = f->getUnmangledName();
+    std::vector<Value *> args(v->begin(), v->end());
+
+    Kind kind;
+    if (name == Module::GETITEM_MAGIC_NAME && args.size() == 2 &&
+        args[1]->getType() == intType && v->getType() == elem) {
+      kind = GetItem;
+    } else if (name == Module::SETITEM_MAGIC_NAME && args.size() == 3 &&
+               args[1]->getType() == intType && args[2]->getType() == elem) {
+      kind = SetItem;
+    } else if (name == Module::LEN_MAGIC_NAME && args.size() == 1) {
+      kind = Len;
+    } else if (name == Module::BOOL_MAGIC_NAME && args.size() == 1) {
+      kind = Bool;
+    } else if (name == "append" && args.size() == 2 &&
+               args[1]->getType() == elem) {
+      kind = Append;
+    } else if (name == Module::INIT_MAGIC_NAME &&
+               (args.size() == 1 ||
+                (args.size() == 2 && args[1]->getType() == intType))) {
+      kind = Init;
+    } else {
+      return;
+    }
+    ++okUses[self->getVar()->getId()];
+    plan.push_back({kind, v, self->getVar(), nullptr});
+  }
+};
+
+/// Realizes the per-field lists and methods for an element record.
+FieldLowering lowerFields(Module *M, types::RecordType *elem) {
+  FieldLowering low;
+  auto *intType = M->getIntType();
+  std::vector<types::Type *> fieldTypes;
+  for (auto &field : *elem) {
+    low.names.push_back(field.getName());
+    fieldTypes.push_back(field.getType());
+    auto *listType = M->getOrRealizeType("List", {field.getType()});
+    if (!listType)
+      return low;
+    low.listTypes.push_back(listType);
+    low.newFns.push_back(M->getOrRealizeMethod(listType, Module::NEW_MAGIC_NAME, {}));
+    low.initFns.push_back(
+        M->getOrRealizeMethod(listType, Module::INIT_MAGIC_NAME, {listType}));
+    low.initCapFns.push_back(M->getOrRealizeMethod(
+        listType, Module::INIT_MAGIC_NAME, {listType, intType}));
+    low.getFns.push_back(M->getOrRealizeMethod(listType, Module::GETITEM_MAGIC_NAME,
+                                               {listType, intType}));
+    low.setFns.push_back(M->getOrRealizeMethod(
+        listType, Module::SETITEM_MAGIC_NAME, {listType, intType, field.getType()}));
+    low.appendFns.push_back(
+        M->getOrRealizeMethod(listType, "append", {listType, field.getType()}));
+    if (!low.newFns.back() || !low.initFns.back() || !low.initCapFns.back() ||
+        !low.getFns.back() || !low.setFns.back() || !low.appendFns.back())
+      return low;
+  }
+  low.lenFn = M->getOrRealizeMethod(low.listTypes[0], Module::LEN_MAGIC_NAME,
+                                    {low.listTypes[0]});
+  low.boolFn = M->getOrRealizeMethod(low.listTypes[0], Module::BOOL_MAGIC_NAME,
+                                     {low.listTypes[0]});
+  low.elemNew = M->getOrRealizeMethod(elem, Module::NEW_MAGIC_NAME, fieldTypes);
+  low.ok = low.lenFn && low.boolFn && low.elemNew;
+  return low;
+}
+} // namespace
+
+const std::string SoALayoutPass::KEY = "core-soa-layout";
+
+void SoALayoutPass::run(Module *m) {
+  numConverted = 0;
+
+  auto *cache = m->getCache();
+  if (!cache)
+    return;
+
+  std::unordered_map<types::Type *, std::string> classOfType;
+  for (const auto &[clsName, cls] : cache->classes) {
+    for (const auto &[realName, real] : cls.realizations) {
+      if (real->ir)
+        classOfType[real->ir] = clsName;
+    }
+  }
+
+  // gather local list variables with an @soa element record
+  std::unordered_map<id_t, Candidate> candidates;
+  auto scan = [&](BodiedFunc *f) {
+    if (!f)
+      return;
+    for (auto *var : *f) {
+      if (var->isGlobal())
+        continue;
+      if (auto *elem = getSoAElement(var->getType(), classOfType, cache))
+        candidates[var->getId()] = {f, var->getType(), elem};
+    }
+  };
+  scan(cast<BodiedFunc>(m->getMainFunc()));
+  for (auto *var : *m)
+    scan(cast<BodiedFunc>(var));
+  if (candidates.empty())
+    return;
+
+  UseCollector collector(&candidates);
+  collector.process(m);
+
+  // a variable is converted only if its whole alias group checks out
+  std::unordered_map<id_t, bool> groupGood;
+  for (auto &[id, c] : candidates) {
+    auto root = collector.find(id);
+    auto it = groupGood.find(root);
+    bool good = it == groupGood.end() ? true : it->second;
+    if (collector.bad.count(id) || collector.uses[id] != collector.okUses[id])
+      good = false;
+    groupGood[root] = good;
+  }
+
+  std::unordered_map<types::Type *, FieldLowering> lowerings;
+  auto getLowering = [&](types::RecordType *elem) -> FieldLowering * {
+    auto it = lowerings.find(elem);
+    if (it == lowerings.end())
+      it = lowerings.emplace(elem, lowerFields(m, elem)).first;
+    return it->second.ok ? &it->second : nullptr;
+  };
+
+  // materialize the per-field lists for every variable in a good group
+  std::unordered_map<id_t, std::vector<Var *>> fieldVars;
+  for (auto &[id, c] : candidates) {
+    if (!groupGood[collector.find(id)])
+      continue;
+    auto *low = getLowering(c.elemType);
+    if (!low) {
+      groupGood[collector.find(id)] = false;
+      continue;
+    }
+    auto &fvs = fieldVars[id];
+    auto *orig = m->getVar(id);
+    for (unsigned i = 0; i < low->names.size(); i++) {
+      auto *fv = m->Nr<Var>(low->listTypes[i], /*global=*/false, /*external=*/false,
+                            orig->getName() + ".soa." + low->names[i]);
+      c.func->push_back(fv);
+      fvs.push_back(fv);
+    }
+  }
+
+  for (auto &use : collector.plan) {
+    auto id = use.var->getId();
+    if (!groupGood[collector.find(id)])
+      continue;
+    auto &c = candidates[id];
+    auto *low = getLowering(c.elemType);
+    auto &fvs = fieldVars[id];
+    auto n = low->names.size();
+
+    switch (use.kind) {
+    case UseCollector::New: {
+      auto *series = m->Nr<SeriesFlow>();
+      for (unsigned i = 0; i < n; i++)
+        series->push_back(
+            m->Nr<AssignInstr>(fvs[i], util::call(low->newFns[i], {})));
+      use.node->replaceAll(series);
+      break;
+    }
+    case UseCollector::Copy:
+    case UseCollector::CopyFlow: {
+      auto *series = m->Nr<SeriesFlow>();
+      if (use.kind == UseCollector::CopyFlow)
+        series->push_back(
+            cast<FlowInstr>(cast<AssignInstr>(use.node)->getRhs())->getFlow());
+      auto &ws = fieldVars[use.other->getId()];
+      for (unsigned i = 0; i < n; i++)
+        series->push_back(m->Nr<AssignInstr>(fvs[i], m->Nr<VarValue>(ws[i])));
+      use.node->replaceAll(series);
+      break;
+    }
+    case UseCollector::Init: {
+      auto *call = cast<CallInstr>(use.node);
+      std::vector<Value *> args(call->begin(), call->end());
+      auto *series = m->Nr<SeriesFlow>();
+      Var *cap = nullptr;
+      if (args.size() == 2)
+        cap = util::makeVar(args[1], series, c.func)->getVar();
+      for (unsigned i = 0; i < n; i++) {
+        std::vector<Value *> a = {m->Nr<VarValue>(fvs[i])};
+        if (cap)
+          a.push_back(m->Nr<VarValue>(cap));
+        series->push_back(
+            util::call(cap ? low->initCapFns[i] : low->initFns[i], a));
+      }
+      use.node->replaceAll(series);
+      break;
+    }
+    case UseCollector::GetItem: {
+      auto *call = cast<CallInstr>(use.node);
+      auto *series = m->Nr<SeriesFlow>();
+      auto *idx = util::makeVar(call->back(), series, c.func)->getVar();
+      std::vector<Value *> elems;
+      for (unsigned i = 0; i < n; i++)
+        elems.push_back(util::call(
+            low->getFns[i], {m->Nr<VarValue>(fvs[i]), m->Nr<VarValue>(idx)}));
+      use.node->replaceAll(
+          m->Nr<FlowInstr>(series, util::call(low->elemNew, elems)));
+      break;
+    }
+    case UseCollector::SetItem: {
+      auto *call = cast<CallInstr>(use.node);
+      std::vector<Value *> args(call->begin(), call->end());
+      auto *series = m->Nr<SeriesFlow>();
+      auto *idx = util::makeVar(args[1], series, c.func)->getVar();
+      auto *val = util::makeVar(args[2], series, c.func)->getVar();
+      for (unsigned i = 0; i < n; i++)
+        series->push_back(util::call(
+            low->setFns[i],
+            {m->Nr<VarValue>(fvs[i]), m->Nr<VarValue>(idx),
+             m->Nr<ExtractInstr>(m->Nr<VarValue>(val), low->names[i])}));
+      use.node->replaceAll(series);
+      break;
+    }
+    case UseCollector::Append: {
+      auto *call = cast<CallInstr>(use.node);
+      auto *series = m->Nr<SeriesFlow>();
+      auto *val = util::makeVar(call->back(), series, c.func)->getVar();
+      for (unsigned i = 0; i < n; i++)
+        series->push_back(util::call(
+            low->appendFns[i],
+            {m->Nr<VarValue>(fvs[i]),
+             m->Nr<ExtractInstr>(m->Nr<VarValue>(val), low->names[i])}));
+      use.node->replaceAll(series);
+      break;
+    }
+    case UseCollector::Len:
+      use.node->replaceAll(util::call(low->lenFn, {m->Nr<VarValue>(fvs[0])}));
+      break;
+    case UseCollector::Bool:
+      use.node->replaceAll(util::call(low->boolFn, {m->Nr<VarValue>(fvs[0])}));
+      break;
+    }
+  }
+
+  for (auto &[id, c] : candidates) {
+    if (groupGood[collector.find(id)]) {
+      LOG_IR("[{}] converted list to struct-of-arrays: {}", KEY,
+             m->getVar(id)->getName());
+      ++numConverted;
+    }
+  }
+}
+
+} // namespace layout
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,42 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace layout {
+
+/// Opt-in array-of-structs to struct-of-arrays conversion. A local
+/// `List[E]` whose element `E` is a tuple class marked with the `@soa`
+/// decorator is split into one list per field, so loops that stream a
+/// single field read a contiguous unit-stride array instead of
+/// gather-loading through interleaved records. Only lists whose every
+/// use is a recognized operation -- construction, append, len, indexed
+/// get/set, and aliasing to another such local -- are converted; a list
+/// that escapes (passed to a call, returned, stored elsewhere) or is
+/// iterated through a generator keeps its original layout. Runs before
+/// loop lowering and outlining so uses inside `@par` bodies are still
+/// local to the frame.
+class SoALayoutPass : public Pass {
+private:
+  /// number of converted lists
+  int numConverted = 0;
+
+public:
+  static const std::string KEY;
+
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of converted lists
+  int getNumConverted() const { return numConverted; }
+};
+
+} // namespace layout
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,289 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "licm.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "codon/cir/analyze/module/side_effect.h"
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/operator.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace licm {
+namespace {
+util::SideEffectStatus statusOf(const analyze::module::SideEffectResult *se,
+                                const Value *v) {
+  auto it = se->result.find(v->getId());
+  return it != se->result.end() ? it->second : util::SideEffectStatus::UNKNOWN;
+}
+
+/// Finds address-taken variables, which can change without an assignment.
+struct Prescan : public util::Operator {
+  std::unordered_set<id_t> banned;
+  void handle(PointerValue *v) override { banned.insert(v->getVar()->getId()); }
+};
+
+/// Scans a loop for the variables it assigns and for anything that may
+/// write memory, which would make heap-reading pure calls variant.
+struct LoopScan : public util::Operator {
+  const analyze::module::SideEffectResult *se;
+  std::unordered_set<id_t> assigned;
+  bool barrier = false;
+
+  explicit LoopScan(const analyze::module::SideEffectResult *se) : se(se) {}
+
+  void handle(AssignInstr *v) override { assigned.insert(v->getLhs()->getId()); }
+  void handle(ForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(ImperativeForFlow *v) override { assigned.insert(v->getVar()->getId()); }
+  void handle(TryCatchFlow *v) override {
+    for (auto &c : *v) {
+      if (auto *var = c.getVar())
+        assigned.insert(var->getId());
+    }
+  }
+  void handle(CallInstr *v) override {
+    if (statusOf(se, v) > util::SideEffectStatus::NO_SIDE_EFFECT)
+      barrier = true;
+  }
+  void handle(InsertInstr *v) override { barrier = true; }
+  void handle(YieldInstr *v) override { barrier = true; }
+  void handle(YieldInInstr *v) override { barrier = true; }
+  void handle(PipelineFlow *v) override { barrier = true; }
+  void handle(dsl::CustomFlow *v) override { barrier = true; }
+  void handle(dsl::CustomInstr *v) override { barrier = true; }
+};
+
+class LICMContext {
+private:
+  Module *M;
+  BodiedFunc *func;
+  const analyze::module::SideEffectResult *se;
+  /// address-taken variables, never invariant
+  std::unordered_set<id_t> banned;
+  /// variables holding lazily materialized invariants
+  std::unordered_set<id_t> lazyVars;
+  /// number of hoisted values
+  int hoisted = 0;
+
+public:
+  LICMContext(Module *M, BodiedFunc *func,
+              const analyze::module::SideEffectResult *se,
+              std::unordered_set<id_t> banned)
+      : M(M), func(func), se(se), banned(std::move(banned)) {}
+
+  int getNumHoisted() const { return hoisted; }
+
+  void run() { processFlow(func->getBody()); }
+
+private:
+  void processFlow(Flow *flow) {
+    if (!flow)
+      return;
+    if (auto *series = cast<SeriesFlow>(flow)) {
+      for (auto it = series->begin(); it != series->end(); ++it)
+        processStmt(*it, series, it);
+    } else {
+      processStmt(flow, nullptr, {});
+    }
+  }
+
+  void processStmt(Value *stmt, SeriesFlow *parent,
+                   std::list<Value *>::iterator it) {
+    if (auto *series = cast<SeriesFlow>(stmt)) {
+      processFlow(series);
+    } else if (auto *iff = cast<IfFlow>(stmt)) {
+      processFlow(iff->getTrueBranch());
+      processFlow(iff->getFalseBranch());
+    } else if (auto *wf = cast<WhileFlow>(stmt)) {
+      // hoist only from for-flows, whose trip behavior is explicit
+      processFlow(wf->getBody());
+    } else if (auto *tc = cast<TryCatchFlow>(stmt)) {
+      processFlow(tc->getBody());
+      for (auto &c : *tc)
+        processFlow(c.getHandler());
+      processFlow(tc->getFinally());
+    } else if (auto *ff = cast<ForFlow>(stmt)) {
+      processFlow(ff->getBody());
+      if (parent)
+        hoistLoop(ff, ff->getBody(), parent, it);
+    } else if (auto *iff = cast<ImperativeForFlow>(stmt)) {
+      processFlow(iff->getBody());
+      if (parent)
+        hoistLoop(iff, iff->getBody(), parent, it);
+    }
+  }
+
+  /// An invariant call's cached value and its evaluated-yet flag. The flag
+  /// is reset before the loop; the value is computed at the call's first
+  /// actual evaluation, never speculatively (pure calls may still trap —
+  /// a raw load or a division — so running one before the loop, or on a
+  /// zero-trip or guard-false path, could fault on valid input).
+  struct LazySlot {
+    Var *val;
+    Var *done;
+  };
+
+  void hoistLoop(Value *loop, Flow *body, SeriesFlow *parent,
+                 std::list<Value *>::iterator it) {
+    LoopScan scan(se);
+    scan.process(loop);
+    if (scan.barrier)
+      return;
+
+    std::unordered_map<std::string, LazySlot> invariants;
+    hoistExpr(body, scan.assigned, invariants, parent, it);
+  }
+
+  /// Builds an invariance key for a value: constants, variables the loop
+  /// does not assign, and pure calls over such values. Empty if variant.
+  std::string invariantKey(Value *v, const std::unordered_set<id_t> &assigned) {
+    if (auto *c = cast<IntConst>(v))
+      return "i" + std::to_string(c->getVal());
+    if (auto *c = cast<FloatConst>(v)) {
+      // key by exact bit pattern; decimal formatting rounds nearby doubles
+      // to the same key
+      uint64_t bits;
+      auto val = c->getVal();
+      std::memcpy(&bits, &val, sizeof(bits));
+      return "f" + std::to_string(bits);
+    }
+    if (auto *c = cast<BoolConst>(v))
+      return c->getVal() ? "b1" : "b0";
+    if (auto *c = cast<StringConst>(v))
+      // length-prefixed so payload bytes cannot mimic key structure
+      return "s" + std::to_string(c->getVal().size()) + ":" + c->getVal();
+    if (auto *vv = cast<VarValue>(v)) {
+      auto id = vv->getVar()->getId();
+      if (banned.find(id) != banned.end() || assigned.find(id) != assigned.end())
+        return "";
+      return "v" + std::to_string(id);
+    }
+    if (auto *call = cast<CallInstr>(v))
+      return callKey(call, assigned);
+    // A lazily materialized invariant (see below) chains: an outer call
+    // over it is itself invariant. Only for the loop it was hoisted out
+    // of, though — a slot created in an inner loop is assigned inside any
+    // enclosing loop and varies per enclosing iteration.
+    if (auto *fi = cast<FlowInstr>(v)) {
+      if (auto *vv = cast<VarValue>(fi->getValue())) {
+        auto id = vv->getVar()->getId();
+        if (lazyVars.find(id) != lazyVars.end() &&
+            assigned.find(id) == assigned.end())
+          return "v" + std::to_string(id);
+      }
+    }
+    return "";
+  }
+
+  std::string callKey(CallInstr *call, const std::unordered_set<id_t> &assigned) {
+    if (statusOf(se, call) != util::SideEffectStatus::PURE)
+      return "";
+    auto *f = util::getFunc(call->getCallee());
+    if (!f)
+      return "";
+    auto *type = call->getType();
+    if (!type || type->is(M->getVoidType()) || type->is(M->getNoneType()) ||
+        isA<types::GeneratorType>(type))
+      return "";
+
+    std::string key = "c" + std::to_string(f->getId()) + "(";
+    for (auto *arg : *call) {
+      auto sub = invariantKey(arg, assigned);
+      if (sub.empty())
+        return "";
+      key += sub + ",";
+    }
+    return key + ")";
+  }
+
+  /// Hoists invariant pure calls in a subtree, innermost first so outer
+  /// calls see the temporaries their operands were hoisted into. Each call
+  /// site is replaced by a one-shot guard that evaluates the call the first
+  /// time the site actually executes and reuses the cached value after
+  /// that, so no call runs earlier — or on more paths — than it did in the
+  /// original loop.
+  void hoistExpr(Value *v, const std::unordered_set<id_t> &assigned,
+                 std::unordered_map<std::string, LazySlot> &invariants,
+                 SeriesFlow *parent, std::list<Value *>::iterator it) {
+    if (!v)
+      return;
+
+    if (auto *call = cast<CallInstr>(v)) {
+      for (auto *arg : *call)
+        hoistExpr(arg, assigned, invariants, parent, it);
+
+      auto key = callKey(call, assigned);
+      if (key.empty())
+        return;
+
+      auto jt = invariants.find(key);
+      LazySlot slot;
+      if (jt != invariants.end()) {
+        slot = jt->second;
+      } else {
+        LOG_IR("[{}] hoisting: {}", LICMPass::KEY, *call);
+        slot.val = M->Nr<Var>(call->getType());
+        slot.done = M->Nr<Var>(M->getBoolType());
+        func->push_back(slot.val);
+        func->push_back(slot.done);
+        // reset per entry so a loop re-entered from an enclosing one
+        // recomputes with the enclosing iteration's operand values
+        parent->insert(it, M->Nr<AssignInstr>(slot.done, M->getBool(false)));
+        invariants[key] = slot;
+        lazyVars.insert(slot.val->getId());
+      }
+      util::CloneVisitor cv(M);
+      auto *compute = M->Nr<SeriesFlow>();
+      compute->push_back(M->Nr<AssignInstr>(slot.val, cv.clone(call)));
+      compute->push_back(M->Nr<AssignInstr>(slot.done, M->getBool(true)));
+      auto *guard = M->Nr<IfFlow>(M->Nr<VarValue>(slot.done), M->Nr<SeriesFlow>(),
+                                  compute);
+      call->replaceAll(M->Nr<FlowInstr>(guard, M->Nr<VarValue>(slot.val)));
+      ++hoisted;
+      return;
+    }
+
+    for (auto *x : v->getUsedValues())
+      hoistExpr(x, assigned, invariants, parent, it);
+  }
+};
+
+int processFunc(Module *M, BodiedFunc *f,
+                const analyze::module::SideEffectResult *se) {
+  if (!f || !f->getBody())
+    return 0;
+
+  Prescan pre;
+  pre.process(f->getBody());
+
+  LICMContext ctx(M, f, se, std::move(pre.banned));
+  ctx.run();
+  return ctx.getNumHoisted();
+}
+} // namespace
+
+const std::string LICMPass::KEY = "core-licm";
+
+void LICMPass::run(Module *m) {
+  auto *se = getAnalysisResult<analyze::module::SideEffectResult>(sideEffectsKey);
+  if (!se)
+    return;
+
+  numHoisted = 0;
+  numHoisted += processFunc(m, cast<BodiedFunc>(m->getMainFunc()), se);
+  for (auto *var : *m) {
+    if (auto *f = cast<BodiedFunc>(var))
+      numHoisted += processFunc(m, f, se);
+  }
+}
+
+} // namespace licm
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,47 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace licm {
+
+/// Loop-invariant code motion pass for for-flows. Pure calls inside a
+/// `ForFlow` or `ImperativeForFlow` body whose operands are loop-invariant
+/// are computed once into a fresh variable and reused for the rest of the
+/// loop. The computation is guarded by a first-use flag rather than moved
+/// before the loop: pure calls may still trap (raw loads, division), so
+/// they must not be speculated on zero-trip loops or past branches that
+/// originally guarded them. Loops whose body may write memory are left
+/// alone, since pure calls may still read the heap; inner loops are
+/// processed first so invariants bubble outward one level at a time.
+class LICMPass : public Pass {
+private:
+  /// the side effect analysis' key
+  std::string sideEffectsKey;
+  /// number of hoisted values
+  int numHoisted = 0;
+
+public:
+  static const std::string KEY;
+
+  /// Constructs a LICM pass.
+  /// @param sideEffectsKey the side effect analysis' key
+  explicit LICMPass(const std::string &sideEffectsKey)
+      : sideEffectsKey(sideEffectsKey) {}
+
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  /// @return the number of hoisted values
+  int getNumHoisted() const { return numHoisted; }
+};
+
+} // namespace licm
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,157 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "dispatch.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "codon/cir/util/irtools.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace lowering {
+namespace {
+/// Minimum number of arms before the two-level dispatch pays for itself.
+const unsigned MIN_ARMS = 8;
+
+/// Matches a condition of the form `subject == "literal"`, where the
+/// subject is one fixed variable across the whole chain.
+StringConst *matchStrEq(Value *cond, Module *M, Var **subject) {
+  auto *call = cast<CallInstr>(cond);
+  auto *strType = M->getStringType();
+  if (!call || !util::isCallOf(call, Module::EQ_MAGIC_NAME, {strType, strType},
+                               M->getBoolType(), /*method=*/true))
+    return nullptr;
+  auto *lhs = cast<VarValue>(call->front());
+  auto *lit = cast<StringConst>(call->back());
+  if (!lhs || !lit)
+    return nullptr;
+  if (*subject && lhs->getVar()->getId() != (*subject)->getId())
+    return nullptr;
+  *subject = lhs->getVar();
+  return lit;
+}
+} // namespace
+
+const std::string StringDispatchLowering::KEY = "core-string-dispatch-lowering";
+
+void StringDispatchLowering::run(Module *m) {
+  numReplacements = 0;
+  OperatorPass::run(m);
+}
+
+void StringDispatchLowering::handle(IfFlow *v) {
+  auto *M = v->getModule();
+  Var *subject = nullptr;
+
+  // collect the `s == "..."` arms and the trailing else of the chain
+  std::vector<IfFlow *> chain;
+  std::vector<StringConst *> lits;
+  Flow *elseFlow = nullptr;
+
+  auto *cur = v;
+  while (true) {
+    auto *lit = matchStrEq(cur->getCond(), M, &subject);
+    if (!lit)
+      return;
+    chain.push_back(cur);
+    lits.push_back(lit);
+
+    auto *fb = cast<SeriesFlow>(cur->getFalseBranch());
+    IfFlow *next = nullptr;
+    if (fb && std::distance(fb->begin(), fb->end()) == 1)
+      next = cast<IfFlow>(*fb->begin());
+    auto *sub = subject;
+    if (next && matchStrEq(next->getCond(), M, &sub)) {
+      cur = next;
+    } else {
+      elseFlow = cur->getFalseBranch();
+      break;
+    }
+  }
+
+  if (chain.size() < MIN_ARMS)
+    return;
+
+  // arms must be mutually exclusive for regrouping to preserve order
+  std::unordered_set<std::string> seenLits;
+  for (auto *lit : lits) {
+    if (!seenLits.insert(lit->getVal()).second)
+      return;
+  }
+
+  // group arms by literal length, keeping first-seen order; a single
+  // length group would just rebuild the same chain behind a length check
+  // (and re-trigger this pass), so require at least two
+  std::vector<int64_t> lengths;
+  std::unordered_map<int64_t, std::vector<unsigned>> groups;
+  for (unsigned i = 0; i < lits.size(); i++) {
+    auto len = int64_t(lits[i]->getVal().size());
+    if (groups.find(len) == groups.end())
+      lengths.push_back(len);
+    groups[len].push_back(i);
+  }
+  if (lengths.size() < 2)
+    return;
+
+  auto *parent = cast<BodiedFunc>(getParentFunc());
+  auto *intEq = M->getOrRealizeMethod(M->getIntType(), Module::EQ_MAGIC_NAME,
+                                      {M->getIntType(), M->getIntType()});
+  auto *boolInv = M->getOrRealizeMethod(M->getBoolType(), Module::INVERT_MAGIC_NAME,
+                                        {M->getBoolType()});
+  if (!parent || !intEq || !boolInv)
+    return;
+
+  auto wrap = [&](Flow *f) -> Flow * {
+    if (!f)
+      return nullptr;
+    auto *s = M->Nr<SeriesFlow>();
+    s->push_back(f);
+    return s;
+  };
+
+  auto *series = M->Nr<SeriesFlow>();
+  auto *doneVar = util::makeVar(M->getBool(false), series, parent)->getVar();
+  auto *lenVar =
+      util::makeVar(M->Nr<ExtractInstr>(M->Nr<VarValue>(subject), "len"), series,
+                    parent)
+          ->getVar();
+
+  // build the per-length groups innermost-first, then chain the length
+  // checks; the length chain is an int equality chain that LLVM turns
+  // into a switch or jump table
+  Flow *outer = nullptr;
+  for (auto lenIt = lengths.rbegin(); lenIt != lengths.rend(); ++lenIt) {
+    auto &group = groups[*lenIt];
+    Flow *inner = nullptr;
+    for (auto it = group.rbegin(); it != group.rend(); ++it) {
+      auto *arm = chain[*it];
+      auto *body = cast<SeriesFlow>(arm->getTrueBranch());
+      if (!body) {
+        body = M->Nr<SeriesFlow>();
+        body->push_back(arm->getTrueBranch());
+      }
+      body->insert(body->begin(), M->Nr<AssignInstr>(doneVar, M->getBool(true)));
+      inner = M->Nr<IfFlow>(arm->getCond(), body, wrap(inner));
+    }
+    auto *lenCond = util::call(intEq, {M->Nr<VarValue>(lenVar), M->getInt(*lenIt)});
+    outer = M->Nr<IfFlow>(lenCond, wrap(inner), wrap(outer));
+  }
+  series->push_back(outer);
+
+  if (elseFlow) {
+    auto *notDone = util::call(boolInv, {M->Nr<VarValue>(doneVar)});
+    series->push_back(M->Nr<IfFlow>(notDone, elseFlow));
+  }
+
+  LOG_IR("[{}] lowered {}-way string chain to length dispatch", KEY, chain.size());
+  numReplacements++;
+  v->replaceAll(series);
+}
+
+} // namespace lowering
+} // namespace transform
+} // namespace ir
+} // namespace codon
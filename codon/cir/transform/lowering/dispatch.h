@@ -0,0 +1,38 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace lowering {
+
+/// Lowers long if/elif chains that compare one string against distinct
+/// literals into a two-level dispatch: an integer chain on the string's
+/// length (which LLVM turns into a switch or jump table) selecting a
+/// short group of same-length compares. Int equality chains need no CIR
+/// help, since LLVM's CFG simplification already converts them after
+/// the comparison calls are inlined.
+class StringDispatchLowering : public OperatorPass {
+private:
+  /// number of lowered chains
+  int numReplacements = 0;
+
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+
+  void run(Module *m) override;
+
+  void handle(IfFlow *v) override;
+
+  /// @return the number of lowered chains
+  int getNumReplacements() const { return numReplacements; }
+};
+
+} // namespace lowering
+} // namespace transform
+} // namespace ir
+} // namespace codon
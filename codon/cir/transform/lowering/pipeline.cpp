@@ -39,8 +39,11 @@ Value *convertPipelineToForLoopsHelper(Module *M, BodiedFunc *parent,
     auto *body = convertPipelineToForLoopsHelper(
         M, parent, stages, idx + 1, callStage(M, stage, M->Nr<VarValue>(var)));
     auto *loop = M->N<ForFlow>(last->getSrcInfo(), last, util::series(body), var);
-    if (stage->isParallel())
+    if (stage->isParallel()) {
       loop->setParallel();
+      // lowered onto SPSC ring buffers rather than per-element tasks
+      loop->getSchedule()->spscPipeline = true;
+    }
     return loop;
   } else {
     return convertPipelineToForLoopsHelper(M, parent, stages, idx + 1,
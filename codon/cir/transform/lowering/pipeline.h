@@ -9,7 +9,8 @@ namespace ir {
 namespace transform {
 namespace lowering {
 
-/// Converts pipelines to for-loops
+/// Converts pipelines to for-loops; parallel (||>) stages become loops
+/// marked for SPSC ring-buffer lowering in the OpenMP pass
 class PipelineLowering : public OperatorPass {
 public:
   static const std::string KEY;
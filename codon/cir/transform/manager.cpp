@@ -8,13 +8,26 @@
 #include "codon/cir/analyze/dataflow/capture.h"
 #include "codon/cir/analyze/dataflow/cfg.h"
 #include "codon/cir/analyze/dataflow/dominator.h"
+#include "codon/cir/analyze/dataflow/liveness.h"
 #include "codon/cir/analyze/dataflow/reaching.h"
 #include "codon/cir/analyze/module/global_vars.h"
 #include "codon/cir/analyze/module/side_effect.h"
+#include "codon/cir/transform/cleanup/dead_store.h"
+#include "codon/cir/transform/cleanup/outline_dedup.h"
+#include "codon/cir/transform/devirt/devirt.h"
+#include "codon/cir/transform/escape/escape.h"
+#include "codon/cir/transform/folding/arg_prop.h"
 #include "codon/cir/transform/folding/folding.h"
+#include "codon/cir/transform/gvn/gvn.h"
+#include "codon/cir/transform/instrument/hit_counters.h"
+#include "codon/cir/transform/instrument/interrupt.h"
+#include "codon/cir/transform/layout/soa.h"
+#include "codon/cir/transform/licm/licm.h"
+#include "codon/cir/transform/lowering/dispatch.h"
 #include "codon/cir/transform/lowering/imperative.h"
 #include "codon/cir/transform/lowering/pipeline.h"
 #include "codon/cir/transform/manager.h"
+#include "codon/cir/transform/parallel/fusion.h"
 #include "codon/cir/transform/parallel/openmp.h"
 #include "codon/cir/transform/pass.h"
 #include "codon/cir/transform/pythonic/dict.h"
@@ -91,6 +104,11 @@ std::string PassManager::registerAnalysis(std::unique_ptr<analyze::Analysis> ana
 }
 
 void PassManager::run(Module *module) {
+  // Passes run serially and act as barriers: rewrites go through shared
+  // mutable state (module ownership lists, the replace-all machinery and
+  // stateful Operator visitors), so the compile-time parallelism lives in
+  // the per-function analysis slices that passes request (see
+  // CFAnalysis/RDAnalysis/DominatorAnalysis).
   for (auto &p : executionOrder) {
     runPass(module, p);
   }
@@ -110,6 +128,7 @@ void PassManager::runPass(Module *module, const std::string &name) {
     Timer timer("  ir pass    : " + meta.pass->getKey());
     meta.pass->run(module);
     timer.log();
+    getProfiler().record("pass", meta.pass->getKey(), timer.elapsed());
 
     for (auto &inv : meta.invalidates)
       invalidate(inv);
@@ -128,8 +147,13 @@ void PassManager::runAnalysis(Module *module, const std::string &name) {
   }
 
   Timer timer("  ir analysis: " + meta.analysis->getKey());
-  results[name] = meta.analysis->run(module);
+  auto staleIt = staleResults.find(name);
+  results[name] = meta.analysis->run(
+      module, staleIt != staleResults.end() ? staleIt->second.get() : nullptr);
+  if (staleIt != staleResults.end())
+    staleResults.erase(staleIt);
   timer.log();
+  getProfiler().record("analysis", meta.analysis->getKey(), timer.elapsed());
 }
 
 void PassManager::invalidate(const std::string &key) {
@@ -138,8 +162,12 @@ void PassManager::invalidate(const std::string &key) {
   while (!open.empty()) {
     std::unordered_set<std::string> newOpen;
     for (const auto &k : open) {
-      if (results.find(k) != results.end()) {
-        results.erase(k);
+      auto it = results.find(k);
+      if (it != results.end()) {
+        // keep the stale result around so the analysis can reuse the pieces
+        // belonging to functions the pass did not touch
+        staleResults[k] = std::move(it->second);
+        results.erase(it);
         newOpen.insert(deps[k].begin(), deps[k].end());
       }
     }
@@ -155,20 +183,47 @@ void PassManager::registerStandardPasses(PassManager::Init init) {
     registerPass(std::make_unique<lowering::PipelineLowering>());
     registerPass(std::make_unique<lowering::ImperativeForFlowLowering>());
     registerPass(std::make_unique<parallel::OpenMPPass>());
+    if (getenv("CODON_HIT_COUNTERS"))
+      registerPass(std::make_unique<instrument::HitCounterInstrumentation>());
     break;
   }
+  case Init::FAST:
   case Init::RELEASE:
   case Init::JIT: {
+    // The FAST tier is RELEASE with repetition trimmed for quick
+    // edit-compile-test cycles: one folding iteration instead of the two
+    // thrice-repeated groups, and no outline deduplication.
     // Pythonic
-    registerPass(std::make_unique<pythonic::DictArithmeticOptimization>());
-    registerPass(std::make_unique<pythonic::ListAdditionOptimization>());
-    registerPass(std::make_unique<pythonic::StrAdditionOptimization>());
-    registerPass(std::make_unique<pythonic::GeneratorArgumentOptimization>());
+    // The dict/list/str/generator-argument peepholes match independent
+    // patterns, so they share one traversal instead of one walk each.
+    // Generator fusion and I/O coalescing consume what the group
+    // produces, so they stay separate and run after it.
+    auto peepholes = std::make_unique<OperatorPassGroup>("core-pythonic-peepholes");
+    peepholes->push_back(std::make_unique<pythonic::DictArithmeticOptimization>());
+    peepholes->push_back(std::make_unique<pythonic::ListAdditionOptimization>());
+    peepholes->push_back(std::make_unique<pythonic::StrAdditionOptimization>());
+    peepholes->push_back(std::make_unique<pythonic::GeneratorArgumentOptimization>());
+    registerPass(std::move(peepholes));
+    registerPass(std::make_unique<pythonic::GeneratorFusionOptimization>());
     registerPass(std::make_unique<pythonic::IOCatOptimization>());
 
+    // struct-of-arrays splitting of @soa lists; must precede loop lowering
+    // and OpenMP outlining so uses inside @par bodies are still frame-local
+    registerPass(std::make_unique<layout::SoALayoutPass>());
+
     // lowering
     registerPass(std::make_unique<lowering::PipelineLowering>());
     registerPass(std::make_unique<lowering::ImperativeForFlowLowering>());
+    registerPass(std::make_unique<lowering::StringDispatchLowering>());
+
+    // list pre-allocation needs lowered range loops
+    registerPass(std::make_unique<pythonic::ListPreallocationOptimization>());
+
+    if (init != Init::JIT) {
+      // Devirtualize single-implementation calls. Not done in JIT mode,
+      // since later inputs may add derived classes to a hierarchy.
+      registerPass(std::make_unique<devirt::DevirtualizationPass>());
+    }
 
     // folding
     auto cfgKey = registerAnalysis(std::make_unique<analyze::dataflow::CFAnalysis>());
@@ -176,6 +231,8 @@ void PassManager::registerStandardPasses(PassManager::Init init) {
         std::make_unique<analyze::dataflow::RDAnalysis>(cfgKey), {cfgKey});
     auto domKey = registerAnalysis(
         std::make_unique<analyze::dataflow::DominatorAnalysis>(cfgKey), {cfgKey});
+    auto liveKey = registerAnalysis(
+        std::make_unique<analyze::dataflow::LivenessAnalysis>(cfgKey), {cfgKey});
     auto capKey = registerAnalysis(
         std::make_unique<analyze::dataflow::CaptureAnalysis>(rdKey, domKey),
         {rdKey, domKey});
@@ -191,26 +248,79 @@ void PassManager::registerStandardPasses(PassManager::Init init) {
                              capKey,
                              /*globalAssignmentHasSideEffects=*/false),
                          {capKey});
+    // stack promotion of non-escaping class allocations
+    registerPass(std::make_unique<escape::StackPromotionPass>(capKey),
+                 /*insertBefore=*/"", {capKey},
+                 {seKey1, rdKey, cfgKey, globalKey, capKey});
+
     registerPass(std::make_unique<folding::FoldingPassGroup>(
-                     seKey1, rdKey, globalKey, /*repeat=*/5, /*runGlobalDemoton=*/false,
-                     pyNumerics),
+                     seKey1, rdKey, globalKey,
+                     /*repeat=*/init == Init::FAST ? 1 : 3,
+                     /*runGlobalDemoton=*/false, pyNumerics),
                  /*insertBefore=*/"", {seKey1, rdKey, globalKey},
                  {seKey1, rdKey, cfgKey, globalKey, capKey});
 
+    // redundancy elimination
+    registerPass(std::make_unique<gvn::GVNPass>(seKey1), /*insertBefore=*/"",
+                 {seKey1}, {seKey1, rdKey, cfgKey, globalKey, capKey});
+    registerPass(std::make_unique<licm::LICMPass>(seKey1), /*insertBefore=*/"",
+                 {seKey1}, {seKey1, rdKey, cfgKey, globalKey, capKey});
+
     // parallel
+    registerPass(std::make_unique<parallel::GPUKernelFusionPass>());
     registerPass(std::make_unique<parallel::OpenMPPass>(), /*insertBefore=*/"", {},
                  {cfgKey, globalKey});
 
-    if (init != Init::JIT) {
+    if (init != Init::JIT && init != Init::FAST) {
+      // Pin arguments that every direct call site passes as the same
+      // literal, so the folding group below propagates them into the
+      // callee and deletes the code paths they disable. Not done in JIT
+      // mode, since later inputs may add call sites with other values.
+      registerPass(std::make_unique<folding::ArgumentPropPass>(),
+                   /*insertBefore=*/"", {},
+                   {seKey2, rdKey, cfgKey, globalKey, capKey});
+
       // Don't demote globals in JIT mode, since they might be used later
       // by another user input.
       registerPass(std::make_unique<folding::FoldingPassGroup>(
                        seKey2, rdKey, globalKey,
-                       /*repeat=*/5,
+                       /*repeat=*/3,
                        /*runGlobalDemoton=*/true, pyNumerics),
                    /*insertBefore=*/"", {seKey2, rdKey, globalKey},
                    {seKey2, rdKey, cfgKey, globalKey});
     }
+
+    // Liveness-driven dead store elimination: drops assignments to locals
+    // whose values are provably never read, along with the allocations
+    // that only feed such stores. Runs after folding and global demotion
+    // so the dead stores they expose are caught too, shrinking what the
+    // LLVM-level allocation remover has to look at.
+    registerPass(std::make_unique<cleanup::DeadStoreCleanupPass>(liveKey, seKey1),
+                 /*insertBefore=*/"", {liveKey, seKey1},
+                 {seKey1, rdKey, cfgKey, globalKey, capKey});
+
+    if (init != Init::FAST) {
+      // Merge structurally identical outlined functions (one per parallel
+      // region, often expanded from the same template over many types) into
+      // a shared copy. Runs after folding so canonicalized bodies compare
+      // equal.
+      registerPass(std::make_unique<cleanup::OutlineDeduplicationPass>());
+    }
+
+    if (getenv("CODON_HIT_COUNTERS")) {
+      // Per-function and per-loop hit counters for production profiling
+      // on hosts without perf access; runs after the optimizers so the
+      // counters do not block fusion or folding, and only instruments
+      // loops that survive optimization.
+      registerPass(std::make_unique<instrument::HitCounterInstrumentation>());
+    }
+
+    if (init == Init::JIT && getenv("CODON_JIT_INTERRUPT")) {
+      // Cooperative interruption for embedders that run inputs off the
+      // main thread (e.g. Jupyter kernels): poll a cancellation flag in
+      // every loop body. Opt-in, since it costs a call per iteration.
+      registerPass(std::make_unique<instrument::InterruptCheckInsertion>());
+    }
     break;
   }
   default:
@@ -87,6 +87,9 @@ private:
   std::vector<std::string> executionOrder;
   /// map of valid analysis results
   std::unordered_map<std::string, std::unique_ptr<analyze::Result>> results;
+  /// invalidated results kept so analyses can salvage per-function pieces
+  /// when re-run (see analyze::Analysis::run overload)
+  std::unordered_map<std::string, std::unique_ptr<analyze::Result>> staleResults;
 
   /// passes to avoid registering
   std::vector<std::string> disabled;
@@ -102,6 +105,7 @@ public:
   enum Init {
     EMPTY,
     DEBUG,
+    FAST,
     RELEASE,
     JIT,
   };
@@ -0,0 +1,78 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "fusion.h"
+
+#include "codon/cir/transform/parallel/schedule.h"
+#include "codon/cir/util/irtools.h"
+#include "codon/cir/util/matching.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace parallel {
+namespace {
+/// The fused loop reuses the first loop's bounds, so the second loop's
+/// bounds must be re-checkable without re-running arbitrary code; only
+/// accept variables and integer constants.
+bool isSimpleBound(Value *v) { return isA<VarValue>(v) || util::isConst<int64_t>(v); }
+
+ImperativeForFlow *asFusableGPULoop(Value *v) {
+  auto *f = cast<ImperativeForFlow>(v);
+  if (!f || !f->isParallel())
+    return nullptr;
+  auto *sched = f->getSchedule();
+  if (!sched->gpu || sched->ordered || sched->collapse != 0)
+    return nullptr;
+  if (!isSimpleBound(f->getStart()) || !isSimpleBound(f->getEnd()))
+    return nullptr;
+  return f;
+}
+
+bool sameIterationSpace(ImperativeForFlow *a, ImperativeForFlow *b) {
+  return a->getStep() == b->getStep() &&
+         a->getVar()->getType()->is(b->getVar()->getType()) &&
+         util::match(a->getStart(), b->getStart(), /*checkNames=*/false,
+                     /*varIdMatch=*/true) &&
+         util::match(a->getEnd(), b->getEnd(), /*checkNames=*/false,
+                     /*varIdMatch=*/true);
+}
+} // namespace
+
+const std::string GPUKernelFusionPass::KEY = "core-parallel-gpu-fusion";
+
+void GPUKernelFusionPass::handle(SeriesFlow *v) {
+  auto *M = v->getModule();
+  auto it = v->begin();
+  while (it != v->end()) {
+    auto *first = asFusableGPULoop(*it);
+    if (!first) {
+      ++it;
+      continue;
+    }
+
+    auto next = std::next(it);
+    while (next != v->end()) {
+      auto *second = asFusableGPULoop(*next);
+      if (!second || !sameIterationSpace(first, second))
+        break;
+
+      // Run the second body right after the first on each iteration. Both
+      // loops are GPU-parallel, so each declares its iterations independent;
+      // since they are adjacent, no host code runs in between. The second
+      // loop keeps its own loop variable, assigned from the first's, so its
+      // body can be spliced in unchanged.
+      auto *body = cast<SeriesFlow>(first->getBody());
+      seqassertn(body, "loop body is not a series flow");
+      body->push_back(
+          M->Nr<AssignInstr>(second->getVar(), M->Nr<VarValue>(first->getVar())));
+      body->push_back(second->getBody());
+      next = v->erase(next);
+    }
+    it = next;
+  }
+}
+
+} // namespace parallel
+} // namespace transform
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,26 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include "codon/cir/transform/pass.h"
+
+namespace codon {
+namespace ir {
+namespace transform {
+namespace parallel {
+
+/// Fuses adjacent GPU-parallel loops with identical iteration spaces into
+/// a single loop, which the OpenMP pass then outlines as one kernel. This
+/// removes intermediate kernel launches and device round-trips between
+/// consecutive loops; runs before the OpenMP pass, on un-outlined loops.
+class GPUKernelFusionPass : public OperatorPass {
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+  void handle(SeriesFlow *v) override;
+};
+
+} // namespace parallel
+} // namespace transform
+} // namespace ir
+} // namespace codon
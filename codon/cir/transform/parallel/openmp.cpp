@@ -20,6 +20,7 @@ namespace {
 const std::string ompModule = "std.openmp";
 const std::string gpuModule = "std.gpu";
 const std::string builtinModule = "std.internal.builtin";
+const std::string simdLoopAttribute = "std.openmp.simd";
 
 void warn(const std::string &msg, const Value *v) {
   auto src = v->getSrcInfo();
@@ -104,10 +105,12 @@ struct Reduction {
     XOR,
     MIN,
     MAX,
+    CUSTOM,
   };
 
   Kind kind = Kind::NONE;
   Var *shared = nullptr;
+  Func *combine = nullptr; // user combine function for Kind::CUSTOM
 
   types::Type *getType() {
     auto *ptrType = cast<types::PointerType>(shared->getType());
@@ -121,6 +124,17 @@ struct Reduction {
     auto *M = shared->getModule();
     auto *type = getType();
 
+    if (kind == Kind::CUSTOM) {
+      // user reductions take their identity from the type when given,
+      // and fall back to default construction otherwise
+      if (auto *identity = M->getOrRealizeMethod(type, "__reduction_identity__", {}))
+        return util::call(identity, {});
+      auto *init = (*type)();
+      if (!init || !init->getType()->is(type))
+        return nullptr;
+      return init;
+    }
+
     if (isA<types::IntType>(type)) {
       switch (kind) {
       case Kind::ADD:
@@ -215,6 +229,10 @@ struct Reduction {
       result = util::call(fn, {tup, none, none});
       break;
     }
+    case Kind::CUSTOM:
+      seqassertn(combine, "custom reduction with no combine function");
+      result = util::call(combine, {lhs, arg});
+      break;
     default:
       return nullptr;
     }
@@ -498,6 +516,30 @@ struct ReductionIdentifier : public util::Operator {
       return reduction;
     }
 
+    // user-defined reductions: 'a = f(a, x)' where 'f' is marked
+    // @associative and combines two values of the shared type
+    if (auto *call = cast<CallInstr>(item)) {
+      auto *combine = util::getFunc(call->getCallee());
+      if (combine && call->numArgs() == 2 &&
+          util::hasAttribute(combine, "std.internal.attributes.associative") &&
+          call->front()->getType()->is(type) && call->back()->getType()->is(type) &&
+          call->getType()->is(type)) {
+        Value *deref = nullptr;
+        for (auto *val : *call) {
+          if (isSharedDeref(shared, val)) {
+            deref = val;
+            break;
+          }
+        }
+
+        if (deref) {
+          Reduction reduction = {Reduction::Kind::CUSTOM, shared, combine};
+          if (reduction.getInitial())
+            return reduction;
+        }
+      }
+    }
+
     return {};
   }
 
@@ -513,7 +555,8 @@ struct ReductionIdentifier : public util::Operator {
       // otherwise mark as invalid via an empty reduction
       if (it == reductions.end()) {
         reductions.emplace(reduction.shared->getId(), reduction);
-      } else if (it->second && it->second.kind != reduction.kind) {
+      } else if (it->second && (it->second.kind != reduction.kind ||
+                                it->second.combine != reduction.combine)) {
         it->second = {};
       }
     }
@@ -1271,6 +1314,7 @@ OpenMPTransformData setupOpenMPTransform(T *v, BodiedFunc *parent, bool gpu) {
 struct ForkCallData {
   CallInstr *fork = nullptr;
   CallInstr *pushNumThreads = nullptr;
+  CallInstr *pushProcBind = nullptr;
 };
 
 ForkCallData createForkCall(Module *M, OMPTypes &types, Value *rawTemplateFunc,
@@ -1288,6 +1332,21 @@ ForkCallData createForkCall(Module *M, OMPTypes &types, Value *rawTemplateFunc,
         M->getOrRealizeFunc("_push_num_threads", {types.i64}, {}, ompModule);
     seqassertn(pushNumThreadsFunc, "push num threads func not found");
     result.pushNumThreads = util::call(pushNumThreadsFunc, {sched->threads});
+  } else {
+    // no explicit thread count; if this fork turns out to be nested, size
+    // the inner team from the global thread budget instead of letting
+    // libomp serialize it
+    auto *pushBudgetFunc =
+        M->getOrRealizeFunc("_push_nested_budget", {}, {}, ompModule);
+    seqassertn(pushBudgetFunc, "push nested budget func not found");
+    result.pushNumThreads = util::call(pushBudgetFunc, {});
+  }
+
+  if (sched->bind >= 0) {
+    auto *pushProcBindFunc =
+        M->getOrRealizeFunc("_push_proc_bind", {types.i64}, {}, ompModule);
+    seqassertn(pushProcBindFunc, "push proc bind func not found");
+    result.pushProcBind = util::call(pushProcBindFunc, {M->getInt(sched->bind)});
   }
   return result;
 }
@@ -1395,11 +1454,114 @@ CollapseResult collapseLoop(BodiedFunc *parent, ImperativeForFlow *v, int64_t le
 
   return res;
 }
+
+/// Rewrites a parallel loop over dict or set iteration -- d.items(),
+/// d.keys(), d.values(), or plain iteration over either container -- into
+/// an imperative loop over the underlying hash-table buckets guarded by
+/// the per-bucket occupancy check. Bucket loops are range loops, so the
+/// regular chunked lowerings partition them across threads; the generator
+/// form would otherwise fall back to a task per element.
+/// @return the replacement loop, or null if the pattern does not apply
+ImperativeForFlow *rewriteHashTableLoop(ForFlow *v, BodiedFunc *parent) {
+  auto *M = v->getModule();
+  auto *sched = v->getSchedule();
+  // pipelines and adaptive scheduling are defined on the element stream
+  if (sched->gpu || sched->spscPipeline || sched->adaptive)
+    return nullptr;
+
+  auto *iterCall = cast<CallInstr>(v->getIter());
+  if (!iterCall || std::distance(iterCall->begin(), iterCall->end()) != 1)
+    return nullptr;
+  auto *fn = util::getFunc(iterCall->getCallee());
+  if (!fn)
+    return nullptr;
+  auto name = fn->getUnmangledName();
+
+  // look through the Generator.__iter__ wrapper if present
+  if (name == "__iter__" && isA<types::GeneratorType>(iterCall->front()->getType())) {
+    iterCall = cast<CallInstr>(iterCall->front());
+    if (!iterCall || std::distance(iterCall->begin(), iterCall->end()) != 1)
+      return nullptr;
+    fn = util::getFunc(iterCall->getCallee());
+    if (!fn)
+      return nullptr;
+    name = fn->getUnmangledName();
+  }
+
+  // require a plain variable so the container is not re-evaluated
+  auto *contVal = cast<VarValue>(iterCall->front());
+  if (!contVal)
+    return nullptr;
+  auto *contVar = contVal->getVar();
+  auto *contType = contVal->getType();
+  bool isDict = contType->getName().rfind(
+                    "std.internal.types.collections.dict.Dict[", 0) == 0;
+  bool isSet =
+      contType->getName().rfind("std.internal.types.collections.set.Set[", 0) == 0;
+
+  bool wantKey = false, wantVal = false;
+  if (isDict && (name == "keys" || name == "__iter__")) {
+    wantKey = true;
+  } else if (isDict && name == "values") {
+    wantVal = true;
+  } else if (isDict && name == "items") {
+    wantKey = wantVal = true;
+  } else if (isSet && name == "__iter__") {
+    wantKey = true;
+  } else {
+    return nullptr;
+  }
+
+  auto *intType = M->getIntType();
+  auto *khEnd = M->getOrRealizeMethod(contType, "_kh_end", {contType});
+  auto *khExist = M->getOrRealizeMethod(contType, "_kh_exist", {contType, intType});
+  auto *khKey =
+      wantKey ? M->getOrRealizeMethod(contType, "_kh_key", {contType, intType})
+              : nullptr;
+  auto *khVal =
+      wantVal ? M->getOrRealizeMethod(contType, "_kh_val", {contType, intType})
+              : nullptr;
+  if (!khEnd || !khExist || (wantKey && !khKey) || (wantVal && !khVal))
+    return nullptr;
+
+  auto *bucketVar = M->Nr<Var>(intType, /*global=*/false);
+  parent->push_back(bucketVar);
+
+  auto elemFrom = [&](Func *accessor) {
+    return util::call(accessor,
+                      {M->Nr<VarValue>(contVar), M->Nr<VarValue>(bucketVar)});
+  };
+  Value *elem = nullptr;
+  if (wantKey && wantVal)
+    elem = util::makeTuple({elemFrom(khKey), elemFrom(khVal)}, M);
+  else
+    elem = elemFrom(wantKey ? khKey : khVal);
+
+  auto *cond = util::call(
+      khExist, {M->Nr<VarValue>(contVar), M->Nr<VarValue>(bucketVar)});
+  auto *ifTrue = util::series(M->Nr<AssignInstr>(v->getVar(), elem), v->getBody());
+  auto *newBody = util::series(M->Nr<IfFlow>(cond, ifTrue));
+
+  auto newSched = std::make_unique<OMPSched>(*sched);
+  newSched->collapse = 0;
+  auto *newLoop = M->Nr<ImperativeForFlow>(
+      M->getInt(0), 1, util::call(khEnd, {M->Nr<VarValue>(contVar)}), newBody,
+      bucketVar, std::move(newSched));
+  v->replaceAll(newLoop);
+  return newLoop;
+}
 } // namespace
 
 const std::string OpenMPPass::KEY = "core-parallel-openmp";
 
 void OpenMPPass::handle(ForFlow *v) {
+  if (v->isParallel()) {
+    if (auto *bucketLoop =
+            rewriteHashTableLoop(v, cast<BodiedFunc>(getParentFunc()))) {
+      handle(bucketLoop);
+      return;
+    }
+  }
   auto data = setupOpenMPTransform(v, cast<BodiedFunc>(getParentFunc()), /*gpu=*/false);
   if (!v->isParallel())
     return;
@@ -1413,6 +1575,9 @@ void OpenMPPass::handle(ForFlow *v) {
   auto *sched = v->getSchedule();
   OMPTypes types(M);
 
+  if (sched->simd)
+    warn("not vectorizing loop: only loops over ranges can be vectorized", v);
+
   // separate arguments into 'private' and 'shared'
   std::vector<Reduction> sharedRedux; // reductions corresponding to shared vars
   std::vector<Value *> privates, shareds;
@@ -1481,8 +1646,16 @@ void OpenMPPass::handle(ForFlow *v) {
       M->getPointerType(
           M->getTupleType({v->getIter()->getType(), privatesTuple->getType(),
                            sharedsTuple->getType()}))};
-  auto *templateFunc = M->getOrRealizeFunc("_task_loop_outline_template",
-                                           templateFuncArgs, {}, ompModule);
+  std::string templateFuncName = "_task_loop_outline_template";
+  if (sched->adaptive) {
+    templateFuncName = "_adaptive_task_loop_outline_template";
+  } else if (sched->spscPipeline && reds.reductions.empty()) {
+    // reductions need the taskgroup machinery, so reducing pipelines
+    // keep per-element tasks
+    templateFuncName = "_pipeline_spsc_outline_template";
+  }
+  auto *templateFunc =
+      M->getOrRealizeFunc(templateFuncName, templateFuncArgs, {}, ompModule);
   seqassertn(templateFunc, "task loop outline template not found");
 
   templateFunc = cv.forceClone(templateFunc);
@@ -1497,12 +1670,32 @@ void OpenMPPass::handle(ForFlow *v) {
   auto forkData = createForkCall(M, types, rawTemplateFunc, forkExtraArgs, sched);
   if (forkData.pushNumThreads)
     insertBefore(forkData.pushNumThreads);
+  if (forkData.pushProcBind)
+    insertBefore(forkData.pushProcBind);
   v->replaceAll(forkData.fork);
 }
 
 void OpenMPPass::handle(ImperativeForFlow *v) {
   auto *parent = cast<BodiedFunc>(getParentFunc());
 
+  if (v->isParallel() && v->getSchedule()->simd) {
+    auto *sched = v->getSchedule();
+    if (sched->threads || sched->gpu || sched->ordered || sched->workStealing ||
+        sched->collapse != 0) {
+      warn("ignoring 'simd' on loop with threading clauses", v);
+      sched->simd = false;
+    } else {
+      // simd loops are not forked onto a team; tag the loop for the LLVM
+      // vectorizer and run it in the enclosing thread. Vectorization
+      // failures are reported through LLVM's missed-transform warnings.
+      v->setAttribute(std::make_unique<KeyValueAttribute>(
+                          std::map<std::string, std::string>{{"simd", "1"}}),
+                      simdLoopAttribute);
+      v->setParallel(false);
+      return;
+    }
+  }
+
   if (v->isParallel() && v->getSchedule()->collapse != 0) {
     auto levels = v->getSchedule()->collapse;
     auto collapse = collapseLoop(parent, v, levels);
@@ -1544,9 +1737,14 @@ void OpenMPPass::handle(ImperativeForFlow *v) {
   }
 
   // template call
+  if (sched->workStealing && sched->ordered)
+    warn("ordered is not supported by the work-stealing schedule; using dynamic", v);
+
   std::string templateFuncName;
   if (sched->gpu) {
     templateFuncName = "_gpu_loop_outline_template";
+  } else if (sched->workStealing && !sched->ordered) {
+    templateFuncName = "_workstealing_loop_outline_template";
   } else if (sched->dynamic) {
     templateFuncName = "_dynamic_loop_outline_template";
   } else if (sched->chunk) {
@@ -1598,6 +1796,31 @@ void OpenMPPass::handle(ImperativeForFlow *v) {
     v->replaceAll(util::call(
         templateFunc, {v->getStart(), v->getEnd(), util::makeTuple(extraArgs, M)}));
   } else {
+    // Hoist the loop bounds so the serial/parallel dispatch below, the
+    // serial clone and the fork all evaluate them exactly once.
+    auto *setup = M->Nr<SeriesFlow>();
+    auto *startVar = util::makeVar(v->getStart(), setup, parent)->getVar();
+    auto *stopVar = util::makeVar(v->getEnd(), setup, parent)->getVar();
+    v->setStart(M->Nr<VarValue>(startVar));
+    v->setEnd(M->Nr<VarValue>(stopVar));
+
+    auto *lenCalc = M->getOrRealizeFunc("_range_len", {types.i64, types.i64, types.i64},
+                                        {}, ompModule);
+    seqassertn(lenCalc, "range length calculation function not found");
+    auto *lenVar =
+        util::makeVar(util::call(lenCalc, {M->Nr<VarValue>(startVar),
+                                           M->Nr<VarValue>(stopVar),
+                                           M->getInt(v->getStep())}),
+                      setup, parent)
+            ->getVar();
+
+    // Keep a serial clone of the (already outlined) loop; the runtime
+    // picks it over the fork when the trip count is too small to pay
+    // for a fork call.
+    util::CloneVisitor scv(M);
+    auto *serialLoop = cast<ImperativeForFlow>(scv.clone(v));
+    serialLoop->setParallel(false);
+
     std::vector<types::Type *> templateFuncArgs = {
         types.i32ptr, types.i32ptr,
         M->getPointerType(M->getTupleType(
@@ -1616,16 +1839,45 @@ void OpenMPPass::handle(ImperativeForFlow *v) {
     auto *chunk = (sched->chunk && sched->chunk->getType()->is(types.i64))
                       ? sched->chunk
                       : M->getInt(1);
-    std::vector<Value *> forkExtraArgs = {chunk, v->getStart(), v->getEnd()};
+    std::vector<Value *> forkExtraArgs = {chunk, M->Nr<VarValue>(startVar),
+                                          M->Nr<VarValue>(stopVar)};
     for (auto *arg : extraArgs) {
       forkExtraArgs.push_back(arg);
     }
 
     // fork call
     auto forkData = createForkCall(M, types, rawTemplateFunc, forkExtraArgs, sched);
+    auto *forkSeries = M->Nr<SeriesFlow>();
     if (forkData.pushNumThreads)
-      insertBefore(forkData.pushNumThreads);
-    v->replaceAll(forkData.fork);
+      forkSeries->push_back(forkData.pushNumThreads);
+    if (forkData.pushProcBind)
+      forkSeries->push_back(forkData.pushProcBind);
+    forkSeries->push_back(forkData.fork);
+
+    // Runtime dispatch: each loop site gets an id so the 'auto' policy
+    // can calibrate per-iteration cost from timed serial executions.
+    static int64_t dispatchSite = 0;
+    auto *shouldFork = M->getOrRealizeFunc("_should_fork", {types.i64, types.i64}, {},
+                                           ompModule);
+    seqassertn(shouldFork, "loop dispatch function not found");
+    auto *timeFunc = M->getOrRealizeFunc("_time_ns", {}, {}, ompModule);
+    seqassertn(timeFunc, "time function not found");
+    auto *recordCost = M->getOrRealizeFunc(
+        "_record_loop_cost", {types.i64, types.i64, types.i64}, {}, ompModule);
+    seqassertn(recordCost, "loop cost recording function not found");
+
+    auto *serialSeries = M->Nr<SeriesFlow>();
+    auto *t0Var = util::makeVar(util::call(timeFunc, {}), serialSeries, parent)->getVar();
+    serialSeries->push_back(serialLoop);
+    serialSeries->push_back(util::call(recordCost, {M->getInt(dispatchSite),
+                                                    M->Nr<VarValue>(lenVar),
+                                                    M->Nr<VarValue>(t0Var)}));
+
+    auto *cond =
+        util::call(shouldFork, {M->getInt(dispatchSite), M->Nr<VarValue>(lenVar)});
+    ++dispatchSite;
+    setup->push_back(M->Nr<IfFlow>(cond, forkSeries, serialSeries));
+    v->replaceAll(setup);
   }
 }
 
@@ -38,10 +38,33 @@ int getScheduleCode(const std::string &schedule = "static", bool chunked = false
     return (ordered ? 69 : 37) | modifier;
   } else if (schedule == "auto") {
     return (ordered ? 70 : 38) | modifier;
+  } else if (schedule == "workstealing") {
+    // no kmpc dispatch code; lowered onto its own outline template
+    return getScheduleCode();
+  } else if (schedule == "adaptive") {
+    // task loops get the adaptive template; imperative loops fall back
+    // to guided dispatch, which also decays chunk sizes over time
+    return getScheduleCode("guided", chunked, ordered, monotonic);
   }
   return getScheduleCode(); // default
 }
 
+int getProcBindCode(const std::string &bind) {
+  // codes from "enum kmp_proc_bind_t" at
+  // https://github.com/llvm/llvm-project/blob/main/openmp/runtime/src/kmp.h
+  if (bind == "false")
+    return 0;
+  else if (bind == "true")
+    return 1;
+  else if (bind == "master" || bind == "primary")
+    return 2;
+  else if (bind == "close")
+    return 3;
+  else if (bind == "spread")
+    return 4;
+  return -1; // none specified
+}
+
 Value *nullIfNeg(Value *v) {
   if (v && util::isConst<int64_t>(v) && util::getConst<int64_t>(v) <= 0)
     return nullptr;
@@ -50,18 +73,22 @@ Value *nullIfNeg(Value *v) {
 } // namespace
 
 OMPSched::OMPSched(int code, bool dynamic, Value *threads, Value *chunk, bool ordered,
-                   int64_t collapse, bool gpu)
+                   int64_t collapse, bool gpu, bool workStealing, bool adaptive,
+                   bool simd, int bind)
     : code(code), dynamic(dynamic), threads(nullIfNeg(threads)),
-      chunk(nullIfNeg(chunk)), ordered(ordered), collapse(collapse), gpu(gpu) {
+      chunk(nullIfNeg(chunk)), ordered(ordered), collapse(collapse), gpu(gpu),
+      workStealing(workStealing), adaptive(adaptive), simd(simd), bind(bind) {
   if (code < 0)
     this->code = getScheduleCode();
 }
 
 OMPSched::OMPSched(const std::string &schedule, Value *threads, Value *chunk,
-                   bool ordered, int64_t collapse, bool gpu)
+                   bool ordered, int64_t collapse, bool gpu, bool simd,
+                   const std::string &procBind)
     : OMPSched(getScheduleCode(schedule, nullIfNeg(chunk) != nullptr, ordered),
                (schedule != "static") || ordered, threads, chunk, ordered, collapse,
-               gpu) {}
+               gpu, schedule == "workstealing", schedule == "adaptive", simd,
+               getProcBindCode(procBind)) {}
 
 std::vector<Value *> OMPSched::getUsedValues() const {
   std::vector<Value *> ret;
@@ -20,16 +20,27 @@ struct OMPSched {
   bool ordered;
   int64_t collapse;
   bool gpu;
+  bool workStealing;
+  bool adaptive;
+  bool simd;
+  /// proc-bind code passed to __kmpc_push_proc_bind, or -1 if none
+  int bind;
+  /// set by pipeline lowering for parallel (||>) stages; not user-accessible
+  bool spscPipeline = false;
 
   explicit OMPSched(int code = -1, bool dynamic = false, Value *threads = nullptr,
                     Value *chunk = nullptr, bool ordered = false, int64_t collapse = 0,
-                    bool gpu = false);
+                    bool gpu = false, bool workStealing = false, bool adaptive = false,
+                    bool simd = false, int bind = -1);
   explicit OMPSched(const std::string &code, Value *threads = nullptr,
                     Value *chunk = nullptr, bool ordered = false, int64_t collapse = 0,
-                    bool gpu = false);
+                    bool gpu = false, bool simd = false,
+                    const std::string &procBind = "");
   OMPSched(const OMPSched &s)
       : code(s.code), dynamic(s.dynamic), threads(s.threads), chunk(s.chunk),
-        ordered(s.ordered), collapse(s.collapse), gpu(s.gpu) {}
+        ordered(s.ordered), collapse(s.collapse), gpu(s.gpu),
+        workStealing(s.workStealing), adaptive(s.adaptive), simd(s.simd),
+        bind(s.bind), spscPipeline(s.spscPipeline) {}
 
   std::vector<Value *> getUsedValues() const;
   int replaceUsedValue(id_t id, Value *newValue);
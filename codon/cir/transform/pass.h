@@ -91,6 +91,89 @@ public:
   }
 };
 
+#define GROUP_HANDLE(x)                                                                \
+  void handle(x *v) override {                                                         \
+    for (auto &p : passes)                                                             \
+      p->handle(v);                                                                    \
+  }
+
+/// Pass that runs several OperatorPasses in a single traversal. The group
+/// walks the module once and dispatches each visited node to every member
+/// pass in registration order; members borrow the group's traversal
+/// context, so parent lookups and insertions behave as in a standalone
+/// run. Members must match independent patterns: a member does not see
+/// rewrites another member performs, and new nodes a member creates are
+/// not revisited within the walk. Patterns that consume each other's
+/// output still need separate passes in pipeline order.
+class OperatorPassGroup : public OperatorPass {
+private:
+  std::string key;
+  std::vector<std::unique_ptr<OperatorPass>> passes;
+
+public:
+  /// Constructs an operator pass group.
+  /// @param key the group's unique key
+  /// @param childrenFirst true if children should be iterated first
+  explicit OperatorPassGroup(std::string key, bool childrenFirst = false)
+      : OperatorPass(childrenFirst), key(std::move(key)) {}
+
+  std::string getKey() const override { return key; }
+
+  void push_back(std::unique_ptr<OperatorPass> p) { passes.push_back(std::move(p)); }
+
+  void setManager(PassManager *mng) override {
+    Pass::setManager(mng);
+    for (auto &p : passes)
+      p->setManager(mng);
+  }
+
+  void run(Module *module) override {
+    reset();
+    for (auto &p : passes) {
+      p->reset();
+      p->setSharedContext(this);
+    }
+    process(module);
+  }
+
+  GROUP_HANDLE(VarValue)
+  GROUP_HANDLE(PointerValue)
+
+  GROUP_HANDLE(SeriesFlow)
+  GROUP_HANDLE(IfFlow)
+  GROUP_HANDLE(WhileFlow)
+  GROUP_HANDLE(ForFlow)
+  GROUP_HANDLE(ImperativeForFlow)
+  GROUP_HANDLE(TryCatchFlow)
+  GROUP_HANDLE(PipelineFlow)
+  GROUP_HANDLE(dsl::CustomFlow)
+
+  GROUP_HANDLE(TemplatedConst<int64_t>)
+  GROUP_HANDLE(TemplatedConst<double>)
+  GROUP_HANDLE(TemplatedConst<bool>)
+  GROUP_HANDLE(TemplatedConst<std::string>)
+  GROUP_HANDLE(dsl::CustomConst)
+
+  GROUP_HANDLE(Instr)
+  GROUP_HANDLE(AssignInstr)
+  GROUP_HANDLE(ExtractInstr)
+  GROUP_HANDLE(InsertInstr)
+  GROUP_HANDLE(CallInstr)
+  GROUP_HANDLE(StackAllocInstr)
+  GROUP_HANDLE(TypePropertyInstr)
+  GROUP_HANDLE(YieldInInstr)
+  GROUP_HANDLE(TernaryInstr)
+  GROUP_HANDLE(BreakInstr)
+  GROUP_HANDLE(ContinueInstr)
+  GROUP_HANDLE(ReturnInstr)
+  GROUP_HANDLE(YieldInstr)
+  GROUP_HANDLE(ThrowInstr)
+  GROUP_HANDLE(FlowInstr)
+  GROUP_HANDLE(dsl::CustomInstr)
+};
+
+#undef GROUP_HANDLE
+
 } // namespace transform
 } // namespace ir
 } // namespace codon
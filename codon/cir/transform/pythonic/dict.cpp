@@ -3,6 +3,7 @@
 #include "dict.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 #include "codon/cir/util/cloning.h"
 #include "codon/cir/util/irtools.h"
@@ -21,8 +22,9 @@ struct GetCall {
   Value *dict = nullptr;
   /// the key, must not be a call
   Value *key = nullptr;
-  /// the default value, may be null
-  Const *dflt = nullptr;
+  /// the default value (a constant or a variable reference, since it is
+  /// cloned into the replacement call), may be null
+  Value *dflt = nullptr;
 };
 
 /// Identify the call and return its metadata.
@@ -50,9 +52,13 @@ GetCall analyzeGet(CallInstr *call) {
   if (isA<CallInstr>(dict) || isA<CallInstr>(k))
     return {};
 
-  // get calls have a default
+  // get calls have a default; it must be a constant or a variable, since the
+  // rewrite clones it (a dropped default would silently become the throwing
+  // variant, and a side-effecting one would be re-evaluated elsewhere)
   if (unmangled == "get" && std::distance(it, call->end()) == 1) {
-    auto *dflt = cast<Const>(*it);
+    auto *dflt = *it;
+    if (!isA<Const>(dflt) && !isA<VarValue>(dflt))
+      return {};
     return {func, dict, k, dflt};
   } else if (unmangled == "__getitem__" && std::distance(it, call->end()) == 0) {
     return {func, dict, k, nullptr};
@@ -61,6 +67,42 @@ GetCall analyzeGet(CallInstr *call) {
   // call is not correct
   return {};
 }
+
+bool isDict(Value *v) {
+  return v->getType()->getName().rfind("std.internal.types.collections.dict.Dict[",
+                                       0) == 0;
+}
+
+/// Returns the tuple element index (0 or 1) if the value extracts that
+/// element of the given variable, -1 otherwise.
+int tupleElement(Value *v, Var *tup) {
+  if (auto *x = cast<ExtractInstr>(v)) {
+    if (auto *vv = cast<VarValue>(x->getVal())) {
+      if (vv->getVar()->getId() == tup->getId()) {
+        if (x->getField() == "item1")
+          return 0;
+        if (x->getField() == "item2")
+          return 1;
+      }
+    }
+  }
+  return -1;
+}
+
+/// Counts references to a set of variables.
+struct VarUseCounter : public util::Operator {
+  std::unordered_set<id_t> vars;
+  int count = 0;
+
+  void handle(VarValue *v) override {
+    if (vars.find(v->getVar()->getId()) != vars.end())
+      ++count;
+  }
+  void handle(PointerValue *v) override {
+    if (vars.find(v->getVar()->getId()) != vars.end())
+      ++count;
+  }
+};
 } // namespace
 
 const std::string DictArithmeticOptimization::KEY = "core-pythonic-dict-arithmetic-opt";
@@ -107,7 +149,11 @@ void DictArithmeticOptimization::handle(CallInstr *v) {
     // second argument can be any non-null value
     auto *secondValue = opCall->back();
 
-    // verify that we are dealing with the same dictionary and key
+    // verify that we are dealing with the same dictionary and key;
+    // fingerprints reject mismatched subtrees without a full comparison
+    if (util::structuralHash(dictValue) != util::structuralHash(getAnalysis.dict) ||
+        util::structuralHash(keyValue) != util::structuralHash(getAnalysis.key))
+      return;
     if (util::match(dictValue, getAnalysis.dict, false, true) &&
         util::match(keyValue, getAnalysis.key, false, true)) {
       util::CloneVisitor cv(M);
@@ -143,6 +189,125 @@ void DictArithmeticOptimization::handle(CallInstr *v) {
   }
 }
 
+void DictArithmeticOptimization::handle(ForFlow *v) {
+  auto *M = v->getModule();
+  if (v->isParallel())
+    return;
+
+  // match `for k, val in src.items(): d[k] = d[k] op val`
+  auto *items = cast<CallInstr>(v->getIter());
+  if (!items || items->numArgs() != 1)
+    return;
+  auto *itemsFunc = util::getFunc(items->getCallee());
+  if (!itemsFunc || itemsFunc->getUnmangledName() != "items")
+    return;
+  auto *srcValue = cast<VarValue>(items->front());
+  if (!srcValue || !isDict(srcValue))
+    return;
+
+  // body is the tuple unpacking followed by the accumulation
+  auto *body = cast<SeriesFlow>(v->getBody());
+  if (!body || std::distance(body->begin(), body->end()) != 3)
+    return;
+  auto it = body->begin();
+  auto *kAssign = cast<AssignInstr>(*it++);
+  auto *valAssign = cast<AssignInstr>(*it++);
+  auto *setCall = cast<CallInstr>(*it++);
+  if (!kAssign || !valAssign || !setCall)
+    return;
+  if (tupleElement(kAssign->getRhs(), v->getVar()) != 0 ||
+      tupleElement(valAssign->getRhs(), v->getVar()) != 1)
+    return;
+  auto *key = kAssign->getLhs();
+  auto *val = valAssign->getLhs();
+
+  auto *setFunc = util::getFunc(setCall->getCallee());
+  if (!setFunc || setFunc->getUnmangledName() != "__setitem__" ||
+      setCall->numArgs() != 3)
+    return;
+  auto sit = setCall->begin();
+  auto *dictValue = cast<VarValue>(*sit++);
+  auto *keyValue = cast<VarValue>(*sit++);
+  auto *opCall = cast<CallInstr>(*sit++);
+  if (!dictValue || !keyValue || !opCall || opCall->numArgs() != 2)
+    return;
+  // merging a dict into itself while iterating it is left alone
+  if (!isDict(dictValue) ||
+      dictValue->getVar()->getId() == srcValue->getVar()->getId())
+    return;
+  if (keyValue->getVar()->getId() != key->getId())
+    return;
+
+  auto *opFunc = util::getFunc(opCall->getCallee());
+  auto *getCall = cast<CallInstr>(opCall->front());
+  auto *operand = cast<VarValue>(opCall->back());
+  if (!opFunc || !getCall || !operand || operand->getVar()->getId() != val->getId())
+    return;
+
+  auto *parentType = opFunc->getParentType();
+  if (!parentType ||
+      !(parentType->is(M->getIntType()) || parentType->is(M->getFloatType())))
+    return;
+
+  auto getAnalysis = analyzeGet(getCall);
+  if (!getAnalysis.func)
+    return;
+  // the default moves out of the loop into the single merge call, so a
+  // variable default must not be one the loop assigns (the loop variable
+  // or the unpacked key/value) — it would be read before its first write
+  if (auto *dfltVar = cast<VarValue>(getAnalysis.dflt)) {
+    auto did = dfltVar->getVar()->getId();
+    if (did == v->getVar()->getId() || did == key->getId() || did == val->getId())
+      return;
+  }
+  auto *getDict = cast<VarValue>(getAnalysis.dict);
+  auto *getKey = cast<VarValue>(getAnalysis.key);
+  if (!getDict || !getKey ||
+      getDict->getVar()->getId() != dictValue->getVar()->getId() ||
+      getKey->getVar()->getId() != key->getId())
+    return;
+
+  // the loop variables must not be read after the loop
+  auto *parent = cast<BodiedFunc>(getParentFunc());
+  if (!parent || !parent->getBody())
+    return;
+  VarUseCounter inLoop;
+  inLoop.vars = {v->getVar()->getId(), key->getId(), val->getId()};
+  inLoop.process(v);
+  VarUseCounter inFunc;
+  inFunc.vars = inLoop.vars;
+  inFunc.process(parent->getBody());
+  if (inFunc.count != inLoop.count)
+    return;
+
+  util::CloneVisitor cv(M);
+  Func *replacementFunc;
+  if (getAnalysis.dflt) {
+    replacementFunc = M->getOrRealizeMethod(
+        dictValue->getType(), "__dict_merge_op__",
+        {dictValue->getType(), srcValue->getType(), getAnalysis.dflt->getType(),
+         opFunc->getType()});
+  } else {
+    replacementFunc = M->getOrRealizeMethod(
+        dictValue->getType(), "__dict_merge_op_throws__",
+        {dictValue->getType(), srcValue->getType(), opFunc->getType()});
+  }
+  if (!replacementFunc)
+    return;
+
+  std::vector<Value *> args = {cv.clone(dictValue), cv.clone(srcValue)};
+  if (getAnalysis.dflt)
+    args.push_back(cv.clone(getAnalysis.dflt));
+
+  // sanity check to make sure function is inlined
+  if (args.size() !=
+      std::distance(replacementFunc->arg_begin(), replacementFunc->arg_end()))
+    args.push_back(M->N<VarValue>(v, opFunc));
+
+  LOG_IR("[{}] merging dict loop: {}", KEY, *setCall);
+  v->replaceAll(util::call(replacementFunc, args));
+}
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
@@ -12,11 +12,15 @@ namespace pythonic {
 /// Pass to optimize calls of form d[x] = func(d[x], any).
 /// This will work on any dictionary-like object that implements _do_op and
 /// _do_op_throws as well as getters.
+/// Loops of form `for k, v in src.items(): d[k] = func(d[k], v)` are
+/// further merged into a single bulk call that walks src's buckets
+/// directly, hashing each key once and skipping the items() generator.
 class DictArithmeticOptimization : public OperatorPass {
 public:
   static const std::string KEY;
   std::string getKey() const override { return KEY; }
   void handle(CallInstr *v) override;
+  void handle(ForFlow *v) override;
 };
 
 } // namespace pythonic
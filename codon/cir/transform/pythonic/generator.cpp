@@ -237,6 +237,198 @@ void GeneratorArgumentOptimization::handle(CallInstr *v) {
   }
 }
 
+namespace {
+/// Collects the yields of a generator body and checks that fusion can
+/// represent them: every yield must carry a value, not be final, and not
+/// sit inside a try/catch, and the generator must not receive values.
+struct YieldCollector : public util::Operator {
+  std::vector<YieldInstr *> yields;
+  bool valid = true;
+
+  void handle(YieldInstr *v) override {
+    if (!v->getValue() || v->isFinal())
+      valid = false;
+    // splicing the consumer body at a yield under a try/catch would run
+    // consumer code inside the generator's handlers — its excepts would
+    // catch the consumer's exceptions, and its finally would run where a
+    // suspended generator's would not
+    if (findLast<TryCatchFlow>())
+      valid = false;
+    yields.push_back(v);
+  }
+  void handle(YieldInInstr *v) override { valid = false; }
+};
+
+/// Retargets breaks and continues that bind to the fused loop. A continue
+/// must resume the generator after its yield and a break must leave the
+/// generator entirely, so both become breaks of the given wrapper loops.
+/// Unlabeled jumps bind to the innermost loop only.
+void retargetJumps(Value *v, id_t loopId, Value *breakTo, Value *continueTo,
+                   bool nested) {
+  if (auto *br = cast<BreakInstr>(v)) {
+    auto *l = br->getLoop();
+    if ((l && l->getId() == loopId) || (!l && !nested))
+      br->replaceAll(v->getModule()->Nr<BreakInstr>(breakTo));
+    return;
+  }
+  if (auto *cn = cast<ContinueInstr>(v)) {
+    auto *l = cn->getLoop();
+    if ((l && l->getId() == loopId) || (!l && !nested))
+      cn->replaceAll(v->getModule()->Nr<BreakInstr>(continueTo));
+    return;
+  }
+  bool childNested =
+      nested || isA<WhileFlow>(v) || isA<ForFlow>(v) || isA<ImperativeForFlow>(v);
+  for (auto *x : v->getUsedValues())
+    retargetJumps(x, loopId, breakTo, continueTo, childNested);
+}
+
+/// Rewrites the inlined generator's returns as breaks out of its wrapper
+/// loop. Must run before the consumer body is spliced in, so the parent
+/// function's own returns are left alone.
+void retargetReturns(Value *v, Value *breakTo) {
+  if (auto *ret = cast<ReturnInstr>(v)) {
+    auto *M = v->getModule();
+    auto *brk = M->Nr<BreakInstr>(breakTo);
+    if (ret->getValue()) {
+      ret->replaceAll(util::series(ret->getValue(), brk));
+    } else {
+      ret->replaceAll(brk);
+    }
+    return;
+  }
+  for (auto *x : v->getUsedValues())
+    retargetReturns(x, breakTo);
+}
+
+/// Counts uses of a variable and remembers the for-loop iterating it,
+/// if any. Taking the variable's address counts as extra uses so such
+/// variables are never forwarded.
+struct UseCounter : public util::Operator {
+  id_t var;
+  int count = 0;
+  ForFlow *iterUse = nullptr;
+
+  explicit UseCounter(id_t var) : var(var) {}
+
+  void handle(VarValue *v) override {
+    if (v->getVar()->getId() == var)
+      ++count;
+  }
+  void handle(PointerValue *v) override {
+    if (v->getVar()->getId() == var)
+      count += 2;
+  }
+  void handle(ForFlow *v) override {
+    if (auto *vv = cast<VarValue>(v->getIter())) {
+      if (vv->getVar()->getId() == var)
+        iterUse = v;
+    }
+  }
+};
+} // namespace
+
+const std::string GeneratorFusionOptimization::KEY =
+    "core-pythonic-generator-fusion-opt";
+
+void GeneratorFusionOptimization::handle(ForFlow *v) {
+  if (v->isParallel())
+    return;
+
+  auto *M = v->getModule();
+  auto *parent = cast<BodiedFunc>(getParentFunc());
+  auto *call = cast<CallInstr>(v->getIter());
+  if (!parent || !call)
+    return;
+
+  auto *gen = cast<BodiedFunc>(util::getFunc(call->getCallee()));
+  if (!gen || !gen->isGenerator() || !gen->getBody() || gen == parent)
+    return;
+
+  YieldCollector check;
+  check.process(gen->getBody());
+  if (!check.valid || check.yields.size() != 1)
+    return;
+  if (!check.yields[0]->getValue()->getType()->is(v->getVar()->getType()))
+    return;
+
+  // bind the generator's arguments in evaluation order
+  auto *fused = M->Nr<SeriesFlow>();
+  std::unordered_map<id_t, Var *> argRemap;
+  std::vector<std::pair<AssignInstr *, Value *>> bindings;
+  auto it = gen->arg_begin();
+  for (auto *arg : *call) {
+    seqassertn(it != gen->arg_end(), "generator call arity mismatch");
+    auto *tmp = M->Nr<Var>(arg->getType());
+    parent->push_back(tmp);
+    auto *assign = M->Nr<AssignInstr>(tmp, arg);
+    fused->push_back(assign);
+    argRemap.emplace((*it)->getId(), tmp);
+    bindings.emplace_back(assign, arg);
+    ++it;
+  }
+
+  util::CloneVisitor cv(M);
+  auto *body = cast<SeriesFlow>(cv.clone(gen->getBody(), parent, argRemap));
+  if (!body)
+    return;
+
+  // the generator body runs once; its returns leave via the wrapper loop
+  auto *outerSeries = M->Nr<SeriesFlow>();
+  auto *outer = M->Nr<WhileFlow>(M->getBool(true), outerSeries);
+  outerSeries->push_back(body);
+  outerSeries->push_back(M->Nr<BreakInstr>(outer));
+  retargetReturns(body, outer);
+
+  YieldCollector collector;
+  collector.process(body);
+  seqassertn(collector.yields.size() == 1, "expected a single yield after cloning");
+  auto *yield = collector.yields[0];
+
+  // splice the consumer body in at the yield; its own wrapper loop gives
+  // continues a target that resumes the generator
+  auto *innerSeries = M->Nr<SeriesFlow>();
+  auto *inner = M->Nr<WhileFlow>(M->getBool(true), innerSeries);
+  retargetJumps(v->getBody(), v->getId(), outer, inner, /*nested=*/false);
+  innerSeries->push_back(M->Nr<AssignInstr>(v->getVar(), yield->getValue()));
+  innerSeries->push_back(v->getBody());
+  innerSeries->push_back(M->Nr<BreakInstr>(inner));
+  yield->replaceAll(inner);
+
+  fused->push_back(outer);
+
+  // Forward a generator argument that the body only iterates directly to
+  // its loop, so chained comprehensions keep fusing. Calling a generator
+  // defers its body, so moving the call is safe as long as the other
+  // bindings cannot observe the reordering (variables and constants).
+  bool othersTrivial = true;
+  for (auto &b : bindings) {
+    if (isA<types::GeneratorType>(b.second->getType()))
+      continue;
+    if (!isA<VarValue>(b.second) && !isA<Const>(b.second))
+      othersTrivial = false;
+  }
+  if (othersTrivial) {
+    for (auto &b : bindings) {
+      auto *argCall = cast<CallInstr>(b.second);
+      if (!argCall || !isA<types::GeneratorType>(argCall->getType()))
+        continue;
+      auto *argGen = cast<BodiedFunc>(util::getFunc(argCall->getCallee()));
+      if (!argGen || !argGen->isGenerator())
+        continue;
+      UseCounter uc(b.first->getLhs()->getId());
+      uc.process(fused);
+      if (uc.count == 1 && uc.iterUse) {
+        uc.iterUse->setIter(argCall);
+        fused->erase(std::find(fused->begin(), fused->end(), b.first));
+      }
+    }
+  }
+
+  LOG_IR("[{}] fusing generator: {}", KEY, *call);
+  v->replaceAll(fused);
+}
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
@@ -19,6 +19,20 @@ public:
   void handle(CallInstr *v) override;
 };
 
+/// Pass to fuse a for-loop that iterates directly over a generator call
+/// into the generator's body, so no coroutine frame is allocated. The
+/// generator body is inlined at the loop site with its yield replaced by
+/// the loop body; breaks, continues and generator returns become jumps
+/// out of small wrapper loops. Only single-yield generators are fused
+/// (comprehensions always have one yield), so the loop body is never
+/// duplicated, and chained comprehensions collapse into one loop nest.
+class GeneratorFusionOptimization : public OperatorPass {
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+  void handle(ForFlow *v) override;
+};
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
@@ -85,6 +85,22 @@ void optimizeWrite(CallInstr *v) {
 
   v->replaceAll(util::call(replacement, args));
 }
+
+/// Returns the file variable if the statement is `f.write(s)` on a plain
+/// file variable with a string argument, null otherwise.
+Var *writeTarget(Value *stmt) {
+  auto *call = cast<CallInstr>(stmt);
+  if (!call || call->numArgs() != 2)
+    return nullptr;
+  auto *func = util::getFunc(call->getCallee());
+  if (!func || func->getUnmangledName() != "write")
+    return nullptr;
+  if (!call->back()->getType()->is(call->getModule()->getStringType()))
+    return nullptr;
+  if (auto *vv = cast<VarValue>(call->front()))
+    return vv->getVar();
+  return nullptr;
+}
 } // namespace
 
 const std::string IOCatOptimization::KEY = "core-pythonic-io-cat-opt";
@@ -98,6 +114,63 @@ void IOCatOptimization::handle(CallInstr *v) {
   }
 }
 
+void IOCatOptimization::handle(SeriesFlow *v) {
+  auto *M = v->getModule();
+
+  auto it = v->begin();
+  while (it != v->end()) {
+    auto *file = writeTarget(*it);
+    if (!file) {
+      ++it;
+      continue;
+    }
+
+    // Collect the run of consecutive writes to this file. Merging evaluates
+    // every piece before the first byte is written, so pieces after the
+    // first must be constants or variable reads: an expression that raises
+    // would leave the file empty where the original had the earlier writes
+    // out, and one that writes the file through an alias would invert the
+    // output order.
+    std::vector<Value *> pieces = {cast<CallInstr>(*it)->back()};
+    auto runEnd = std::next(it);
+    while (runEnd != v->end()) {
+      auto *next = writeTarget(*runEnd);
+      if (!next || next->getId() != file->getId())
+        break;
+      auto *piece = cast<CallInstr>(*runEnd)->back();
+      if (!isA<Const>(piece) && !isA<VarValue>(piece))
+        break;
+      pieces.push_back(piece);
+      ++runEnd;
+    }
+
+    if (pieces.size() < 2) {
+      it = runEnd;
+      continue;
+    }
+
+    auto *first = cast<CallInstr>(*it);
+    auto *fileVal = first->front();
+    util::CloneVisitor cv(M);
+    for (auto *&p : pieces)
+      p = cv.clone(p);
+    auto *strs = util::makeTuple(pieces, M);
+
+    auto *fn = M->getOrRealizeMethod(fileVal->getType(), "__file_write_vec__",
+                                     {fileVal->getType(), strs->getType()});
+    if (!fn) {
+      it = runEnd;
+      continue;
+    }
+
+    LOG_IR("[{}] merging {} writes: {}", KEY, pieces.size(), *first);
+    first->replaceAll(util::call(fn, {cv.clone(fileVal), strs}));
+    it = std::next(it);
+    while (it != runEnd)
+      it = v->erase(it);
+  }
+}
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
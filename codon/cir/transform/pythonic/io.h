@@ -10,11 +10,14 @@ namespace transform {
 namespace pythonic {
 
 /// Pass to optimize print str.cat(...) or file.write(str.cat(...)).
+/// Also coalesces runs of consecutive writes to the same file into one
+/// vectored write, which the runtime gathers into a single buffer.
 class IOCatOptimization : public OperatorPass {
 public:
   static const std::string KEY;
   std::string getKey() const override { return KEY; }
   void handle(CallInstr *v) override;
+  void handle(SeriesFlow *v) override;
 };
 
 } // namespace pythonic
@@ -265,6 +265,102 @@ void ListAdditionOptimization::handle(CallInstr *v) {
     v->replaceAll(opt);
 }
 
+namespace {
+/// Finds the no-argument List.__init__ call whose result is the assigned
+/// value. Only the top-level constructor counts: an empty-list literal
+/// nested deeper in the right-hand side (e.g. `l = [[]]`) constructs a
+/// different list than the one the loop appends to.
+CallInstr *findEmptyInit(Value *v) {
+  while (auto *fi = cast<FlowInstr>(v))
+    v = fi->getValue();
+
+  if (auto *c = cast<CallInstr>(v)) {
+    auto *func = util::getFunc(c->getCallee());
+    if (func && func->getUnmangledName() == Module::INIT_MAGIC_NAME &&
+        c->numArgs() == 1 && isList(c->front()))
+      return c;
+  }
+  return nullptr;
+}
+
+/// Counts appends to a given list anywhere in a loop body.
+struct AppendCounter : public util::Operator {
+  Var *list;
+  int64_t count = 0;
+
+  explicit AppendCounter(Var *list) : list(list) {}
+
+  void handle(CallInstr *v) override {
+    auto *func = util::getFunc(v->getCallee());
+    if (func && func->getUnmangledName() == "append" && v->numArgs() == 2) {
+      if (auto *vv = cast<VarValue>(v->front())) {
+        if (vv->getVar()->getId() == list->getId())
+          ++count;
+      }
+    }
+  }
+};
+
+/// Loop bounds must be cheaply re-evaluable at the construction site.
+bool okBound(Value *v) { return isA<IntConst>(v) || isA<VarValue>(v); }
+} // namespace
+
+const std::string ListPreallocationOptimization::KEY =
+    "core-pythonic-list-prealloc-opt";
+
+void ListPreallocationOptimization::handle(SeriesFlow *v) {
+  auto *M = v->getModule();
+
+  for (auto it = v->begin(); it != v->end(); ++it) {
+    auto next = std::next(it);
+    if (next == v->end())
+      break;
+
+    // look for `l = List()` immediately followed by a range loop over l
+    auto *assign = cast<AssignInstr>(*it);
+    auto *loop = cast<ImperativeForFlow>(*next);
+    if (!assign || !loop)
+      continue;
+    auto *init = findEmptyInit(assign->getRhs());
+    if (!init)
+      continue;
+
+    auto step = loop->getStep();
+    if (step == 0 || !okBound(loop->getStart()) || !okBound(loop->getEnd()))
+      continue;
+
+    AppendCounter counter(assign->getLhs());
+    counter.process(loop->getBody());
+    if (counter.count == 0)
+      continue;
+
+    auto *selfArg = init->front();
+    auto *listType = selfArg->getType();
+    auto *fn = M->getOrRealizeMethod(listType, Module::INIT_MAGIC_NAME,
+                                     {listType, M->getIntType()});
+    if (!fn)
+      continue;
+
+    // trip count rounds up; a negative value is clamped to zero by the
+    // capacity constructor
+    util::CloneVisitor cv(M);
+    Value *trip;
+    if (step > 0) {
+      trip = *(*(*cv.clone(loop->getEnd()) - *cv.clone(loop->getStart())) +
+               *M->getInt(step - 1)) /
+             *M->getInt(step);
+    } else {
+      trip = *(*(*cv.clone(loop->getStart()) - *cv.clone(loop->getEnd())) +
+               *M->getInt(-step - 1)) /
+             *M->getInt(-step);
+    }
+    Value *capacity = *M->getInt(counter.count) * *trip;
+
+    LOG_IR("[{}] pre-allocating: {}", KEY, *init);
+    init->replaceAll(util::call(fn, {cv.clone(selfArg), capacity}));
+  }
+}
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
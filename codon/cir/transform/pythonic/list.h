@@ -18,6 +18,20 @@ public:
   void handle(CallInstr *v) override;
 };
 
+/// Pass to pre-allocate lists filled by range loops. A fresh list
+/// construction immediately followed by an `ImperativeForFlow` that appends
+/// to it is rewritten to construct with a capacity derived from the loop's
+/// bounds and the number of appends per iteration, avoiding the repeated
+/// doubling reallocations of `append`. The capacity is only a reservation,
+/// so a conservative estimate never changes behavior. Runs after
+/// imperative-for lowering so `range` loops are visible.
+class ListPreallocationOptimization : public OperatorPass {
+public:
+  static const std::string KEY;
+  std::string getKey() const override { return KEY; }
+  void handle(SeriesFlow *v) override;
+};
+
 } // namespace pythonic
 } // namespace transform
 } // namespace ir
@@ -14,6 +14,7 @@ namespace pythonic {
 namespace {
 struct InspectionResult {
   bool valid = true;
+  bool expanded = false;
   std::vector<Value *> args;
 };
 
@@ -22,6 +23,34 @@ bool isString(Value *v) {
   return v->getType()->is(M->getStringType());
 }
 
+/// Returns the pieces of a `str.cat(tuple)` call (the form f-strings and
+/// this pass itself produce), or empty if `v` is not one.
+std::vector<Value *> catElements(Value *v) {
+  auto *M = v->getModule();
+  auto *c = cast<CallInstr>(v);
+  if (!c || c->numArgs() != 1 || !isString(v))
+    return {};
+  auto *func = util::getFunc(c->getCallee());
+  if (!func || func->getUnmangledName() != "cat")
+    return {};
+  auto *realCat =
+      M->getOrRealizeMethod(M->getStringType(), "cat", {c->front()->getType()});
+  if (!realCat || realCat->getId() != func->getId())
+    return {};
+
+  auto *tup = cast<CallInstr>(c->front());
+  if (!tup)
+    return {};
+  auto *tupFunc = util::getFunc(tup->getCallee());
+  if (!tupFunc || tupFunc->getUnmangledName() != Module::NEW_MAGIC_NAME)
+    return {};
+
+  std::vector<Value *> elements(tup->begin(), tup->end());
+  if (elements.empty() || !std::all_of(elements.begin(), elements.end(), isString))
+    return {};
+  return elements;
+}
+
 void inspect(Value *v, InspectionResult &r) {
   // check if add first then go from there
   if (isString(v)) {
@@ -34,40 +63,113 @@ void inspect(Value *v, InspectionResult &r) {
         return;
       }
     }
+
+    // nested cats (e.g. concatenated f-strings) contribute their pieces
+    // directly, avoiding the intermediate string
+    auto elements = catElements(v);
+    if (!elements.empty()) {
+      r.expanded = true;
+      for (auto *e : elements)
+        inspect(e, r);
+      return;
+    }
+
     r.args.push_back(v);
   } else {
     r.valid = false;
   }
 }
+
+void rewriteToCat(CallInstr *v, const std::vector<Value *> &pieces) {
+  auto *M = v->getModule();
+  std::vector<Value *> args;
+  util::CloneVisitor cv(M);
+
+  for (auto *arg : pieces) {
+    args.push_back(cv.clone(arg));
+  }
+
+  auto *arg = util::makeTuple(args, M);
+  auto *replacementFunc =
+      M->getOrRealizeMethod(M->getStringType(), "cat", {arg->getType()});
+  seqassertn(replacementFunc, "could not find cat function [{}]", v->getSrcInfo());
+  v->replaceAll(util::call(replacementFunc, {arg}));
+}
 } // namespace
 
 const std::string StrAdditionOptimization::KEY = "core-pythonic-str-addition-opt";
 
 void StrAdditionOptimization::handle(CallInstr *v) {
-  auto *M = v->getModule();
-
   auto *f = util::getFunc(v->getCallee());
-  if (!f || f->getUnmangledName() != Module::ADD_MAGIC_NAME)
+  if (!f)
     return;
 
-  InspectionResult r;
-  inspect(v, r);
+  if (f->getUnmangledName() == Module::ADD_MAGIC_NAME) {
+    InspectionResult r;
+    inspect(v, r);
+    if (r.valid && (r.args.size() > 2 || (r.expanded && r.args.size() > 1)))
+      rewriteToCat(v, r.args);
+  } else if (f->getUnmangledName() == "cat") {
+    // flatten cats of cats so the whole string is assembled once
+    auto elements = catElements(v);
+    if (elements.empty())
+      return;
+    InspectionResult r;
+    for (auto *e : elements)
+      inspect(e, r);
+    if (r.valid && (r.expanded || r.args.size() != elements.size()))
+      rewriteToCat(v, r.args);
+  } else if (f->getUnmangledName() == "join") {
+    optimizeJoin(v);
+  }
+}
 
-  if (r.valid && r.args.size() > 2) {
-    std::vector<Value *> args;
-    util::CloneVisitor cv(M);
+void StrAdditionOptimization::optimizeJoin(CallInstr *v) {
+  auto *M = v->getModule();
+  auto *parent = cast<BodiedFunc>(getParentFunc());
+  if (!parent || v->numArgs() != 2 || !isString(v->front()))
+    return;
 
-    for (auto *arg : r.args) {
-      args.push_back(cv.clone(arg));
-    }
+  // A join over a generator call appends into a growing buffer. Gather the
+  // pieces into a list instead and use the two-pass list join, which sizes
+  // the result exactly and writes each piece once; the loop over the
+  // generator call is then fused by the generator fusion pass.
+  auto *gen = cast<CallInstr>(v->back());
+  if (!gen)
+    return;
+  auto *genType = cast<types::GeneratorType>(gen->getType());
+  if (!genType || !genType->getBase()->is(M->getStringType()))
+    return;
+  auto *genFunc = cast<BodiedFunc>(util::getFunc(gen->getCallee()));
+  if (!genFunc || !genFunc->isGenerator())
+    return;
 
-    auto *arg = util::makeTuple(args, M);
-    args = {arg};
-    auto *replacementFunc =
-        M->getOrRealizeMethod(M->getStringType(), "cat", {arg->getType()});
-    seqassertn(replacementFunc, "could not find cat function [{}]", v->getSrcInfo());
-    v->replaceAll(util::call(replacementFunc, args));
-  }
+  auto *listType = M->getOrRealizeType("List", {M->getStringType()});
+  if (!listType)
+    return;
+  auto *newFn =
+      M->getOrRealizeMethod(listType, "_list_add_opt_opt_new", {M->getIntType()});
+  auto *appendFn =
+      M->getOrRealizeMethod(listType, "append", {listType, M->getStringType()});
+  auto *joinFn = M->getOrRealizeMethod(M->getStringType(), "join",
+                                       {M->getStringType(), listType});
+  if (!newFn || !appendFn || !joinFn)
+    return;
+
+  util::CloneVisitor cv(M);
+  auto *series = M->Nr<SeriesFlow>();
+  auto *sep = util::makeVar(cv.clone(v->front()), series, parent)->getVar();
+  auto *parts =
+      util::makeVar(util::call(newFn, {M->getInt(0)}), series, parent)->getVar();
+  auto *x = M->Nr<Var>(M->getStringType());
+  parent->push_back(x);
+  auto *body = util::series(
+      util::call(appendFn, {M->Nr<VarValue>(parts), M->Nr<VarValue>(x)}));
+  series->push_back(M->Nr<ForFlow>(cv.clone(gen), body, x));
+
+  LOG_IR("[{}] materializing join pieces: {}", KEY, *v);
+  v->replaceAll(M->Nr<FlowInstr>(
+      series, util::call(joinFn, {M->Nr<VarValue>(sep), M->Nr<VarValue>(parts)})));
 }
 
 } // namespace pythonic
@@ -10,11 +10,17 @@ namespace transform {
 namespace pythonic {
 
 /// Pass to optimize str1 + str2 + ...
+/// Nested `str.cat` calls (the form f-strings lower to) are flattened into
+/// one cat so the final string is assembled in a single allocation, and
+/// joins over generator calls are turned into two-pass list joins.
 class StrAdditionOptimization : public OperatorPass {
 public:
   static const std::string KEY;
   std::string getKey() const override { return KEY; }
   void handle(CallInstr *v) override;
+
+private:
+  void optimizeJoin(CallInstr *v);
 };
 
 } // namespace pythonic
@@ -47,10 +47,16 @@ Value *CloneVisitor::clone(const Value *other, BodiedFunc *cloneTo,
   }
 
   auto id = other->getId();
-  if (ctx.find(id) == ctx.end()) {
+  if (!ctx.contains(id)) {
     other->accept(*this);
     ctx[id] = result;
 
+    for (auto slot = 0; slot < NUM_ATTRIBUTE_SLOTS; ++slot) {
+      if (const auto *attr = other->getAttribute(slot)) {
+        if (attr->needsClone())
+          ctx[id]->setAttribute(attr->clone(*this), slot);
+      }
+    }
     for (auto it = other->attributes_begin(); it != other->attributes_end(); ++it) {
       const auto *attr = other->getAttribute(*it);
       if (attr->needsClone()) {
@@ -64,9 +70,8 @@ Value *CloneVisitor::clone(const Value *other, BodiedFunc *cloneTo,
 Var *CloneVisitor::clone(const Var *other) {
   if (!other)
     return nullptr;
-  auto id = other->getId();
-  if (ctx.find(id) != ctx.end())
-    return cast<Var>(ctx[id]);
+  if (auto *cloned = ctx.find(other->getId()))
+    return cast<Var>(*cloned);
 
   return const_cast<Var *>(other);
 }
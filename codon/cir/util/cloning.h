@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include "codon/cir/cir.h"
+#include "codon/cir/util/id_map.h"
 #include "codon/cir/util/visitor.h"
 
 namespace codon {
@@ -12,9 +13,9 @@ namespace ir {
 namespace util {
 
 class CloneVisitor : public ConstVisitor {
-private:
-  /// the clone context
-  std::unordered_map<int, Node *> ctx;
+protected:
+  /// the clone context; node IDs are dense, so use an ID-indexed table
+  IdMap<Node *> ctx;
   /// the result
   Node *result;
   /// the module
@@ -101,10 +102,16 @@ public:
       return nullptr;
 
     auto id = other->getId();
-    if (ctx.find(id) == ctx.end()) {
+    if (!ctx.contains(id)) {
       other->accept(*this);
       ctx[id] = result;
 
+      for (auto slot = 0; slot < NUM_ATTRIBUTE_SLOTS; ++slot) {
+        if (const auto *attr = other->getAttribute(slot)) {
+          if (attr->needsClone())
+            ctx[id]->setAttribute(attr->forceClone(*this), slot);
+        }
+      }
       for (auto it = other->attributes_begin(); it != other->attributes_end(); ++it) {
         const auto *attr = other->getAttribute(*it);
         if (attr->needsClone()) {
@@ -0,0 +1,99 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace codon {
+namespace ir {
+namespace util {
+
+/// Dense ID-indexed side table, the standard CIR mapping primitive for
+/// node-keyed data. CIR node IDs are assigned monotonically, so lookups are
+/// plain array indexing into lazily allocated fixed-size pages instead of
+/// hashing; sparse ID ranges only pay for the pages they touch. Intended as a
+/// drop-in replacement for std::unordered_map<id_t, V> in cloning and
+/// analysis results.
+template <typename V> class IdMap {
+  static constexpr size_t PAGE_BITS = 10;
+  static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+  struct Page {
+    std::array<V, PAGE_SIZE> slots{};
+    std::bitset<PAGE_SIZE> used;
+  };
+
+  std::vector<std::unique_ptr<Page>> pages;
+  size_t count = 0;
+
+  Page *getPage(int64_t id, bool create) {
+    auto p = size_t(id) >> PAGE_BITS;
+    if (p >= pages.size()) {
+      if (!create)
+        return nullptr;
+      pages.resize(p + 1);
+    }
+    if (!pages[p]) {
+      if (!create)
+        return nullptr;
+      pages[p] = std::make_unique<Page>();
+    }
+    return pages[p].get();
+  }
+
+public:
+  IdMap() = default;
+
+  /// @return the number of stored entries
+  size_t size() const { return count; }
+  /// @return true if the table is empty
+  bool empty() const { return count == 0; }
+
+  /// @return a pointer to the value stored under the given ID, or null if none
+  V *find(int64_t id) {
+    auto *page = getPage(id, /*create=*/false);
+    auto slot = size_t(id) & (PAGE_SIZE - 1);
+    return page && page->used[slot] ? &page->slots[slot] : nullptr;
+  }
+  const V *find(int64_t id) const { return const_cast<IdMap *>(this)->find(id); }
+
+  /// @return true if the table contains the given ID
+  bool contains(int64_t id) const { return find(id) != nullptr; }
+
+  /// @return a reference to the value stored under the given ID, inserting a
+  ///         default-constructed value if none
+  V &operator[](int64_t id) {
+    auto *page = getPage(id, /*create=*/true);
+    auto slot = size_t(id) & (PAGE_SIZE - 1);
+    if (!page->used[slot]) {
+      page->used[slot] = true;
+      ++count;
+    }
+    return page->slots[slot];
+  }
+
+  /// Removes the entry stored under the given ID, if any.
+  void erase(int64_t id) {
+    auto *page = getPage(id, /*create=*/false);
+    auto slot = size_t(id) & (PAGE_SIZE - 1);
+    if (page && page->used[slot]) {
+      page->used[slot] = false;
+      page->slots[slot] = V();
+      --count;
+    }
+  }
+
+  /// Removes all entries.
+  void clear() {
+    pages.clear();
+    count = 0;
+  }
+};
+
+} // namespace util
+} // namespace ir
+} // namespace codon
@@ -3,10 +3,12 @@
 #include "inlining.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 #include "codon/cir/util/cloning.h"
 #include "codon/cir/util/irtools.h"
 #include "codon/cir/util/operator.h"
+#include "codon/cir/util/outlining.h"
 
 namespace codon {
 namespace ir {
@@ -43,27 +45,58 @@ public:
   }
 };
 
-class ReturnReplacer : public util::Operator {
+/// Clone visitor that rewrites returns as it copies, so the callee body is
+/// walked once and return-value subtrees are materialized directly in their
+/// rewritten form instead of being cloned and then lazily replaced.
+class InlineCloneVisitor : public util::CloneVisitor {
 private:
   Value *implicitLoop;
   Var *var;
-  bool aggressive;
-  util::CloneVisitor &cv;
+  bool insertBreak;
 
 public:
-  ReturnReplacer(Value *implicitLoop, Var *var, bool aggressive, util::CloneVisitor &cv)
-      : implicitLoop(implicitLoop), var(var), aggressive(aggressive), cv(cv) {}
+  InlineCloneVisitor(Module *module, Value *implicitLoop, Var *var, bool insertBreak)
+      : util::CloneVisitor(module), implicitLoop(implicitLoop), var(var),
+        insertBreak(insertBreak) {}
 
-  void handle(ReturnInstr *v) {
-    auto *M = v->getModule();
+  void visit(const ReturnInstr *v) override {
+    auto *M = module;
     auto *rep = M->N<SeriesFlow>(v);
     if (var) {
-      rep->push_back(M->N<AssignInstr>(v, var, cv.clone(v->getValue())));
+      rep->push_back(M->N<AssignInstr>(v, var, clone(v->getValue())));
     }
-    if (aggressive)
+    if (insertBreak)
       rep->push_back(M->N<BreakInstr>(v, implicitLoop));
+    result = rep;
+  }
+};
+
+/// Collects throw-dominated series: any series flow other than the body
+/// itself that ends in a ThrowInstr only ever runs on the way to an
+/// exception. Series nested inside an already-collected cold region are
+/// skipped so each region is outlined exactly once, outermost first.
+class ColdRegionCollector : public util::Operator {
+private:
+  Flow *body;
+  std::unordered_set<id_t> coldIds;
+
+public:
+  std::vector<SeriesFlow *> cold;
 
-    v->replaceAll(rep);
+  explicit ColdRegionCollector(Flow *body) : util::Operator(), body(body) {}
+
+  void handle(SeriesFlow *v) override {
+    if (v->getId() == body->getId() || v->begin() == v->end() ||
+        !isA<ThrowInstr>(v->back()))
+      return;
+    for (auto it = parent_begin(); it != parent_end(); ++it) {
+      if (auto *p = cast<Value>(*it)) {
+        if (coldIds.find(p->getId()) != coldIds.end())
+          return;
+      }
+    }
+    coldIds.insert(v->getId());
+    cold.push_back(v);
   }
 };
 
@@ -79,7 +112,27 @@ InlineResult inlineFunction(Func *func, std::vector<Value *> args, bool aggressi
     return {nullptr, {}};
   auto *M = bodied->getModule();
 
-  util::CloneVisitor cv(M);
+  // decide up front whether the body's returns force an implicit loop; this
+  // runs on the original body so bailing out does not pay for a clone
+  ReturnVerifier rv;
+  rv.process(bodied->getBody());
+
+  if (!aggressive && rv.needLoop)
+    return {nullptr, {}};
+
+  Var *retVal = nullptr;
+  if (!fType->getReturnType()->is(M->getVoidType()) &&
+      !fType->getReturnType()->is(M->getNoneType())) {
+    retVal = M->N<Var>(info, fType->getReturnType());
+  }
+
+  WhileFlow *implicit = nullptr;
+  if (rv.needLoop) {
+    auto *loopBody = M->N<SeriesFlow>(info);
+    implicit = M->N<WhileFlow>(info, M->getBool(true), loopBody);
+  }
+
+  InlineCloneVisitor cv(M, implicit, retVal, rv.needLoop);
   auto *newFlow = M->N<SeriesFlow>(info, bodied->getName() + "_inlined");
 
   std::vector<Var *> newVars;
@@ -91,33 +144,18 @@ InlineResult inlineFunction(Func *func, std::vector<Value *> args, bool aggressi
   for (auto *v : *bodied) {
     newVars.push_back(cv.forceClone(v));
   }
-  Var *retVal = nullptr;
-  if (!fType->getReturnType()->is(M->getVoidType()) &&
-      !fType->getReturnType()->is(M->getNoneType())) {
-    retVal = M->N<Var>(info, fType->getReturnType());
+  if (retVal)
     newVars.push_back(retVal);
-  }
 
   Flow *clonedBody = cv.clone(bodied->getBody());
 
-  ReturnVerifier rv;
-  rv.process(clonedBody);
-
-  if (!aggressive && rv.needLoop)
-    return {nullptr, {}};
-
-  WhileFlow *implicit = nullptr;
-  if (rv.needLoop) {
-    auto *loopBody = M->N<SeriesFlow>(info);
-    implicit = M->N<WhileFlow>(info, M->getBool(true), loopBody);
+  if (implicit) {
+    auto *loopBody = cast<SeriesFlow>(implicit->getBody());
     loopBody->push_back(clonedBody);
     if (!retVal)
       loopBody->push_back(M->N<BreakInstr>(info, implicit));
   }
 
-  ReturnReplacer rr(implicit, retVal, rv.needLoop, cv);
-  rr.process(clonedBody);
-
   newFlow->push_back(implicit ? implicit : clonedBody);
 
   if (retVal) {
@@ -133,6 +171,37 @@ InlineResult inlineCall(CallInstr *v, bool aggressive) {
                         v->getSrcInfo());
 }
 
+int outlineColdRegions(BodiedFunc *func) {
+  if (!func || func->isGenerator())
+    return 0;
+  auto *body = cast<SeriesFlow>(func->getBody());
+  if (!body)
+    return 0;
+
+  ColdRegionCollector collector(body);
+  collector.process(func);
+
+  int num = 0;
+  for (auto *series : collector.cold) {
+    if (outlineRegion(func, series))
+      ++num;
+  }
+  return num;
+}
+
+InlineResult partialInlineFunction(Func *func, std::vector<Value *> args,
+                                   bool aggressive, codon::SrcInfo info) {
+  if (auto *bodied = cast<BodiedFunc>(func))
+    outlineColdRegions(bodied);
+  return inlineFunction(func, std::move(args), aggressive, info);
+}
+
+InlineResult partialInlineCall(CallInstr *v, bool aggressive) {
+  return partialInlineFunction(util::getFunc(v->getCallee()),
+                               std::vector<Value *>(v->begin(), v->end()),
+                               aggressive, v->getSrcInfo());
+}
+
 } // namespace util
 } // namespace ir
 } // namespace codon
@@ -33,6 +33,33 @@ InlineResult inlineFunction(Func *func, std::vector<Value *> args,
 /// @return the inlined result, nullptr if unsuccessful
 InlineResult inlineCall(CallInstr *v, bool aggressive = false);
 
+/// Outlines the function's cold regions -- branch series that end in a
+/// throw, which can only run on the way to an exception -- into separate
+/// functions, leaving calls in their place. The function is modified in
+/// place; the shrunken hot residue is what subsequent inlining operates on.
+/// @param func the function
+/// @return the number of regions outlined
+int outlineColdRegions(BodiedFunc *func);
+
+/// Partially inline the given function: its cold throw-dominated regions
+/// are first split off with `outlineColdRegions`, then the hot residue is
+/// inlined as usual. Note that the split modifies the callee itself, so
+/// every call site shares the outlined cold paths.
+/// @param func the function
+/// @param args the arguments
+/// @param aggressive true if should inline complex functions
+/// @param callInfo the call information
+/// @return the inlined result, nullptr if unsuccessful
+InlineResult partialInlineFunction(Func *func, std::vector<Value *> args,
+                                   bool aggressive = false,
+                                   codon::SrcInfo callInfo = {});
+
+/// Partially inline the given call.
+/// @param v the instruction
+/// @param aggressive true if should inline complex functions
+/// @return the inlined result, nullptr if unsuccessful
+InlineResult partialInlineCall(CallInstr *v, bool aggressive = false);
+
 } // namespace util
 } // namespace ir
 } // namespace codon
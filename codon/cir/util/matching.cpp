@@ -3,8 +3,12 @@
 #include "matching.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <typeinfo>
+#include <unordered_map>
 
 #include "codon/cir/cir.h"
+#include "codon/cir/util/operator.h"
 #include "codon/cir/util/visitor.h"
 
 #define VISIT(x)                                                                       \
@@ -26,6 +30,13 @@ namespace codon {
 namespace ir {
 namespace util {
 namespace {
+/// One-to-one variable mapping built up while comparing two functions,
+/// shared across the recursive sub-visitors of a single comparison.
+struct VarBijection {
+  std::unordered_map<id_t, id_t> fwd;
+  std::unordered_map<id_t, id_t> rev;
+};
+
 class MatchVisitor : public util::ConstVisitor {
 private:
   bool matchAny = false;
@@ -34,10 +45,12 @@ private:
   bool result = false;
   const Node *other = nullptr;
   bool varIdMatch;
+  VarBijection *bijection;
 
 public:
-  explicit MatchVisitor(bool checkName = false, bool varIdMatch = false)
-      : checkName(checkName), varIdMatch(varIdMatch) {}
+  explicit MatchVisitor(bool checkName = false, bool varIdMatch = false,
+                        VarBijection *bijection = nullptr)
+      : checkName(checkName), varIdMatch(varIdMatch), bijection(bijection) {}
 
   VISIT(Var);
   void handle(const Var *x, const Var *y) { result = compareVars(x, y); }
@@ -242,7 +255,7 @@ public:
     if (tx || ty)
       return tx && ty && tx->is(const_cast<types::Type *>(ty));
 
-    MatchVisitor v(checkName);
+    MatchVisitor v(checkName, /*varIdMatch=*/false, bijection);
     x->accept(v);
     y->accept(v);
 
@@ -251,8 +264,25 @@ public:
 
 private:
   bool compareVars(const Var *x, const Var *y) const {
-    return process(x->getType(), y->getType()) &&
-           (!varIdMatch || x->getId() == y->getId());
+    if (!process(x->getType(), y->getType()))
+      return false;
+    if (varIdMatch && x->getId() != y->getId())
+      return false;
+    if (bijection) {
+      // Pair variables as they are encountered; once paired, each must
+      // always map to the other. Globals (including functions) are never
+      // paired implicitly -- they must be the very same variable.
+      auto f = bijection->fwd.find(x->getId());
+      auto r = bijection->rev.find(y->getId());
+      if (f != bijection->fwd.end() || r != bijection->rev.end())
+        return f != bijection->fwd.end() && r != bijection->rev.end() &&
+               f->second == y->getId();
+      if (x->isGlobal() || y->isGlobal())
+        return x->getId() == y->getId();
+      bijection->fwd.emplace(x->getId(), y->getId());
+      bijection->rev.emplace(y->getId(), x->getId());
+    }
+    return true;
   }
 
   bool compareFuncs(const Func *x, const Func *y) const {
@@ -280,6 +310,54 @@ bool match(Node *a, Node *b, bool checkNames, bool varIdMatch) {
   return MatchVisitor(checkNames).process(a, b);
 }
 
+bool matchFuncsInterchangeable(BodiedFunc *a, BodiedFunc *b) {
+  if (a == b)
+    return true;
+  // Seed the mapping with the functions themselves so self-references
+  // (and the functions being globals) do not fail the comparison.
+  VarBijection bijection;
+  bijection.fwd.emplace(a->getId(), b->getId());
+  bijection.rev.emplace(b->getId(), a->getId());
+  return MatchVisitor(/*checkName=*/false, /*varIdMatch=*/false, &bijection)
+      .process(a, b);
+}
+
+namespace {
+/// Hashes only features that util::match requires to be equal: node class,
+/// name, constant values and used-variable types. Variable IDs are excluded
+/// since match may succeed across different variables.
+struct StructuralHashVisitor : public Operator {
+  uint64_t hash = 14695981039346656037ULL;
+
+  void preHook(Node *node) override {
+    combine(typeid(*node).hash_code());
+    combine(std::hash<std::string>()(node->getName()));
+    if (auto *c = cast<IntConst>(node)) {
+      combine(uint64_t(c->getVal()));
+    } else if (auto *c = cast<FloatConst>(node)) {
+      combine(std::hash<double>()(c->getVal()));
+    } else if (auto *c = cast<BoolConst>(node)) {
+      combine(uint64_t(c->getVal()));
+    } else if (auto *c = cast<StringConst>(node)) {
+      combine(std::hash<std::string>()(c->getVal()));
+    }
+    for (auto *var : node->getUsedVariables())
+      combine(std::hash<std::string>()(var->getType()->getName()));
+  }
+
+  void combine(uint64_t v) { hash = (hash ^ v) * 1099511628211ULL; }
+};
+} // namespace
+
+uint64_t structuralHash(const Node *node) {
+  StructuralHashVisitor v;
+  if (auto *value = cast<Value>(const_cast<Node *>(node)))
+    v.process(value);
+  else
+    const_cast<Node *>(node)->accept(v);
+  return v.hash;
+}
+
 } // namespace util
 } // namespace ir
 } // namespace codon
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "codon/cir/cir.h"
 
 namespace codon {
@@ -52,6 +54,27 @@ public:
 /// @return true if the nodes are equal
 bool match(Node *a, Node *b, bool checkNames = false, bool varIdMatch = false);
 
+/// Checks if two bodied functions are interchangeable: their types match
+/// and their bodies are structurally identical with arguments and locals
+/// paired one-to-one as they are encountered, while referenced globals
+/// (including called functions) must be the very same. Unlike match, which
+/// compares variables by type only, a true result here means every call to
+/// one function can be redirected to the other.
+/// @param a the first function
+/// @param b the second function
+/// @return true if the functions are interchangeable
+bool matchFuncsInterchangeable(BodiedFunc *a, BodiedFunc *b);
+
+/// Computes a structural fingerprint of a node in a single walk. If two
+/// nodes match under util::match with default checkNames (and no
+/// wildcard nodes are involved), their fingerprints are equal, so differing
+/// fingerprints cheaply reject candidates without a full recursive
+/// comparison. Passes that repeatedly compare against the same subtree
+/// should fingerprint it once and compare hashes first.
+/// @param node the node
+/// @return the fingerprint
+uint64_t structuralHash(const Node *node);
+
 } // namespace util
 } // namespace ir
 } // namespace codon
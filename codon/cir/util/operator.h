@@ -34,6 +34,11 @@ private:
   std::vector<decltype(SeriesFlow().begin())> itStack;
   /// true if should visit children first
   bool childrenFirst;
+  /// operator whose traversal context is used instead of our own, if any
+  Operator *shared = nullptr;
+
+  Operator &state() { return shared ? *shared : *this; }
+  const Operator &state() const { return shared ? *shared : *this; }
 
 protected:
   void defaultVisit(Node *) override {}
@@ -45,6 +50,14 @@ public:
 
   virtual ~Operator() noexcept = default;
 
+  /// Borrows traversal context (parent stack, series iterators, seen set)
+  /// from another operator: parent lookups and insertions made by this
+  /// operator consult the driver's state instead of our own. Lets several
+  /// operators share a single walk, with one driver doing the traversal
+  /// and dispatching each node to the rest.
+  /// @param driver the operator doing the traversal (null to detach)
+  void setSharedContext(Operator *driver) { shared = driver; }
+
   /// This function is applied to all nodes before handling the node
   /// itself. It provides a way to write one function that gets
   /// applied to every visited node.
@@ -126,15 +139,17 @@ public:
   /// Return the parent of the current node.
   /// @param level the number of levels up from the current node
   template <typename Desired = Node> Desired *getParent(int level = 0) {
-    return cast<Desired>(nodeStack[nodeStack.size() - level - 1]);
+    auto &stack = state().nodeStack;
+    return cast<Desired>(stack[stack.size() - level - 1]);
   }
   /// @return current depth in the tree
-  int depth() const { return nodeStack.size(); }
+  int depth() const { return state().nodeStack.size(); }
 
   /// @tparam Desired the desired type
   /// @return the last encountered example of the desired type
   template <typename Desired> Desired *findLast() {
-    for (auto it = nodeStack.rbegin(); it != nodeStack.rend(); ++it) {
+    auto &stack = state().nodeStack;
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
       if (auto *v = cast<Desired>(*it))
         return v;
     }
@@ -144,26 +159,29 @@ public:
   Func *getParentFunc() { return findLast<Func>(); }
 
   /// @return an iterator to the first parent
-  auto parent_begin() const { return nodeStack.begin(); }
+  auto parent_begin() const { return state().nodeStack.begin(); }
   /// @return an iterator beyond the last parent
-  auto parent_end() const { return nodeStack.end(); }
+  auto parent_end() const { return state().nodeStack.end(); }
 
   /// @param v the value
   /// @return whether we have visited ("seen") the given value
-  bool saw(const Value *v) const { return seen.find(v->getId()) != seen.end(); }
+  bool saw(const Value *v) const {
+    auto &s = state().seen;
+    return s.find(v->getId()) != s.end();
+  }
   /// Avoid visiting the given value in the future.
   /// @param v the value
-  void see(const Value *v) { seen.insert(v->getId()); }
+  void see(const Value *v) { state().seen.insert(v->getId()); }
 
   /// Inserts the new value before the current position in the last seen SeriesFlow.
   /// @param v the new value
   auto insertBefore(Value *v) {
-    return findLast<SeriesFlow>()->insert(itStack.back(), v);
+    return findLast<SeriesFlow>()->insert(state().itStack.back(), v);
   }
   /// Inserts the new value after the current position in the last seen SeriesFlow.
   /// @param v the new value, which is marked seen
   auto insertAfter(Value *v) {
-    auto newPos = itStack.back();
+    auto newPos = state().itStack.back();
     ++newPos;
     see(v);
 
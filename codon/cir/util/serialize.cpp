@@ -0,0 +1,1371 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "serialize.h"
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "codon/cir/transform/parallel/schedule.h"
+#include "codon/cir/util/visitor.h"
+
+namespace codon {
+namespace ir {
+namespace util {
+namespace {
+
+const char MAGIC[4] = {'C', 'I', 'R', 'B'};
+const uint32_t VERSION = 1;
+
+const uint32_t NO_TYPE = 0xffffffffu;
+const int64_t NO_NODE = -1;
+
+/// Type entry tags.
+enum TypeKind : uint8_t {
+  T_INT,
+  T_FLOAT,
+  T_FLOAT32,
+  T_FLOAT16,
+  T_BFLOAT16,
+  T_FLOAT128,
+  T_BOOL,
+  T_BYTE,
+  T_VOID,
+  T_INTN,
+  T_VECTOR,
+  T_POINTER,
+  T_OPTIONAL,
+  T_GENERATOR,
+  T_FUNC,
+  T_UNION,
+  T_RECORD,
+  T_REF,
+};
+
+/// Variable/function entry tags.
+enum VarKind : uint8_t {
+  V_VAR,
+  V_BODIED_FUNC,
+  V_EXTERNAL_FUNC,
+  V_INTERNAL_FUNC,
+  V_LLVM_FUNC,
+};
+
+/// Value entry tags.
+enum ValueKind : uint8_t {
+  K_VAR_VALUE,
+  K_POINTER_VALUE,
+  K_INT_CONST,
+  K_FLOAT_CONST,
+  K_BOOL_CONST,
+  K_STRING_CONST,
+  K_SERIES_FLOW,
+  K_IF_FLOW,
+  K_WHILE_FLOW,
+  K_FOR_FLOW,
+  K_IMPERATIVE_FOR_FLOW,
+  K_TRY_CATCH_FLOW,
+  K_PIPELINE_FLOW,
+  K_ASSIGN_INSTR,
+  K_EXTRACT_INSTR,
+  K_INSERT_INSTR,
+  K_CALL_INSTR,
+  K_STACK_ALLOC_INSTR,
+  K_TYPE_PROPERTY_INSTR,
+  K_YIELD_IN_INSTR,
+  K_TERNARY_INSTR,
+  K_BREAK_INSTR,
+  K_CONTINUE_INSTR,
+  K_RETURN_INSTR,
+  K_YIELD_INSTR,
+  K_THROW_INSTR,
+  K_FLOW_INSTR,
+};
+
+/// Little-endian byte sink.
+struct Writer {
+  std::string buf;
+
+  void u8(uint8_t v) { buf.push_back(char(v)); }
+  void u32(uint32_t v) {
+    for (int i = 0; i < 4; i++)
+      buf.push_back(char((v >> (8 * i)) & 0xff));
+  }
+  void u64(uint64_t v) {
+    for (int i = 0; i < 8; i++)
+      buf.push_back(char((v >> (8 * i)) & 0xff));
+  }
+  void i64(int64_t v) { u64(uint64_t(v)); }
+  void f64(double v) {
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    u64(u);
+  }
+};
+
+/// Thrown (internally) on malformed or truncated input.
+struct ReadError {};
+
+/// Bounds-checked little-endian byte source.
+struct Reader {
+  const unsigned char *p, *end;
+
+  Reader(const char *data, size_t size)
+      : p(reinterpret_cast<const unsigned char *>(data)), end(p + size) {}
+
+  void need(size_t n) {
+    if (size_t(end - p) < n)
+      throw ReadError();
+  }
+  uint8_t u8() {
+    need(1);
+    return *p++;
+  }
+  uint32_t u32() {
+    need(4);
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+      v |= uint32_t(*p++) << (8 * i);
+    return v;
+  }
+  uint64_t u64() {
+    need(8);
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+      v |= uint64_t(*p++) << (8 * i);
+    return v;
+  }
+  int64_t i64() { return int64_t(u64()); }
+  double f64() {
+    uint64_t u = u64();
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+  }
+  std::string bytes(size_t n) {
+    need(n);
+    std::string s(reinterpret_cast<const char *>(p), n);
+    p += n;
+    return s;
+  }
+};
+
+class ModuleWriter;
+
+/// Writes a single type table entry; unknown (plugin) types mark the
+/// serialization as failed via defaultVisit.
+class TypeWriter : public ConstVisitor {
+  ModuleWriter &w;
+
+public:
+  explicit TypeWriter(ModuleWriter &w) : w(w) {}
+
+  void defaultVisit(const Node *) override;
+
+  void visit(const types::IntType *) override;
+  void visit(const types::FloatType *) override;
+  void visit(const types::Float32Type *) override;
+  void visit(const types::Float16Type *) override;
+  void visit(const types::BFloat16Type *) override;
+  void visit(const types::Float128Type *) override;
+  void visit(const types::BoolType *) override;
+  void visit(const types::ByteType *) override;
+  void visit(const types::VoidType *) override;
+  void visit(const types::IntNType *) override;
+  void visit(const types::VectorType *) override;
+  void visit(const types::PointerType *) override;
+  void visit(const types::OptionalType *) override;
+  void visit(const types::GeneratorType *) override;
+  void visit(const types::FuncType *) override;
+  void visit(const types::UnionType *) override;
+  void visit(const types::RecordType *) override;
+  void visit(const types::RefType *) override;
+};
+
+/// Writes a single value table entry.
+class ValueWriter : public ConstVisitor {
+  ModuleWriter &w;
+
+public:
+  explicit ValueWriter(ModuleWriter &w) : w(w) {}
+
+  void defaultVisit(const Node *) override;
+
+  void visit(const VarValue *) override;
+  void visit(const PointerValue *) override;
+  void visit(const TemplatedConst<int64_t> *) override;
+  void visit(const TemplatedConst<double> *) override;
+  void visit(const TemplatedConst<bool> *) override;
+  void visit(const TemplatedConst<std::string> *) override;
+  void visit(const SeriesFlow *) override;
+  void visit(const IfFlow *) override;
+  void visit(const WhileFlow *) override;
+  void visit(const ForFlow *) override;
+  void visit(const ImperativeForFlow *) override;
+  void visit(const TryCatchFlow *) override;
+  void visit(const PipelineFlow *) override;
+  void visit(const AssignInstr *) override;
+  void visit(const ExtractInstr *) override;
+  void visit(const InsertInstr *) override;
+  void visit(const CallInstr *) override;
+  void visit(const StackAllocInstr *) override;
+  void visit(const TypePropertyInstr *) override;
+  void visit(const YieldInInstr *) override;
+  void visit(const TernaryInstr *) override;
+  void visit(const BreakInstr *) override;
+  void visit(const ContinueInstr *) override;
+  void visit(const ReturnInstr *) override;
+  void visit(const YieldInstr *) override;
+  void visit(const ThrowInstr *) override;
+  void visit(const FlowInstr *) override;
+};
+
+/// Serializes a whole module: a string table followed by dense type,
+/// variable/function and value tables that reference each other by
+/// table index (types) or original node ID (vars and values).
+class ModuleWriter {
+public:
+  Writer w;
+  std::vector<std::string> strings;
+  std::unordered_map<std::string, uint32_t> stringIds;
+  std::unordered_map<const types::Type *, uint32_t> typeIds;
+  bool ok = true;
+
+  uint32_t intern(const std::string &s) {
+    auto it = stringIds.find(s);
+    if (it != stringIds.end())
+      return it->second;
+    auto id = uint32_t(strings.size());
+    strings.push_back(s);
+    stringIds.emplace(s, id);
+    return id;
+  }
+
+  void str(const std::string &s) { w.u32(intern(s)); }
+
+  void src(const Node *n) {
+    auto i = n->getSrcInfo();
+    str(i.file);
+    w.i64(i.line);
+    w.i64(i.col);
+    w.i64(i.len);
+  }
+
+  void typeRef(const types::Type *t) {
+    auto it = typeIds.find(t ? t->getActual() : nullptr);
+    if (it == typeIds.end()) {
+      ok = false;
+      w.u32(NO_TYPE);
+    } else {
+      w.u32(it->second);
+    }
+  }
+  void typeRefOrNone(const types::Type *t) {
+    if (!t)
+      w.u32(NO_TYPE);
+    else
+      typeRef(t);
+  }
+
+  void valRef(const Value *v) { w.i64(v ? v->getActual()->getId() : NO_NODE); }
+  void varRef(const Var *v) { w.i64(v ? v->getActual()->getId() : NO_NODE); }
+
+  void sched(const transform::parallel::OMPSched *s) {
+    w.i64(s->code);
+    w.u8(s->dynamic);
+    valRef(s->threads);
+    valRef(s->chunk);
+    w.u8(s->ordered);
+    w.i64(s->collapse);
+    w.u8(s->gpu);
+    w.u8(s->workStealing);
+    w.u8(s->adaptive);
+    w.u8(s->simd);
+    w.i64(s->bind);
+    w.u8(s->spscPipeline);
+  }
+
+  void writeTypes(const Module *module) {
+    // Membered types can be created empty and realized later, which is how
+    // recursive types (e.g. a class containing a pointer to itself) are
+    // broken: records first, then refs (whose contents are records), then
+    // everything else bottom-up. Field lists are emitted at the end, once
+    // every type has an index.
+    std::vector<const types::Type *> order;
+    std::vector<const types::RecordType *> records;
+    auto add = [&](const types::Type *t) {
+      typeIds.emplace(t, uint32_t(order.size()));
+      order.push_back(t);
+    };
+    for (auto it = module->types_begin(); it != module->types_end(); ++it) {
+      auto *t = (*it)->getActual();
+      if (auto *r = cast<types::RecordType>(t)) {
+        if (typeIds.find(t) == typeIds.end()) {
+          add(t);
+          records.push_back(r);
+        }
+      }
+    }
+    for (auto it = module->types_begin(); it != module->types_end(); ++it) {
+      auto *t = (*it)->getActual();
+      if (isA<types::RefType>(t) && typeIds.find(t) == typeIds.end())
+        add(t);
+    }
+    std::function<void(const types::Type *)> dfs = [&](const types::Type *t) {
+      t = t->getActual();
+      if (typeIds.find(t) != typeIds.end())
+        return;
+      for (auto *u : t->getUsedTypes())
+        dfs(u);
+      // vector bases are not reported as used types
+      if (auto *v = cast<types::VectorType>(t))
+        dfs(v->getBase());
+      add(t);
+    };
+    for (auto it = module->types_begin(); it != module->types_end(); ++it)
+      dfs(*it);
+
+    w.u32(uint32_t(order.size()));
+    TypeWriter tv(*this);
+    for (auto *t : order)
+      t->accept(tv);
+
+    w.u32(uint32_t(records.size()));
+    for (auto *r : records) {
+      w.u32(uint32_t(std::distance(r->begin(), r->end())));
+      for (auto &field : *r) {
+        str(field.getName());
+        typeRef(field.getType());
+      }
+    }
+  }
+
+  void writeFunc(const Func *f) {
+    str(f->getUnmangledName());
+    w.u8(f->isGenerator());
+    typeRefOrNone(f->getParentType());
+    std::map<std::string, std::string> kv;
+    if (auto *attr = f->getAttribute<KeyValueAttribute>())
+      kv = attr->attributes;
+    w.u32(uint32_t(kv.size()));
+    for (auto &[k, v] : kv) {
+      str(k);
+      str(v);
+    }
+    w.u32(uint32_t(std::distance(f->arg_begin(), f->arg_end())));
+    for (auto it = f->arg_begin(); it != f->arg_end(); ++it) {
+      str((*it)->getName());
+      varRef(*it);
+    }
+  }
+
+  void writeVar(const Var *v) {
+    w.i64(v->getId());
+    uint8_t kind = V_VAR;
+    if (isA<BodiedFunc>(v))
+      kind = V_BODIED_FUNC;
+    else if (isA<ExternalFunc>(v))
+      kind = V_EXTERNAL_FUNC;
+    else if (isA<InternalFunc>(v))
+      kind = V_INTERNAL_FUNC;
+    else if (isA<LLVMFunc>(v))
+      kind = V_LLVM_FUNC;
+    else if (isA<Func>(v))
+      ok = false; // unknown function subclass
+    w.u8(kind);
+    str(v->getName());
+    src(v);
+    typeRefOrNone(v->getType());
+    w.u8(v->isGlobal());
+    w.u8(v->isExternal());
+    switch (kind) {
+    case V_VAR:
+      break;
+    case V_BODIED_FUNC: {
+      auto *f = cast<BodiedFunc>(v);
+      writeFunc(f);
+      w.u8(f->isJIT());
+      valRef(f->getBody());
+      w.u32(uint32_t(std::distance(f->begin(), f->end())));
+      for (auto it = f->begin(); it != f->end(); ++it)
+        varRef(*it);
+      break;
+    }
+    case V_EXTERNAL_FUNC:
+    case V_INTERNAL_FUNC:
+      writeFunc(cast<Func>(v));
+      break;
+    case V_LLVM_FUNC: {
+      auto *f = cast<LLVMFunc>(v);
+      writeFunc(f);
+      str(f->getLLVMDeclarations());
+      str(f->getLLVMBody());
+      w.u32(uint32_t(std::distance(f->literal_begin(), f->literal_end())));
+      for (auto it = f->literal_begin(); it != f->literal_end(); ++it) {
+        if (it->isStatic()) {
+          w.u8(0);
+          w.i64(it->getStaticValue());
+        } else if (it->isStaticStr()) {
+          w.u8(1);
+          str(it->getStaticStringValue());
+        } else {
+          w.u8(2);
+          typeRef(it->getTypeValue());
+        }
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  void writeVars(const Module *module) {
+    // Function argument variables are re-created by Func::realize during
+    // deserialization, so they are not written as standalone entries; their
+    // IDs are recorded with their function and mapped positionally.
+    std::unordered_set<id_t> argIds;
+    for (auto it = module->begin(); it != module->end(); ++it) {
+      if (auto *f = cast<Func>(*it))
+        for (auto a = f->arg_begin(); a != f->arg_end(); ++a)
+          argIds.insert((*a)->getActual()->getId());
+    }
+
+    w.i64(module->getArgVar()->getId());
+    writeVar(module->getMainFunc());
+
+    std::vector<const Var *> vars;
+    for (auto it = module->begin(); it != module->end(); ++it) {
+      auto *v = *it;
+      if (v->hasReplacement() || argIds.count(v->getId()))
+        continue;
+      vars.push_back(v);
+    }
+    w.u32(uint32_t(vars.size()));
+    for (auto *v : vars)
+      writeVar(v);
+  }
+
+  void writeValues(const Module *module) {
+    std::vector<const Value *> values;
+    for (auto it = module->values_begin(); it != module->values_end(); ++it)
+      if (!(*it)->hasReplacement())
+        values.push_back(*it);
+    w.u32(uint32_t(values.size()));
+    ValueWriter vv(*this);
+    for (auto *v : values) {
+      w.i64(v->getId());
+      str(v->getName());
+      src(v);
+      v->accept(vv);
+    }
+  }
+
+  std::string finish(const Module *module) {
+    str(module->getName());
+    src(module);
+    writeTypes(module);
+    writeVars(module);
+    writeValues(module);
+    if (!ok)
+      return "";
+
+    Writer out;
+    out.buf.append(MAGIC, sizeof(MAGIC));
+    out.u32(VERSION);
+    out.u32(uint32_t(strings.size()));
+    for (auto &s : strings) {
+      out.u32(uint32_t(s.size()));
+      out.buf.append(s);
+    }
+    out.buf.append(w.buf);
+    return std::move(out.buf);
+  }
+};
+
+void TypeWriter::defaultVisit(const Node *) { w.ok = false; }
+void TypeWriter::visit(const types::IntType *) { w.w.u8(T_INT); }
+void TypeWriter::visit(const types::FloatType *) { w.w.u8(T_FLOAT); }
+void TypeWriter::visit(const types::Float32Type *) { w.w.u8(T_FLOAT32); }
+void TypeWriter::visit(const types::Float16Type *) { w.w.u8(T_FLOAT16); }
+void TypeWriter::visit(const types::BFloat16Type *) { w.w.u8(T_BFLOAT16); }
+void TypeWriter::visit(const types::Float128Type *) { w.w.u8(T_FLOAT128); }
+void TypeWriter::visit(const types::BoolType *) { w.w.u8(T_BOOL); }
+void TypeWriter::visit(const types::ByteType *) { w.w.u8(T_BYTE); }
+void TypeWriter::visit(const types::VoidType *) { w.w.u8(T_VOID); }
+void TypeWriter::visit(const types::IntNType *t) {
+  w.w.u8(T_INTN);
+  w.w.u32(t->getLen());
+  w.w.u8(t->isSigned());
+}
+void TypeWriter::visit(const types::VectorType *t) {
+  w.w.u8(T_VECTOR);
+  w.w.u32(t->getCount());
+  w.typeRef(t->getBase());
+}
+void TypeWriter::visit(const types::PointerType *t) {
+  w.w.u8(T_POINTER);
+  w.typeRef(t->getBase());
+}
+void TypeWriter::visit(const types::OptionalType *t) {
+  w.w.u8(T_OPTIONAL);
+  w.typeRef(t->getBase());
+}
+void TypeWriter::visit(const types::GeneratorType *t) {
+  w.w.u8(T_GENERATOR);
+  w.typeRef(t->getBase());
+}
+void TypeWriter::visit(const types::FuncType *t) {
+  w.w.u8(T_FUNC);
+  w.str(t->getName());
+  w.typeRef(t->getReturnType());
+  w.w.u32(uint32_t(std::distance(t->begin(), t->end())));
+  for (auto *a : *t)
+    w.typeRef(a);
+  w.w.u8(t->isVariadic());
+}
+void TypeWriter::visit(const types::UnionType *t) {
+  w.w.u8(T_UNION);
+  w.w.u32(uint32_t(std::distance(t->begin(), t->end())));
+  for (auto *a : *t)
+    w.typeRef(a);
+}
+void TypeWriter::visit(const types::RecordType *t) {
+  w.w.u8(T_RECORD);
+  w.str(t->getName());
+}
+void TypeWriter::visit(const types::RefType *t) {
+  w.w.u8(T_REF);
+  w.str(t->getName());
+  w.typeRef(t->getContents());
+  w.w.u8(t->isPolymorphic());
+}
+
+void ValueWriter::defaultVisit(const Node *) { w.ok = false; }
+void ValueWriter::visit(const VarValue *v) {
+  w.w.u8(K_VAR_VALUE);
+  w.varRef(v->getVar());
+}
+void ValueWriter::visit(const PointerValue *v) {
+  w.w.u8(K_POINTER_VALUE);
+  w.varRef(v->getVar());
+}
+void ValueWriter::visit(const TemplatedConst<int64_t> *v) {
+  w.w.u8(K_INT_CONST);
+  w.w.i64(v->getVal());
+  w.typeRef(v->getType());
+}
+void ValueWriter::visit(const TemplatedConst<double> *v) {
+  w.w.u8(K_FLOAT_CONST);
+  w.w.f64(v->getVal());
+  w.typeRef(v->getType());
+}
+void ValueWriter::visit(const TemplatedConst<bool> *v) {
+  w.w.u8(K_BOOL_CONST);
+  w.w.u8(v->getVal());
+  w.typeRef(v->getType());
+}
+void ValueWriter::visit(const TemplatedConst<std::string> *v) {
+  w.w.u8(K_STRING_CONST);
+  w.str(v->getVal());
+  w.typeRef(v->getType());
+}
+void ValueWriter::visit(const SeriesFlow *v) {
+  w.w.u8(K_SERIES_FLOW);
+  w.w.u32(uint32_t(std::distance(v->begin(), v->end())));
+  for (auto *x : *v)
+    w.valRef(x);
+}
+void ValueWriter::visit(const IfFlow *v) {
+  w.w.u8(K_IF_FLOW);
+  w.valRef(v->getCond());
+  w.valRef(v->getTrueBranch());
+  w.valRef(v->getFalseBranch());
+}
+void ValueWriter::visit(const WhileFlow *v) {
+  w.w.u8(K_WHILE_FLOW);
+  w.valRef(v->getCond());
+  w.valRef(v->getBody());
+}
+void ValueWriter::visit(const ForFlow *v) {
+  w.w.u8(K_FOR_FLOW);
+  w.valRef(v->getIter());
+  w.valRef(v->getBody());
+  w.varRef(v->getVar());
+  w.w.u8(v->isParallel());
+  if (v->isParallel())
+    w.sched(v->getSchedule());
+}
+void ValueWriter::visit(const ImperativeForFlow *v) {
+  w.w.u8(K_IMPERATIVE_FOR_FLOW);
+  w.valRef(v->getStart());
+  w.w.i64(v->getStep());
+  w.valRef(v->getEnd());
+  w.valRef(v->getBody());
+  w.varRef(v->getVar());
+  w.w.u8(v->isParallel());
+  if (v->isParallel())
+    w.sched(v->getSchedule());
+}
+void ValueWriter::visit(const TryCatchFlow *v) {
+  w.w.u8(K_TRY_CATCH_FLOW);
+  w.valRef(v->getBody());
+  w.valRef(v->getFinally());
+  w.w.u32(uint32_t(std::distance(v->begin(), v->end())));
+  for (auto &c : *v) {
+    w.valRef(c.getHandler());
+    w.typeRefOrNone(c.getType());
+    w.varRef(c.getVar());
+  }
+}
+void ValueWriter::visit(const PipelineFlow *v) {
+  w.w.u8(K_PIPELINE_FLOW);
+  w.w.u32(uint32_t(std::distance(v->begin(), v->end())));
+  for (auto &s : *v) {
+    w.valRef(s.getCallee());
+    w.w.u8(s.isGenerator());
+    w.w.u8(s.isParallel());
+    w.w.u32(uint32_t(std::distance(s.begin(), s.end())));
+    for (auto *a : s)
+      w.valRef(a);
+  }
+}
+void ValueWriter::visit(const AssignInstr *v) {
+  w.w.u8(K_ASSIGN_INSTR);
+  w.varRef(v->getLhs());
+  w.valRef(v->getRhs());
+}
+void ValueWriter::visit(const ExtractInstr *v) {
+  w.w.u8(K_EXTRACT_INSTR);
+  w.valRef(v->getVal());
+  w.str(v->getField());
+}
+void ValueWriter::visit(const InsertInstr *v) {
+  w.w.u8(K_INSERT_INSTR);
+  w.valRef(v->getLhs());
+  w.str(v->getField());
+  w.valRef(v->getRhs());
+}
+void ValueWriter::visit(const CallInstr *v) {
+  w.w.u8(K_CALL_INSTR);
+  w.valRef(v->getCallee());
+  w.w.u32(uint32_t(v->numArgs()));
+  for (auto *a : *v)
+    w.valRef(a);
+}
+void ValueWriter::visit(const StackAllocInstr *v) {
+  w.w.u8(K_STACK_ALLOC_INSTR);
+  w.typeRef(v->getArrayType());
+  w.w.i64(v->getCount());
+}
+void ValueWriter::visit(const TypePropertyInstr *v) {
+  w.w.u8(K_TYPE_PROPERTY_INSTR);
+  w.typeRef(v->getInspectType());
+  w.w.u8(uint8_t(v->getProperty()));
+}
+void ValueWriter::visit(const YieldInInstr *v) {
+  w.w.u8(K_YIELD_IN_INSTR);
+  w.typeRef(v->getType());
+  w.w.u8(v->isSuspending());
+}
+void ValueWriter::visit(const TernaryInstr *v) {
+  w.w.u8(K_TERNARY_INSTR);
+  w.valRef(v->getCond());
+  w.valRef(v->getTrueValue());
+  w.valRef(v->getFalseValue());
+}
+void ValueWriter::visit(const BreakInstr *v) {
+  w.w.u8(K_BREAK_INSTR);
+  w.valRef(v->getLoop());
+}
+void ValueWriter::visit(const ContinueInstr *v) {
+  w.w.u8(K_CONTINUE_INSTR);
+  w.valRef(v->getLoop());
+}
+void ValueWriter::visit(const ReturnInstr *v) {
+  w.w.u8(K_RETURN_INSTR);
+  w.valRef(v->getValue());
+}
+void ValueWriter::visit(const YieldInstr *v) {
+  w.w.u8(K_YIELD_INSTR);
+  w.valRef(v->getValue());
+  w.w.u8(v->isFinal());
+}
+void ValueWriter::visit(const ThrowInstr *v) {
+  w.w.u8(K_THROW_INSTR);
+  w.valRef(v->getValue());
+}
+void ValueWriter::visit(const FlowInstr *v) {
+  w.w.u8(K_FLOW_INSTR);
+  w.valRef(v->getFlow());
+  w.valRef(v->getValue());
+}
+
+/// Parsed value table entry; materialized on demand (operands may be
+/// forward references).
+struct ValueDesc {
+  uint8_t kind = 0;
+  std::string name;
+  SrcInfo src;
+  std::vector<int64_t> vals;
+  std::vector<int64_t> vars;
+  std::vector<uint32_t> types;
+  std::vector<std::string> strs;
+  std::vector<int64_t> ints;
+  double f = 0;
+  bool hasSched = false;
+  std::vector<int64_t> sched;
+  /// stages or catch clauses, each a flat list of refs/flags
+  std::vector<std::vector<int64_t>> groups;
+};
+
+class ModuleReader {
+public:
+  Reader r;
+  std::unique_ptr<Module> module;
+  std::vector<std::string> strings;
+  std::vector<types::Type *> typeTable;
+  std::unordered_map<int64_t, Var *> varMap;
+  std::unordered_map<int64_t, ValueDesc> valueDescs;
+  std::unordered_map<int64_t, Value *> valueMap;
+  std::vector<std::pair<Value *, int64_t>> loopFixups;
+  /// (function, body value ID, symbol var IDs)
+  std::vector<std::tuple<BodiedFunc *, int64_t, std::vector<int64_t>>> funcBodies;
+
+  ModuleReader(const char *data, size_t size) : r(data, size) {}
+
+  const std::string &str() {
+    auto i = r.u32();
+    if (i >= strings.size())
+      throw ReadError();
+    return strings[i];
+  }
+
+  SrcInfo src() {
+    auto file = str();
+    auto line = int(r.i64());
+    auto col = int(r.i64());
+    auto len = int(r.i64());
+    return {file, line, col, len};
+  }
+
+  types::Type *typeAt(uint32_t i) {
+    if (i == NO_TYPE)
+      return nullptr;
+    if (i >= typeTable.size())
+      throw ReadError();
+    return typeTable[i];
+  }
+  types::Type *typeRef() { return typeAt(r.u32()); }
+
+  void readTypes() {
+    auto *M = module.get();
+    auto count = r.u32();
+    std::vector<uint32_t> recordIdx;
+    for (uint32_t i = 0; i < count; i++) {
+      types::Type *t = nullptr;
+      switch (r.u8()) {
+      case T_INT:
+        t = M->getIntType();
+        break;
+      case T_FLOAT:
+        t = M->getFloatType();
+        break;
+      case T_FLOAT32:
+        t = M->getFloat32Type();
+        break;
+      case T_FLOAT16:
+        t = M->getFloat16Type();
+        break;
+      case T_BFLOAT16:
+        t = M->getBFloat16Type();
+        break;
+      case T_FLOAT128:
+        t = M->getFloat128Type();
+        break;
+      case T_BOOL:
+        t = M->getBoolType();
+        break;
+      case T_BYTE:
+        t = M->getByteType();
+        break;
+      case T_VOID:
+        t = M->getVoidType();
+        break;
+      case T_INTN: {
+        auto len = r.u32();
+        auto sign = bool(r.u8());
+        t = M->unsafeGetIntNType(len, sign);
+        break;
+      }
+      case T_VECTOR: {
+        auto n = r.u32();
+        auto *base = typeRef();
+        t = M->unsafeGetVectorType(n, base);
+        break;
+      }
+      case T_POINTER:
+        t = M->unsafeGetPointerType(typeRef());
+        break;
+      case T_OPTIONAL:
+        t = M->unsafeGetOptionalType(typeRef());
+        break;
+      case T_GENERATOR:
+        t = M->unsafeGetGeneratorType(typeRef());
+        break;
+      case T_FUNC: {
+        auto name = str();
+        auto *ret = typeRef();
+        std::vector<types::Type *> args(r.u32());
+        for (auto &a : args)
+          a = typeRef();
+        auto variadic = bool(r.u8());
+        t = M->unsafeGetFuncType(name, ret, std::move(args), variadic);
+        break;
+      }
+      case T_UNION: {
+        std::vector<types::Type *> alts(r.u32());
+        for (auto &a : alts)
+          a = typeRef();
+        t = M->unsafeGetUnionType(alts);
+        break;
+      }
+      case T_RECORD: {
+        auto name = str();
+        t = M->getType(name);
+        if (!t)
+          t = M->Nr<types::RecordType>(name);
+        recordIdx.push_back(uint32_t(typeTable.size()));
+        break;
+      }
+      case T_REF: {
+        auto name = str();
+        auto *contents = cast<types::RecordType>(typeRef());
+        auto polymorphic = bool(r.u8());
+        if (!contents)
+          throw ReadError();
+        t = M->getType(name);
+        if (!t)
+          t = M->Nr<types::RefType>(name, contents, polymorphic);
+        break;
+      }
+      default:
+        throw ReadError();
+      }
+      typeTable.push_back(t);
+    }
+
+    // realize record bodies now that every type has an index
+    auto numRecords = r.u32();
+    if (numRecords != recordIdx.size())
+      throw ReadError();
+    for (auto i : recordIdx) {
+      std::vector<types::Type *> fieldTypes(r.u32());
+      std::vector<std::string> fieldNames(fieldTypes.size());
+      for (size_t j = 0; j < fieldTypes.size(); j++) {
+        fieldNames[j] = str();
+        fieldTypes[j] = typeRef();
+      }
+      cast<types::RecordType>(typeTable[i])->realize(std::move(fieldTypes),
+                                                     std::move(fieldNames));
+    }
+  }
+
+  void readFunc(Func *f) {
+    f->setUnmangledName(str());
+    f->setGenerator(bool(r.u8()));
+    if (auto *parent = typeAt(r.u32()))
+      f->setParentType(parent);
+    std::map<std::string, std::string> kv;
+    auto numAttrs = r.u32();
+    for (uint32_t i = 0; i < numAttrs; i++) {
+      auto k = str();
+      kv[k] = str();
+    }
+    if (!kv.empty())
+      f->setAttribute(std::make_unique<KeyValueAttribute>(std::move(kv)));
+    std::vector<std::string> argNames(r.u32());
+    std::vector<int64_t> argIds(argNames.size());
+    for (size_t i = 0; i < argNames.size(); i++) {
+      argNames[i] = str();
+      argIds[i] = r.i64();
+    }
+    auto *ftype = cast<types::FuncType>(f->getType());
+    if (ftype &&
+        size_t(std::distance(ftype->begin(), ftype->end())) == argNames.size()) {
+      f->realize(ftype, argNames);
+      auto it = f->arg_begin();
+      for (size_t i = 0; i < argIds.size(); i++, ++it)
+        varMap[argIds[i]] = *it;
+    }
+  }
+
+  void readVar(Var *existing = nullptr) {
+    auto *M = module.get();
+    auto id = r.i64();
+    auto kind = r.u8();
+    auto name = str();
+    auto info = src();
+    auto *type = typeAt(r.u32());
+    auto global = bool(r.u8());
+    auto external = bool(r.u8());
+
+    Var *v = existing;
+    if (!v) {
+      switch (kind) {
+      case V_VAR:
+        v = M->N<Var>(info, type, global, external, name);
+        break;
+      case V_BODIED_FUNC:
+        v = M->N<BodiedFunc>(info, name);
+        break;
+      case V_EXTERNAL_FUNC:
+        v = M->N<ExternalFunc>(info, name);
+        break;
+      case V_INTERNAL_FUNC:
+        v = M->N<InternalFunc>(info, name);
+        break;
+      case V_LLVM_FUNC:
+        v = M->N<LLVMFunc>(info, name);
+        break;
+      default:
+        throw ReadError();
+      }
+    } else {
+      v->setSrcInfo(info);
+    }
+    varMap[id] = v;
+    if (kind != V_VAR) {
+      auto *f = cast<Func>(v);
+      if (!f)
+        throw ReadError();
+      if (type)
+        f->setType(type);
+      f->setGlobal(global);
+      f->setExternal(external);
+      readFunc(f);
+      switch (kind) {
+      case V_BODIED_FUNC: {
+        auto *bf = cast<BodiedFunc>(v);
+        bf->setJIT(bool(r.u8()));
+        auto bodyId = r.i64();
+        std::vector<int64_t> symbols(r.u32());
+        for (auto &s : symbols)
+          s = r.i64();
+        funcBodies.emplace_back(bf, bodyId, std::move(symbols));
+        break;
+      }
+      case V_LLVM_FUNC: {
+        auto *lf = cast<LLVMFunc>(v);
+        lf->setLLVMDeclarations(str());
+        lf->setLLVMBody(str());
+        std::vector<types::Generic> literals;
+        auto numLiterals = r.u32();
+        for (uint32_t i = 0; i < numLiterals; i++) {
+          switch (r.u8()) {
+          case 0:
+            literals.emplace_back(r.i64());
+            break;
+          case 1:
+            literals.emplace_back(str());
+            break;
+          case 2: {
+            auto *t = typeRef();
+            if (!t)
+              throw ReadError();
+            literals.emplace_back(t);
+            break;
+          }
+          default:
+            throw ReadError();
+          }
+        }
+        lf->setLLVMLiterals(std::move(literals));
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  }
+
+  void readVars() {
+    varMap[r.i64()] = module->getArgVar();
+    readVar(module->getMainFunc());
+    auto count = r.u32();
+    for (uint32_t i = 0; i < count; i++)
+      readVar();
+  }
+
+  void readSched(ValueDesc &d) {
+    d.hasSched = bool(r.u8());
+    if (!d.hasSched)
+      return;
+    d.sched.push_back(r.i64()); // code
+    d.sched.push_back(r.u8());  // dynamic
+    d.sched.push_back(r.i64()); // threads
+    d.sched.push_back(r.i64()); // chunk
+    d.sched.push_back(r.u8());  // ordered
+    d.sched.push_back(r.i64()); // collapse
+    d.sched.push_back(r.u8());  // gpu
+    d.sched.push_back(r.u8());  // work-stealing
+    d.sched.push_back(r.u8());  // adaptive
+    d.sched.push_back(r.u8());  // simd
+    d.sched.push_back(r.i64()); // bind
+    d.sched.push_back(r.u8());  // spsc pipeline
+  }
+
+  void readValueDescs() {
+    auto count = r.u32();
+    for (uint32_t i = 0; i < count; i++) {
+      auto id = r.i64();
+      ValueDesc d;
+      d.name = str();
+      d.src = src();
+      d.kind = r.u8();
+      switch (d.kind) {
+      case K_VAR_VALUE:
+      case K_POINTER_VALUE:
+        d.vars.push_back(r.i64());
+        break;
+      case K_INT_CONST:
+        d.ints.push_back(r.i64());
+        d.types.push_back(r.u32());
+        break;
+      case K_FLOAT_CONST:
+        d.f = r.f64();
+        d.types.push_back(r.u32());
+        break;
+      case K_BOOL_CONST:
+        d.ints.push_back(r.u8());
+        d.types.push_back(r.u32());
+        break;
+      case K_STRING_CONST:
+        d.strs.push_back(str());
+        d.types.push_back(r.u32());
+        break;
+      case K_SERIES_FLOW: {
+        d.vals.resize(r.u32());
+        for (auto &x : d.vals)
+          x = r.i64();
+        break;
+      }
+      case K_IF_FLOW:
+      case K_TERNARY_INSTR:
+        d.vals = {r.i64(), r.i64(), r.i64()};
+        break;
+      case K_WHILE_FLOW:
+      case K_FLOW_INSTR:
+        d.vals = {r.i64(), r.i64()};
+        break;
+      case K_FOR_FLOW:
+        d.vals = {r.i64(), r.i64()};
+        d.vars.push_back(r.i64());
+        readSched(d);
+        break;
+      case K_IMPERATIVE_FOR_FLOW:
+        d.vals.push_back(r.i64());
+        d.ints.push_back(r.i64()); // step
+        d.vals.push_back(r.i64());
+        d.vals.push_back(r.i64());
+        d.vars.push_back(r.i64());
+        readSched(d);
+        break;
+      case K_TRY_CATCH_FLOW: {
+        d.vals = {r.i64(), r.i64()};
+        auto n = r.u32();
+        for (uint32_t j = 0; j < n; j++) {
+          auto handler = r.i64();
+          auto type = int64_t(int32_t(r.u32()));
+          auto var = r.i64();
+          d.groups.push_back({handler, type, var});
+        }
+        break;
+      }
+      case K_PIPELINE_FLOW: {
+        auto n = r.u32();
+        for (uint32_t j = 0; j < n; j++) {
+          std::vector<int64_t> stage;
+          stage.push_back(r.i64()); // callee
+          stage.push_back(r.u8());  // generator
+          stage.push_back(r.u8());  // parallel
+          auto nargs = r.u32();
+          for (uint32_t k = 0; k < nargs; k++)
+            stage.push_back(r.i64());
+          d.groups.push_back(std::move(stage));
+        }
+        break;
+      }
+      case K_ASSIGN_INSTR:
+        d.vars.push_back(r.i64());
+        d.vals.push_back(r.i64());
+        break;
+      case K_EXTRACT_INSTR:
+        d.vals.push_back(r.i64());
+        d.strs.push_back(str());
+        break;
+      case K_INSERT_INSTR:
+        d.vals.push_back(r.i64());
+        d.strs.push_back(str());
+        d.vals.push_back(r.i64());
+        break;
+      case K_CALL_INSTR: {
+        d.vals.push_back(r.i64());
+        auto n = r.u32();
+        for (uint32_t j = 0; j < n; j++)
+          d.vals.push_back(r.i64());
+        break;
+      }
+      case K_STACK_ALLOC_INSTR:
+        d.types.push_back(r.u32());
+        d.ints.push_back(r.i64());
+        break;
+      case K_TYPE_PROPERTY_INSTR:
+      case K_YIELD_IN_INSTR:
+        d.types.push_back(r.u32());
+        d.ints.push_back(r.u8());
+        break;
+      case K_BREAK_INSTR:
+      case K_CONTINUE_INSTR:
+      case K_RETURN_INSTR:
+      case K_THROW_INSTR:
+        d.vals.push_back(r.i64());
+        break;
+      case K_YIELD_INSTR:
+        d.vals.push_back(r.i64());
+        d.ints.push_back(r.u8());
+        break;
+      default:
+        throw ReadError();
+      }
+      valueDescs.emplace(id, std::move(d));
+    }
+  }
+
+  Var *var(int64_t id) {
+    if (id == NO_NODE)
+      return nullptr;
+    auto it = varMap.find(id);
+    if (it == varMap.end())
+      throw ReadError();
+    return it->second;
+  }
+
+  std::unique_ptr<transform::parallel::OMPSched> makeSched(const ValueDesc &d) {
+    if (!d.hasSched)
+      return nullptr;
+    auto &s = d.sched;
+    auto sched = std::make_unique<transform::parallel::OMPSched>(
+        int(s[0]), bool(s[1]), value(s[2]), value(s[3]), bool(s[4]), s[5], bool(s[6]),
+        bool(s[7]), bool(s[8]), bool(s[9]), int(s[10]));
+    sched->spscPipeline = bool(s[11]);
+    return sched;
+  }
+
+  Value *value(int64_t id) {
+    if (id == NO_NODE)
+      return nullptr;
+    auto it = valueMap.find(id);
+    if (it != valueMap.end())
+      return it->second;
+    auto dit = valueDescs.find(id);
+    if (dit == valueDescs.end())
+      throw ReadError();
+    auto &d = dit->second;
+
+    auto *M = module.get();
+    auto flowAt = [&](int64_t i) { return cast<Flow>(value(i)); };
+    Value *v = nullptr;
+    switch (d.kind) {
+    case K_VAR_VALUE:
+      v = M->N<VarValue>(d.src, var(d.vars[0]), d.name);
+      break;
+    case K_POINTER_VALUE:
+      v = M->N<PointerValue>(d.src, var(d.vars[0]), d.name);
+      break;
+    case K_INT_CONST:
+      v = M->N<IntConst>(d.src, d.ints[0], typeAt(d.types[0]), d.name);
+      break;
+    case K_FLOAT_CONST:
+      v = M->N<FloatConst>(d.src, d.f, typeAt(d.types[0]), d.name);
+      break;
+    case K_BOOL_CONST:
+      v = M->N<BoolConst>(d.src, bool(d.ints[0]), typeAt(d.types[0]), d.name);
+      break;
+    case K_STRING_CONST:
+      v = M->N<StringConst>(d.src, d.strs[0], typeAt(d.types[0]), d.name);
+      break;
+    case K_SERIES_FLOW: {
+      auto *s = M->N<SeriesFlow>(d.src, d.name);
+      valueMap[id] = s; // avoid re-entry while filling the series
+      for (auto x : d.vals)
+        s->push_back(value(x));
+      return s;
+    }
+    case K_IF_FLOW:
+      v = M->N<IfFlow>(d.src, value(d.vals[0]), flowAt(d.vals[1]), flowAt(d.vals[2]),
+                       d.name);
+      break;
+    case K_WHILE_FLOW:
+      v = M->N<WhileFlow>(d.src, value(d.vals[0]), flowAt(d.vals[1]), d.name);
+      break;
+    case K_FOR_FLOW:
+      v = M->N<ForFlow>(d.src, value(d.vals[0]), flowAt(d.vals[1]), var(d.vars[0]),
+                        makeSched(d), d.name);
+      break;
+    case K_IMPERATIVE_FOR_FLOW:
+      v = M->N<ImperativeForFlow>(d.src, value(d.vals[0]), d.ints[0],
+                                  value(d.vals[1]), flowAt(d.vals[2]), var(d.vars[0]),
+                                  makeSched(d), d.name);
+      break;
+    case K_TRY_CATCH_FLOW: {
+      auto *tc =
+          M->N<TryCatchFlow>(d.src, flowAt(d.vals[0]), flowAt(d.vals[1]), d.name);
+      valueMap[id] = tc;
+      for (auto &c : d.groups) {
+        auto *type = c[1] == NO_NODE ? nullptr : typeAt(uint32_t(c[1]));
+        tc->push_back(TryCatchFlow::Catch(flowAt(c[0]), type, var(c[2])));
+      }
+      return tc;
+    }
+    case K_PIPELINE_FLOW: {
+      std::vector<PipelineFlow::Stage> stages;
+      for (auto &s : d.groups) {
+        std::vector<Value *> args;
+        for (size_t j = 3; j < s.size(); j++)
+          args.push_back(value(s[j]));
+        stages.emplace_back(value(s[0]), std::move(args), bool(s[1]), bool(s[2]));
+      }
+      v = M->N<PipelineFlow>(d.src, std::move(stages), d.name);
+      break;
+    }
+    case K_ASSIGN_INSTR:
+      v = M->N<AssignInstr>(d.src, var(d.vars[0]), value(d.vals[0]), d.name);
+      break;
+    case K_EXTRACT_INSTR:
+      v = M->N<ExtractInstr>(d.src, value(d.vals[0]), d.strs[0], d.name);
+      break;
+    case K_INSERT_INSTR:
+      v = M->N<InsertInstr>(d.src, value(d.vals[0]), d.strs[0], value(d.vals[1]),
+                            d.name);
+      break;
+    case K_CALL_INSTR: {
+      std::vector<Value *> args;
+      for (size_t j = 1; j < d.vals.size(); j++)
+        args.push_back(value(d.vals[j]));
+      v = M->N<CallInstr>(d.src, value(d.vals[0]), std::move(args), d.name);
+      break;
+    }
+    case K_STACK_ALLOC_INSTR:
+      v = M->N<StackAllocInstr>(d.src, typeAt(d.types[0]), d.ints[0], d.name);
+      break;
+    case K_TYPE_PROPERTY_INSTR:
+      v = M->N<TypePropertyInstr>(
+          d.src, typeAt(d.types[0]),
+          static_cast<TypePropertyInstr::Property>(d.ints[0]), d.name);
+      break;
+    case K_YIELD_IN_INSTR:
+      v = M->N<YieldInInstr>(d.src, typeAt(d.types[0]), bool(d.ints[0]), d.name);
+      break;
+    case K_TERNARY_INSTR:
+      v = M->N<TernaryInstr>(d.src, value(d.vals[0]), value(d.vals[1]),
+                             value(d.vals[2]), d.name);
+      break;
+    case K_BREAK_INSTR:
+      // loop references point back at an enclosing flow; resolve them once
+      // every value exists
+      v = M->N<BreakInstr>(d.src, nullptr, d.name);
+      loopFixups.emplace_back(v, d.vals[0]);
+      break;
+    case K_CONTINUE_INSTR:
+      v = M->N<ContinueInstr>(d.src, nullptr, d.name);
+      loopFixups.emplace_back(v, d.vals[0]);
+      break;
+    case K_RETURN_INSTR:
+      v = M->N<ReturnInstr>(d.src, value(d.vals[0]), d.name);
+      break;
+    case K_YIELD_INSTR:
+      v = M->N<YieldInstr>(d.src, value(d.vals[0]), bool(d.ints[0]), d.name);
+      break;
+    case K_THROW_INSTR:
+      v = M->N<ThrowInstr>(d.src, value(d.vals[0]), d.name);
+      break;
+    default:
+      throw ReadError();
+    }
+    valueMap[id] = v;
+    return v;
+  }
+
+  void readValues() {
+    readValueDescs();
+    for (auto &[id, d] : valueDescs)
+      value(id);
+    for (auto &[v, loopId] : loopFixups) {
+      if (auto *b = cast<BreakInstr>(v))
+        b->setLoop(value(loopId));
+      else if (auto *c = cast<ContinueInstr>(v))
+        c->setLoop(value(loopId));
+    }
+    for (auto &[f, bodyId, symbols] : funcBodies) {
+      if (bodyId != NO_NODE)
+        f->setBody(cast<Flow>(value(bodyId)));
+      for (auto s : symbols)
+        f->push_back(var(s));
+    }
+  }
+
+  std::unique_ptr<Module> read() {
+    r.need(sizeof(MAGIC) + 4);
+    if (memcmp(r.p, MAGIC, sizeof(MAGIC)) != 0)
+      return nullptr;
+    r.p += sizeof(MAGIC);
+    if (r.u32() != VERSION)
+      return nullptr;
+
+    auto numStrings = r.u32();
+    strings.reserve(numStrings);
+    for (uint32_t i = 0; i < numStrings; i++) {
+      auto len = r.u32();
+      strings.push_back(r.bytes(len));
+    }
+
+    auto name = str();
+    auto info = src();
+    module = std::make_unique<Module>(name);
+    module->setSrcInfo(info);
+
+    readTypes();
+    readVars();
+    readValues();
+    return std::move(module);
+  }
+};
+
+} // namespace
+
+std::string serializeModule(const Module *module) {
+  ModuleWriter w;
+  return w.finish(module);
+}
+
+std::unique_ptr<Module> deserializeModule(const char *data, size_t size) {
+  try {
+    ModuleReader reader(data, size);
+    return reader.read();
+  } catch (ReadError &) {
+    return nullptr;
+  }
+}
+
+std::unique_ptr<Module> deserializeModule(const std::string &data) {
+  return deserializeModule(data.data(), data.size());
+}
+
+} // namespace util
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,44 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "codon/cir/cir.h"
+
+namespace codon {
+namespace ir {
+namespace util {
+
+/// Serializes a module to a compact binary blob. The format stores dense
+/// node tables (types, variables/functions, values) that reference each
+/// other by index or ID rather than by name, with all strings interned in
+/// a single table, and starts with a versioned header so readers can
+/// reject incompatible blobs. Typechecker (AST) linkage and plugin/DSL
+/// attributes are not preserved: a deserialized module is intended for
+/// backend consumption (codegen, caching, pass-pipeline snapshots), not
+/// for re-entering the frontend.
+/// @param module the module
+/// @return the serialized bytes, or an empty string if the module contains
+///         nodes that cannot be serialized (e.g. plugin DSL nodes)
+std::string serializeModule(const Module *module);
+
+/// Deserializes a module previously produced by serializeModule. The
+/// buffer is only read from — callers can hand in a memory-mapped file
+/// (e.g. an llvm::MemoryBuffer) without copying it first.
+/// @param data the buffer
+/// @param size the buffer size in bytes
+/// @return the module, or null if the buffer is malformed or was written
+///         by an incompatible serializer version
+std::unique_ptr<Module> deserializeModule(const char *data, size_t size);
+
+/// Deserializes a module previously produced by serializeModule.
+/// @param data the serialized bytes
+/// @return the module, or null if the buffer is malformed or was written
+///         by an incompatible serializer version
+std::unique_ptr<Module> deserializeModule(const std::string &data);
+
+} // namespace util
+} // namespace ir
+} // namespace codon
@@ -0,0 +1,120 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#include "compilation_cache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "codon/util/common.h"
+
+namespace codon {
+namespace {
+
+// 64-bit FNV-1a; two lanes with distinct offsets give a 128-bit key,
+// which is plenty for content addressing.
+const uint64_t FNV_OFFSET_1 = 0xcbf29ce484222325ull;
+const uint64_t FNV_OFFSET_2 = 0x84222325cbf29ce4ull;
+const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+uint64_t fnv1a(const std::string &data, uint64_t hash) {
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+std::string digest(const std::string &data, const std::string &salt) {
+  auto h1 = fnv1a(data, fnv1a(salt, FNV_OFFSET_1));
+  auto h2 = fnv1a(data, fnv1a(salt, FNV_OFFSET_2));
+  return fmt::format("{:016x}{:016x}", h1, h2);
+}
+
+bool makeDir(const std::string &path) {
+  return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+std::string getDefaultDir() {
+  if (auto *d = getenv("CODON_CACHE")) {
+    if (std::string(d) == "0")
+      return "";
+  }
+  if (auto *d = getenv("CODON_CACHE_DIR"))
+    return d;
+  if (auto *d = getenv("XDG_CACHE_HOME"))
+    return fmt::format("{}/codon", d);
+  if (auto *d = getenv("HOME"))
+    return fmt::format("{}/.codon/cache", d);
+  return "";
+}
+
+} // namespace
+
+CompilationCache::CompilationCache(const std::string &salt)
+    : dir(getDefaultDir()), salt(salt) {
+  if (!dir.empty() && !makeDir(dir))
+    dir = "";
+}
+
+std::string CompilationCache::getKey(const std::string &data) const {
+  return digest(data, salt);
+}
+
+std::string CompilationCache::combineKeys(const std::string &key,
+                                          const std::string &data) const {
+  return digest(key + data, salt);
+}
+
+std::string CompilationCache::getPath(const std::string &kind,
+                                      const std::string &key) const {
+  return fmt::format("{}/{}/{}", dir, kind, key);
+}
+
+bool CompilationCache::contains(const std::string &kind, const std::string &key) const {
+  if (!isEnabled())
+    return false;
+  struct stat st;
+  return stat(getPath(kind, key).c_str(), &st) == 0;
+}
+
+bool CompilationCache::lookup(const std::string &kind, const std::string &key,
+                              std::string &data) const {
+  if (!isEnabled())
+    return false;
+  std::ifstream fin(getPath(kind, key), std::ios::binary);
+  if (!fin)
+    return false;
+  std::ostringstream buf;
+  buf << fin.rdbuf();
+  data = buf.str();
+  return true;
+}
+
+void CompilationCache::store(const std::string &kind, const std::string &key,
+                             const std::string &data) const {
+  if (!isEnabled())
+    return;
+  if (!makeDir(fmt::format("{}/{}", dir, kind)))
+    return;
+  auto path = getPath(kind, key);
+  auto tmp = fmt::format("{}.tmp.{}", path, getpid());
+  {
+    std::ofstream fout(tmp, std::ios::binary);
+    if (!fout)
+      return;
+    fout.write(data.data(), data.size());
+    if (!fout) {
+      fout.close();
+      remove(tmp.c_str());
+      return;
+    }
+  }
+  if (rename(tmp.c_str(), path.c_str()) != 0)
+    remove(tmp.c_str());
+}
+
+} // namespace codon
@@ -0,0 +1,52 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace codon {
+
+/// Content-hash-keyed on-disk cache shared by compilation stages.
+/// Artifacts are stored under a per-user cache directory (overridable via
+/// the CODON_CACHE_DIR environment variable; CODON_CACHE=0 disables caching
+/// altogether) and are keyed by a digest that incorporates the compiler
+/// version, so stale entries from older builds are never observed. Writers
+/// publish entries atomically (write to a temporary file, then rename), so
+/// concurrent compilations can safely share one cache directory.
+class CompilationCache {
+private:
+  /// Root cache directory ("" if caching is disabled).
+  std::string dir;
+  /// Salt mixed into every key (compiler version and build mode).
+  std::string salt;
+
+public:
+  /// Construct a cache rooted at the default directory.
+  /// @param salt compiler version/build-mode string mixed into all keys
+  explicit CompilationCache(const std::string &salt);
+
+  /// true if the cache directory is usable
+  bool isEnabled() const { return !dir.empty(); }
+
+  /// Digest of the given buffer (salted); usable as a cache key.
+  std::string getKey(const std::string &data) const;
+  /// Combine an existing key with additional data (e.g. per-module hashes
+  /// into an import-closure digest).
+  std::string combineKeys(const std::string &key, const std::string &data) const;
+
+  /// true if an artifact of the given kind exists, without reading it
+  bool contains(const std::string &kind, const std::string &key) const;
+  /// Look up an artifact of the given kind (e.g. "ast", "obj", "ptx").
+  /// @return true and fill `data` on a hit
+  bool lookup(const std::string &kind, const std::string &key,
+              std::string &data) const;
+  /// Atomically store an artifact of the given kind.
+  void store(const std::string &kind, const std::string &key,
+             const std::string &data) const;
+
+private:
+  std::string getPath(const std::string &kind, const std::string &key) const;
+};
+
+} // namespace codon
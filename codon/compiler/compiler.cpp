@@ -2,6 +2,14 @@
 
 #include "compiler.h"
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "codon/cir/llvm/optimize.h"
+#include "codon/cir/util/serialize.h"
+#include "codon/compiler/compilation_cache.h"
 #include "codon/compiler/error.h"
 #include "codon/parser/cache.h"
 #include "codon/parser/peg/peg.h"
@@ -20,6 +28,8 @@ ir::transform::PassManager::Init getPassManagerInit(Compiler::Mode mode, bool is
   switch (mode) {
   case Compiler::Mode::DEBUG:
     return isTest ? PassManager::Init::RELEASE : PassManager::Init::DEBUG;
+  case Compiler::Mode::FAST:
+    return PassManager::Init::FAST;
   case Compiler::Mode::RELEASE:
     return PassManager::Init::RELEASE;
   case Compiler::Mode::JIT:
@@ -28,12 +38,27 @@ ir::transform::PassManager::Init getPassManagerInit(Compiler::Mode mode, bool is
     return PassManager::Init::EMPTY;
   }
 }
+
+/// Artifact kind of cached optimized-CIR modules. An artifact is a manifest
+/// (a file count, then one "<content-hash> <path>" line per module in the
+/// import closure) followed by the serialized module.
+const std::string CIR_CACHE_KIND = "cir";
+
+bool readFileContent(const std::string &path, std::string &out) {
+  std::ifstream fin(path, std::ios::binary);
+  if (!fin)
+    return false;
+  std::ostringstream buf;
+  buf << fin.rdbuf();
+  out = buf.str();
+  return true;
+}
 } // namespace
 
 Compiler::Compiler(const std::string &argv0, Compiler::Mode mode,
                    const std::vector<std::string> &disabledPasses, bool isTest,
                    bool pyNumerics, bool pyExtension)
-    : argv0(argv0), debug(mode == Mode::DEBUG), pyNumerics(pyNumerics),
+    : argv0(argv0), mode(mode), debug(mode == Mode::DEBUG), pyNumerics(pyNumerics),
       pyExtension(pyExtension), input(), plm(std::make_unique<PluginManager>(argv0)),
       cache(std::make_unique<ast::Cache>(argv0)),
       module(std::make_unique<ir::Module>()),
@@ -41,8 +66,15 @@ Compiler::Compiler(const std::string &argv0, Compiler::Mode mode,
           getPassManagerInit(mode, isTest), disabledPasses, pyNumerics, pyExtension)),
       llvisitor(std::make_unique<ir::LLVMVisitor>()) {
   cache->module = module.get();
+  if (mode == Mode::FAST)
+    ir::setFastOptimization();
+  cache->diskCache = std::make_shared<CompilationCache>(fmt::format(
+      "{}-{}", CODON_VERSION,
+      debug ? "debug" : (mode == Mode::FAST ? "fast" : "release")));
   cache->pythonExt = pyExtension;
   cache->pythonCompat = pyNumerics;
+  for (const auto &p : disabledPasses)
+    disabledPassKey += p + ";";
   module->setCache(cache.get());
   llvisitor->setDebug(debug);
   llvisitor->setPluginManager(plm.get());
@@ -73,7 +105,32 @@ Compiler::parse(bool isCode, const std::string &file, const std::string &code,
                 const std::unordered_map<std::string, std::string> &defines) {
   input = file;
   std::string abspath = (file != "-") ? ast::getAbsolutePath(file) : file;
+
+  // Warm path: if an optimized-CIR artifact exists for this entry module
+  // and every file in its recorded import closure is unchanged, load it and
+  // skip the frontend (parse, simplify, typecheck, translate) and the CIR
+  // pass pipeline entirely.
+  if (!isCode && file != "-" && testFlags == 0) {
+    irCacheKey = getIRCacheKey(abspath, defines);
+    if (!irCacheKey.empty() && loadCachedIR(irCacheKey)) {
+      LOG_TIME("[T] cir cache hit = {}", abspath);
+      getProfiler().count("cir_cache_hits", 1);
+      irFromCache = true;
+      cache->module0 = file;
+      module->setSrcInfo({abspath, 0, 0, 0});
+      return llvm::Error::success();
+    }
+  }
+
   try {
+    // Parse the standard library in the background while the input module is
+    // read and parsed; the typechecker only realizes what is actually used,
+    // so parsing is the dominant fixed cost of the stdlib on small inputs.
+    if (!in(cache->imports, STDLIB_IMPORT) && testFlags <= 1) {
+      if (auto stdlibPath =
+              ast::getImportFile(cache->argv0, STDLIB_INTERNAL_MODULE, "", true, file))
+        ast::prefetchFile(cache.get(), stdlibPath->path);
+    }
     ast::StmtPtr codeStmt = isCode
                                 ? ast::parseCode(cache.get(), abspath, code, startLine)
                                 : ast::parseFile(cache.get(), abspath);
@@ -87,6 +144,8 @@ Compiler::parse(bool isCode, const std::string &file, const std::string &code,
                                     getEarlyDefines(), (testFlags > 1));
     LOG_TIME("[T] parse = {:.1f}", totalPeg);
     LOG_TIME("[T] simplify = {:.1f}", t2.elapsed() - totalPeg);
+    getProfiler().record("phase", "parse", totalPeg);
+    getProfiler().record("phase", "simplify", t2.elapsed() - totalPeg);
 
     if (codon::getLogger().flags & codon::Logger::FLAG_USER) {
       auto fo = fopen("_dump_simplify.sexp", "w");
@@ -98,6 +157,19 @@ Compiler::parse(bool isCode, const std::string &file, const std::string &code,
     auto typechecked =
         ast::TypecheckVisitor::apply(cache.get(), std::move(transformed));
     t3.log();
+    getProfiler().record("phase", "typecheck", t3.elapsed());
+    if (getProfiler().enabled) {
+      int64_t funcRealizations = 0, classRealizations = 0;
+      for (auto &f : cache->functions)
+        funcRealizations += f.second.realizations.size();
+      for (auto &c : cache->classes)
+        classRealizations += c.second.realizations.size();
+      getProfiler().count("imports", cache->imports.size());
+      getProfiler().count("functions", cache->functions.size());
+      getProfiler().count("classes", cache->classes.size());
+      getProfiler().count("function_realizations", funcRealizations);
+      getProfiler().count("class_realizations", classRealizations);
+    }
     if (codon::getLogger().flags & codon::Logger::FLAG_USER) {
       auto fo = fopen("_dump_typecheck.sexp", "w");
       fmt::print(fo, "{}\n", typechecked->toString(0));
@@ -111,6 +183,7 @@ Compiler::parse(bool isCode, const std::string &file, const std::string &code,
     Timer t4("translate");
     ast::TranslateVisitor::apply(cache.get(), std::move(typechecked));
     t4.log();
+    getProfiler().record("phase", "translate", t4.elapsed());
   } catch (const exc::ParserException &exc) {
     std::vector<error::Message> messages;
     if (exc.messages.empty()) {
@@ -154,14 +227,131 @@ Compiler::parseCode(const std::string &file, const std::string &code, int startL
   return parse(/*isCode=*/true, file, code, startLine, testFlags, defines);
 }
 
+std::string
+Compiler::getIRCacheKey(const std::string &abspath,
+                        const std::unordered_map<std::string, std::string> &defines) {
+  // JIT sessions and Python extensions keep the frontend alive and reuse
+  // it after compilation; plugins contribute DSL passes whose effect the
+  // key cannot see. None of those compilations use the artifact cache.
+  if (mode == Mode::JIT || pyExtension || !cache->diskCache ||
+      !cache->diskCache->isEnabled())
+    return "";
+  if (plm->begin() != plm->end())
+    return "";
+  std::string content;
+  if (!readFileContent(abspath, content))
+    return "";
+  // anything that changes the produced IR must feed the key: entry content
+  // and location, the compiler location (import resolution), the pass
+  // configuration and all defines (the disk-cache salt already covers the
+  // compiler version and build mode)
+  auto &dc = *cache->diskCache;
+  auto key = dc.getKey(content);
+  key = dc.combineKeys(key, abspath);
+  key = dc.combineKeys(key, argv0);
+  key = dc.combineKeys(key, disabledPassKey);
+  std::map<std::string, std::string> sorted(defines.begin(), defines.end());
+  auto early = getEarlyDefines();
+  sorted.insert(early.begin(), early.end());
+  for (auto &[name, value] : sorted)
+    key = dc.combineKeys(key, name + "=" + value);
+  return key;
+}
+
+bool Compiler::loadCachedIR(const std::string &key) {
+  std::string data;
+  if (!cache->diskCache->lookup(CIR_CACHE_KIND, key, data))
+    return false;
+
+  // Verify the manifest: every file recorded in the import closure must
+  // still be present with unchanged content. (Like depfile-based caches,
+  // this does not detect a new file shadowing an import earlier on the
+  // search path.)
+  size_t pos = 0;
+  auto nextLine = [&](std::string &line) {
+    auto nl = data.find('\n', pos);
+    if (nl == std::string::npos)
+      return false;
+    line = data.substr(pos, nl - pos);
+    pos = nl + 1;
+    return true;
+  };
+  std::string line;
+  if (!nextLine(line))
+    return false;
+  long files = strtol(line.c_str(), nullptr, 10);
+  if (files <= 0)
+    return false;
+  for (long i = 0; i < files; i++) {
+    if (!nextLine(line))
+      return false;
+    auto sep = line.find(' ');
+    if (sep == std::string::npos)
+      return false;
+    auto hash = line.substr(0, sep);
+    auto path = line.substr(sep + 1);
+    std::string content;
+    if (!readFileContent(path, content) || cache->diskCache->getKey(content) != hash)
+      return false;
+  }
+
+  auto loaded = ir::util::deserializeModule(data.data() + pos, data.size() - pos);
+  if (!loaded)
+    return false;
+  module = std::move(loaded);
+  module->setCache(cache.get());
+  cache->module = module.get();
+  return true;
+}
+
+void Compiler::storeCachedIR(const std::string &key) {
+  auto blob = ir::util::serializeModule(module.get());
+  if (blob.empty()) // module contains nodes the serializer cannot encode
+    return;
+  std::vector<std::string> manifest;
+  for (const auto &[path, import] : cache->imports) {
+    if (import.contentHash.empty() || path == STDLIB_IMPORT || path == "-")
+      continue;
+    manifest.push_back(fmt::format("{} {}", import.contentHash, path));
+  }
+  if (manifest.empty())
+    return;
+  std::sort(manifest.begin(), manifest.end());
+  std::string out = fmt::format("{}\n", manifest.size());
+  for (const auto &entry : manifest)
+    out += entry + "\n";
+  out += blob;
+  cache->diskCache->store(CIR_CACHE_KIND, key, out);
+}
+
 llvm::Error Compiler::compile() {
-  pm->run(module.get());
-  if (codon::getLogger().flags & codon::Logger::FLAG_USER) {
-    auto fo = fopen("_dump_ir_opt.sexp", "w");
-    fmt::print(fo, "{}\n", *module);
-    fclose(fo);
+  if (!irFromCache) {
+    Timer t1("ir_passes");
+    t1.logged = true;
+    pm->run(module.get());
+    getProfiler().record("phase", "ir_passes", t1.elapsed());
+    if (codon::getLogger().flags & codon::Logger::FLAG_USER) {
+      auto fo = fopen("_dump_ir_opt.sexp", "w");
+      fmt::print(fo, "{}\n", *module);
+      fclose(fo);
+    }
+    // Store the optimized module for warm builds while Cache::imports still
+    // holds the content hashes the manifest needs.
+    if (!irCacheKey.empty())
+      storeCachedIR(irCacheKey);
+    // Phase boundary: CIR passes were the last consumer of the frontend's
+    // ASTs and type machinery, so drop them before LLVM allocates its own
+    // module to keep both out of the peak. The JIT needs the frontend for
+    // later inputs and the Python-extension path reads the cache after
+    // compilation, so both keep it.
+    if (mode != Mode::JIT && !pyExtension)
+      cache->releaseFrontend();
   }
+
+  Timer t2("codegen");
+  t2.logged = true;
   llvisitor->visit(module.get());
+  getProfiler().record("phase", "codegen", t2.elapsed());
   if (codon::getLogger().flags & codon::Logger::FLAG_USER) {
     auto fo = fopen("_dump_llvm.ll", "w");
     std::string str;
@@ -20,12 +20,14 @@ class Compiler {
 public:
   enum Mode {
     DEBUG,
+    FAST,
     RELEASE,
     JIT,
   };
 
 private:
   std::string argv0;
+  Mode mode;
   bool debug;
   bool pyNumerics;
   bool pyExtension;
@@ -35,11 +37,32 @@ private:
   std::unique_ptr<ir::Module> module;
   std::unique_ptr<ir::transform::PassManager> pm;
   std::unique_ptr<ir::LLVMVisitor> llvisitor;
+  /// set when the module was loaded from the optimized-CIR artifact cache,
+  /// in which case the frontend and the CIR pass pipeline are both skipped
+  bool irFromCache = false;
+  /// artifact-cache key of this compilation ("" when not cacheable)
+  std::string irCacheKey;
+  /// disabled-pass list, mixed into the artifact key since it changes the
+  /// stored IR
+  std::string disabledPassKey;
 
   llvm::Error parse(bool isCode, const std::string &file, const std::string &code,
                     int startLine, int testFlags,
                     const std::unordered_map<std::string, std::string> &defines);
 
+  /// Computes the optimized-CIR artifact key for the entry module, or ""
+  /// if this compilation cannot use the artifact cache.
+  std::string
+  getIRCacheKey(const std::string &abspath,
+                const std::unordered_map<std::string, std::string> &defines);
+  /// Loads a cached optimized module after verifying its import-closure
+  /// manifest against the files currently on disk.
+  /// @return true if the module was loaded
+  bool loadCachedIR(const std::string &key);
+  /// Serializes the optimized module together with its import-closure
+  /// manifest. Must run before the frontend state is released.
+  void storeCachedIR(const std::string &key);
+
 public:
   Compiler(const std::string &argv0, Mode mode,
            const std::vector<std::string> &disabledPasses = {}, bool isTest = false,
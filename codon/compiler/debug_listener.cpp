@@ -3,9 +3,18 @@
 #include "debug_listener.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <ctime>
 #include <functional>
 #include <sstream>
 
+#ifdef __linux__
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "codon/runtime/lib.h"
 
 namespace codon {
@@ -24,6 +33,173 @@ makeBacktrace(const std::vector<uintptr_t> &backtrace,
   }
   return buf.str();
 }
+
+#ifdef __linux__
+/// Emits Linux 'perf' profiling metadata for JIT-compiled functions: plain
+/// /tmp/perf-<pid>.map entries (picked up by 'perf report' directly) and a
+/// jitdump file (for 'perf inject --jit', which also recovers line info).
+/// Opt-in via the CODON_PERF environment variable since it writes files and
+/// keeps a copy of every emitted function's code range on disk. The jitdump
+/// file goes to $JITDUMPDIR or the working directory, per perf's convention.
+class PerfJITSupport {
+private:
+  struct JitDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+  };
+
+  struct JitDumpCodeLoad {
+    uint32_t id;
+    uint32_t totalSize;
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddr;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+  };
+
+  static const uint32_t JITDUMP_MAGIC = 0x4A695444; // "JiTD"
+  static const uint32_t JITDUMP_VERSION = 1;
+  static const uint32_t JIT_CODE_LOAD = 0;
+
+  std::mutex mutex;
+  FILE *mapFile = nullptr;
+  FILE *dumpFile = nullptr;
+  uint64_t codeIndex = 0;
+
+  static uint64_t timestamp() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+  }
+
+  static uint32_t elfMachine() {
+#if defined(__x86_64__)
+    return EM_X86_64;
+#elif defined(__aarch64__)
+    return EM_AARCH64;
+#else
+    return EM_NONE;
+#endif
+  }
+
+  PerfJITSupport() {
+    if (!getenv("CODON_PERF"))
+      return;
+
+    auto pid = uint32_t(getpid());
+    mapFile = fopen(fmt::format("/tmp/perf-{}.map", pid).c_str(), "w");
+
+    const char *dir = getenv("JITDUMPDIR");
+    dumpFile = fopen(
+        fmt::format("{}/jit-{}.dump", (dir && *dir) ? dir : ".", pid).c_str(), "wb");
+    if (dumpFile) {
+      JitDumpHeader header = {JITDUMP_MAGIC, JITDUMP_VERSION, sizeof(JitDumpHeader),
+                              elfMachine(),  /*pad1=*/0,      pid,
+                              timestamp(),   /*flags=*/0};
+      fwrite(&header, sizeof(header), 1, dumpFile);
+      fflush(dumpFile);
+      // perf finds the jitdump file through an mmap record for it in the
+      // trace, so map the first page executable for the process lifetime.
+      mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE,
+           fileno(dumpFile), 0);
+    }
+  }
+
+public:
+  static PerfJITSupport &get() {
+    static PerfJITSupport instance;
+    return instance;
+  }
+
+  bool isEnabled() const { return mapFile || dumpFile; }
+
+  /// Records one JIT-compiled function at the given load address.
+  void registerCode(llvm::StringRef name, uintptr_t addr, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mapFile) {
+      fprintf(mapFile, "%lx %lx %.*s\n", (unsigned long)addr, (unsigned long)size,
+              (int)name.size(), name.data());
+      fflush(mapFile);
+    }
+    if (dumpFile) {
+      JitDumpCodeLoad load = {JIT_CODE_LOAD,
+                              uint32_t(sizeof(JitDumpCodeLoad) + name.size() + 1 +
+                                       size),
+                              timestamp(),
+                              uint32_t(getpid()),
+                              uint32_t(syscall(SYS_gettid)),
+                              uint64_t(addr),
+                              uint64_t(addr),
+                              uint64_t(size),
+                              codeIndex++};
+      fwrite(&load, sizeof(load), 1, dumpFile);
+      fwrite(name.data(), 1, name.size(), dumpFile);
+      fputc('\0', dumpFile);
+      fwrite(reinterpret_cast<const void *>(addr), 1, size, dumpFile);
+      fflush(dumpFile);
+    }
+  }
+};
+#endif
+
+/// Records every function of a freshly loaded JIT object with perf, given a
+/// callback mapping an object section to its load address (0 if unmapped).
+/// No-op unless profiling support is enabled (Linux with CODON_PERF set).
+void notifyPerf(const llvm::object::ObjectFile &obj,
+                std::function<uint64_t(const llvm::object::SectionRef &)>
+                    getSectionLoadAddress) {
+#ifdef __linux__
+  auto &perf = PerfJITSupport::get();
+  if (!perf.isEnabled() || !obj.isELF())
+    return;
+
+  for (const auto &sym : obj.symbols()) {
+    auto type = sym.getType();
+    if (!type) {
+      llvm::consumeError(type.takeError());
+      continue;
+    }
+    if (*type != llvm::object::SymbolRef::ST_Function)
+      continue;
+
+    auto name = sym.getName();
+    if (!name) {
+      llvm::consumeError(name.takeError());
+      continue;
+    }
+
+    auto secOr = sym.getSection();
+    if (!secOr) {
+      llvm::consumeError(secOr.takeError());
+      continue;
+    }
+    if (*secOr == obj.section_end() || !(*secOr)->isText())
+      continue;
+
+    auto addrOr = sym.getAddress();
+    if (!addrOr) {
+      llvm::consumeError(addrOr.takeError());
+      continue;
+    }
+
+    uint64_t load = getSectionLoadAddress(**secOr);
+    uint64_t size = llvm::object::ELFSymbolRef(sym).getSize();
+    if (!load || !size || name->empty())
+      continue;
+
+    perf.registerCode(*name, load + (*addrOr - (*secOr)->getAddress()), size);
+  }
+#endif
+}
 } // namespace
 
 void DebugListener::notifyObjectLoaded(ObjectKey key,
@@ -40,6 +216,9 @@ void DebugListener::notifyObjectLoaded(ObjectKey key,
   auto buf = llvm::MemoryBuffer::getMemBufferCopy(obj.getData(), obj.getFileName());
   auto newObj = llvm::cantFail(
       llvm::object::ObjectFile::createObjectFile(buf->getMemBufferRef()));
+  notifyPerf(obj, [&L](const llvm::object::SectionRef &sec) {
+    return L.getSectionLoadAddress(sec);
+  });
   objects.emplace_back(key, std::move(newObj), std::move(buf), start, stop);
 }
 
@@ -110,6 +289,16 @@ llvm::Error DebugPlugin::notifyEmitted(llvm::orc::MaterializationResponsibility
     };
 
     // register(*newInfo->Object, getLoadAddress, nullptr)
+
+    notifyPerf(*newInfo->object,
+               [&getLoadAddress](const llvm::object::SectionRef &sec) -> uint64_t {
+                 auto name = sec.getName();
+                 if (!name) {
+                   llvm::consumeError(name.takeError());
+                   return 0;
+                 }
+                 return getLoadAddress(*name);
+               });
   }
 
   llvm::cantFail(mr.withResourceKeyDo([&](llvm::orc::ResourceKey key) {
@@ -2,8 +2,143 @@
 
 #include "engine.h"
 
+#include <cstdlib>
+#include <thread>
+
 #include "codon/cir/llvm/optimize.h"
+#include "codon/compiler/compilation_cache.h"
 #include "codon/compiler/memory_manager.h"
+#include "codon/util/common.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+
+namespace {
+unsigned getCompileThreads() {
+  if (const char *env = getenv("CODON_JIT_THREADS")) {
+    auto n = atoi(env);
+    if (n >= 0)
+      return (unsigned)n;
+  }
+  auto n = std::thread::hardware_concurrency();
+  return n ? n : 1;
+}
+
+bool getSpeculationEnabled() {
+  if (const char *env = getenv("CODON_JIT_SPECULATE"))
+    return *env && *env != '0';
+  return true;
+}
+
+// Tiered compilation (CODON_JIT_TIER=1, off by default): compile new
+// modules with the cheap pipeline so cells start running immediately, and
+// recompile them at full optimization in the background into the object
+// cache. Compiled code is not repatched in place -- ORC gives us no safe
+// way to retarget already-bound calls -- so the optimized object is picked
+// up by the next compilation of the same IR: a re-run cell, or the next
+// session.
+bool getTieredEnabled() {
+  if (const char *env = getenv("CODON_JIT_TIER"))
+    return *env && *env != '0';
+  return false;
+}
+
+// On-disk ORC object cache shared by all JIT sessions. Modules are keyed by
+// their (optimized) IR, salted with compiler version and host, so a fresh
+// REPL or Jupyter session maps in the objects of the stdlib preamble and
+// wrapper functions compiled by previous sessions.
+class DiskObjectCache : public llvm::ObjectCache {
+private:
+  /// Named metadata carrying a module's cache key, stamped before
+  /// optimization so hits can skip the optimization pipeline too.
+  static constexpr const char *KEY_MD = "codon.jit.cache.key";
+
+  /// Named metadata marking a module as compiled by the fast tier; such
+  /// objects are for this session's latency only and never published.
+  static constexpr const char *FAST_MD = "codon.jit.cache.fast.tier";
+
+  codon::CompilationCache cache;
+
+public:
+  DiskObjectCache()
+      : cache(fmt::format("{}-jit-{}-{}", CODON_VERSION, llvm::sys::getProcessTriple(),
+                          llvm::sys::getHostCPUName().str())) {}
+
+  bool isEnabled() const { return cache.isEnabled(); }
+
+  /// Digest of the module's current (pre-optimization) IR.
+  std::string keyForIR(llvm::Module &module) const {
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    module.print(os, nullptr);
+    return cache.getKey(ir);
+  }
+
+  /// Stamp the module with its cache key so later stages (which see the
+  /// module after optimization) store and look up under the same key.
+  void tag(llvm::Module &module, const std::string &key) const {
+    auto &ctx = module.getContext();
+    auto *md = module.getOrInsertNamedMetadata(KEY_MD);
+    md->clearOperands();
+    md->addOperand(llvm::MDNode::get(ctx, llvm::MDString::get(ctx, key)));
+  }
+
+  /// true if an object for the given key is already on disk
+  bool has(const std::string &key) const { return cache.contains("jit", key); }
+
+  /// Mark a module as fast-tier so its object is kept out of the cache.
+  void markFastTier(llvm::Module &module) const {
+    module.getOrInsertNamedMetadata(FAST_MD);
+  }
+
+  /// Stores an object compiled outside the normal pipeline (e.g. by the
+  /// background reoptimization worker), overwriting any existing entry.
+  void storeObject(const std::string &key, llvm::StringRef data) const {
+    cache.store("jit", key, data.str());
+  }
+
+  void notifyObjectCompiled(const llvm::Module *module,
+                            llvm::MemoryBufferRef obj) override {
+    // Fast-tier objects exist for this session's latency only: publishing
+    // one would make every later session hit the key and skip optimization
+    // for good if the background reoptimizer never drains its queue (e.g.
+    // the session exits first). Only the reoptimizer's storeObject() may
+    // publish under a fast-tier module's key.
+    if (module->getNamedMetadata(FAST_MD))
+      return;
+    auto k = key(module);
+    // never downgrade an entry: a concurrent reoptimization of the same IR
+    // may already have published a fully optimized object under this key
+    if (cache.contains("jit", k))
+      return;
+    cache.store("jit", k, obj.getBuffer().str());
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override {
+    std::string data;
+    if (!cache.lookup("jit", key(module), data))
+      return nullptr;
+    return llvm::MemoryBuffer::getMemBufferCopy(data, module->getModuleIdentifier());
+  }
+
+private:
+  std::string key(const llvm::Module *module) const {
+    if (auto *md = module->getNamedMetadata(KEY_MD)) {
+      if (md->getNumOperands() > 0 && md->getOperand(0)->getNumOperands() > 0) {
+        if (auto *s = llvm::dyn_cast<llvm::MDString>(md->getOperand(0)->getOperand(0)))
+          return s->getString().str();
+      }
+    }
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    module->print(os, nullptr);
+    return cache.getKey(ir);
+  }
+};
+
+DiskObjectCache &getDiskObjectCache() {
+  static DiskObjectCache cache;
+  return cache;
+}
+} // namespace
 
 namespace codon {
 namespace jit {
@@ -16,10 +151,18 @@ Engine::Engine() : jit(), debug(nullptr) {
 
   auto target = eb.selectTarget();
   auto layout = target->createDataLayout();
+  // The engine is tied to in-process execution. A remote executor (e.g.
+  // SimpleRemoteEPC in place of SelfExecutorProcessControl) would also need:
+  // the codon runtime loaded in the executor process in place of the
+  // GetForCurrentProcess generator below; a memory manager on the executor
+  // side in place of BoehmGCJITLinkMemoryManager, whose GC roots only make
+  // sense in this process; and non-lazy materialization, since LLLazyJIT's
+  // call-through stubs are created in local memory. Until those land, code
+  // runs where it is compiled.
   auto epc = llvm::cantFail(llvm::orc::SelfExecutorProcessControl::Create(
       std::make_shared<llvm::orc::SymbolStringPool>()));
 
-  llvm::orc::LLJITBuilder builder;
+  llvm::orc::LLLazyJITBuilder builder;
   builder.setDataLayout(layout);
   builder.setObjectLinkingLayerCreator(
       [&](llvm::orc::ExecutionSession &es, const llvm::Triple &triple)
@@ -38,33 +181,208 @@ Engine::Engine() : jit(), debug(nullptr) {
       });
   builder.setJITTargetMachineBuilder(
       llvm::orc::JITTargetMachineBuilder(target->getTargetTriple()));
+  // Optimize and compile materialized modules on a thread pool (LLJIT clones
+  // each module into a fresh context on emit, so compiles are independent);
+  // CODON_JIT_THREADS overrides, 0 compiles in place on the calling thread.
+  builder.setNumCompileThreads(getCompileThreads());
+  builder.setCompileFunctionCreator(
+      [](llvm::orc::JITTargetMachineBuilder jtmb)
+          -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+        auto &objCache = getDiskObjectCache();
+        auto *cache = objCache.isEnabled() ? &objCache : nullptr;
+        if (getCompileThreads() > 0)
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb),
+                                                                   cache);
+        auto tm = jtmb.createTargetMachine();
+        if (!tm)
+          return tm.takeError();
+        return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(*tm),
+                                                                   cache);
+      });
   jit = llvm::cantFail(builder.create());
+  // Only compile the functions a lookup actually reaches; everything else
+  // stays as a lazy reexport until first call.
+  jit->setPartitionFunction(llvm::orc::CompileOnDemandLayer::compileRequested);
 
   jit->getMainJITDylib().addGenerator(
       llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
           layout.getGlobalPrefix())));
 
   jit->getIRTransformLayer().setTransform(
-      [&](llvm::orc::ThreadSafeModule module,
-          const llvm::orc::MaterializationResponsibility &R) {
-        module.withModuleDo([](llvm::Module &module) {
+      [this](llvm::orc::ThreadSafeModule module,
+             const llvm::orc::MaterializationResponsibility &R) {
+        module.withModuleDo([this](llvm::Module &module) {
+          // Key the object cache on the pre-optimization IR and probe it
+          // here: on a hit the compiler loads the cached object directly,
+          // so the optimization pipeline can be skipped as well. This is
+          // what lets a fresh session -- e.g. a Python process importing
+          // @codon.jit helpers -- reuse yesterday's objects instead of
+          // re-optimizing them.
+          auto &cache = getDiskObjectCache();
+          if (cache.isEnabled()) {
+            auto key = cache.keyForIR(module);
+            cache.tag(module, key);
+            if (cache.has(key))
+              return;
+            if (getTieredEnabled()) {
+              // Fast tier: run the cheap pipeline now and queue the IR for
+              // full optimization in the background. The resulting object
+              // is marked so it never reaches the shared cache; only the
+              // reoptimizer publishes under this key.
+              cache.markFastTier(module);
+              std::string ir;
+              llvm::raw_string_ostream os(ir);
+              module.print(os, nullptr);
+              enqueueReoptimization(key, std::move(ir));
+              ir::optimize(&module, /*debug=*/true, /*jit=*/true);
+              return;
+            }
+          }
           ir::optimize(&module, /*debug=*/false, /*jit=*/true);
         });
         return std::move(module);
       });
 }
 
+Engine::~Engine() {
+  speculationStop = true;
+  reoptStop = true;
+  if (speculationWorker.joinable())
+    speculationWorker.join();
+  if (reoptWorker.joinable())
+    reoptWorker.join();
+}
+
+void Engine::enqueueReoptimization(const std::string &key, std::string ir) {
+  {
+    std::lock_guard<std::mutex> lock(reoptMutex);
+    reoptQueue.emplace_back(key, std::move(ir));
+  }
+  if (reoptStop || reoptRunning.exchange(true))
+    return;
+  if (reoptWorker.joinable())
+    reoptWorker.join();
+
+  reoptWorker = std::thread([this] {
+    while (!reoptStop) {
+      std::pair<std::string, std::string> job;
+      {
+        std::lock_guard<std::mutex> lock(reoptMutex);
+        if (reoptQueue.empty())
+          break;
+        job = std::move(reoptQueue.back());
+        reoptQueue.pop_back();
+      }
+
+      // The IR was serialized by the fast tier, so the module can be
+      // rebuilt in a private context without touching the JIT's.
+      llvm::LLVMContext ctx;
+      llvm::SMDiagnostic err;
+      auto mod = llvm::parseIR(llvm::MemoryBufferRef(job.second, "<reopt>"), err, ctx);
+      if (!mod)
+        continue;
+      ir::optimize(mod.get(), /*debug=*/false, /*jit=*/true);
+
+      auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+      if (!jtmb) {
+        llvm::consumeError(jtmb.takeError());
+        continue;
+      }
+      auto tm = jtmb->createTargetMachine();
+      if (!tm) {
+        llvm::consumeError(tm.takeError());
+        continue;
+      }
+      llvm::orc::SimpleCompiler compile(**tm);
+      if (auto obj = compile(*mod))
+        getDiskObjectCache().storeObject(job.first, (*obj)->getBuffer());
+      else
+        llvm::consumeError(obj.takeError());
+    }
+    reoptRunning = false;
+  });
+}
+
 llvm::Error Engine::addModule(llvm::orc::ThreadSafeModule module,
                               llvm::orc::ResourceTrackerSP rt) {
-  if (!rt)
-    rt = jit->getMainJITDylib().getDefaultResourceTracker();
+  // Record the module's definitions as speculation candidates before the
+  // module is moved into the JIT; a cheap use-count walk stands in for the
+  // call graph, so the most-called functions are compiled first.
+  if (getSpeculationEnabled()) {
+    module.withModuleDo([&](llvm::Module &m) {
+      std::lock_guard<std::mutex> lock(speculationMutex);
+      for (auto &f : m) {
+        if (f.isDeclaration() || f.hasLocalLinkage() || f.getName() == "main")
+          continue;
+        speculationCandidates[f.getName().str()] += f.getNumUses();
+      }
+    });
+  }
+
+  if (rt)
+    return jit->getCompileOnDemandLayer().add(std::move(rt), std::move(module));
 
-  return jit->addIRModule(rt, std::move(module));
+  return jit->addLazyIRModule(jit->getMainJITDylib(), std::move(module));
 }
 
 llvm::Expected<llvm::orc::ExecutorAddr> Engine::lookup(llvm::StringRef name) {
   return jit->lookup(name);
 }
 
+void Engine::speculate() {
+  if (!getSpeculationEnabled() || speculationStop ||
+      speculationRunning.exchange(true))
+    return;
+  {
+    std::lock_guard<std::mutex> lock(speculationMutex);
+    if (speculationCandidates.empty()) {
+      speculationRunning = false;
+      return;
+    }
+  }
+  if (speculationWorker.joinable())
+    speculationWorker.join();
+
+  speculationWorker = std::thread([this] {
+    auto &es = jit->getExecutionSession();
+    llvm::orc::MangleAndInterner mangle(es, jit->getDataLayout());
+    while (!speculationStop) {
+      std::string name;
+      {
+        std::lock_guard<std::mutex> lock(speculationMutex);
+        if (speculationCandidates.empty())
+          break;
+        auto best = speculationCandidates.begin();
+        for (auto it = speculationCandidates.begin();
+             it != speculationCandidates.end(); ++it) {
+          if (it->second > best->second)
+            best = it;
+        }
+        name = best->first;
+        speculationCandidates.erase(best);
+      }
+
+      // Make sure the function's lazy reexport exists; this materializes
+      // the containing module's stubs but compiles nothing.
+      if (auto stub = jit->lookup(name)) {
+        // Compiling ahead of the first call means looking the body up in
+        // the implementation dylib behind the lazy reexports; the stub in
+        // the main dylib is bound to the compiled body on its first call.
+        auto implName = jit->getMainJITDylib().getName() + ".impl";
+        if (auto *implD = es.getJITDylibByName(implName)) {
+          if (auto body = es.lookup(llvm::orc::makeJITDylibSearchOrder(implD),
+                                    mangle(name)))
+            continue;
+          else
+            llvm::consumeError(body.takeError());
+        }
+      } else {
+        llvm::consumeError(stub.takeError());
+      }
+    }
+    speculationRunning = false;
+  });
+}
+
 } // namespace jit
 } // namespace codon
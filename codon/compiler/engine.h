@@ -2,7 +2,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "codon/cir/llvm/llvm.h"
@@ -13,11 +18,34 @@ namespace jit {
 
 class Engine {
 private:
-  std::unique_ptr<llvm::orc::LLJIT> jit;
+  std::unique_ptr<llvm::orc::LLLazyJIT> jit;
   DebugPlugin *debug;
 
+  /// Speculative-compilation state: functions defined by added modules that
+  /// have not been compiled yet, keyed by name with their static call-site
+  /// counts, plus the background worker that compiles them.
+  std::map<std::string, unsigned> speculationCandidates;
+  std::mutex speculationMutex;
+  std::thread speculationWorker;
+  std::atomic<bool> speculationRunning{false};
+  std::atomic<bool> speculationStop{false};
+
+  /// Tiered-compilation state: pre-optimization IR of modules compiled at
+  /// the fast tier, keyed by object-cache key, waiting to be recompiled at
+  /// full optimization by the background worker.
+  std::vector<std::pair<std::string, std::string>> reoptQueue;
+  std::mutex reoptMutex;
+  std::thread reoptWorker;
+  std::atomic<bool> reoptRunning{false};
+  std::atomic<bool> reoptStop{false};
+
+  /// Queues the given IR for background recompilation at full optimization;
+  /// the result is published to the on-disk object cache under `key`.
+  void enqueueReoptimization(const std::string &key, std::string ir);
+
 public:
   Engine();
+  ~Engine();
 
   const llvm::DataLayout &getDataLayout() const { return jit->getDataLayout(); }
 
@@ -29,6 +57,11 @@ public:
                         llvm::orc::ResourceTrackerSP rt = nullptr);
 
   llvm::Expected<llvm::orc::ExecutorAddr> lookup(llvm::StringRef name);
+
+  /// Background-compiles functions statically reachable from added modules,
+  /// most-called first, so their first call hits warm code. Returns
+  /// immediately; intended to be called when the session goes idle.
+  void speculate();
 };
 
 } // namespace jit
@@ -57,6 +57,9 @@ llvm::Error JIT::init() {
 
   auto *main = func->toPtr<MainFunc>();
   (*main)(0, nullptr);
+  // First lookup only compiled what startup reached; warm the rest of the
+  // preamble in the background while the session waits for input.
+  engine->speculate();
   return llvm::Error::success();
 }
 
@@ -74,10 +77,13 @@ llvm::Error JIT::compile(const ir::Func *input) {
   t2.log();
 
   Timer t3("jit/engine");
-  if (auto err = engine->addModule({std::move(pair.first), std::move(pair.second)}))
+  auto rt = engine->getMainJITDylib().createResourceTracker();
+  if (auto err =
+          engine->addModule({std::move(pair.first), std::move(pair.second)}, rt))
     return std::move(err);
   t3.log();
 
+  inputTrackers[ir::LLVMVisitor::getNameForFunction(input)] = std::move(rt);
   return llvm::Error::success();
 }
 
@@ -87,6 +93,16 @@ llvm::Expected<ir::Func *> JIT::compile(const std::string &code,
   auto sctx = cache->imports[MAIN_IMPORT].ctx;
   auto preamble = std::make_shared<std::vector<ast::StmtPtr>>();
 
+  auto numGlobals = [](ir::Module *m) {
+    size_t n = 0;
+    for (auto *var : *m) {
+      if (!ir::isA<ir::Func>(var) && var->isGlobal())
+        ++n;
+    }
+    return n;
+  };
+  auto globalsBefore = numGlobals(compiler->getModule());
+
   ast::Cache bCache = *cache;
   ast::SimplifyContext bSimplify = *sctx;
   ast::SimplifyContext stdlibSimplify = *(cache->imports[STDLIB_IMPORT].ctx);
@@ -126,6 +142,21 @@ llvm::Expected<ir::Func *> JIT::compile(const std::string &code,
         ast::TranslateVisitor::apply(cache, std::make_shared<ast::SuiteStmt>(v));
     cache->jitCell++;
 
+    // A cell that defines nothing reusable by later cells -- no new global
+    // variables and no realized functions beyond its own entry -- only ever
+    // runs once, so its machine code can be reclaimed after it executes.
+    bool transient = numGlobals(compiler->getModule()) == globalsBefore;
+    if (transient) {
+      for (ir::Func **fr : frs) {
+        if (*fr && *fr != func) {
+          transient = false;
+          break;
+        }
+      }
+    }
+    if (transient)
+      transientInputs.insert(func);
+
     return func;
   } catch (const exc::ParserException &exc) {
     std::vector<error::Message> messages;
@@ -183,6 +214,23 @@ llvm::Expected<std::string> JIT::run(const ir::Func *input) {
   } catch (const runtime::JITError &e) {
     return handleJITError(e);
   }
+
+  // Free the machine code of one-shot inputs; long REPL sessions otherwise
+  // accumulate the code of every cell ever executed.
+  if (transientInputs.erase(input)) {
+    auto it = inputTrackers.find(ir::LLVMVisitor::getNameForFunction(input));
+    if (it != inputTrackers.end()) {
+      if (auto err = it->second->remove())
+        return std::move(err);
+      inputTrackers.erase(it);
+      // a later module may be handed the freed code's LSDA addresses, so
+      // drop any decoded tables cached against them
+      seq_exc_lsda_cache_invalidate();
+    }
+  }
+  // The session is about to go idle; background-compile whatever this
+  // input made reachable so the next request starts warm.
+  engine->speculate();
   return runtime::getCapturedOutput();
 }
 
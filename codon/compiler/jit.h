@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "codon/cir/llvm/llvisitor.h"
@@ -36,6 +37,13 @@ private:
   std::unique_ptr<Engine> engine;
   std::unique_ptr<PythonData> pydata;
   std::string mode;
+  /// Resource tracker for each compiled input's machine code, keyed by the
+  /// input function's mangled name.
+  std::unordered_map<std::string, llvm::orc::ResourceTrackerSP> inputTrackers;
+  /// Inputs that define nothing reusable by later cells (no new global
+  /// variables and no realized functions beyond the input itself); their
+  /// machine code is reclaimed right after they run.
+  std::unordered_set<const ir::Func *> transientInputs;
 
 public:
   explicit JIT(const std::string &argv0, const std::string &mode = "");
@@ -2,10 +2,21 @@
 
 #include "memory_manager.h"
 
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 #include "codon/runtime/lib.h"
 
 namespace codon {
 
+namespace {
+/// Huge page size assumed when advising the kernel on slab mappings.
+const size_t HugePageSize = 2 * 1024 * 1024;
+} // namespace
+
 BoehmGCMemoryManager::BoehmGCMemoryManager() : SectionMemoryManager(), roots() {}
 
 uint8_t *BoehmGCMemoryManager::allocateDataSection(uintptr_t size, unsigned alignment,
@@ -153,15 +164,26 @@ void BoehmGCJITLinkMemoryManager::allocate(const llvm::jitlink::JITLinkDylib *JD
         static_cast<llvm::sys::Memory::ProtectionFlags>(llvm::sys::Memory::MF_READ |
                                                         llvm::sys::Memory::MF_WRITE);
 
+    // Round large slabs up to a huge page multiple and ask the kernel to
+    // back them with transparent huge pages: tens of MB of JIT code on
+    // base-size pages otherwise thrashes the iTLB.
+    auto SlabSize = SegsSizes->total();
+    if (SlabSize >= HugePageSize)
+      SlabSize = llvm::alignTo(SlabSize, HugePageSize);
+
     std::error_code EC;
-    Slab = llvm::sys::Memory::allocateMappedMemory(SegsSizes->total(), nullptr,
-                                                   ReadWrite, EC);
+    Slab = llvm::sys::Memory::allocateMappedMemory(SlabSize, nullptr, ReadWrite, EC);
 
     if (EC) {
       OnAllocated(llvm::errorCodeToError(EC));
       return;
     }
 
+#ifdef __linux__
+    if (Slab.allocatedSize() >= HugePageSize)
+      madvise(Slab.base(), Slab.allocatedSize(), MADV_HUGEPAGE);
+#endif
+
     // Zero-fill the whole slab up-front.
     memset(Slab.base(), 0, Slab.allocatedSize());
 
@@ -174,6 +196,7 @@ void BoehmGCJITLinkMemoryManager::allocate(const llvm::jitlink::JITLinkDylib *JD
   auto NextFinalizeSegAddr = llvm::orc::ExecutorAddr::fromPtr(FinalizeSegsMem.base());
 
   // Build ProtMap, assign addresses.
+  std::vector<std::pair<uintptr_t, uintptr_t>> gcSpans;
   for (auto &KV : BL.segments()) {
     auto &AG = KV.first;
     auto &Seg = KV.second;
@@ -190,8 +213,20 @@ void BoehmGCJITLinkMemoryManager::allocate(const llvm::jitlink::JITLinkDylib *JD
 
     if (static_cast<int>(AG.getMemProt()) &
         static_cast<int>(llvm::orc::MemProt::Write)) {
-      seq_gc_add_roots((void *)Seg.Addr.getValue(), (void *)SegAddr.getValue());
+      gcSpans.emplace_back(Seg.Addr.getValue(), SegAddr.getValue());
+    }
+  }
+
+  // Register writable segments as GC roots, coalescing adjacent segments
+  // into single spans first; the GC walks its root set per entry, and JIT
+  // services otherwise accumulate one tiny root per section per module.
+  std::sort(gcSpans.begin(), gcSpans.end());
+  for (unsigned i = 0; i < gcSpans.size(); i++) {
+    auto span = gcSpans[i];
+    while (i + 1 < gcSpans.size() && gcSpans[i + 1].first == span.second) {
+      span.second = gcSpans[++i].second;
     }
+    seq_gc_add_roots((void *)span.first, (void *)span.second);
   }
 
   if (auto Err = BL.apply()) {
@@ -21,7 +21,34 @@ llvm::Expected<Plugin *> pluginError(const std::string &msg) {
 typedef std::unique_ptr<DSL> LoadFunc();
 } // namespace
 
+EmbeddedPluginRegistry &EmbeddedPluginRegistry::get() {
+  static EmbeddedPluginRegistry registry;
+  return registry;
+}
+
+void EmbeddedPluginRegistry::add(DSL::Info info, Factory factory) {
+  entries.push_back({std::move(info), std::move(factory)});
+}
+
+const EmbeddedPluginRegistry::Entry *
+EmbeddedPluginRegistry::find(const std::string &name) const {
+  for (auto &entry : entries) {
+    if (entry.info.name == name)
+      return &entry;
+  }
+  return nullptr;
+}
+
 llvm::Expected<Plugin *> PluginManager::load(const std::string &path) {
+  // Embedded plugins are keyed by name and built against this exact
+  // compiler, so no library loading, config parsing or version check
+  // is needed.
+  if (auto *embedded = EmbeddedPluginRegistry::get().find(path)) {
+    plugins.push_back(std::make_unique<Plugin>(embedded->factory(), embedded->info,
+                                               llvm::sys::DynamicLibrary()));
+    return plugins.back().get();
+  }
+
 #if __APPLE__
   const std::string libExt = "dylib";
 #else
@@ -27,6 +27,46 @@ struct Plugin {
       : dsl(std::move(dsl)), info(std::move(info)), handle(std::move(handle)) {}
 };
 
+/// Registry of plugins compiled directly into the binary. Embedded plugins
+/// register a DSL factory under their name during static initialization
+/// (via EmbeddedPluginRegistration below); PluginManager::load consults the
+/// registry before touching the filesystem, so embedded plugins cost no
+/// dlopen, plugin.toml parse or version check per compiler start. Their
+/// stdlib modules, like those of dynamic plugins, are only parsed when
+/// imported.
+class EmbeddedPluginRegistry {
+public:
+  using Factory = std::function<std::unique_ptr<DSL>()>;
+
+  struct Entry {
+    DSL::Info info;
+    Factory factory;
+  };
+
+  /// @return the process-wide registry
+  static EmbeddedPluginRegistry &get();
+
+  /// Registers an embedded plugin under info.name.
+  void add(DSL::Info info, Factory factory);
+
+  /// @return the entry registered under the given name, or null
+  const Entry *find(const std::string &name) const;
+
+private:
+  std::vector<Entry> entries;
+};
+
+/// Registers an embedded plugin at static initialization time. Define a
+/// static instance in the plugin's translation unit:
+///   static codon::EmbeddedPluginRegistration reg(info, [] {
+///     return std::make_unique<MyDSL>();
+///   });
+struct EmbeddedPluginRegistration {
+  EmbeddedPluginRegistration(DSL::Info info, EmbeddedPluginRegistry::Factory factory) {
+    EmbeddedPluginRegistry::get().add(std::move(info), std::move(factory));
+  }
+};
+
 /// Manager for loading, applying and unloading plugins.
 class PluginManager {
 private:
@@ -0,0 +1,49 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "codon/util/pool.h"
+
+namespace codon::ast {
+
+/// Standard allocator facade over util::MemoryPool; used with allocate_shared
+/// below.
+template <typename T> class NodeAllocator {
+public:
+  using value_type = T;
+
+  NodeAllocator() noexcept = default;
+  template <typename U> NodeAllocator(const NodeAllocator<U> &) noexcept {}
+
+  T *allocate(size_t n) {
+    if (n == 1)
+      return static_cast<T *>(util::MemoryPool::get().allocate(sizeof(T)));
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t n) noexcept {
+    if (n == 1)
+      util::MemoryPool::get().deallocate(p, sizeof(T));
+    else
+      ::operator delete(p);
+  }
+
+  template <typename U> bool operator==(const NodeAllocator<U> &) const noexcept {
+    return true;
+  }
+  template <typename U> bool operator!=(const NodeAllocator<U> &) const noexcept {
+    return false;
+  }
+};
+
+/// Construct an AST node in the pooled allocator. Drop-in replacement for
+/// std::make_shared on node types; the control block and the node share one
+/// pooled allocation.
+template <typename Tn, typename... Ts> std::shared_ptr<Tn> make_node(Ts &&...args) {
+  return std::allocate_shared<Tn>(NodeAllocator<Tn>(), std::forward<Ts>(args)...);
+}
+
+} // namespace codon::ast
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -25,7 +26,8 @@ struct SrcInfo {
 
   SrcInfo(std::string file, int line, int col, int len)
       : file(std::move(file)), line(line), col(col), len(len), id(0) {
-    static int nextId = 0;
+    // atomic: nodes are constructed concurrently by the parse prefetcher
+    static std::atomic<int> nextId(0);
     id = nextId++;
   }
 
@@ -11,7 +11,7 @@
 #include "codon/parser/visitors/visitor.h"
 
 #define ACCEPT_IMPL(T, X)                                                              \
-  ExprPtr T::clone() const { return std::make_shared<T>(*this); }                      \
+  ExprPtr T::clone() const { return make_node<T>(*this); }                             \
   void T::accept(X &visitor) { visitor.visit(this); }
 
 using fmt::format;
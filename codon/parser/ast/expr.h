@@ -8,6 +8,7 @@
 #include <variant>
 #include <vector>
 
+#include "codon/parser/ast/alloc.h"
 #include "codon/parser/ast/types.h"
 #include "codon/parser/common.h"
 
@@ -11,7 +11,7 @@
 #include "codon/parser/visitors/visitor.h"
 
 #define ACCEPT_IMPL(T, X)                                                              \
-  StmtPtr T::clone() const { return std::make_shared<T>(*this); }                      \
+  StmtPtr T::clone() const { return make_node<T>(*this); }                             \
   void T::accept(X &visitor) { visitor.visit(this); }
 
 using fmt::format;
@@ -615,6 +615,10 @@ void ClassStmt::parseDecorators() {
   for (auto &d : decorators) {
     if (d->isId("deduce")) {
       attributes.customAttr.insert("deduce");
+    } else if (d->isId("soa")) {
+      // opt-in struct-of-arrays layout for lists of this record; see the
+      // SoALayoutPass in codon/cir/transform/layout/soa.cpp
+      attributes.customAttr.insert("soa");
     } else if (d->isId("__notuple__")) {
       attributes.customAttr.insert("__notuple__");
     } else if (auto c = d->getCall()) {
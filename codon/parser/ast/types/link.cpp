@@ -128,10 +128,40 @@ TypePtr LinkType::instantiate(int atLevel, int *unboundCount,
 }
 
 TypePtr LinkType::follow() {
-  if (kind == Link)
-    return type->follow();
-  else
+  if (kind != Link)
     return shared_from_this();
+
+  // Follow the chain iteratively; link chains get deep on heavily generic
+  // code and follow() is one of the hottest frontend frames.
+  constexpr size_t MAX_CHAIN = 32;
+  LinkType *chain[MAX_CHAIN];
+  size_t n = 0;
+  auto *last = this;
+  while (true) {
+    if (n < MAX_CHAIN)
+      chain[n++] = last;
+    auto *next = dynamic_cast<LinkType *>(last->type.get());
+    if (!next || next->kind != Link)
+      break;
+    last = next;
+  }
+  auto res = last->type->follow();
+
+  // Union-find-style path compression, restricted to links that are permanent.
+  // A link born as a link (id == 0; see LinkType(TypePtr)) can never revert,
+  // so bypassing it is unobservable; links produced by unification (id != 0)
+  // may be reverted to Unbound by Unification::undo and must stay reachable.
+  // A node may point directly at the result only if every bypassed node is
+  // permanent (chains longer than MAX_CHAIN skip compression entirely).
+  if (n >= 2 && n < MAX_CHAIN) {
+    bool permanentTail = true;
+    for (size_t i = n; permanentTail && i-- > 1;) {
+      permanentTail = chain[i]->id == 0;
+      if (permanentTail && chain[i - 1]->type.get() != res.get())
+        chain[i - 1]->type = res;
+    }
+  }
+  return res;
 }
 
 std::vector<TypePtr> LinkType::getUnbounds() const {
@@ -160,7 +160,7 @@ void StaticType::parseExpr(const ExprPtr &e, std::unordered_set<std::string> &se
                     ? 0
                     : genTyp->getStatic()->generics[0].id;
       generics.emplace_back(ClassType::Generic(
-          ei->value, cache->typeCtx->cache->reverseIdentifierLookup[ei->value], genTyp,
+          ei->value, cache->typeCtx->cache->revDefault(ei->value), genTyp,
           id));
       seen.insert(ei->value);
     }
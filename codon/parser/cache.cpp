@@ -22,19 +22,48 @@ Cache::Cache(std::string argv0)
       argv0(std::move(argv0)), typeCtx(nullptr), codegenCtx(nullptr), isJit(false),
       jitCell(0), pythonExt(false), pyModule(nullptr) {}
 
+Cache::~Cache() {
+  // the parse prefetcher's workers may still hold a pointer to this cache
+  prefetchRelease(this);
+}
+
 std::string Cache::getTemporaryVar(const std::string &prefix, char sigil) {
   return fmt::format("{}{}_{}", sigil ? fmt::format("{}_", sigil) : "", prefix,
                      ++varCount);
 }
 
+Cache::SymbolHandle Cache::intern(const std::string &name) {
+  auto i = symbolIndex.find(std::string_view(name));
+  if (i != symbolIndex.end())
+    return i->second;
+  symbolArena.push_back(name);
+  auto h = SymbolHandle(symbolArena.size() - 1);
+  symbolIndex[std::string_view(symbolArena.back())] = h;
+  identifierCount.push_back(0);
+  return h;
+}
+
+const std::string &Cache::symbol(SymbolHandle h) const { return symbolArena[h]; }
+
+int &Cache::idCount(const std::string &name) { return identifierCount[intern(name)]; }
+
 std::string Cache::rev(const std::string &s) {
-  auto i = reverseIdentifierLookup.find(s);
+  auto i = reverseIdentifierLookup.find(intern(s));
   if (i != reverseIdentifierLookup.end())
-    return i->second;
+    return symbol(i->second);
   seqassertn(false, "'{}' has no non-canonical name", s);
   return "";
 }
 
+std::string Cache::revDefault(const std::string &s) {
+  auto i = reverseIdentifierLookup.find(intern(s));
+  return i != reverseIdentifierLookup.end() ? symbol(i->second) : "";
+}
+
+void Cache::setRev(const std::string &canonical, const std::string &original) {
+  reverseIdentifierLookup[intern(canonical)] = intern(original);
+}
+
 void Cache::addGlobal(const std::string &name, ir::Var *var) {
   if (!in(globals, name)) {
     // LOG("[global] {}", name);
@@ -51,17 +80,24 @@ std::string Cache::getContent(const SrcInfo &info) {
   if (i == imports.end())
     return "";
   int line = info.line - 1;
-  if (line < 0 || line >= i->second.content.size())
+  auto &content = i->second.content;
+  auto &offsets = i->second.lineOffsets;
+  if (line < 0 || line >= offsets.size())
     return "";
-  auto s = i->second.content[line];
+  size_t start = offsets[line];
+  size_t end = line + 1 < offsets.size() ? offsets[line + 1] : content.size();
+  while (end > start && (content[end - 1] == '\n' || content[end - 1] == '\r'))
+    end--;
   int col = info.col - 1;
-  if (col < 0 || col >= s.size())
+  if (col < 0 || col >= int(end - start))
     return "";
   int len = info.len;
-  return s.substr(col, len);
+  return content.substr(start + col, len);
 }
 
 types::ClassTypePtr Cache::findClass(const std::string &name) const {
+  if (frontendReleased)
+    return nullptr;
   auto f = typeCtx->find(name);
   if (f && f->kind == TypecheckItem::Type)
     return f->type->getClass();
@@ -69,6 +105,8 @@ types::ClassTypePtr Cache::findClass(const std::string &name) const {
 }
 
 types::FuncTypePtr Cache::findFunction(const std::string &name) const {
+  if (frontendReleased)
+    return nullptr;
   auto f = typeCtx->find(name);
   if (f && f->type && f->kind == TypecheckItem::Func)
     return f->type->getFunc();
@@ -80,6 +118,8 @@ types::FuncTypePtr Cache::findFunction(const std::string &name) const {
 
 types::FuncTypePtr Cache::findMethod(types::ClassType *typ, const std::string &member,
                                      const std::vector<types::TypePtr> &args) {
+  if (frontendReleased)
+    return nullptr;
   auto e = std::make_shared<IdExpr>(typ->name);
   e->type = typ->getClass();
   seqassertn(e->type, "not a class");
@@ -92,6 +132,8 @@ types::FuncTypePtr Cache::findMethod(types::ClassType *typ, const std::string &m
 
 ir::types::Type *Cache::realizeType(types::ClassTypePtr type,
                                     const std::vector<types::TypePtr> &generics) {
+  if (frontendReleased)
+    return nullptr;
   auto e = std::make_shared<IdExpr>(type->name);
   e->type = type;
   type = typeCtx->instantiateGeneric(type, generics)->getClass();
@@ -108,6 +150,8 @@ ir::Func *Cache::realizeFunction(types::FuncTypePtr type,
                                  const std::vector<types::TypePtr> &args,
                                  const std::vector<types::TypePtr> &generics,
                                  const types::ClassTypePtr &parentClass) {
+  if (frontendReleased)
+    return nullptr;
   auto e = std::make_shared<IdExpr>(type->ast->name);
   e->type = type;
   type = typeCtx->instantiate(type, parentClass)->getFunc();
@@ -185,6 +229,40 @@ void Cache::parseCode(const std::string &code) {
   ast::TranslateVisitor(codegenCtx).transform(node);
 }
 
+void Cache::releaseFrontend() {
+  for (auto &[name, f] : functions) {
+    f.ast = nullptr;
+    f.origAst = nullptr;
+    f.type = nullptr;
+    for (auto &[rname, r] : f.realizations) {
+      r->ast = nullptr;
+      r->type = nullptr;
+    }
+  }
+  for (auto &[name, c] : classes) {
+    c.ast = nullptr;
+    c.originalAst = nullptr;
+    c.mro.clear();
+    for (auto &[rname, r] : c.realizations) {
+      r->type = nullptr;
+      r->fields.clear();
+    }
+  }
+  for (auto &[name, imp] : imports) {
+    imp.ctx = nullptr;
+    imp.content.clear();
+    imp.content.shrink_to_fit();
+    imp.lineOffsets.clear();
+    imp.lineOffsets.shrink_to_fit();
+  }
+  overloads.clear();
+  partials.clear();
+  pendingRealizations.clear();
+  typeCtx = nullptr;
+  codegenCtx = nullptr;
+  frontendReleased = true;
+}
+
 std::vector<ExprPtr> Cache::mergeC3(std::vector<std::vector<ExprPtr>> &seqs) {
   // Reference: https://www.python.org/download/releases/2.3/mro/
   std::vector<ExprPtr> result;
@@ -237,7 +315,7 @@ void Cache::populatePythonModule() {
 
   LOG_USER("[py] ====== module generation =======");
 
-#define N std::make_shared
+#define N codon::ast::make_node
 
   if (!pyModule)
     pyModule = std::make_shared<ir::PyModule>();
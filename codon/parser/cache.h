@@ -2,10 +2,14 @@
 
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "codon/cir/cir.h"
@@ -34,6 +38,10 @@
 #define MAX_REALIZATION_DEPTH 200
 #define MAX_STATIC_ITER 1024
 
+namespace codon {
+class CompilationCache;
+}
+
 namespace codon::ast {
 
 /// Forward declarations
@@ -49,12 +57,20 @@ struct TranslateContext;
  * Implemented to avoid bunch of global objects.
  */
 struct Cache : public std::enable_shared_from_this<Cache> {
-  /// Stores a count for each identifier (name) seen in the code.
+  /// Dense handle of an interned identifier (see @c intern).
+  using SymbolHandle = uint32_t;
+  /// Backing arena for interned identifiers. Each identifier is stored exactly
+  /// once; a deque is used so that references stay stable as it grows.
+  std::deque<std::string> symbolArena;
+  /// Maps an interned identifier (viewing into @c symbolArena) to its handle.
+  std::unordered_map<std::string_view, SymbolHandle> symbolIndex;
+  /// Stores a count for each identifier (name) seen in the code, indexed by
+  /// symbol handle.
   /// Used to generate unique identifier for each name in the code (e.g. Foo -> Foo.2).
-  std::unordered_map<std::string, int> identifierCount;
+  std::vector<int> identifierCount;
   /// Maps a unique identifier back to the original name in the code
-  /// (e.g. Foo.2 -> Foo).
-  std::unordered_map<std::string, std::string> reverseIdentifierLookup;
+  /// (e.g. Foo.2 -> Foo). Both sides are interned symbol handles.
+  std::unordered_map<SymbolHandle, SymbolHandle> reverseIdentifierLookup;
   /// Number of code-generated source code positions. Used to generate the next unique
   /// source-code position information.
   int generatedSrcInfoCount;
@@ -76,10 +92,18 @@ struct Cache : public std::enable_shared_from_this<Cache> {
     std::shared_ptr<SimplifyContext> ctx;
     /// Unique import variable for checking already loaded imports.
     std::string importVar;
-    /// File content (line:col indexable)
-    std::vector<std::string> content;
+    /// Full file content.
+    std::string content;
+    /// Byte offset of the start of each line in `content`. Built once at
+    /// parse so that diagnostics can resolve line:col context in O(1)
+    /// instead of rescanning the file.
+    std::vector<size_t> lineOffsets;
     /// Relative module name (e.g., `foo.bar`)
     std::string moduleName;
+    /// Salted digest of the file content (set when a disk cache is active).
+    /// Used to key on-disk artifacts and to detect unchanged modules on
+    /// warm builds.
+    std::string contentHash;
   };
 
   /// Absolute path of seqc executable (if available).
@@ -88,6 +112,9 @@ struct Cache : public std::enable_shared_from_this<Cache> {
   std::string module0;
   /// IR module.
   ir::Module *module = nullptr;
+  /// Persistent on-disk artifact cache shared by compilation stages
+  /// (nullptr if disabled).
+  std::shared_ptr<CompilationCache> diskCache = nullptr;
 
   /// Table of imported files that maps an absolute filename to a Import structure.
   /// By convention, the key of the Codon's standard library is "".
@@ -221,6 +248,9 @@ struct Cache : public std::enable_shared_from_this<Cache> {
   /// Pointer to the later contexts needed for IR API access.
   std::shared_ptr<TypeContext> typeCtx;
   std::shared_ptr<TranslateContext> codegenCtx;
+  /// Set once releaseFrontend() has run. Realization entry points fail
+  /// gracefully (return nullptr) afterwards instead of touching freed state.
+  bool frontendReleased = false;
   /// Set of function realizations that are to be translated to IR.
   std::set<std::pair<std::string, std::string>> pendingRealizations;
   /// Mapping of partial record names to function pointers and corresponding masks.
@@ -254,12 +284,26 @@ struct Cache : public std::enable_shared_from_this<Cache> {
 
 public:
   explicit Cache(std::string argv0 = "");
+  ~Cache();
 
   /// Return a uniquely named temporary variable of a format
   /// "{sigil}_{prefix}{counter}". A sigil should be a non-lexable symbol.
   std::string getTemporaryVar(const std::string &prefix = "", char sigil = '.');
+  /// Intern an identifier and get its dense handle (stable for the Cache
+  /// lifetime). Interning an already-seen identifier is a single hash lookup;
+  /// all identifier bookkeeping below is integer-indexed by these handles.
+  SymbolHandle intern(const std::string &name);
+  /// Get the interned identifier for the given handle.
+  const std::string &symbol(SymbolHandle h) const;
+  /// Get (a mutable reference to) the use count of the given identifier.
+  int &idCount(const std::string &name);
   /// Get the non-canonical version of a canonical name.
   std::string rev(const std::string &s);
+  /// Same as @c rev, except that an empty string is returned if there is no
+  /// non-canonical name.
+  std::string revDefault(const std::string &s);
+  /// Register the non-canonical (original) name of a canonical name.
+  void setRev(const std::string &canonical, const std::string &original);
 
   /// Generate a unique SrcInfo for internally generated AST nodes.
   SrcInfo generateSrcInfo();
@@ -312,6 +356,17 @@ public:
 
   void parseCode(const std::string &code);
 
+  /// Releases frontend state that is no longer needed once the IR pass
+  /// stage is done: template and per-realization ASTs, the type and
+  /// translation contexts, import contexts and file contents. The slim
+  /// realization tables (names and IR pointers) stay in place. Codegen
+  /// works off CIR alone, so dropping this before LLVM runs keeps the
+  /// frontend's allocations out of the peak. Afterwards the cache can no
+  /// longer realize anything new: findFunction/findMethod/realizeType/
+  /// realizeFunction (and the Module::getOrRealize* helpers built on
+  /// them) return nullptr.
+  void releaseFrontend();
+
   static std::vector<ExprPtr> mergeC3(std::vector<std::vector<ExprPtr>> &);
 
   std::shared_ptr<ir::PyModule> pyModule = nullptr;
@@ -2,7 +2,7 @@
 
 #pragma once
 
-#include <deque>
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <stack>
@@ -27,15 +27,16 @@ public:
 
 protected:
   using Map = std::unordered_map<std::string, std::list<Item>>;
+  using MapEntry = typename Map::value_type;
   /// Maps a identifier to a stack of objects that share the same identifier.
   /// Each object is represented by a nesting level and a pointer to that object.
   /// Top of the stack is the current block; the bottom is the outer-most block.
-  /// Stack is represented as std::deque to allow iteration and access to the outer-most
-  /// block.
   Map map;
-  /// Stack of blocks and their corresponding identifiers. Top of the stack is the
-  /// current block.
-  std::deque<std::list<std::string>> stack;
+  /// Stack of blocks, each a flat list of pointers to the map entries of the
+  /// identifiers the block added; the top (back) is the current block. Entry
+  /// pointers stay valid across rehashes, so block bookkeeping (adding,
+  /// popping, removing identifiers) never re-hashes identifier strings.
+  std::vector<std::vector<MapEntry *>> stack;
 
 private:
   /// Set of current context flags.
@@ -48,26 +49,31 @@ private:
 public:
   explicit Context(std::string filename) : filename(std::move(filename)) {
     /// Add a top-level block to the stack.
-    stack.push_front(std::list<std::string>());
+    stack.emplace_back();
   }
   virtual ~Context() = default;
 
   /// Add an object to the top of the stack.
   virtual void add(const std::string &name, const Item &var) {
     seqassertn(!name.empty(), "adding an empty identifier");
-    map[name].push_front(var);
-    stack.front().push_back(name);
+    auto it = map.emplace(name, std::list<Item>()).first;
+    it->second.push_front(var);
+    stack.back().push_back(&*it);
   }
   /// Remove the top-most object with a given identifier.
   void remove(const std::string &name) {
-    removeFromMap(name);
-    for (auto &s : stack) {
-      auto i = std::find(s.begin(), s.end(), name);
-      if (i != s.end()) {
-        s.erase(i);
-        return;
+    auto i = map.find(name);
+    if (i == map.end())
+      return;
+    auto *entry = &*i;
+    for (auto s = stack.rbegin(); s != stack.rend(); ++s) {
+      auto j = std::find(s->begin(), s->end(), entry);
+      if (j != s->end()) {
+        s->erase(j);
+        break;
       }
     }
+    removeFromMap(i);
   }
   /// Return a top-most object with a given identifier or nullptr if it does not exist.
   virtual Item find(const std::string &name) const {
@@ -75,12 +81,17 @@ public:
     return it != map.end() ? it->second.front() : nullptr;
   }
   /// Add a new block (i.e. adds a stack level).
-  virtual void addBlock() { stack.push_front(std::list<std::string>()); }
+  virtual void addBlock() { stack.emplace_back(); }
   /// Remove the top-most block and all variables it holds.
   virtual void popBlock() {
-    for (auto &name : stack.front())
-      removeFromMap(name);
-    stack.pop_front();
+    for (auto *entry : stack.back()) {
+      seqassertn(entry->second.size(), "identifier {} not found in the map",
+                 entry->first);
+      entry->second.pop_front();
+      if (entry->second.empty())
+        map.erase(map.find(entry->first));
+    }
+    stack.pop_back();
   }
 
   /// The absolute path of a current module.
@@ -96,15 +107,13 @@ public:
   virtual void dump() {}
 
 private:
-  /// Remove an identifier from the map only.
-  void removeFromMap(const std::string &name) {
-    auto i = map.find(name);
-    if (i == map.end())
-      return;
-    seqassertn(i->second.size(), "identifier {} not found in the map", name);
+  /// Remove the top-most object of the given map entry, erasing the entry
+  /// if it becomes empty.
+  void removeFromMap(typename Map::iterator i) {
+    seqassertn(i->second.size(), "identifier {} not found in the map", i->first);
     i->second.pop_front();
     if (!i->second.size())
-      map.erase(name);
+      map.erase(i);
   }
 
 public:
@@ -2,13 +2,22 @@
 
 #include "peg.h"
 
+#include <algorithm>
 #include <any>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <peglib.h>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "codon/compiler/compilation_cache.h"
 #include "codon/parser/ast.h"
 #include "codon/parser/common.h"
 #include "codon/parser/peg/rules.h"
@@ -20,6 +29,7 @@ namespace codon::ast {
 
 static std::shared_ptr<peg::Grammar> grammar(nullptr);
 static std::shared_ptr<peg::Grammar> ompGrammar(nullptr);
+static std::once_flag grammarOnce, ompGrammarOnce;
 
 std::shared_ptr<peg::Grammar> initParser() {
   auto g = std::make_shared<peg::Grammar>();
@@ -57,9 +67,9 @@ T parseCode(Cache *cache, const std::string &file, const std::string &code,
             int line_offset, int col_offset, const std::string &rule) {
   Timer t("");
   t.logged = true;
-  // Initialize
-  if (!grammar)
-    grammar = initParser();
+  // Initialize (once per process; construction is table-driven and fairly cheap,
+  // but must not race when parses are issued from multiple threads)
+  std::call_once(grammarOnce, [] { grammar = initParser(); });
 
   std::vector<std::tuple<size_t, size_t, std::string>> errors;
   auto log = [&](size_t line, size_t col, const std::string &msg, const std::string &) {
@@ -78,7 +88,12 @@ T parseCode(Cache *cache, const std::string &file, const std::string &code,
   auto ret = r.ret && r.len == code.size();
   if (!ret)
     r.error_info.output_log(log, code.c_str(), code.size());
-  totalPeg += t.elapsed();
+  {
+    // Parses can run concurrently (see ParsePrefetcher below)
+    static std::mutex timerMutex;
+    std::unique_lock<std::mutex> lock(timerMutex);
+    totalPeg += t.elapsed();
+  }
   exc::ParserException ex;
   if (!errors.empty()) {
     for (auto &e : errors)
@@ -92,6 +107,10 @@ T parseCode(Cache *cache, const std::string &file, const std::string &code,
 
 StmtPtr parseCode(Cache *cache, const std::string &file, const std::string &code,
                   int line_offset) {
+  // Avoid copying the whole (potentially multi-MB) buffer when it is already
+  // newline-terminated; the grammar only needs the final line to be closed.
+  if (!code.empty() && code.back() == '\n')
+    return parseCode<StmtPtr>(cache, file, code, line_offset, 0, "program");
   return parseCode<StmtPtr>(cache, file, code + "\n", line_offset, 0, "program");
 }
 
@@ -105,7 +124,241 @@ std::pair<ExprPtr, std::string> parseExpr(Cache *cache, const std::string &code,
   return e;
 }
 
+namespace {
+
+/// Background parsing of imported modules. Imports named by a module are
+/// discovered with a cheap line scan, resolved with @c getImportFile and parsed
+/// on a small worker pool while the (serial) simplification of earlier modules
+/// is still running; @c parseFile then consumes the pre-parsed ASTs in the
+/// usual deterministic order. Workers only read shared state (the grammar and
+/// the custom-keyword tables), so results are identical to a serial parse; any
+/// worker-side failure simply falls back to the serial path so that errors are
+/// reported exactly as before.
+/// Byte offsets of line starts in the given buffer. Built once per file and
+/// stored with the import so that diagnostics can index line:col pairs without
+/// rescanning the source.
+std::vector<size_t> indexLines(const std::string &code) {
+  std::vector<size_t> offsets{0};
+  for (size_t i = 0; i + 1 < code.size(); i++)
+    if (code[i] == '\n')
+      offsets.push_back(i + 1);
+  return offsets;
+}
+
+struct ParsePrefetcher {
+  struct Result {
+    std::vector<std::string> lines;
+    std::string code;
+    StmtPtr ast = nullptr;
+    bool ok = false;
+  };
+
+  std::mutex mutex;
+  std::condition_variable hasWork, hasResult;
+  std::deque<std::string> queue;
+  std::unordered_set<std::string> scheduled;
+  std::unordered_map<std::string, Result> results;
+  std::vector<std::thread> workers;
+  bool stop = false;
+  /// number of workers currently parsing a dequeued file
+  size_t busy = 0;
+
+  /// Resolution context. Stable while any worker is busy: rebinding and
+  /// releasing both drain the queue and wait for in-flight parses first,
+  /// so workers never touch a Cache that may have been destroyed.
+  Cache *cache = nullptr;
+
+  ~ParsePrefetcher() {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stop = true;
+    }
+    hasWork.notify_all();
+    for (auto &t : workers)
+      t.join();
+  }
+
+  static size_t jobs() {
+    if (auto *e = getenv("CODON_PARSE_JOBS"))
+      return std::max(atoi(e), 0);
+    return std::min<size_t>(std::thread::hardware_concurrency(), 8);
+  }
+
+  /// Scan module lines for top-level import statements and schedule those that
+  /// are not already cached. Called by the main thread and by workers.
+  void schedule(const std::vector<std::string> &lines, const std::string &relativeTo) {
+    if (!cache)
+      return;
+    std::vector<std::string> found;
+    for (auto &line : lines) {
+      std::string what;
+      if (startswith(line, "import "))
+        what = line.substr(7);
+      else if (startswith(line, "from "))
+        what = line.substr(5);
+      else
+        continue;
+      size_t e = 0;
+      while (e < what.size() && (isalnum(what[e]) || what[e] == '_' || what[e] == '.'))
+        e++;
+      what = what.substr(0, e);
+      // Skip relative imports and special `from C` / `from python` imports
+      if (what.empty() || what[0] == '.' || what == "C" || what == "python")
+        continue;
+      std::replace(what.begin(), what.end(), '.', '/');
+      found.push_back(what);
+    }
+    bool notify = false;
+    for (auto &path : found) {
+      auto file = getImportFile(cache->argv0, path, relativeTo, false, cache->module0,
+                                cache->pluginImportPaths);
+      if (!file)
+        continue;
+      std::unique_lock<std::mutex> lock(mutex);
+      if (in(scheduled, file->path))
+        continue;
+      scheduled.insert(file->path);
+      queue.push_back(file->path);
+      notify = true;
+    }
+    if (notify)
+      hasWork.notify_all();
+  }
+
+  /// Schedule a single already-resolved file.
+  void scheduleFile(const std::string &path) {
+    if (!cache)
+      return;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (in(scheduled, path))
+        return;
+      scheduled.insert(path);
+      queue.push_back(path);
+    }
+    hasWork.notify_one();
+  }
+
+  void work() {
+    while (true) {
+      std::string path;
+      Cache *c;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        hasWork.wait(lock, [&] { return stop || !queue.empty(); });
+        if (stop)
+          return;
+        path = queue.front();
+        queue.pop_front();
+        c = cache; // cannot change while busy > 0
+        busy++;
+      }
+      Result r;
+      std::ifstream fin(path);
+      if (fin) {
+        for (std::string line; getline(fin, line);) {
+          r.lines.push_back(line);
+          r.code += line + "\n";
+        }
+        try {
+          r.ast = parseCode(c, path, r.code, 0);
+          r.ok = true;
+        } catch (...) {
+          r.ok = false; // serial parse will report the error
+        }
+      }
+      if (r.ok)
+        schedule(r.lines, path);
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        results[path] = std::move(r);
+        busy--;
+      }
+      hasResult.notify_all();
+    }
+  }
+
+  void start(Cache *c) {
+    auto n = jobs();
+    if (n <= 1)
+      return;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (cache == c)
+      return;
+    // a new compiler session: drop the previous cache's pending work, wait
+    // out its in-flight parses, then rebind
+    quiesce(lock);
+    cache = c;
+    if (workers.empty()) {
+      for (size_t i = 0; i < n; i++)
+        workers.emplace_back([this] { work(); });
+    }
+  }
+
+  /// Detach from a Cache that is about to be destroyed. No-op unless the
+  /// prefetcher is currently bound to it.
+  void release(Cache *c) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (cache != c)
+      return;
+    quiesce(lock);
+    cache = nullptr;
+  }
+
+  /// Discards queued work and pre-parsed results and waits for busy workers
+  /// to finish. Must be called with the mutex held.
+  void quiesce(std::unique_lock<std::mutex> &lock) {
+    queue.clear();
+    hasResult.wait(lock, [&] { return busy == 0; });
+    scheduled.clear();
+    results.clear();
+  }
+
+  /// Fetch a pre-parsed module. If the module is still queued, it is parsed
+  /// serially instead of waiting for a worker to reach it.
+  /// @return true and fill `result` if the module was pre-parsed successfully
+  bool consume(Cache *c, const std::string &path, Result &result) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (c != cache)
+      return false;
+    if (!in(scheduled, path))
+      return false;
+    auto q = std::find(queue.begin(), queue.end(), path);
+    if (q != queue.end()) {
+      queue.erase(q);
+      scheduled.erase(path);
+      return false;
+    }
+    hasResult.wait(lock, [&] { return in(results, path); });
+    result = std::move(results[path]);
+    results.erase(path);
+    scheduled.erase(path);
+    return result.ok;
+  }
+};
+
+ParsePrefetcher prefetcher;
+
+} // namespace
+
+void prefetchFile(Cache *cache, const std::string &file) {
+  prefetcher.start(cache);
+  prefetcher.scheduleFile(file);
+}
+
+void prefetchRelease(Cache *cache) { prefetcher.release(cache); }
+
 StmtPtr parseFile(Cache *cache, const std::string &file) {
+  ParsePrefetcher::Result pre;
+  if (file != "-" && prefetcher.consume(cache, file, pre)) {
+    auto &import = cache->imports[file];
+    import.content = std::move(pre.code);
+    import.lineOffsets = indexLines(import.content);
+    if (cache->diskCache)
+      import.contentHash = cache->diskCache->getKey(import.content);
+    return pre.ast;
+  }
+
   std::vector<std::string> lines;
   std::string code;
   if (file == "-") {
@@ -124,7 +377,12 @@ StmtPtr parseFile(Cache *cache, const std::string &file) {
     fin.close();
   }
 
-  cache->imports[file].content = lines;
+  cache->imports[file].content = code;
+  cache->imports[file].lineOffsets = indexLines(code);
+  if (cache->diskCache)
+    cache->imports[file].contentHash = cache->diskCache->getKey(code);
+  prefetcher.start(cache);
+  prefetcher.schedule(lines, file);
   auto result = parseCode(cache, file, code);
   // For debugging purposes:
   // LOG("peg/{} :=  {}", file, result);
@@ -145,8 +403,7 @@ std::shared_ptr<peg::Grammar> initOpenMPParser() {
 
 std::vector<CallExpr::Arg> parseOpenMP(Cache *cache, const std::string &code,
                                        const codon::SrcInfo &loc) {
-  if (!ompGrammar)
-    ompGrammar = initOpenMPParser();
+  std::call_once(ompGrammarOnce, [] { ompGrammar = initOpenMPParser(); });
 
   std::vector<std::tuple<size_t, size_t, std::string>> errors;
   auto log = [&](size_t line, size_t col, const std::string &msg, const std::string &) {
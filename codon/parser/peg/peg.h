@@ -22,6 +22,12 @@ std::pair<ExprPtr, std::string> parseExpr(Cache *cache, const std::string &code,
                                           const codon::SrcInfo &offset);
 /// Parse a Seq file.
 StmtPtr parseFile(Cache *cache, const std::string &file);
+/// Start parsing a file and its transitive imports in the background.
+/// Pre-parsed results are picked up by later parseFile() calls.
+void prefetchFile(Cache *cache, const std::string &file);
+/// Detach background parsing from a Cache that is about to be destroyed,
+/// waiting for any in-flight parses against it. Called by ~Cache().
+void prefetchRelease(Cache *cache);
 
 /// Parse a OpenMP clause.
 std::vector<CallExpr::Arg> parseOpenMP(Cache *cache, const std::string &code,
@@ -96,6 +96,12 @@ std::shared_ptr<json> DocVisitor::apply(const std::string &argv0,
   shared->j = std::make_shared<json>();
 
   auto stdlib = getImportFile(argv0, STDLIB_INTERNAL_MODULE, "", true, "");
+  // Parse the requested files (and, transitively, their imports) on the
+  // prefetch pool while the stdlib is parsed and documented below. The
+  // documentation passes themselves stay serial so that item IDs — and hence
+  // the emitted JSON — are deterministic.
+  for (auto &f : files)
+    ast::prefetchFile(shared->cache, getAbsolutePath(f));
   auto ast = ast::parseFile(shared->cache, stdlib->path);
   auto core =
       ast::parseCode(shared->cache, stdlib->path, "from internal.core import *");
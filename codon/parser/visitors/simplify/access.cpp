@@ -81,7 +81,7 @@ void SimplifyVisitor::visit(IdExpr *expr) {
       auto checkStmt = N<ExprStmt>(N<CallExpr>(
           N<IdExpr>("__internal__.undef"),
           N<IdExpr>(fmt::format("{}.__used__", val->canonicalName)),
-          N<StringExpr>(ctx->cache->reverseIdentifierLookup[val->canonicalName])));
+          N<StringExpr>(ctx->cache->revDefault(val->canonicalName))));
       if (!ctx->isConditionalExpr) {
         // If the expression is not conditional, we can just do the check once
         prependStmts->push_back(checkStmt);
@@ -203,7 +203,7 @@ bool SimplifyVisitor::checkCapture(const SimplifyContext::Item &val) {
                          N<IdExpr>(st == StaticValue::INT ? "int" : "str"));
     auto [newName, _] = (*captures)[val->canonicalName] = {
         ctx->generateCanonicalName(val->canonicalName), typ};
-    ctx->cache->reverseIdentifierLookup[newName] = newName;
+    ctx->cache->setRev(newName, newName);
     // Add newly generated argument to the context
     std::shared_ptr<SimplifyItem> newVal = nullptr;
     if (val->isType())
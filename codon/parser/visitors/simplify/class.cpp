@@ -202,8 +202,7 @@ void SimplifyVisitor::visit(ClassStmt *stmt) {
                   format("{}:{}", rootName, ctx->cache->overloads[rootName].size());
               ctx->cache->overloads[rootName].push_back(
                   {newCanonicalName, ctx->cache->age});
-              ctx->cache->reverseIdentifierLookup[newCanonicalName] =
-                  ctx->cache->rev(f->name);
+              ctx->cache->setRev(newCanonicalName, ctx->cache->rev(f->name));
               auto nf = std::dynamic_pointer_cast<FunctionStmt>(f->clone());
               nf->name = newCanonicalName;
               nf->attributes.parentClass = ctx->getBase()->name;
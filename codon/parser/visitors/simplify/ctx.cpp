@@ -158,7 +158,7 @@ SimplifyContext::Item SimplifyContext::findDominatingBinding(const std::string &
         (*lastGood)->importPath);
     item->accessChecked = {(*lastGood)->scope};
     lastGood = it->second.insert(++lastGood, item);
-    stack.front().push_back(name);
+    stack.back().push_back(&*it);
     // Make sure to prepend a binding declaration: `var` and `var__used__ = False`
     // to the dominating scope.
     scope.stmts[scope.blocks[prefix - 1]].push_back(std::make_unique<AssignStmt>(
@@ -186,9 +186,9 @@ SimplifyContext::Item SimplifyContext::findDominatingBinding(const std::string &
         format("{}.__used__", canonicalName), false};
     seqassert((*i)->canonicalName != canonicalName, "invalid replacement at {}: {}",
               getSrcInfo(), canonicalName);
-    auto it = std::find(stack.front().begin(), stack.front().end(), name);
-    if (it != stack.front().end())
-      stack.front().erase(it);
+    auto sit = std::find(stack.back().begin(), stack.back().end(), &*it);
+    if (sit != stack.back().end())
+      stack.back().erase(sit);
   }
   it->second.erase(it->second.begin(), lastGood);
   return it->second.front();
@@ -219,12 +219,12 @@ std::string SimplifyContext::generateCanonicalName(const std::string &name,
       base = "";
     newName = (base.empty() ? "" : (base + ".")) + newName;
   }
-  auto num = cache->identifierCount[newName]++;
+  auto num = cache->idCount(newName)++;
   if (num)
     newName = format("{}.{}", newName, num);
   if (name != newName && !zeroId)
-    cache->identifierCount[newName]++;
-  cache->reverseIdentifierLookup[newName] = name;
+    cache->idCount(newName)++;
+  cache->setRev(newName, name);
   return newName;
 }
 
@@ -270,8 +270,8 @@ void SimplifyContext::dump(int pad) {
   LOG("module:   {}", getModule());
   LOG("base:     {}", getBaseName());
   LOG("scope:    {}", fmt::join(scope.blocks, ","));
-  for (auto &s : stack.front())
-    LOG("-> {}", s);
+  for (auto *s : stack.back())
+    LOG("-> {}", s->first);
   for (auto &i : ordered) {
     std::string s;
     bool f = true;
@@ -150,7 +150,7 @@ void SimplifyVisitor::visit(FunctionStmt *stmt) {
   // Append overload number to the name
   auto canonicalName =
       format("{}:{}", rootName, ctx->cache->overloads[rootName].size());
-  ctx->cache->reverseIdentifierLookup[canonicalName] = stmt->name;
+  ctx->cache->setRev(canonicalName, stmt->name);
 
   // Ensure that function binding does not shadow anything.
   // Function bindings cannot be dominated either
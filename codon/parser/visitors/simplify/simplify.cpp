@@ -32,7 +32,7 @@ SimplifyVisitor::apply(Cache *cache, const StmtPtr &node, const std::string &fil
   auto preamble = std::make_shared<std::vector<StmtPtr>>();
   seqassertn(cache->module, "cache's module is not set");
 
-#define N std::make_shared
+#define N codon::ast::make_node
   // Load standard library if it has not been loaded
   if (!in(cache->imports, STDLIB_IMPORT)) {
     // Load the internal.__init__
@@ -448,7 +448,11 @@ void TranslateVisitor::visit(ForStmt *stmt) {
     int64_t collapse =
         fc->funcGenerics[2].type->getStatic()->expr->staticValue.getInt();
     bool gpu = fc->funcGenerics[3].type->getStatic()->expr->staticValue.getInt();
-    os = std::make_unique<OMPSched>(schedule, threads, chunk, ordered, collapse, gpu);
+    bool simd = fc->funcGenerics[4].type->getStatic()->expr->staticValue.getInt();
+    auto procBind =
+        fc->funcGenerics[5].type->getStatic()->expr->staticValue.getString();
+    os = std::make_unique<OMPSched>(schedule, threads, chunk, ordered, collapse, gpu,
+                                    simd, procBind);
   }
 
   seqassert(stmt->var->getId(), "expected IdExpr, got {}", stmt->var);
@@ -559,13 +563,69 @@ void TranslateVisitor::transformFunctionRealizations(const std::string &name,
     real.second->ir->setSrcInfo(getSrcInfo());
     const auto &ast = real.second->ast;
     seqassert(ast, "AST not set for {}", real.first);
-    if (!isLLVM)
-      transformFunction(real.second->type.get(), ast.get(), real.second->ir);
-    else
+    if (!isLLVM) {
+      // Different instantiations of a generic frequently realize to
+      // byte-identical bodies (e.g. pointer-shaped generics). The first one
+      // is translated normally; structural duplicates become forwarding
+      // stubs to it that LLVM inlines away, so each distinct body is only
+      // translated and compiled once.
+      if (auto *canonical = findDuplicate(name, real.second->type.get(), ast.get(),
+                                          real.second->ir))
+        transformForwardingFunction(ast.get(), real.second->ir, canonical);
+      else
+        transformFunction(real.second->type.get(), ast.get(), real.second->ir);
+    } else {
       transformLLVMFunction(real.second->type.get(), ast.get(), real.second->ir);
+    }
   }
 }
 
+ir::Func *TranslateVisitor::findDuplicate(const std::string &name,
+                                          types::FuncType *type, FunctionStmt *ast,
+                                          ir::Func *func) {
+  if (!ast->suite || ast->attributes.has(Attr::C) ||
+      ast->attributes.has(Attr::Internal) || !cast<ir::BodiedFunc>(func))
+    return nullptr;
+
+  // The signature captures everything translation depends on: the generic
+  // function, the realized argument and return types, and the realized body.
+  // Realized call targets and type names are embedded in the printed AST, so
+  // equal signatures translate to identical IR.
+  std::string sig = name;
+  for (auto &t : type->getArgTypes()) {
+    sig += '|';
+    sig += t->realizedName();
+  }
+  sig += '|';
+  sig += type->getRetType()->realizedName();
+  sig += '|';
+  sig += ast->suite->toString(-1);
+
+  auto it = ctx->functionDedup.find(sig);
+  if (it != ctx->functionDedup.end() && it->second != func)
+    return it->second;
+  ctx->functionDedup.emplace(std::move(sig), func);
+  return nullptr;
+}
+
+void TranslateVisitor::transformForwardingFunction(FunctionStmt *ast, ir::Func *func,
+                                                   ir::Func *canonical) {
+  // TODO: refactor IR attribute API
+  std::map<std::string, std::string> attr;
+  attr[".module"] = ast->attributes.module;
+  for (auto &a : ast->attributes.customAttr)
+    attr[a] = "";
+  func->setAttribute(std::make_unique<ir::KeyValueAttribute>(attr));
+
+  std::vector<ir::Value *> args;
+  for (auto it = func->arg_begin(); it != func->arg_end(); ++it)
+    args.push_back(make<ir::VarValue>(ast, *it));
+  auto *body = make<ir::SeriesFlow>(ast, "body");
+  body->push_back(make<ir::ReturnInstr>(
+      ast, make<ir::CallInstr>(ast, make<ir::VarValue>(ast, canonical), args)));
+  cast<ir::BodiedFunc>(func)->setBody(body);
+}
+
 void TranslateVisitor::transformFunction(types::FuncType *type, FunctionStmt *ast,
                                          ir::Func *func) {
   std::vector<std::string> names;
@@ -573,7 +633,7 @@ void TranslateVisitor::transformFunction(types::FuncType *type, FunctionStmt *as
   for (int i = 0, j = 0; i < ast->args.size(); i++)
     if (ast->args[i].status == Param::Normal) {
       if (!type->getArgTypes()[j]->getFunc()) {
-        names.push_back(ctx->cache->reverseIdentifierLookup[ast->args[i].name]);
+        names.push_back(ctx->cache->revDefault(ast->args[i].name));
         indices.push_back(i);
       }
       j++;
@@ -614,7 +674,7 @@ void TranslateVisitor::transformLLVMFunction(types::FuncType *type, FunctionStmt
   std::vector<int> indices;
   for (int i = 0, j = 1; i < ast->args.size(); i++)
     if (ast->args[i].status == Param::Normal) {
-      names.push_back(ctx->cache->reverseIdentifierLookup[ast->args[i].name]);
+      names.push_back(ctx->cache->revDefault(ast->args[i].name));
       indices.push_back(i);
       j++;
     }
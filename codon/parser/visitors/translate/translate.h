@@ -69,6 +69,10 @@ private:
   void transformFunctionRealizations(const std::string &name, bool isLLVM);
   void transformFunction(types::FuncType *type, FunctionStmt *ast, ir::Func *func);
   void transformLLVMFunction(types::FuncType *type, FunctionStmt *ast, ir::Func *func);
+  ir::Func *findDuplicate(const std::string &name, types::FuncType *type,
+                          FunctionStmt *ast, ir::Func *func);
+  void transformForwardingFunction(FunctionStmt *ast, ir::Func *func,
+                                   ir::Func *canonical);
 
   template <typename ValueType, typename... Args> ValueType *make(Args &&...args) {
     auto *ret = ctx->getModule()->N<ValueType>(std::forward<Args>(args)...);
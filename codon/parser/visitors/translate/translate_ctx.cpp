@@ -18,6 +18,9 @@ TranslateContext::TranslateContext(Cache *cache)
 std::shared_ptr<TranslateItem> TranslateContext::find(const std::string &name) const {
   if (auto t = Context<TranslateItem>::find(name))
     return t;
+  auto ci = realizationCache.find(name);
+  if (ci != realizationCache.end())
+    return ci->second;
   std::shared_ptr<TranslateItem> ret = nullptr;
   auto tt = cache->typeCtx->find(name);
   if (tt && tt->isType() && tt->type->canRealize()) {
@@ -36,6 +39,10 @@ std::shared_ptr<TranslateItem> TranslateContext::find(const std::string &name) c
     ret->handle.func =
         cache->functions[tt->type->getFunc()->ast->name].realizations[name]->ir;
   }
+  // Realization handles never change once created, so cache them; negative
+  // results are not cached as later batches may realize the name.
+  if (ret)
+    realizationCache.emplace(name, ret);
   return ret;
 }
 
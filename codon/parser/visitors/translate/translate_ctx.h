@@ -53,6 +53,14 @@ struct TranslateContext : public Context<TranslateItem> {
   std::vector<codon::ir::SeriesFlow *> series;
   /// Stack of sequence items for attribute initialization.
   std::vector<std::vector<std::pair<ExprAttr, ir::Value *>>> seqItems;
+  /// Pre-resolved realization handles. Realized names are resolved through the
+  /// typechecking context and the cache realization tables only once; subsequent
+  /// `find` calls hit this table directly.
+  mutable std::unordered_map<std::string, std::shared_ptr<TranslateItem>>
+      realizationCache;
+  /// Structural signatures of already-translated function realizations, used
+  /// to alias byte-identical instantiations of a generic to one translation.
+  std::unordered_map<std::string, codon::ir::Func *> functionDedup;
 
 public:
   TranslateContext(Cache *cache);
@@ -98,7 +98,7 @@ types::FuncTypePtr TypecheckVisitor::getDispatch(const std::string &fn) {
   auto a = ctx->cache->functions[overloads[0].name].ast;
   if (!a->attributes.parentClass.empty())
     root = N<DotExpr>(N<IdExpr>(a->attributes.parentClass),
-                      ctx->cache->reverseIdentifierLookup[fn]);
+                      ctx->cache->revDefault(fn));
   else
     root = N<IdExpr>(fn);
   root = N<CallExpr>(root, N<StarExpr>(N<IdExpr>("args")),
@@ -106,7 +106,7 @@ types::FuncTypePtr TypecheckVisitor::getDispatch(const std::string &fn) {
   auto ast = N<FunctionStmt>(
       name, nullptr, std::vector<Param>{Param("*args"), Param("**kwargs")},
       N<SuiteStmt>(N<ReturnStmt>(root)), Attr({"autogenerated"}));
-  ctx->cache->reverseIdentifierLookup[name] = ctx->cache->reverseIdentifierLookup[fn];
+  ctx->cache->setRev(name, ctx->cache->revDefault(fn));
 
   auto baseType = getFuncTypeBase(2);
   auto typ = std::make_shared<FuncType>(baseType, ast.get());
@@ -286,7 +286,7 @@ ExprPtr TypecheckVisitor::getClassMember(DotExpr *expr,
   // Case: object generic access (`obj.T`)
   TypePtr generic = nullptr;
   for (auto &g : typ->generics)
-    if (ctx->cache->reverseIdentifierLookup[g.name] == expr->member) {
+    if (ctx->cache->revDefault(g.name) == expr->member) {
       generic = g.type;
       break;
     }
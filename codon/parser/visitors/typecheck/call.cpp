@@ -1173,6 +1173,28 @@ std::pair<bool, ExprPtr> TypecheckVisitor::transformInternalStaticFn(CallExpr *e
     }
     typ = realize(typ);
     return {true, transform(NT<IdExpr>(typ->realizedName()))};
+  } else if (expr->expr->isId("std.internal.static.union_all_by_ref")) {
+    // True if every member of a union is a non-polymorphic reference class
+    // (and there are at most 8 of them), in which case the union is packed
+    // into a tagged pointer (see LLVMVisitor and internal.codon).
+    expr->staticValue.type = StaticValue::INT;
+    auto funcTyp = expr->expr->type->getFunc();
+    auto t = funcTyp->funcGenerics[0].type;
+    if (!t || !realize(t))
+      return {true, nullptr};
+    auto u = t->getUnion();
+    if (!u)
+      return {true, transform(N<BoolExpr>(false))};
+    auto types = u->getRealizationTypes();
+    bool allByRef = !types.empty() && types.size() <= 8;
+    for (auto &m : types) {
+      auto mc = m->getClass();
+      if (!mc || mc->getRecord() || ctx->cache->classes[mc->name].rtti) {
+        allByRef = false;
+        break;
+      }
+    }
+    return {true, transform(N<BoolExpr>(allByRef))};
   } else {
     return {false, nullptr};
   }
@@ -227,7 +227,7 @@ std::vector<types::FuncTypePtr> TypeContext::findMethod(types::ClassType *type,
           );
         }
       }
-      cache->reverseIdentifierLookup[f.ast->name] = method;
+      cache->setRev(f.ast->name, method);
       cache->functions[f.ast->name] = f;
       cache->functions[f.ast->name].type =
           TypecheckVisitor(cache->typeCtx).makeFunctionType(f.ast.get());
@@ -369,7 +369,7 @@ int TypeContext::reorderNamedArgs(types::FuncType *func,
     std::map<std::string, int> slotNames;
     for (int i = 0; i < func->ast->args.size(); i++)
       if (known.empty() || !known[i]) {
-        slotNames[cache->reverseIdentifierLookup[func->ast->args[i].name]] = i;
+        slotNames[cache->revDefault(func->ast->args[i].name)] = i;
       }
     for (auto &n : namedArgs) {
       if (!in(slotNames, n.first))
@@ -410,7 +410,7 @@ int TypeContext::reorderNamedArgs(types::FuncType *func,
       else if (!partial && func->ast->args[i].status == Param::Normal)
         return onError(Error::CALL_ARGS_MISSING, getSrcInfo(),
                        Emsg(Error::CALL_ARGS_MISSING, cache->rev(func->ast->name),
-                            cache->reverseIdentifierLookup[func->ast->args[i].name]));
+                            cache->revDefault(func->ast->args[i].name)));
     }
   auto s = onDone(starArgIndex, kwstarArgIndex, slots, partial);
   return s != -1 ? score + s : -1;
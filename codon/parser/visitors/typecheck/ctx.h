@@ -72,6 +72,15 @@ struct TypeContext : public Context<TypecheckItem> {
   bool returnEarly;
   /// Stack of static loop control variables (used to emulate goto statements).
   std::vector<std::string> staticLoops;
+  /// Memoized overload resolutions for fully concrete call signatures.
+  /// Maps a (candidate methods, receiver, argument types) key to the matching
+  /// methods; see TypecheckVisitor::findMatchingMethods.
+  std::unordered_map<std::string, std::vector<types::FuncTypePtr>> overloadCache;
+  /// Memoized best-method resolutions keyed by (receiver, member, argument
+  /// types), including negative results; see TypecheckVisitor::findBestMethodImpl.
+  /// Cleared at the start of every typechecking batch, since later batches
+  /// (e.g. JIT inputs) may extend classes with new overloads.
+  std::unordered_map<std::string, types::FuncTypePtr> methodCache;
 
 public:
   explicit TypeContext(Cache *cache);
@@ -241,13 +241,14 @@ types::TypePtr TypecheckVisitor::realizeType(types::ClassType *type) {
       return nullptr;
   }
 
-  LOG_REALIZE("[realize] ty {} -> {}", realized->name, realized->realizedTypeName());
+  auto realizedName = realized->realizedTypeName();
+  LOG_REALIZE("[realize] ty {} -> {}", realized->name, realizedName);
 
   // Realizations should always be visible, so add them to the toplevel
-  ctx->addToplevel(realized->realizedTypeName(),
+  ctx->addToplevel(realizedName,
                    std::make_shared<TypecheckItem>(TypecheckItem::Type, realized));
   auto realization =
-      ctx->cache->classes[realized->name].realizations[realized->realizedTypeName()] =
+      ctx->cache->classes[realized->name].realizations[realizedName] =
           std::make_shared<Cache::Class::ClassRealization>();
   realization->type = realized;
   realization->id = ctx->cache->classRealizationCnt++;
@@ -308,7 +309,10 @@ types::TypePtr TypecheckVisitor::realizeType(types::ClassType *type) {
 
 types::TypePtr TypecheckVisitor::realizeFunc(types::FuncType *type, bool force) {
   auto &realizations = ctx->cache->functions[type->ast->name].realizations;
-  if (auto r = in(realizations, type->realizedName())) {
+  // realizedName() rebuilds the full mangled name recursively; compute it once
+  // here and reuse it as the (initial) realization key below
+  auto key = type->realizedName();
+  if (auto r = in(realizations, key)) {
     if (!force) {
       return (*r)->type;
     }
@@ -345,8 +349,8 @@ types::TypePtr TypecheckVisitor::realizeFunc(types::FuncType *type, bool force)
     }
 
   // Populate realization table in advance to support recursive realizations
-  auto key = type->realizedName(); // note: the key might change later
-  ir::Func *oldIR = nullptr;       // Get it if it was already made (force mode)
+  // (note: the key might change later)
+  ir::Func *oldIR = nullptr; // Get it if it was already made (force mode)
   if (auto i = in(realizations, key))
     oldIR = (*i)->ir;
   auto r = realizations[key] = std::make_shared<Cache::Function::FunctionRealization>();
@@ -758,7 +762,7 @@ ir::Func *TypecheckVisitor::makeIRFunction(
   } else {
     fn = ctx->cache->module->Nr<ir::BodiedFunc>(r->type->realizedName());
   }
-  fn->setUnmangledName(ctx->cache->reverseIdentifierLookup[r->type->ast->name]);
+  fn->setUnmangledName(ctx->cache->revDefault(r->type->ast->name));
   auto parent = r->type->funcParent;
   if (!r->ast->attributes.parentClass.empty() &&
       !r->ast->attributes.has(Attr::Method)) {
@@ -784,7 +788,7 @@ ir::Func *TypecheckVisitor::makeIRFunction(
     if (r->ast->args[i].status == Param::Normal) {
       if (!r->type->getArgTypes()[j]->getFunc()) {
         types.push_back(makeIRType(r->type->getArgTypes()[j]->getClass().get()));
-        names.push_back(ctx->cache->reverseIdentifierLookup[r->ast->args[i].name]);
+        names.push_back(ctx->cache->revDefault(r->ast->args[i].name));
       }
       j++;
     }
@@ -22,6 +22,9 @@ using namespace types;
 StmtPtr TypecheckVisitor::apply(Cache *cache, const StmtPtr &stmts) {
   if (!cache->typeCtx)
     cache->typeCtx = std::make_shared<TypeContext>(cache);
+  // Method resolutions can change between batches (later JIT inputs may
+  // extend classes with new overloads), so the cache lives within one batch.
+  cache->typeCtx->methodCache.clear();
   TypecheckVisitor v(cache->typeCtx);
   auto so = clone(stmts);
   auto s = v.inferTypes(so, true);
@@ -186,9 +189,7 @@ TypecheckVisitor::findBestMethod(const ClassTypePtr &typ, const std::string &mem
     callArgs.push_back({"", std::make_shared<NoneExpr>()}); // dummy expression
     callArgs.back().value->setType(a);
   }
-  auto methods = ctx->findMethod(typ.get(), member, false);
-  auto m = findMatchingMethods(typ, methods, callArgs);
-  return m.empty() ? nullptr : m[0];
+  return findBestMethodImpl(typ, member, callArgs);
 }
 
 /// Select the best method indicated of an object that matches the given argument
@@ -199,9 +200,7 @@ types::FuncTypePtr TypecheckVisitor::findBestMethod(const ClassTypePtr &typ,
   std::vector<CallExpr::Arg> callArgs;
   for (auto &a : args)
     callArgs.push_back({"", a});
-  auto methods = ctx->findMethod(typ.get(), member, false);
-  auto m = findMatchingMethods(typ, methods, callArgs);
-  return m.empty() ? nullptr : m[0];
+  return findBestMethodImpl(typ, member, callArgs);
 }
 
 /// Select the best method indicated of an object that matches the given argument
@@ -214,9 +213,43 @@ types::FuncTypePtr TypecheckVisitor::findBestMethod(
     callArgs.push_back({n, std::make_shared<NoneExpr>()}); // dummy expression
     callArgs.back().value->setType(a);
   }
+  return findBestMethodImpl(typ, member, callArgs);
+}
+
+/// Shared implementation of @c findBestMethod. Resolutions for fully
+/// concrete receivers and argument types are memoized in the type context:
+/// operator magic-method lookups alone run this millions of times in
+/// numeric-heavy code. Negative results are cached too, since right-hand
+/// magic fallbacks routinely probe methods that do not exist.
+types::FuncTypePtr
+TypecheckVisitor::findBestMethodImpl(const ClassTypePtr &typ, const std::string &member,
+                                     const std::vector<CallExpr::Arg> &callArgs) {
+  std::string key;
+  bool cacheable = typ->canRealize();
+  if (cacheable) {
+    key = fmt::format("{}.{}", typ->realizedName(), member);
+    for (const auto &a : callArgs) {
+      auto at = a.value->type;
+      if (!at || !at->canRealize() || a.value->isStatic()) {
+        cacheable = false;
+        break;
+      }
+      key += fmt::format("|{}={}{}", a.name, a.value->isType() ? "T " : "",
+                         at->realizedName());
+    }
+  }
+  if (cacheable) {
+    auto it = ctx->methodCache.find(key);
+    if (it != ctx->methodCache.end())
+      return it->second;
+  }
+
   auto methods = ctx->findMethod(typ.get(), member, false);
   auto m = findMatchingMethods(typ, methods, callArgs);
-  return m.empty() ? nullptr : m[0];
+  auto result = m.empty() ? types::FuncTypePtr() : m[0];
+  if (cacheable)
+    ctx->methodCache[key] = result;
+  return result;
 }
 
 // Search expression tree for a identifier
@@ -348,6 +381,30 @@ std::vector<types::FuncTypePtr>
 TypecheckVisitor::findMatchingMethods(const types::ClassTypePtr &typ,
                                       const std::vector<types::FuncTypePtr> &methods,
                                       const std::vector<CallExpr::Arg> &args) {
+  // Memoize resolutions for fully concrete call signatures: template-heavy
+  // code re-runs the same (method, argument types) scoring thousands of times.
+  // Unbound or static arguments are never cached, as their resolution can
+  // depend on the current unification state.
+  std::string key = typ ? (typ->canRealize() ? typ->realizedName() : "") : "-";
+  bool cacheable = !typ || typ->canRealize();
+  for (const auto &mi : methods)
+    if (mi)
+      key += fmt::format(":{}", mi->ast->name);
+  for (const auto &a : args) {
+    auto at = a.value->type;
+    if (!at || !at->canRealize() || a.value->isStatic()) {
+      cacheable = false;
+      break;
+    }
+    key += fmt::format("|{}={}{}", a.name, a.value->isType() ? "T " : "",
+                       at->realizedName());
+  }
+  if (cacheable) {
+    auto it = ctx->overloadCache.find(key);
+    if (it != ctx->overloadCache.end())
+      return it->second;
+  }
+
   // Pick the last method that accepts the given arguments.
   std::vector<types::FuncTypePtr> results;
   for (const auto &mi : methods) {
@@ -359,6 +416,8 @@ TypecheckVisitor::findMatchingMethods(const types::ClassTypePtr &typ,
       results.push_back(mi);
     }
   }
+  if (cacheable)
+    ctx->overloadCache[key] = results;
   return results;
 }
 
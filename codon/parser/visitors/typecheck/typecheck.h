@@ -220,6 +220,9 @@ private:
   types::FuncTypePtr
   findBestMethod(const types::ClassTypePtr &typ, const std::string &member,
                  const std::vector<std::pair<std::string, types::TypePtr>> &args);
+  types::FuncTypePtr findBestMethodImpl(const types::ClassTypePtr &typ,
+                                        const std::string &member,
+                                        const std::vector<CallExpr::Arg> &callArgs);
   int canCall(const types::FuncTypePtr &, const std::vector<CallExpr::Arg> &,
               std::shared_ptr<types::PartialType> = nullptr);
   std::vector<types::FuncTypePtr>
@@ -108,22 +108,22 @@ struct CallbackASTVisitor : public ASTVisitor, public SrcObject {
   }
 
   /// Convenience method that constructs a clone of a node.
-  template <typename Tn> auto N(const Tn &ptr) { return std::make_shared<Tn>(ptr); }
+  template <typename Tn> auto N(const Tn &ptr) { return make_node<Tn>(ptr); }
   /// Convenience method that constructs a node.
   /// @param s source location.
   template <typename Tn, typename... Ts> auto N(codon::SrcInfo s, Ts &&...args) {
-    auto t = std::make_shared<Tn>(std::forward<Ts>(args)...);
+    auto t = make_node<Tn>(std::forward<Ts>(args)...);
     t->setSrcInfo(s);
     return t;
   }
   /// Convenience method that constructs a node with the visitor's source location.
   template <typename Tn, typename... Ts> auto N(Ts &&...args) {
-    auto t = std::make_shared<Tn>(std::forward<Ts>(args)...);
+    auto t = make_node<Tn>(std::forward<Ts>(args)...);
     t->setSrcInfo(getSrcInfo());
     return t;
   }
   template <typename Tn, typename... Ts> auto NT(Ts &&...args) {
-    auto t = std::make_shared<Tn>(std::forward<Ts>(args)...);
+    auto t = make_node<Tn>(std::forward<Ts>(args)...);
     t->setSrcInfo(getSrcInfo());
     t->markType();
     return t;
@@ -2,6 +2,7 @@
 
 #include "codon/runtime/lib.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include <atomic>
 #include <backtrace.h>
 #include <cassert>
 #include <cstdint>
@@ -60,45 +61,22 @@ typedef int (*unw_find_dynamic_unwind_sections)(
     uintptr_t addr, struct unw_dynamic_unwind_sections *info);
 #endif
 
-struct BacktraceFrame {
-  char *function;
-  char *filename;
-  uintptr_t pc;
-  int32_t lineno;
-};
-
+// Only raw return addresses are captured at throw; symbolization (which
+// dominates throw cost) is deferred until a traceback is actually printed.
 struct Backtrace {
   static const size_t LIMIT = 20;
-  struct BacktraceFrame *frames;
+  uintptr_t *frames;
   size_t count;
 
-  void push_back(const char *function, const char *filename, uintptr_t pc,
-                 int32_t lineno) {
-    if (count >= LIMIT || !function || !filename) {
+  void push_back(uintptr_t pc) {
+    if (count >= LIMIT)
       return;
-    } else if (count == 0) {
-      frames = (BacktraceFrame *)seq_alloc(LIMIT * sizeof(*frames));
-    }
-
-    size_t functionLen = strlen(function) + 1;
-    auto *functionDup = (char *)seq_alloc_atomic(functionLen);
-    memcpy(functionDup, function, functionLen);
-
-    size_t filenameLen = strlen(filename) + 1;
-    auto *filenameDup = (char *)seq_alloc_atomic(filenameLen);
-    memcpy(filenameDup, filename, filenameLen);
-
-    frames[count++] = {functionDup, filenameDup, pc, lineno};
+    if (count == 0)
+      frames = (uintptr_t *)seq_alloc_atomic(LIMIT * sizeof(*frames));
+    frames[count++] = pc;
   }
 
-  void push_back(uintptr_t pc) { push_back("<invalid>", "<invalid>", pc, 0); }
-
   void free() {
-    for (auto i = 0; i < count; i++) {
-      auto *frame = &frames[i];
-      seq_free(frame->function);
-      seq_free(frame->filename);
-    }
     seq_free(frames);
     frames = nullptr;
     count = 0;
@@ -109,19 +87,23 @@ void seq_backtrace_error_callback(void *data, const char *msg, int errnum) {
   // printf("seq_backtrace_error_callback: %s (errnum = %d)\n", msg, errnum);
 }
 
-int seq_backtrace_full_callback(void *data, uintptr_t pc, const char *filename,
-                                int lineno, const char *function) {
-  auto *bt = ((Backtrace *)data);
-  bt->push_back(function, filename, pc, lineno);
-  return (bt->count < Backtrace::LIMIT) ? 0 : 1;
-}
-
 int seq_backtrace_simple_callback(void *data, uintptr_t pc) {
   auto *bt = ((Backtrace *)data);
   bt->push_back(pc);
   return (bt->count < Backtrace::LIMIT) ? 0 : 1;
 }
 
+int seq_backtrace_print_callback(void *data, uintptr_t pc, const char *filename,
+                                 int lineno, const char *function) {
+  if (!function || !filename)
+    return 0;
+  auto *buf = (std::ostringstream *)data;
+  *buf << "  "
+       << codon::runtime::makeBacktraceFrameString(pc, function, filename, lineno)
+       << "\n";
+  return 0;
+}
+
 /*
  * This is largely based on
  * llvm/examples/ExceptionDemo/ExceptionDemo.cpp
@@ -171,6 +153,38 @@ void seq_exc_init(int flags) {
 #endif
 }
 
+// Per-thread recycling pool for exception wrappers. Code that uses
+// exceptions for control flow (e.g. parsers raising ValueError) throws and
+// catches millions of times per run; recycling the _Unwind_Exception-bearing
+// wrapper keeps each raise from creating fresh GC garbage. Wrappers are
+// allocated uncollectable -- still scanned, so the held exception object
+// stays live while in flight, but never swept -- and returned here on catch.
+struct seq_exc_pool {
+  static const size_t LIMIT = 8;
+  OurException *cached[LIMIT];
+  size_t count = 0;
+
+  OurException *get() {
+    if (count > 0)
+      return cached[--count];
+    return (OurException *)seq_alloc_uncollectable(sizeof(OurException));
+  }
+
+  void put(OurException *e) {
+    if (count < LIMIT)
+      cached[count++] = e;
+    else
+      seq_free(e);
+  }
+
+  ~seq_exc_pool() {
+    while (count > 0)
+      seq_free(cached[--count]);
+  }
+};
+
+static thread_local seq_exc_pool excPool;
+
 static void seq_delete_exc(_Unwind_Exception *expToDelete) {
   if (!expToDelete || expToDelete->exception_class != SEQ_EXCEPTION_CLASS)
     return;
@@ -178,7 +192,8 @@ static void seq_delete_exc(_Unwind_Exception *expToDelete) {
   if (seq_flags & SEQ_FLAG_DEBUG) {
     exc->bt.free();
   }
-  seq_free(exc);
+  exc->obj = nullptr; // drop the instance reference before pooling
+  excPool.put(exc);
 }
 
 static void seq_delete_unwind_exc(_Unwind_Reason_Code reason,
@@ -191,7 +206,7 @@ static std::mutex stateLock;
 
 SEQ_FUNC void *seq_alloc_exc(int type, void *obj) {
   const size_t size = sizeof(OurException);
-  auto *e = (OurException *)memset(seq_alloc(size), 0, size);
+  auto *e = (OurException *)memset(excPool.get(), 0, size);
   assert(e);
   e->type.type = type;
   e->obj = obj;
@@ -200,22 +215,8 @@ SEQ_FUNC void *seq_alloc_exc(int type, void *obj) {
   if (seq_flags & SEQ_FLAG_DEBUG) {
     e->bt.frames = nullptr;
     e->bt.count = 0;
-
-    if (seq_flags & SEQ_FLAG_STANDALONE) {
-      if (!state) {
-        stateLock.lock();
-        if (!state)
-          state =
-              backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
-                                     seq_backtrace_error_callback, /*data=*/nullptr);
-        stateLock.unlock();
-      }
-      backtrace_full(state, /*skip=*/1, seq_backtrace_full_callback,
+    backtrace_simple(/*state=*/nullptr, /*skip=*/1, seq_backtrace_simple_callback,
                      seq_backtrace_error_callback, &e->bt);
-    } else {
-      backtrace_simple(/*state=*/nullptr, /*skip=*/1, seq_backtrace_simple_callback,
-                       seq_backtrace_error_callback, &e->bt);
-    }
   }
   return &(e->unwindException);
 }
@@ -274,14 +275,19 @@ SEQ_FUNC void seq_terminate(void *exc) {
   if ((seq_flags & SEQ_FLAG_DEBUG) && (seq_flags & SEQ_FLAG_STANDALONE)) {
     auto *bt = &base->bt;
     if (bt->count > 0) {
+      // symbolize the captured addresses now that we actually print them
+      if (!state) {
+        stateLock.lock();
+        if (!state)
+          state =
+              backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
+                                     seq_backtrace_error_callback, /*data=*/nullptr);
+        stateLock.unlock();
+      }
       buf << "\n\033[1mBacktrace:\033[0m\n";
       for (unsigned i = 0; i < bt->count; i++) {
-        auto *frame = &bt->frames[i];
-        buf << "  "
-            << codon::runtime::makeBacktraceFrameString(
-                   frame->pc, std::string(frame->function),
-                   std::string(frame->filename), frame->lineno)
-            << "\n";
+        backtrace_pcinfo(state, bt->frames[i], seq_backtrace_print_callback,
+                         seq_backtrace_error_callback, &buf);
       }
     }
   }
@@ -299,7 +305,7 @@ SEQ_FUNC void seq_terminate(void *exc) {
     std::vector<uintptr_t> backtrace;
     if (seq_flags & SEQ_FLAG_DEBUG) {
       for (unsigned i = 0; i < bt->count; i++) {
-        backtrace.push_back(bt->frames[i].pc);
+        backtrace.push_back(bt->frames[i]);
       }
     }
     codon::runtime::JITError e(output, msg, type, file, (int)hdr->line, (int)hdr->col,
@@ -449,6 +455,110 @@ static uintptr_t readEncodedPointer(const uint8_t **data, uint8_t encoding) {
   return result;
 }
 
+// A call-site table entry decoded out of an LSDA. 'actionEntry' is the
+// absolute address of the first action record, or 0 for cleanup-only sites.
+struct LsdaCallSite {
+  uintptr_t start;
+  uintptr_t length;
+  uintptr_t landingPad;
+  uintptr_t actionEntry;
+};
+
+struct LsdaTable {
+  const uint8_t *lsda;
+  uint8_t ttypeEncoding;
+  const uint8_t *classInfo;
+  std::vector<LsdaCallSite> callSites;
+};
+
+// Decode an LSDA's header and full call-site table. LSDA bytes are immutable
+// for the lifetime of the code they describe, so the result can be reused
+// across unwinds; only the action-record walk depends on the thrown type.
+static void decodeLsda(const uint8_t *lsda, LsdaTable *table) {
+  // Note: See JITDwarfEmitter::EmitExceptionTable(...) for corresponding
+  //       dwarf emission
+  table->lsda = lsda;
+  table->classInfo = nullptr;
+
+  uint8_t lpStartEncoding = *lsda++;
+
+  if (lpStartEncoding != llvm::dwarf::DW_EH_PE_omit) {
+    readEncodedPointer(&lsda, lpStartEncoding);
+  }
+
+  table->ttypeEncoding = *lsda++;
+
+  if (table->ttypeEncoding != llvm::dwarf::DW_EH_PE_omit) {
+    // Calculate type info locations in emitted dwarf code which
+    // were flagged by type info arguments to llvm.eh.selector
+    // intrinsic
+    uintptr_t classInfoOffset = readULEB128(&lsda);
+    table->classInfo = lsda + classInfoOffset;
+  }
+
+  uint8_t callSiteEncoding = *lsda++;
+  auto callSiteTableLength = (uint32_t)readULEB128(&lsda);
+  const uint8_t *callSiteTableStart = lsda;
+  const uint8_t *callSiteTableEnd = callSiteTableStart + callSiteTableLength;
+  const uint8_t *actionTableStart = callSiteTableEnd;
+  const uint8_t *callSitePtr = callSiteTableStart;
+
+  while (callSitePtr < callSiteTableEnd) {
+    LsdaCallSite cs;
+    cs.start = readEncodedPointer(&callSitePtr, callSiteEncoding);
+    cs.length = readEncodedPointer(&callSitePtr, callSiteEncoding);
+    cs.landingPad = readEncodedPointer(&callSitePtr, callSiteEncoding);
+    cs.actionEntry = readULEB128(&callSitePtr);
+    if (cs.actionEntry)
+      cs.actionEntry += (uintptr_t)actionTableStart - 1;
+    table->callSites.push_back(cs);
+  }
+}
+
+// Lock-free cache of decoded LSDAs, keyed by LSDA address. Every search and
+// cleanup phase of every unwind hits the personality routine, so hot
+// throw/catch paths decode the same tables over and over; caching the decode
+// leaves only the PC-range scan and the type match per phase. Slots are
+// claimed by CAS; AOT LSDAs stay mapped for the life of the process, but the
+// JIT can discard a module's code, after which a later module may be handed
+// the same LSDA address -- so discarding code must flush the cache via
+// seq_exc_lsda_cache_invalidate() below.
+static const size_t LSDA_CACHE_SIZE = 1024; // must be a power of two
+static const size_t LSDA_CACHE_MAX_PROBES = 8;
+static std::atomic<LsdaTable *> lsdaCache[LSDA_CACHE_SIZE];
+
+// Flushes the decoded-LSDA cache. Called by the JIT when it frees a module's
+// code: an address-keyed entry for a recycled LSDA address would otherwise
+// dispatch unwinds to the dead module's landing pads. Retired tables are
+// leaked rather than freed, since a concurrent unwind through still-live
+// code may hold a pointer to one; flushes are rare (one per discarded JIT
+// input) and the tables are small.
+SEQ_FUNC void seq_exc_lsda_cache_invalidate() {
+  for (size_t i = 0; i < LSDA_CACHE_SIZE; i++)
+    lsdaCache[i].store(nullptr, std::memory_order_release);
+}
+
+static const LsdaTable *getCachedLsdaTable(const uint8_t *lsda) {
+  size_t hash = ((uintptr_t)lsda >> 4) & (LSDA_CACHE_SIZE - 1);
+  for (size_t probe = 0; probe < LSDA_CACHE_MAX_PROBES; probe++) {
+    auto &slot = lsdaCache[(hash + probe) & (LSDA_CACHE_SIZE - 1)];
+    LsdaTable *entry = slot.load(std::memory_order_acquire);
+    if (!entry) {
+      auto *fresh = new LsdaTable();
+      decodeLsda(lsda, fresh);
+      LsdaTable *expected = nullptr;
+      if (slot.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel,
+                                       std::memory_order_acquire))
+        return fresh;
+      delete fresh; // another thread won the slot
+      entry = expected;
+    }
+    if (entry->lsda == lsda)
+      return entry;
+  }
+  return nullptr; // probe window full; caller decodes without caching
+}
+
 static bool handleActionValue(int64_t *resultAction, uint8_t TTypeEncoding,
                               const uint8_t *ClassInfo, uintptr_t actionEntry,
                               uint64_t exceptionClass,
@@ -517,46 +627,26 @@ static _Unwind_Reason_Code handleLsda(int version, const uint8_t *lsda,
   // emitted dwarf code)
   uintptr_t funcStart = _Unwind_GetRegionStart(context);
   uintptr_t pcOffset = pc - funcStart;
-  const uint8_t *ClassInfo = nullptr;
-
-  // Note: See JITDwarfEmitter::EmitExceptionTable(...) for corresponding
-  //       dwarf emission
-
-  // Parse LSDA header.
-  uint8_t lpStartEncoding = *lsda++;
 
-  if (lpStartEncoding != llvm::dwarf::DW_EH_PE_omit) {
-    readEncodedPointer(&lsda, lpStartEncoding);
+  // Decode once per LSDA; subsequent unwind phases reuse the cached table.
+  const LsdaTable *table = getCachedLsdaTable(lsda);
+  LsdaTable local;
+  if (!table) {
+    decodeLsda(lsda, &local);
+    table = &local;
   }
 
-  uint8_t ttypeEncoding = *lsda++;
-  uintptr_t classInfoOffset;
-
-  if (ttypeEncoding != llvm::dwarf::DW_EH_PE_omit) {
-    // Calculate type info locations in emitted dwarf code which
-    // were flagged by type info arguments to llvm.eh.selector
-    // intrinsic
-    classInfoOffset = readULEB128(&lsda);
-    ClassInfo = lsda + classInfoOffset;
-  }
+  uint8_t ttypeEncoding = table->ttypeEncoding;
+  const uint8_t *ClassInfo = table->classInfo;
 
   // Walk call-site table looking for range that
   // includes current PC.
 
-  uint8_t callSiteEncoding = *lsda++;
-  auto callSiteTableLength = (uint32_t)readULEB128(&lsda);
-  const uint8_t *callSiteTableStart = lsda;
-  const uint8_t *callSiteTableEnd = callSiteTableStart + callSiteTableLength;
-  const uint8_t *actionTableStart = callSiteTableEnd;
-  const uint8_t *callSitePtr = callSiteTableStart;
-
-  while (callSitePtr < callSiteTableEnd) {
-    uintptr_t start = readEncodedPointer(&callSitePtr, callSiteEncoding);
-    uintptr_t length = readEncodedPointer(&callSitePtr, callSiteEncoding);
-    uintptr_t landingPad = readEncodedPointer(&callSitePtr, callSiteEncoding);
-
-    // Note: Action value
-    uintptr_t actionEntry = readULEB128(&callSitePtr);
+  for (const LsdaCallSite &cs : table->callSites) {
+    uintptr_t start = cs.start;
+    uintptr_t length = cs.length;
+    uintptr_t landingPad = cs.landingPad;
+    uintptr_t actionEntry = cs.actionEntry;
 
     if (exceptionClass != SEQ_EXCEPTION_CLASS) {
       // We have been notified of a foreign exception being thrown,
@@ -568,10 +658,6 @@ static _Unwind_Reason_Code handleLsda(int version, const uint8_t *lsda,
       continue; // no landing pad for this entry
     }
 
-    if (actionEntry) {
-      actionEntry += (uintptr_t)actionTableStart - 1;
-    }
-
     bool exceptionMatched = false;
 
     if ((start <= pcOffset) && (pcOffset < (start + length))) {
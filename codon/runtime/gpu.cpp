@@ -3,6 +3,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "lib.h"
@@ -27,22 +30,60 @@
     }                                                                                  \
   } while (0)
 
-static std::vector<CUmodule> modules;
-static CUcontext context;
+// Contexts and loaded modules are per-device; the device current on the
+// calling thread is selected with seq_nvptx_set_device. Contexts are
+// created and modules loaded into them lazily, on first use of a device.
+static std::mutex device_lock;
+static std::vector<CUcontext> contexts;
+static std::vector<std::vector<CUmodule>> device_modules;
+static std::vector<std::string> module_files;
+static thread_local int current_device = 0;
 
 void seq_nvptx_init() {
   CUdevice device;
   check(cuInit(0));
+  int devCount;
+  check(cuDeviceGetCount(&devCount));
+  contexts.resize(devCount > 0 ? devCount : 1);
+  device_modules.resize(contexts.size());
   check(cuDeviceGet(&device, 0));
-  check(cuCtxCreate(&context, 0, device));
+  check(cuCtxCreate(&contexts[0], 0, device));
 }
 
 SEQ_FUNC void seq_nvptx_load_module(const char *filename) {
   CUmodule module;
   check(cuModuleLoad(&module, filename));
-  modules.push_back(module);
+  std::lock_guard<std::mutex> guard(device_lock);
+  device_modules[current_device].push_back(module);
+  module_files.push_back(filename);
+}
+
+SEQ_FUNC void seq_nvptx_set_device(seq_int_t idx) {
+  {
+    std::lock_guard<std::mutex> guard(device_lock);
+    if (idx < 0 || idx >= (seq_int_t)contexts.size())
+      fail(CUDA_ERROR_INVALID_DEVICE);
+    if (!contexts[idx]) {
+      CUdevice device;
+      check(cuDeviceGet(&device, idx));
+      check(cuCtxCreate(&contexts[idx], 0, device));
+    }
+  }
+  check(cuCtxSetCurrent(contexts[idx]));
+  current_device = (int)idx;
+
+  // load any modules this device has not seen yet
+  std::lock_guard<std::mutex> guard(device_lock);
+  auto &modules = device_modules[idx];
+  while (modules.size() < module_files.size()) {
+    CUmodule module;
+    check(cuModuleLoad(&module, module_files[modules.size()].c_str()));
+    modules.push_back(module);
+  }
 }
 
+SEQ_FUNC seq_int_t seq_nvptx_get_device() { return current_device; }
+
 SEQ_FUNC seq_int_t seq_nvptx_device_count() {
   int devCount;
   check(cuDeviceGetCount(&devCount));
@@ -88,6 +129,11 @@ SEQ_FUNC CUfunction seq_nvptx_function(seq_str_t name) {
   }
   clean[name.len] = '\0';
 
+  std::vector<CUmodule> modules;
+  {
+    std::lock_guard<std::mutex> guard(device_lock);
+    modules = device_modules[current_device];
+  }
   for (auto it = modules.rbegin(); it != modules.rend(); ++it) {
     result = cuModuleGetFunction(&function, *it, clean.data());
     if (result == CUDA_SUCCESS) {
@@ -136,4 +182,134 @@ SEQ_FUNC void seq_nvptx_device_free(CUdeviceptr devp) {
     check(cuMemFree(devp));
 }
 
+// Device memory pool: allocations are rounded up to power-of-two size
+// classes and freed buffers go onto a per-class free list instead of
+// through cuMemFree, so iterative workloads stop paying cuMemAlloc/cuMemFree
+// on every kernel invocation. Pools are per-device, since device pointers
+// belong to one context; on out-of-memory the current device's free lists
+// are released back to the driver and the allocation is retried once.
+static std::mutex pool_lock;
+static std::vector<std::unordered_map<size_t, std::vector<CUdeviceptr>>> pool_avail;
+static std::vector<std::unordered_map<CUdeviceptr, size_t>> pool_sizes;
+
+static size_t pool_size_class(seq_int_t size) {
+  size_t c = 256;
+  while (c < (size_t)size)
+    c <<= 1;
+  return c;
+}
+
+// call with pool_lock held
+static void pool_reserve_device() {
+  if (pool_avail.size() < contexts.size()) {
+    pool_avail.resize(contexts.size());
+    pool_sizes.resize(contexts.size());
+  }
+}
+
+SEQ_FUNC void seq_nvptx_pool_trim() {
+  std::lock_guard<std::mutex> guard(pool_lock);
+  pool_reserve_device();
+  for (auto &entry : pool_avail[current_device]) {
+    for (auto devp : entry.second) {
+      pool_sizes[current_device].erase(devp);
+      check(cuMemFree(devp));
+    }
+  }
+  pool_avail[current_device].clear();
+}
+
+SEQ_FUNC CUdeviceptr seq_nvptx_pool_alloc(seq_int_t size) {
+  if (size == 0)
+    return {};
+
+  auto sizeClass = pool_size_class(size);
+  {
+    std::lock_guard<std::mutex> guard(pool_lock);
+    pool_reserve_device();
+    auto &avail = pool_avail[current_device][sizeClass];
+    if (!avail.empty()) {
+      auto devp = avail.back();
+      avail.pop_back();
+      return devp;
+    }
+  }
+
+  CUdeviceptr devp;
+  auto err = cuMemAlloc(&devp, sizeClass);
+  if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+    seq_nvptx_pool_trim();
+    err = cuMemAlloc(&devp, sizeClass);
+  }
+  if (err != CUDA_SUCCESS)
+    fail(err);
+
+  std::lock_guard<std::mutex> guard(pool_lock);
+  pool_sizes[current_device][devp] = sizeClass;
+  return devp;
+}
+
+SEQ_FUNC void seq_nvptx_pool_free(CUdeviceptr devp) {
+  if (!devp)
+    return;
+
+  std::lock_guard<std::mutex> guard(pool_lock);
+  pool_reserve_device();
+  auto it = pool_sizes[current_device].find(devp);
+  if (it == pool_sizes[current_device].end()) {
+    // not from the current device's pool
+    check(cuMemFree(devp));
+    return;
+  }
+  pool_avail[current_device][it->second].push_back(devp);
+}
+
+SEQ_FUNC CUstream seq_nvptx_stream_create() {
+  CUstream stream;
+  check(cuStreamCreate(&stream, CU_STREAM_NON_BLOCKING));
+  return stream;
+}
+
+SEQ_FUNC void seq_nvptx_stream_destroy(CUstream stream) {
+  if (stream)
+    check(cuStreamDestroy(stream));
+}
+
+SEQ_FUNC void seq_nvptx_stream_sync(CUstream stream) {
+  check(cuStreamSynchronize(stream));
+}
+
+SEQ_FUNC void *seq_nvptx_host_alloc(seq_int_t size) {
+  void *p;
+  check(cuMemAllocHost(&p, size));
+  return p;
+}
+
+SEQ_FUNC void seq_nvptx_host_free(void *p) {
+  if (p)
+    check(cuMemFreeHost(p));
+}
+
+SEQ_FUNC void seq_nvptx_memcpy_h2d_async(CUdeviceptr devp, char *hostp, seq_int_t size,
+                                         CUstream stream) {
+  if (size)
+    check(cuMemcpyHtoDAsync(devp, hostp, size, stream));
+}
+
+SEQ_FUNC void seq_nvptx_memcpy_d2h_async(char *hostp, CUdeviceptr devp, seq_int_t size,
+                                         CUstream stream) {
+  if (size)
+    check(cuMemcpyDtoHAsync(hostp, devp, size, stream));
+}
+
+SEQ_FUNC void seq_nvptx_invoke_stream(CUfunction f, unsigned int gridDimX,
+                                      unsigned int gridDimY, unsigned int gridDimZ,
+                                      unsigned int blockDimX, unsigned int blockDimY,
+                                      unsigned int blockDimZ,
+                                      unsigned int sharedMemBytes, void **kernelParams,
+                                      CUstream stream) {
+  check(cuLaunchKernel(f, gridDimX, gridDimY, gridDimZ, blockDimX, blockDimY, blockDimZ,
+                       sharedMemBytes, stream, kernelParams, nullptr));
+}
+
 #endif /* CODON_GPU */
@@ -1,5 +1,6 @@
 // Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <chrono>
@@ -17,10 +18,24 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <atomic>
+#include <unordered_map>
 #include <unistd.h>
 #include <unwind.h>
 #include <vector>
 
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
 #define GC_THREADS
 #include "codon/runtime/lib.h"
 #include <gc.h>
@@ -42,26 +57,302 @@ extern "C" void __kmpc_set_gc_callbacks(gc_setup_callback get_stack_base,
                                         gc_roots_callback del_roots);
 
 void seq_exc_init(int flags);
+static void seq_alloc_profile_init();
 
 #ifdef CODON_GPU
 void seq_nvptx_init();
 #endif
 
+/*
+ * PGO profile runtime
+ */
+
+// Minimal profile runtime for '-pgo-instrument' builds. Defining
+// __llvm_profile_runtime here keeps compiler-rt's profile runtime out of the
+// link; the section start/stop symbols below are weak and null unless the
+// program was actually instrumented.
+#if defined(__linux__)
+extern "C" {
+__attribute__((weak)) extern char __start___llvm_prf_data[];
+__attribute__((weak)) extern char __stop___llvm_prf_data[];
+__attribute__((weak)) extern char __start___llvm_prf_cnts[];
+__attribute__((weak)) extern char __stop___llvm_prf_cnts[];
+__attribute__((weak)) extern char __start___llvm_prf_names[];
+__attribute__((weak)) extern char __stop___llvm_prf_names[];
+int __llvm_profile_runtime = 0;
+
+// Codegen groups globals of pointer-free types into this section; the
+// range is excluded from the collector's static roots at startup.
+__attribute__((weak)) extern char __start_codon_atomic_data[];
+__attribute__((weak)) extern char __stop_codon_atomic_data[];
+}
+#endif
+
+SEQ_FUNC void seq_pgo_dump() {
+#if defined(__linux__)
+  char *dataBegin = __start___llvm_prf_data;
+  char *dataEnd = __stop___llvm_prf_data;
+  if (!dataBegin || dataBegin == dataEnd)
+    return;
+  char *cntsBegin = __start___llvm_prf_cnts;
+  char *cntsEnd = __stop___llvm_prf_cnts;
+  char *namesBegin = __start___llvm_prf_names;
+  char *namesEnd = __stop___llvm_prf_names;
+
+  const char *filename = getenv("LLVM_PROFILE_FILE");
+  if (!filename || !*filename)
+    filename = "default.profraw";
+  FILE *f = fopen(filename, "wb");
+  if (!f)
+    return;
+
+  // Raw profile (version 8) layout, as in llvm/ProfileData/InstrProfData.inc;
+  // each __llvm_profile_data entry is 48 bytes.
+  const uint64_t dataEntrySize = 48;
+  uint64_t header[] = {
+      /*magic=*/0xff6c70726f667281ULL,
+      /*version=*/8,
+      /*binaryIdsSize=*/0,
+      /*numData=*/(uint64_t)(dataEnd - dataBegin) / dataEntrySize,
+      /*padBeforeCounters=*/0,
+      /*numCounters=*/(uint64_t)(cntsEnd - cntsBegin) / sizeof(uint64_t),
+      /*padAfterCounters=*/0,
+      /*namesSize=*/(uint64_t)(namesEnd - namesBegin),
+      /*countersDelta=*/(uint64_t)(uintptr_t)cntsBegin,
+      /*namesDelta=*/(uint64_t)(uintptr_t)namesBegin,
+      /*valueKindLast=*/1,
+  };
+  fwrite(header, sizeof(header), 1, f);
+  fwrite(dataBegin, 1, dataEnd - dataBegin, f);
+  fwrite(cntsBegin, 1, cntsEnd - cntsBegin, f);
+  fwrite(namesBegin, 1, namesEnd - namesBegin, f);
+  const char pad[8] = {0};
+  uint64_t namesSize = namesEnd - namesBegin;
+  if (namesSize % 8)
+    fwrite(pad, 1, 8 - (namesSize % 8), f);
+  fclose(f);
+#endif
+}
+
+/*
+ * GC observability
+ */
+
+// Pause tracking piggybacks on the collector's performance counters: the
+// start callback runs with the world stopped at the beginning of each
+// collection, where the counter delta is the previous collection's pause.
+// Nothing is printed from the callback (stopped threads may hold the stdio
+// lock); CODON_GC_LOG dumps the histogram at exit instead.
+namespace {
+std::atomic<unsigned long> seq_gc_pause_hist[6];
+std::atomic<unsigned long> seq_gc_pause_total_ms{0};
+std::atomic<unsigned long> seq_gc_pause_max_ms{0};
+unsigned long seq_gc_pause_last_total = 0;
+
+void seq_gc_note_pause(unsigned long ms) {
+  static const unsigned long buckets[] = {1, 5, 10, 50, 100};
+  int b = 0;
+  while (b < 5 && ms >= buckets[b])
+    b++;
+  seq_gc_pause_hist[b]++;
+  seq_gc_pause_total_ms += ms;
+  auto prev = seq_gc_pause_max_ms.load();
+  while (ms > prev && !seq_gc_pause_max_ms.compare_exchange_weak(prev, ms))
+    ;
+}
+
+void seq_gc_on_collection_start() {
+  auto total = GC_get_full_gc_total_time();
+  if (total > seq_gc_pause_last_total) {
+    seq_gc_note_pause(total - seq_gc_pause_last_total);
+    seq_gc_pause_last_total = total;
+  }
+}
+
+void seq_gc_dump_pauses() {
+  seq_gc_on_collection_start(); // pick up the last collection's delta
+  static const char *labels[] = {"<1ms",    "1-5ms",    "5-10ms",
+                                 "10-50ms", "50-100ms", ">=100ms"};
+  fprintf(stderr, "[gc] collections: %lu, heap: %zu bytes, pauses: %lums total, %lums max\n",
+          (unsigned long)GC_get_gc_no(), GC_get_heap_size(),
+          seq_gc_pause_total_ms.load(), seq_gc_pause_max_ms.load());
+  for (int b = 0; b < 6; b++)
+    fprintf(stderr, "[gc]   %-8s %lu\n", labels[b], seq_gc_pause_hist[b].load());
+}
+} // namespace
+
+// CODON_OUTPUT_BUFFER selects stdout's buffering at startup: a byte size for
+// full buffering (one write syscall per buffer fill instead of per line), or
+// 0 for unbuffered. Unset keeps libc's default (line buffered on a TTY).
+// Full buffering registers an exit-time flush so output is never dropped;
+// captured output (SEQ_FLAG_CAPTURE_OUTPUT) bypasses stdio and is unaffected.
+static void seq_output_buffer_init() {
+  if (const char *env = getenv("CODON_OUTPUT_BUFFER")) {
+    long size = strtol(env, nullptr, 10);
+    if (size <= 0) {
+      setvbuf(stdout, nullptr, _IONBF, 0);
+    } else {
+      setvbuf(stdout, nullptr, _IOFBF, (size_t)size);
+      atexit([] { fflush(stdout); });
+    }
+  }
+}
+
+// Parses a byte size with an optional K/M/G suffix ("64G"); 0 on bad input.
+static size_t seq_parse_byte_size(const char *s) {
+  char *end = nullptr;
+  auto val = strtoull(s, &end, 10);
+  if (end == s)
+    return 0;
+  switch (*end) {
+  case 'k':
+  case 'K':
+    return (size_t)val << 10;
+  case 'm':
+  case 'M':
+    return (size_t)val << 20;
+  case 'g':
+  case 'G':
+    return (size_t)val << 30;
+  case '\0':
+    return (size_t)val;
+  default:
+    return 0;
+  }
+}
+
+#if defined(__linux__) && !USE_STANDARD_MALLOC
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23 // Linux 5.14+; older kernels reject it
+#endif
+
+// Applies `advice` to every large private anonymous writable mapping in
+// /proc/self/maps and returns how many took it. The collector's public API
+// does not expose heap-section addresses, but its sections are exactly such
+// mappings, so this reaches the whole heap (plus any similar mapping, where
+// the advice is harmless). Only mappings of at least huge-page size matter
+// for either THP or prefaulting, so smaller ones are skipped.
+static int seq_gc_advise_heap(int advice) {
+  const size_t minBytes = (size_t)2 << 20;
+  FILE *f = fopen("/proc/self/maps", "r");
+  if (!f)
+    return 0;
+  int applied = 0;
+  char line[512];
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long lo = 0, hi = 0, offset = 0, inode = 0;
+    char perms[8] = {0}, dev[16] = {0}, path[256] = {0};
+    int n = sscanf(line, "%lx-%lx %7s %lx %15s %lu %255s", &lo, &hi, perms, &offset,
+                   dev, &inode, path);
+    if (n < 6 || inode != 0 || strncmp(perms, "rw", 2) != 0 || perms[3] != 'p')
+      continue;
+    // anonymous mappings have no path; also take the brk heap, in case the
+    // collector was built to grow via sbrk
+    if (n == 7 && strcmp(path, "[heap]") != 0)
+      continue;
+    if (hi - lo < minBytes)
+      continue;
+    if (madvise(reinterpret_cast<void *>(lo), hi - lo, advice) == 0)
+      applied++;
+  }
+  fclose(f);
+  return applied;
+}
+#endif
+
 int seq_flags;
 
 SEQ_FUNC void seq_init(int flags) {
   GC_INIT();
   GC_set_warn_proc(GC_ignore_warn_proc);
   GC_allow_register_threads();
+  GC_start_performance_measurement();
+  GC_set_start_callback(seq_gc_on_collection_start);
+  if (getenv("CODON_GC_LOG"))
+    atexit(seq_gc_dump_pauses);
+  // Incremental/generational marking trades throughput for bounded pauses;
+  // it must be enabled before the heap grows, hence here.
+  if (auto *inc = getenv("CODON_GC_INCREMENTAL")) {
+    if (*inc && *inc != '0')
+      GC_enable_incremental();
+  }
+  if (auto *limit = getenv("CODON_GC_PAUSE_LIMIT")) {
+    auto ms = atoi(limit);
+    if (ms > 0)
+      GC_set_time_limit((unsigned long)ms);
+  }
+  // A job with a known footprint can map its heap up front in a few large
+  // sections; grown on demand, the same heap arrives in many small ones,
+  // with a collection attempt and a page-fault storm at each step of the
+  // ramp. THP/prefault advice follows the expansion so it covers the full
+  // initial heap.
+  if (auto *heap = getenv("CODON_GC_INITIAL_HEAP")) {
+    if (auto bytes = seq_parse_byte_size(heap))
+      seq_gc_expand_heap((seq_int_t)bytes);
+  }
+  if (auto *thp = getenv("CODON_GC_THP")) {
+    if (*thp && *thp != '0')
+      seq_gc_hugepage_heap();
+  }
+  if (auto *pf = getenv("CODON_GC_PREFAULT")) {
+    if (*pf && *pf != '0')
+      seq_gc_prefault_heap();
+  }
+#if defined(__linux__)
+  // Globals the compiler proved pointer-free never need scanning; skipping
+  // their section shrinks the conservative static root set and the false
+  // retention a scalar that happens to look like a heap address causes.
+  if (__start_codon_atomic_data &&
+      __start_codon_atomic_data != __stop_codon_atomic_data)
+    GC_exclude_static_roots(__start_codon_atomic_data, __stop_codon_atomic_data);
+#endif
   __kmpc_set_gc_callbacks(GC_get_stack_base, (gc_setup_callback)GC_register_my_thread,
                           GC_add_roots, GC_remove_roots);
+  seq_alloc_profile_init();
+  seq_output_buffer_init();
   seq_exc_init(flags);
 #ifdef CODON_GPU
   seq_nvptx_init();
+#endif
+#if defined(__linux__)
+  if (__start___llvm_prf_data != __stop___llvm_prf_data)
+    atexit(seq_pgo_dump);
 #endif
   seq_flags = flags;
 }
 
+// CPU feature probe backing multiversioned function dispatch:
+// 0 = baseline, 1 = AVX2 (x86-64-v3-style), 2 = AVX-512. Self-contained
+// (raw CPUID/XGETBV, no static initializers), so it is safe to call from
+// resolver code that runs before constructors.
+SEQ_FUNC seq_int_t seq_cpu_feature_level() {
+#if defined(__x86_64__)
+  unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+  const bool osxsave = (ecx & (1u << 27)) != 0;
+  if (!osxsave)
+    return 0;
+  unsigned xcr0_lo = 0, xcr0_hi = 0;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  const bool avxState = (xcr0_lo & 0x6) == 0x6;      // XMM and YMM saved
+  const bool avx512State = (xcr0_lo & 0xe6) == 0xe6; // + opmask and ZMM saved
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return 0;
+  const bool avx2 = (ebx & (1u << 5)) != 0;
+  const bool avx512 = (ebx & (1u << 16)) && (ebx & (1u << 17)) && // F, DQ
+                      (ebx & (1u << 28)) && (ebx & (1u << 30)) && // CD, BW
+                      (ebx & (1u << 31));                         // VL
+
+  if (avx512State && avx512)
+    return 2;
+  if (avxState && avx2)
+    return 1;
+#endif
+  return 0;
+}
+
 SEQ_FUNC bool seq_is_macos() {
 #ifdef __APPLE__
   return true;
@@ -72,6 +363,20 @@ SEQ_FUNC bool seq_is_macos() {
 
 SEQ_FUNC seq_int_t seq_pid() { return (seq_int_t)getpid(); }
 
+// Cooperative interruption flag, polled by instrumented loops (see
+// codon/cir/transform/instrument/interrupt.cpp). Embedders set it from
+// another thread to cancel long-running code.
+static std::atomic<bool> interruptRequested(false);
+
+SEQ_FUNC void seq_set_interrupt(bool flag) {
+  interruptRequested.store(flag, std::memory_order_relaxed);
+}
+
+SEQ_FUNC bool seq_check_interrupt() {
+  return interruptRequested.load(std::memory_order_relaxed) &&
+         interruptRequested.exchange(false);
+}
+
 SEQ_FUNC seq_int_t seq_time() {
   auto duration = std::chrono::system_clock::now().time_since_epoch();
   seq_int_t nanos =
@@ -148,23 +453,657 @@ SEQ_FUNC void seq_sleep(double secs) {
 extern char **environ;
 SEQ_FUNC char **seq_env() { return environ; }
 
+/*
+ * Directory traversal
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+
+SEQ_FUNC void *seq_dir_open(seq_str_t path) {
+  std::string p(path.str, path.len);
+  return opendir(p.c_str());
+}
+
+// Fills up to max entries ("." and ".." excluded) and returns the count;
+// zero means end of directory. Batching the libc calls behind one foreign
+// call amortizes the call overhead across the whole getdents buffer that
+// readdir drains. Entry types come from d_type where the filesystem
+// provides it (0 = unknown, 1 = file, 2 = dir, 3 = symlink, 4 = other),
+// letting callers skip the per-entry stat in the common case.
+SEQ_FUNC seq_int_t seq_dir_read(void *dir, seq_dirent_t *out, seq_int_t max) {
+  auto *d = (DIR *)dir;
+  seq_int_t n = 0;
+  while (n < max) {
+    auto *ent = readdir(d);
+    if (!ent)
+      break;
+    const char *name = ent->d_name;
+    if (name[0] == '.' &&
+        (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+      continue;
+    auto len = strlen(name);
+    auto *buf = (char *)seq_alloc_atomic(len);
+    memcpy(buf, name, len);
+    seq_int_t type = 0;
+#ifdef DT_UNKNOWN
+    switch (ent->d_type) {
+    case DT_REG:
+      type = 1;
+      break;
+    case DT_DIR:
+      type = 2;
+      break;
+    case DT_LNK:
+      type = 3;
+      break;
+    case DT_UNKNOWN:
+      type = 0;
+      break;
+    default:
+      type = 4;
+      break;
+    }
+#endif
+    out[n].name = {(seq_int_t)len, buf};
+    out[n].type = type;
+    n++;
+  }
+  return n;
+}
+
+SEQ_FUNC void seq_dir_close(void *dir) { closedir((DIR *)dir); }
+
+SEQ_FUNC bool seq_stat(seq_str_t path, bool follow, seq_stat_t *out) {
+  std::string p(path.str, path.len);
+  struct stat st;
+  if ((follow ? stat(p.c_str(), &st) : lstat(p.c_str(), &st)) != 0)
+    return false;
+  out->mode = st.st_mode;
+  out->size = st.st_size;
+  out->mtime = st.st_mtime;
+  return true;
+}
+
+#else
+
+SEQ_FUNC void *seq_dir_open(seq_str_t path) { return nullptr; }
+
+SEQ_FUNC seq_int_t seq_dir_read(void *dir, seq_dirent_t *out, seq_int_t max) {
+  return 0;
+}
+
+SEQ_FUNC void seq_dir_close(void *dir) {}
+
+SEQ_FUNC bool seq_stat(seq_str_t path, bool follow, seq_stat_t *out) {
+  return false;
+}
+
+#endif
+
+/*
+ * Sampling profiler
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <backtrace.h>
+#include <csignal>
+#include <sys/time.h>
+
+namespace {
+// Folded-stack table filled from the SIGPROF handler. The handler may not
+// allocate, so the table is sized up front; samples whose stacks find no
+// free slot are counted as dropped.
+const int PROF_MAX_DEPTH = 64;
+const size_t PROF_TABLE_SIZE = 1 << 13; // must be a power of two
+
+struct ProfileSample {
+  std::atomic<int> depth{0}; // 0 = empty, -1 = being written
+  std::atomic<uint64_t> count{0};
+  uintptr_t pcs[PROF_MAX_DEPTH];
+};
+
+struct ProfileStack {
+  int depth;
+  uintptr_t pcs[PROF_MAX_DEPTH];
+};
+
+ProfileSample *profileTable = nullptr;
+struct backtrace_state *profileState = nullptr;
+std::atomic<bool> profileActive(false);
+std::atomic<uint64_t> profileDropped(0);
+std::function<std::string(uintptr_t)> profileSymbolizer;
+
+void profileErrorCallback(void *data, const char *msg, int errnum) {}
+
+int profileCollectCallback(void *data, uintptr_t pc) {
+  auto *stack = (ProfileStack *)data;
+  stack->pcs[stack->depth++] = pc;
+  return (stack->depth < PROF_MAX_DEPTH) ? 0 : 1;
+}
+
+void profileSignalHandler(int sig) {
+  if (!profileActive.load(std::memory_order_relaxed))
+    return;
+
+  ProfileStack stack;
+  stack.depth = 0;
+  // skip this handler and the signal trampoline
+  backtrace_simple(profileState, /*skip=*/2, profileCollectCallback,
+                   profileErrorCallback, &stack);
+  if (!stack.depth)
+    return;
+
+  uint64_t h = 14695981039346656037ull; // FNV-1a
+  for (int i = 0; i < stack.depth; i++) {
+    h ^= stack.pcs[i];
+    h *= 1099511628211ull;
+  }
+
+  for (size_t probe = 0; probe < PROF_TABLE_SIZE; probe++) {
+    auto &entry = profileTable[(h + probe) & (PROF_TABLE_SIZE - 1)];
+    int depth = entry.depth.load(std::memory_order_acquire);
+    if (depth == stack.depth &&
+        memcmp(entry.pcs, stack.pcs, stack.depth * sizeof(uintptr_t)) == 0) {
+      entry.count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (depth == 0) {
+      int expected = 0;
+      if (entry.depth.compare_exchange_strong(expected, -1,
+                                              std::memory_order_acq_rel)) {
+        memcpy(entry.pcs, stack.pcs, stack.depth * sizeof(uintptr_t));
+        entry.count.store(1, std::memory_order_relaxed);
+        entry.depth.store(stack.depth, std::memory_order_release);
+        return;
+      }
+    }
+    // mid-write (-1) or a different stack; keep probing
+  }
+  profileDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+int profileSymbolCallback(void *data, uintptr_t pc, const char *filename, int lineno,
+                          const char *function) {
+  auto *out = (std::string *)data;
+  if (function)
+    *out = filename ? fmt::format("{} ({}:{})", function, filename, lineno)
+                    : std::string(function);
+  return 1; // innermost frame only
+}
+
+std::string profileFrame(uintptr_t pc) {
+  std::string out;
+  // JIT'ed code is symbolized by the compiler (see setProfileSymbolizer);
+  // everything else falls back to the executable's own debug info.
+  if (profileSymbolizer)
+    out = profileSymbolizer(pc);
+  if (out.empty() && profileState)
+    backtrace_pcinfo(profileState, pc, profileSymbolCallback, profileErrorCallback,
+                     &out);
+  if (out.empty())
+    out = fmt::format("{:#x}", pc);
+  // frames are joined with semicolons in the folded output
+  std::replace(out.begin(), out.end(), ';', ':');
+  return out;
+}
+} // namespace
+
+SEQ_FUNC void seq_profile_start(seq_int_t interval) {
+  if (profileActive.load())
+    return;
+  if (interval <= 0)
+    interval = 1000; // ~1kHz of CPU time
+  if (!profileTable)
+    profileTable = new ProfileSample[PROF_TABLE_SIZE];
+  if (!profileState)
+    profileState = backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
+                                          profileErrorCallback, /*data=*/nullptr);
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = profileSignalHandler;
+  sa.sa_flags = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGPROF, &sa, nullptr);
+
+  profileActive.store(true);
+
+  struct itimerval timer;
+  timer.it_interval.tv_sec = interval / 1000000;
+  timer.it_interval.tv_usec = interval % 1000000;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+SEQ_FUNC void seq_profile_stop() {
+  if (!profileActive.exchange(false))
+    return;
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  signal(SIGPROF, SIG_IGN);
+}
+
+SEQ_FUNC bool seq_profile_dump(seq_str_t path) {
+  seq_profile_stop();
+  if (!profileTable)
+    return false;
+  std::ofstream out(std::string(path.str, path.len));
+  if (!out)
+    return false;
+  for (size_t i = 0; i < PROF_TABLE_SIZE; i++) {
+    auto &entry = profileTable[i];
+    const int depth = entry.depth.load();
+    if (depth <= 0)
+      continue;
+    // backtrace_simple reports leaf-first; the folded format is root-first
+    std::string line;
+    for (int j = depth - 1; j >= 0; j--) {
+      if (!line.empty())
+        line += ';';
+      line += profileFrame(entry.pcs[j]);
+    }
+    out << line << ' ' << entry.count.load() << "\n";
+  }
+  if (auto dropped = profileDropped.load())
+    out << "[dropped] " << dropped << "\n";
+  return bool(out);
+}
+
+void codon::runtime::setProfileSymbolizer(
+    std::function<std::string(uintptr_t)> symbolizer) {
+  profileSymbolizer = std::move(symbolizer);
+}
+
+#else
+
+SEQ_FUNC void seq_profile_start(seq_int_t interval) {}
+SEQ_FUNC void seq_profile_stop() {}
+SEQ_FUNC bool seq_profile_dump(seq_str_t path) { return false; }
+
+void codon::runtime::setProfileSymbolizer(
+    std::function<std::string(uintptr_t)> symbolizer) {}
+
+#endif
+
+/*
+ * Allocation profiler
+ */
+
+// Samples every Nth seq_alloc/seq_alloc_atomic call, aggregating sizes by
+// call site, to attribute GC pressure to source lines instead of bisecting
+// by hand. Opt-in: set CODON_ALLOC_PROFILE to a sampling interval (e.g.
+// 1024); a per-site report, symbolized like exception backtraces, is
+// written to stderr at exit. Multiply the sampled figures by the interval
+// for an estimate of the true totals.
+
+namespace {
+seq_int_t allocProfileEvery = 0;
+thread_local seq_int_t allocProfileCountdown = 0;
+
+#if defined(__unix__) || defined(__APPLE__)
+struct AllocSite {
+  uint64_t samples = 0;
+  uint64_t bytes = 0;
+};
+
+std::mutex allocProfileLock;
+// leaked intentionally: the atexit dump must not race static destruction
+std::unordered_map<uintptr_t, AllocSite> *allocProfileSites = nullptr;
+
+int allocSiteCallback(void *data, uintptr_t pc) {
+  *(uintptr_t *)data = pc;
+  return 1; // first frame only
+}
+
+void allocProfileDump() {
+  std::lock_guard<std::mutex> guard(allocProfileLock);
+  std::vector<std::pair<uintptr_t, AllocSite>> sites(allocProfileSites->begin(),
+                                                     allocProfileSites->end());
+  std::sort(sites.begin(), sites.end(), [](const auto &a, const auto &b) {
+    return a.second.bytes > b.second.bytes;
+  });
+
+  uint64_t totalBytes = 0, totalSamples = 0;
+  for (const auto &site : sites) {
+    totalBytes += site.second.bytes;
+    totalSamples += site.second.samples;
+  }
+  fmt::print(stderr,
+             "=== allocation profile: 1 in {} calls sampled, {} samples, "
+             "~{} MB total ===\n",
+             allocProfileEvery, totalSamples,
+             totalBytes * allocProfileEvery / (1024 * 1024));
+  for (const auto &site : sites) {
+    fmt::print(stderr, "{:>14} bytes {:>10} samples  {}\n", site.second.bytes,
+               site.second.samples, profileFrame(site.first));
+  }
+}
+#endif
+} // namespace
+
+static void seq_alloc_profile_init() {
+#if defined(__unix__) || defined(__APPLE__)
+  auto *env = getenv("CODON_ALLOC_PROFILE");
+  if (!env)
+    return;
+  allocProfileEvery = atoll(env);
+  if (allocProfileEvery <= 0) {
+    allocProfileEvery = 0;
+    return;
+  }
+  allocProfileSites = new std::unordered_map<uintptr_t, AllocSite>();
+  if (!profileState)
+    profileState = backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
+                                          profileErrorCallback, /*data=*/nullptr);
+  atexit(allocProfileDump);
+#endif
+}
+
+static void seq_alloc_profile_record(size_t n) {
+#if defined(__unix__) || defined(__APPLE__)
+  allocProfileCountdown = allocProfileEvery;
+  uintptr_t pc = 0;
+  // skip this function and the allocator entry point; the first reported
+  // frame is the allocation site
+  backtrace_simple(profileState, /*skip=*/2, allocSiteCallback,
+                   profileErrorCallback, &pc);
+  if (!pc)
+    return;
+  std::lock_guard<std::mutex> guard(allocProfileLock);
+  auto &site = (*allocProfileSites)[pc];
+  site.samples++;
+  site.bytes += n;
+#endif
+}
+
+/*
+ * Hit counters
+ */
+
+// Runtime side of the CIR hit-counter instrumentation (see
+// codon/cir/transform/instrument/hit_counters.cpp). Each thread counts
+// into its own cache-line-aligned block so threads never share a line;
+// blocks are merged into the per-site report written to stderr at exit.
+
+namespace {
+struct HitCounters {
+  std::mutex lock;
+  std::vector<std::string> names;
+  std::vector<std::pair<uint64_t *, size_t>> blocks;
+};
+
+HitCounters &hitCounters() {
+  // leaked intentionally: the atexit dump must not race static destruction
+  static auto *hc = new HitCounters();
+  return *hc;
+}
+
+thread_local uint64_t *hitBlock = nullptr;
+thread_local size_t hitBlockSize = 0;
+
+void seq_hit_dump() {
+  auto &hc = hitCounters();
+  std::lock_guard<std::mutex> guard(hc.lock);
+  std::vector<std::pair<uint64_t, std::string>> totals;
+  for (size_t site = 0; site < hc.names.size(); site++) {
+    uint64_t total = 0;
+    for (const auto &block : hc.blocks) {
+      if (site < block.second)
+        total += block.first[site];
+    }
+    totals.emplace_back(total, hc.names[site]);
+  }
+  std::sort(totals.begin(), totals.end(), std::greater<>());
+  fmt::print(stderr, "=== hit counters ===\n");
+  for (const auto &site : totals)
+    fmt::print(stderr, "{:>14}  {}\n", site.first, site.second);
+}
+
+// (re)allocates the calling thread's counter block; rare, so out of line
+void seq_hit_grow(seq_int_t site) {
+  auto &hc = hitCounters();
+  std::lock_guard<std::mutex> guard(hc.lock);
+  size_t n = std::max(hc.names.size(), (size_t)site + 1);
+  // round up to whole cache lines; also keeps aligned_alloc's size
+  // requirement satisfied
+  n = (n + 7) & ~(size_t)7;
+  auto *block = (uint64_t *)aligned_alloc(64, n * sizeof(uint64_t));
+  memset(block, 0, n * sizeof(uint64_t));
+  if (hitBlock) {
+    memcpy(block, hitBlock, hitBlockSize * sizeof(uint64_t));
+    for (auto &entry : hc.blocks) {
+      if (entry.first == hitBlock) {
+        free(hitBlock);
+        entry = {block, n};
+        hitBlock = block;
+        hitBlockSize = n;
+        return;
+      }
+    }
+  }
+  hc.blocks.emplace_back(block, n);
+  hitBlock = block;
+  hitBlockSize = n;
+}
+} // namespace
+
+SEQ_FUNC void seq_hit_register(seq_int_t site, seq_str_t name) {
+  auto &hc = hitCounters();
+  std::lock_guard<std::mutex> guard(hc.lock);
+  if (hc.names.empty())
+    atexit(seq_hit_dump);
+  if (hc.names.size() <= (size_t)site)
+    hc.names.resize(site + 1);
+  hc.names[site] = std::string(name.str, name.len);
+}
+
+SEQ_FUNC void seq_hit(seq_int_t site) {
+  if (__builtin_expect((size_t)site >= hitBlockSize, 0))
+    seq_hit_grow(site);
+  hitBlock[site]++;
+}
+
 /*
  * GC
  */
 #define USE_STANDARD_MALLOC 0
 
+#if !USE_STANDARD_MALLOC
+#include <gc_inline.h>
+
+// Per-thread magazine in front of the collector: small objects come off
+// thread-local size-class freelists that are refilled in bulk (one lock
+// acquisition per refill via GC_generic_malloc_many), so allocation in
+// parallel regions does not contend on the GC's allocation lock. Each
+// thread's cache is registered as a GC root so cached objects stay alive.
+namespace {
+const size_t SEQ_MAG_GRANULE = 16;
+const size_t SEQ_MAG_MAX = 256;
+const int SEQ_MAG_CLASSES = SEQ_MAG_MAX / SEQ_MAG_GRANULE;
+const int SEQ_MAG_ATOMIC_BATCH = 16;
+
+struct seq_alloc_cache {
+  // pointer-containing objects, linked through their (scanned) first words
+  void *lists[SEQ_MAG_CLASSES];
+  // pointer-free objects; links inside them would not be scanned, so they
+  // are held in a rooted array instead
+  void *atomics[SEQ_MAG_CLASSES][SEQ_MAG_ATOMIC_BATCH];
+  int atomicCount[SEQ_MAG_CLASSES];
+
+  seq_alloc_cache() : lists(), atomics(), atomicCount() {
+    GC_INIT();
+    GC_add_roots(this, this + 1);
+  }
+
+  ~seq_alloc_cache() {
+    for (int c = 0; c < SEQ_MAG_CLASSES; c++) {
+      while (lists[c]) {
+        void *next = *(void **)lists[c];
+        GC_FREE(lists[c]);
+        lists[c] = next;
+      }
+      while (atomicCount[c] > 0)
+        GC_FREE(atomics[c][--atomicCount[c]]);
+    }
+    GC_remove_roots(this, this + 1);
+  }
+
+  void *alloc(size_t n) {
+    const int c = (n > 0) ? (int)((n - 1) / SEQ_MAG_GRANULE) : 0;
+    void *p = lists[c];
+    if (!p) {
+      GC_generic_malloc_many((c + 1) * SEQ_MAG_GRANULE, GC_I_NORMAL, &lists[c]);
+      p = lists[c];
+      if (!p)
+        return GC_MALLOC(n);
+    }
+    lists[c] = *(void **)p;
+    *(void **)p = nullptr;
+    return p;
+  }
+
+  void *allocAtomic(size_t n) {
+    const int c = (n > 0) ? (int)((n - 1) / SEQ_MAG_GRANULE) : 0;
+    if (atomicCount[c] == 0) {
+      const size_t size = (c + 1) * SEQ_MAG_GRANULE;
+      for (int i = 0; i < SEQ_MAG_ATOMIC_BATCH; i++) {
+        void *q = GC_MALLOC_ATOMIC(size);
+        if (!q)
+          break;
+        atomics[c][atomicCount[c]++] = q;
+      }
+      if (atomicCount[c] == 0)
+        return GC_MALLOC_ATOMIC(n);
+    }
+    return atomics[c][--atomicCount[c]];
+  }
+};
+
+thread_local seq_alloc_cache seq_tl_alloc_cache;
+
+// Request-scoped arenas: while one is open on a thread, seq_alloc and
+// seq_alloc_atomic bump-allocate from its chunks and everything is freed en
+// masse when it closes. Chunks are uncollectable GC blocks, so the collector
+// still sees pointers from arena objects into the regular heap (atomic chunks
+// are not scanned at all), but never scans or collects the arena contents as
+// individual objects. Finalizers registered for arena objects run at close,
+// newest first.
+struct seq_arena {
+  static const size_t CHUNK = 64 * 1024;
+
+  struct chunk_t {
+    chunk_t *next;
+    size_t size;
+    size_t used;
+  };
+
+  chunk_t *scanned;
+  chunk_t *atomic;
+  seq_arena *parent;
+  std::vector<std::pair<void *, void (*)(void *, void *)>> finalizers;
+
+  explicit seq_arena(seq_arena *parent)
+      : scanned(nullptr), atomic(nullptr), parent(parent), finalizers() {}
+
+  static void *chunkAlloc(chunk_t *&list, size_t n, bool isAtomic) {
+    const size_t hdr = (sizeof(chunk_t) + 15) & ~(size_t)15;
+    n = (n + 15) & ~(size_t)15;
+    chunk_t *head = list;
+    if (!head || head->size - head->used < n) {
+      size_t size = hdr + n;
+      if (size < CHUNK)
+        size = CHUNK;
+      void *raw = isAtomic ? GC_MALLOC_ATOMIC_UNCOLLECTABLE(size)
+                           : GC_MALLOC_UNCOLLECTABLE(size);
+      if (!raw)
+        return nullptr;
+      head = (chunk_t *)raw;
+      head->next = list;
+      head->size = size;
+      head->used = hdr;
+      list = head;
+    }
+    void *p = (char *)head + head->used;
+    head->used += n;
+    return p;
+  }
+
+  void *alloc(size_t n, bool isAtomic) {
+    return chunkAlloc(isAtomic ? atomic : scanned, n, isAtomic);
+  }
+
+  bool contains(void *p) const {
+    for (auto *c = scanned; c; c = c->next)
+      if (p >= (void *)c && p < (void *)((char *)c + c->size))
+        return true;
+    for (auto *c = atomic; c; c = c->next)
+      if (p >= (void *)c && p < (void *)((char *)c + c->size))
+        return true;
+    return false;
+  }
+
+  void close() {
+    for (auto it = finalizers.rbegin(); it != finalizers.rend(); ++it)
+      it->second(it->first, nullptr);
+    while (scanned) {
+      auto *next = scanned->next;
+      GC_FREE(scanned);
+      scanned = next;
+    }
+    while (atomic) {
+      auto *next = atomic->next;
+      GC_FREE(atomic);
+      atomic = next;
+    }
+  }
+};
+
+thread_local seq_arena *seq_tl_arena = nullptr;
+} // namespace
+#endif
+
+SEQ_FUNC void seq_arena_begin() {
+#if !USE_STANDARD_MALLOC
+  seq_tl_arena = new seq_arena(seq_tl_arena);
+#endif
+}
+
+SEQ_FUNC void seq_arena_end() {
+#if !USE_STANDARD_MALLOC
+  if (auto *arena = seq_tl_arena) {
+    seq_tl_arena = arena->parent;
+    arena->close();
+    delete arena;
+  }
+#endif
+}
+
 SEQ_FUNC void *seq_alloc(size_t n) {
+  if (allocProfileEvery && --allocProfileCountdown <= 0)
+    seq_alloc_profile_record(n);
 #if USE_STANDARD_MALLOC
   return malloc(n);
 #else
+  if (seq_tl_arena)
+    return seq_tl_arena->alloc(n, /*isAtomic=*/false);
+  if (n <= SEQ_MAG_MAX)
+    return seq_tl_alloc_cache.alloc(n);
   return GC_MALLOC(n);
 #endif
 }
 
 SEQ_FUNC void *seq_alloc_atomic(size_t n) {
+  if (allocProfileEvery && --allocProfileCountdown <= 0)
+    seq_alloc_profile_record(n);
 #if USE_STANDARD_MALLOC
   return malloc(n);
 #else
+  if (seq_tl_arena)
+    return seq_tl_arena->alloc(n, /*isAtomic=*/true);
+  if (n <= SEQ_MAG_MAX)
+    return seq_tl_alloc_cache.allocAtomic(n);
   return GC_MALLOC_ATOMIC(n);
 #endif
 }
@@ -185,6 +1124,70 @@ SEQ_FUNC void *seq_alloc_atomic_uncollectable(size_t n) {
 #endif
 }
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+
+// memory policy modes from <numaif.h>; call mbind/get_mempolicy via
+// syscall() directly to avoid a libnuma dependency
+#define SEQ_MPOL_BIND 2
+#define SEQ_MPOL_INTERLEAVE 3
+#define SEQ_MPOL_F_MEMS_ALLOWED (1 << 2)
+
+static void seq_numa_apply(void *p, size_t n, int mode, unsigned long *nodemask,
+                           unsigned long maxnode) {
+  if (!p || !n)
+    return;
+  // mbind requires a page-aligned range; policy only matters for whole
+  // pages anyway, so cover the page-aligned interior of the block
+  const uintptr_t page = sysconf(_SC_PAGESIZE);
+  uintptr_t lo = (reinterpret_cast<uintptr_t>(p) + page - 1) & ~(page - 1);
+  uintptr_t hi = (reinterpret_cast<uintptr_t>(p) + n) & ~(page - 1);
+  if (hi > lo)
+    syscall(SYS_mbind, reinterpret_cast<void *>(lo), hi - lo, mode, nodemask, maxnode,
+            0UL); // best-effort; on failure pages keep the default policy
+}
+#endif
+
+static void *seq_numa_interleave(void *p, size_t n) {
+#if defined(__linux__)
+  unsigned long nodemask[16] = {0};
+  const unsigned long maxnode = sizeof(nodemask) * CHAR_BIT;
+  if (syscall(SYS_get_mempolicy, nullptr, nodemask, maxnode, nullptr,
+              (unsigned long)SEQ_MPOL_F_MEMS_ALLOWED) == 0)
+    seq_numa_apply(p, n, SEQ_MPOL_INTERLEAVE, nodemask, maxnode);
+#endif
+  return p;
+}
+
+static void *seq_numa_bind(void *p, size_t n, seq_int_t node) {
+#if defined(__linux__)
+  unsigned long nodemask[16] = {0};
+  const unsigned long maxnode = sizeof(nodemask) * CHAR_BIT;
+  if (node >= 0 && node < (seq_int_t)maxnode) {
+    nodemask[node / (sizeof(unsigned long) * CHAR_BIT)] |=
+        1UL << (node % (sizeof(unsigned long) * CHAR_BIT));
+    seq_numa_apply(p, n, SEQ_MPOL_BIND, nodemask, maxnode);
+  }
+#endif
+  return p;
+}
+
+SEQ_FUNC void *seq_alloc_numa_interleaved(size_t n) {
+  return seq_numa_interleave(seq_alloc(n), n);
+}
+
+SEQ_FUNC void *seq_alloc_atomic_numa_interleaved(size_t n) {
+  return seq_numa_interleave(seq_alloc_atomic(n), n);
+}
+
+SEQ_FUNC void *seq_alloc_numa_bound(size_t n, seq_int_t node) {
+  return seq_numa_bind(seq_alloc(n), n, node);
+}
+
+SEQ_FUNC void *seq_alloc_atomic_numa_bound(size_t n, seq_int_t node) {
+  return seq_numa_bind(seq_alloc_atomic(n), n, node);
+}
+
 SEQ_FUNC void *seq_realloc(void *p, size_t newsize, size_t oldsize) {
 #if USE_STANDARD_MALLOC
   return realloc(p, newsize);
@@ -203,6 +1206,13 @@ SEQ_FUNC void seq_free(void *p) {
 
 SEQ_FUNC void seq_register_finalizer(void *p, void (*f)(void *obj, void *data)) {
 #if !USE_STANDARD_MALLOC
+  // arena objects are never collected; run their finalizers at region close
+  for (auto *arena = seq_tl_arena; arena; arena = arena->parent) {
+    if (arena->contains(p)) {
+      arena->finalizers.emplace_back(p, f);
+      return;
+    }
+  }
   GC_REGISTER_FINALIZER(p, f, nullptr, nullptr, nullptr);
 #endif
 }
@@ -231,6 +1241,78 @@ SEQ_FUNC void seq_gc_exclude_static_roots(void *start, void *end) {
 #endif
 }
 
+// Switches the collector to incremental (generational) marking, which bounds
+// individual pauses at some throughput cost. Also reachable via the
+// CODON_GC_INCREMENTAL environment variable, which enables it at startup —
+// preferable, since incremental mode is best entered before the heap grows.
+SEQ_FUNC void seq_gc_enable_incremental() {
+#if !USE_STANDARD_MALLOC
+  GC_enable_incremental();
+#endif
+}
+
+// Hints an upper bound, in milliseconds, for a single incremental marking
+// pause (CODON_GC_PAUSE_LIMIT at startup). Only meaningful in incremental
+// mode; the bound is approximate.
+SEQ_FUNC void seq_gc_set_pause_budget(seq_int_t ms) {
+#if !USE_STANDARD_MALLOC
+  if (ms > 0)
+    GC_set_time_limit((unsigned long)ms);
+#endif
+}
+
+// Grows the heap by at least `bytes` up front (CODON_GC_INITIAL_HEAP at
+// startup, with an optional K/M/G suffix), so a job with a known footprint
+// maps its heap in a few large sections instead of paying a collection
+// attempt and a fault storm at every step of an on-demand ramp.
+SEQ_FUNC void seq_gc_expand_heap(seq_int_t bytes) {
+#if !USE_STANDARD_MALLOC
+  if (bytes > 0)
+    GC_expand_hp((size_t)bytes);
+#endif
+}
+
+// Marks the heap's mappings as transparent-huge-page candidates
+// (CODON_GC_THP at startup), trading some memory slack for far fewer TLB
+// misses on large heaps. Advice does not extend to sections mapped later,
+// so call again after significant growth. Linux only; a no-op elsewhere.
+SEQ_FUNC void seq_gc_hugepage_heap() {
+#if defined(__linux__) && !USE_STANDARD_MALLOC
+  seq_gc_advise_heap(MADV_HUGEPAGE);
+#endif
+}
+
+// Eagerly faults in the heap's mappings (CODON_GC_PREFAULT at startup) so
+// first-touch page faults are paid here, once, rather than spread across the
+// allocation path. Most useful right after expand_heap(). Linux only; a
+// no-op elsewhere.
+SEQ_FUNC void seq_gc_prefault_heap() {
+#if defined(__linux__) && !USE_STANDARD_MALLOC
+  // MADV_POPULATE_WRITE populates pages as if written, without changing
+  // their contents; kernels before 5.14 reject it, where MADV_WILLNEED is
+  // the best remaining hint.
+  if (seq_gc_advise_heap(MADV_POPULATE_WRITE) == 0)
+    seq_gc_advise_heap(MADV_WILLNEED);
+#endif
+}
+
+// Fills out[0..5] with: heap size, free bytes, total bytes allocated since
+// startup, number of collections, cumulative full-collection pause time (ms)
+// and maximum pause (ms).
+SEQ_FUNC void seq_gc_stats(seq_int_t *out) {
+#if !USE_STANDARD_MALLOC
+  out[0] = (seq_int_t)GC_get_heap_size();
+  out[1] = (seq_int_t)GC_get_free_bytes();
+  out[2] = (seq_int_t)GC_get_total_bytes();
+  out[3] = (seq_int_t)GC_get_gc_no();
+  out[4] = (seq_int_t)seq_gc_pause_total_ms.load();
+  out[5] = (seq_int_t)seq_gc_pause_max_ms.load();
+#else
+  for (int i = 0; i < 6; i++)
+    out[i] = 0;
+#endif
+}
+
 /*
  * String conversion
  */
@@ -265,15 +1347,62 @@ template <typename T> seq_str_t fmt_conv(T n, seq_str_t format, bool *error) {
   }
 }
 
+// Non-allocating conversions writing into caller-provided buffers, used by
+// the default (no-format-spec) paths below and callable directly from
+// generated code. These are locale-free: integers go through fmt's
+// digit-pair tables and floats through fmt's binary-to-decimal algorithm,
+// never snprintf. Buffers must hold at least 20 (int) or 32 (float) bytes.
+
+SEQ_FUNC seq_int_t seq_str_int_buf(seq_int_t n, char *buf) {
+  fmt::format_int f(n);
+  memcpy(buf, f.data(), f.size());
+  return (seq_int_t)f.size();
+}
+
+SEQ_FUNC seq_int_t seq_str_uint_buf(seq_int_t n, char *buf) {
+  fmt::format_int f((uint64_t)n);
+  memcpy(buf, f.data(), f.size());
+  return (seq_int_t)f.size();
+}
+
+SEQ_FUNC seq_int_t seq_str_float_buf(double f, char *buf) {
+  auto result = fmt::format_to_n(buf, 32, FMT_STRING("{:g}"), f);
+  return (seq_int_t)result.size;
+}
+
 SEQ_FUNC seq_str_t seq_str_int(seq_int_t n, seq_str_t format, bool *error) {
+  if (format.len == 0) {
+    *error = false;
+    char buf[20];
+    auto size = seq_str_int_buf(n, buf);
+    auto *p = (char *)seq_alloc_atomic(size);
+    memcpy(p, buf, size);
+    return {size, p};
+  }
   return fmt_conv<seq_int_t>(n, format, error);
 }
 
 SEQ_FUNC seq_str_t seq_str_uint(seq_int_t n, seq_str_t format, bool *error) {
+  if (format.len == 0) {
+    *error = false;
+    char buf[20];
+    auto size = seq_str_uint_buf(n, buf);
+    auto *p = (char *)seq_alloc_atomic(size);
+    memcpy(p, buf, size);
+    return {size, p};
+  }
   return fmt_conv<uint64_t>(n, format, error);
 }
 
 SEQ_FUNC seq_str_t seq_str_float(double f, seq_str_t format, bool *error) {
+  if (format.len == 0) {
+    *error = false;
+    char buf[32];
+    auto size = seq_str_float_buf(f, buf);
+    auto *p = (char *)seq_alloc_atomic(size);
+    memcpy(p, buf, size);
+    return {size, p};
+  }
   return fmt_conv<double>(f, format, error);
 }
 
@@ -300,6 +1429,77 @@ SEQ_FUNC double seq_float_from_str(seq_str_t s, const char **e) {
   return result;
 }
 
+// Strict fast-path parsers for the common case of a clean base-10 number with
+// no surrounding whitespace, underscores or prefixes. On any deviation they
+// set *ok to false and the caller falls back to the general parsing path, so
+// these never need to replicate full Python semantics.
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// SWAR helpers: validate and convert eight ASCII digits per 64-bit word.
+static inline bool seq_eight_digits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+static inline uint64_t seq_parse_eight_digits(uint64_t chunk) {
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10) + (chunk >> 8); // digit pairs
+  return (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+}
+#endif
+
+SEQ_FUNC seq_int_t seq_fast_atoi(seq_str_t s, bool *ok) {
+  const char *p = s.str;
+  const char *end = s.str + s.len;
+  *ok = false;
+
+  bool neg = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    neg = (*p == '-');
+    ++p;
+  }
+  // empty, or enough digits to overflow: let the general path sort it out
+  if (p == end || end - p > 19)
+    return 0;
+
+  uint64_t value = 0;
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - p >= 8) {
+    uint64_t chunk;
+    memcpy(&chunk, p, 8);
+    if (!seq_eight_digits(chunk))
+      return 0;
+    value = value * 100000000 + seq_parse_eight_digits(chunk);
+    p += 8;
+  }
+#endif
+  while (p < end) {
+    unsigned digit = (unsigned char)*p - '0';
+    if (digit > 9)
+      return 0;
+    value = value * 10 + digit;
+    ++p;
+  }
+
+  if (value > (uint64_t)INT64_MAX + (neg ? 1 : 0))
+    return 0;
+  *ok = true;
+  return neg ? -(seq_int_t)value : (seq_int_t)value;
+}
+
+SEQ_FUNC double seq_fast_atof(seq_str_t s, bool *ok) {
+  double result = 0.0;
+  auto r = fast_float::from_chars(s.str, s.str + s.len, result);
+  *ok = s.len > 0 &&
+        (r.ec == std::errc() || r.ec == std::errc::result_out_of_range) &&
+        r.ptr == s.str + s.len;
+  return result;
+}
+
 /*
  * General I/O
  */
@@ -316,25 +1516,156 @@ SEQ_FUNC seq_str_t seq_check_errno() {
 
 SEQ_FUNC void seq_print(seq_str_t str) { seq_print_full(str, stdout); }
 
-static std::ostringstream capture;
+// Captured stdout/stderr accumulates directly in a string that is moved --
+// not copied -- to the caller, so a cell printing a large table pays for one
+// buffer, not the buffer plus an ostringstream and a .str() copy of it.
+static std::string capture;
 static std::mutex captureLock;
 
 SEQ_FUNC void seq_print_full(seq_str_t str, FILE *fo) {
   if ((seq_flags & SEQ_FLAG_CAPTURE_OUTPUT) && (fo == stdout || fo == stderr)) {
-    captureLock.lock();
-    capture.write(str.str, str.len);
-    captureLock.unlock();
+    std::lock_guard<std::mutex> guard(captureLock);
+    capture.append(str.str, (size_t)str.len);
   } else {
     fwrite(str.str, 1, (size_t)str.len, fo);
   }
 }
 
+#if defined(__unix__) || defined(__APPLE__)
+static void seq_writev_all(int fd, struct iovec *iov, int count) {
+  while (count > 0) {
+    ssize_t w = writev(fd, iov, count);
+    if (w < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    // advance past fully written pieces, then trim a partial one
+    while (count > 0 && (size_t)w >= iov->iov_len) {
+      w -= (ssize_t)iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = (char *)iov->iov_base + w;
+      iov->iov_len -= (size_t)w;
+    }
+  }
+}
+#endif
+
+SEQ_FUNC void seq_print_vec(seq_str_t *strs, seq_int_t n, FILE *fo) {
+  if ((seq_flags & SEQ_FLAG_CAPTURE_OUTPUT) && (fo == stdout || fo == stderr)) {
+    std::lock_guard<std::mutex> guard(captureLock);
+    size_t total = 0;
+    for (seq_int_t i = 0; i < n; i++)
+      total += (size_t)strs[i].len;
+    capture.reserve(capture.size() + total);
+    for (seq_int_t i = 0; i < n; i++)
+      capture.append(strs[i].str, (size_t)strs[i].len);
+    return;
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // large batches skip stdio entirely: flush what stdio holds (to keep
+  // ordering), then hand the pieces to the kernel directly via writev
+  size_t total = 0;
+  for (seq_int_t i = 0; i < n; i++)
+    total += (size_t)strs[i].len;
+  if (total >= 4096) {
+    fflush(fo);
+    int fd = fileno(fo);
+    seq_int_t i = 0;
+    while (i < n) {
+      struct iovec iov[64];
+      int count = 0;
+      while (i < n && count < 64) {
+        if (strs[i].len > 0) {
+          iov[count].iov_base = (void *)strs[i].str;
+          iov[count].iov_len = (size_t)strs[i].len;
+          ++count;
+        }
+        ++i;
+      }
+      seq_writev_all(fd, iov, count);
+    }
+    return;
+  }
+#endif
+
+  // gather small pieces into a stack buffer so a run of writes costs a
+  // single fwrite (and stdio lock round) instead of one per piece
+  char buf[4096];
+  size_t filled = 0;
+  for (seq_int_t i = 0; i < n; i++) {
+    auto len = (size_t)strs[i].len;
+    if (len > sizeof(buf) - filled) {
+      if (filled) {
+        fwrite(buf, 1, filled, fo);
+        filled = 0;
+      }
+      if (len >= sizeof(buf)) {
+        fwrite(strs[i].str, 1, len, fo);
+        continue;
+      }
+    }
+    memcpy(buf + filled, strs[i].str, len);
+    filled += len;
+  }
+  if (filled)
+    fwrite(buf, 1, filled, fo);
+}
+
 std::string codon::runtime::getCapturedOutput() {
-  std::string result = capture.str();
-  capture.str("");
+  std::lock_guard<std::mutex> guard(captureLock);
+  std::string result;
+  result.swap(capture);
   return result;
 }
 
+// Read-only file mapping backing the zero-copy file mode. On success returns
+// the mapping base and stores the file size; on error returns null with
+// *size = -1. A zero-size file yields a null base with *size = 0 (mmap
+// rejects empty mappings). The fd is closed immediately -- the mapping keeps
+// the file alive -- and the kernel is advised of sequential access.
+SEQ_FUNC void *seq_mmap_open(seq_str_t path, seq_int_t *size) {
+#if defined(__unix__) || defined(__APPLE__)
+  *size = -1;
+  std::string p(path.str, path.len);
+  int fd = open(p.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+  *size = (seq_int_t)st.st_size;
+  if (st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  void *base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    *size = -1;
+    return nullptr;
+  }
+  madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+  return base;
+#else
+  *size = -1;
+  return nullptr;
+#endif
+}
+
+SEQ_FUNC void seq_mmap_close(void *base, seq_int_t size) {
+#if defined(__unix__) || defined(__APPLE__)
+  if (base && size > 0)
+    munmap(base, (size_t)size);
+#endif
+}
+
 SEQ_FUNC void *seq_stdin() { return stdin; }
 
 SEQ_FUNC void *seq_stdout() { return stdout; }
@@ -40,12 +40,27 @@ struct seq_time_t {
   int8_t isdst;
 };
 
+struct seq_dirent_t {
+  seq_str_t name;
+  seq_int_t type; // 0 = unknown, 1 = file, 2 = dir, 3 = symlink, 4 = other
+};
+
+struct seq_stat_t {
+  seq_int_t mode;
+  seq_int_t size;
+  seq_int_t mtime;
+};
+
 SEQ_FUNC int seq_flags;
 
 SEQ_FUNC void seq_init(int flags);
+SEQ_FUNC void seq_pgo_dump();
 
+SEQ_FUNC seq_int_t seq_cpu_feature_level();
 SEQ_FUNC bool seq_is_macos();
 SEQ_FUNC seq_int_t seq_pid();
+SEQ_FUNC void seq_set_interrupt(bool flag);
+SEQ_FUNC bool seq_check_interrupt();
 SEQ_FUNC seq_int_t seq_time();
 SEQ_FUNC seq_int_t seq_time_monotonic();
 SEQ_FUNC seq_int_t seq_time_highres();
@@ -54,12 +69,29 @@ SEQ_FUNC bool seq_gmtime(seq_int_t secs, seq_time_t *output);
 SEQ_FUNC seq_int_t seq_mktime(seq_time_t *time);
 SEQ_FUNC void seq_sleep(double secs);
 SEQ_FUNC char **seq_env();
+SEQ_FUNC void *seq_dir_open(seq_str_t path);
+SEQ_FUNC seq_int_t seq_dir_read(void *dir, seq_dirent_t *out, seq_int_t max);
+SEQ_FUNC void seq_dir_close(void *dir);
+SEQ_FUNC bool seq_stat(seq_str_t path, bool follow, seq_stat_t *out);
 SEQ_FUNC void seq_assert_failed(seq_str_t file, seq_int_t line);
 
+SEQ_FUNC void seq_profile_start(seq_int_t interval);
+SEQ_FUNC void seq_profile_stop();
+SEQ_FUNC bool seq_profile_dump(seq_str_t path);
+
+SEQ_FUNC void seq_hit(seq_int_t site);
+SEQ_FUNC void seq_hit_register(seq_int_t site, seq_str_t name);
+
 SEQ_FUNC void *seq_alloc(size_t n);
 SEQ_FUNC void *seq_alloc_atomic(size_t n);
 SEQ_FUNC void *seq_alloc_uncollectable(size_t n);
 SEQ_FUNC void *seq_alloc_atomic_uncollectable(size_t n);
+SEQ_FUNC void *seq_alloc_numa_interleaved(size_t n);
+SEQ_FUNC void *seq_alloc_atomic_numa_interleaved(size_t n);
+SEQ_FUNC void *seq_alloc_numa_bound(size_t n, seq_int_t node);
+SEQ_FUNC void *seq_alloc_atomic_numa_bound(size_t n, seq_int_t node);
+SEQ_FUNC void seq_arena_begin();
+SEQ_FUNC void seq_arena_end();
 SEQ_FUNC void *seq_realloc(void *p, size_t newsize, size_t oldsize);
 SEQ_FUNC void seq_free(void *p);
 SEQ_FUNC void seq_register_finalizer(void *p, void (*f)(void *obj, void *data));
@@ -68,6 +100,12 @@ SEQ_FUNC void seq_gc_add_roots(void *start, void *end);
 SEQ_FUNC void seq_gc_remove_roots(void *start, void *end);
 SEQ_FUNC void seq_gc_clear_roots();
 SEQ_FUNC void seq_gc_exclude_static_roots(void *start, void *end);
+SEQ_FUNC void seq_gc_stats(seq_int_t *out);
+SEQ_FUNC void seq_gc_enable_incremental();
+SEQ_FUNC void seq_gc_set_pause_budget(seq_int_t ms);
+SEQ_FUNC void seq_gc_expand_heap(seq_int_t bytes);
+SEQ_FUNC void seq_gc_hugepage_heap();
+SEQ_FUNC void seq_gc_prefault_heap();
 
 SEQ_FUNC void *seq_alloc_exc(int type, void *obj);
 SEQ_FUNC void seq_throw(void *exc);
@@ -76,19 +114,30 @@ SEQ_FUNC _Unwind_Reason_Code seq_personality(int version, _Unwind_Action actions
                                              _Unwind_Exception *exceptionObject,
                                              _Unwind_Context *context);
 SEQ_FUNC int64_t seq_exc_offset();
+SEQ_FUNC void seq_exc_lsda_cache_invalidate();
 
+SEQ_FUNC seq_int_t seq_str_int_buf(seq_int_t n, char *buf);
+SEQ_FUNC seq_int_t seq_str_uint_buf(seq_int_t n, char *buf);
+SEQ_FUNC seq_int_t seq_str_float_buf(double f, char *buf);
 SEQ_FUNC seq_str_t seq_str_int(seq_int_t n, seq_str_t format, bool *error);
 SEQ_FUNC seq_str_t seq_str_uint(seq_int_t n, seq_str_t format, bool *error);
 SEQ_FUNC seq_str_t seq_str_float(double f, seq_str_t format, bool *error);
 SEQ_FUNC seq_str_t seq_str_ptr(void *p, seq_str_t format, bool *error);
 SEQ_FUNC seq_str_t seq_str_str(seq_str_t s, seq_str_t format, bool *error);
 
+SEQ_FUNC seq_int_t seq_fast_atoi(seq_str_t s, bool *ok);
+SEQ_FUNC double seq_fast_atof(seq_str_t s, bool *ok);
+
+SEQ_FUNC void *seq_mmap_open(seq_str_t path, seq_int_t *size);
+SEQ_FUNC void seq_mmap_close(void *base, seq_int_t size);
+
 SEQ_FUNC void *seq_stdin();
 SEQ_FUNC void *seq_stdout();
 SEQ_FUNC void *seq_stderr();
 
 SEQ_FUNC void seq_print(seq_str_t str);
 SEQ_FUNC void seq_print_full(seq_str_t str, FILE *fo);
+SEQ_FUNC void seq_print_vec(seq_str_t *strs, seq_int_t n, FILE *fo);
 
 SEQ_FUNC void *seq_lock_new();
 SEQ_FUNC void *seq_lock_new();
@@ -132,5 +181,7 @@ std::string getCapturedOutput();
 
 void setJITErrorCallback(std::function<void(const JITError &)> callback);
 
+void setProfileSymbolizer(std::function<std::string(uintptr_t)> symbolizer);
+
 } // namespace runtime
 } // namespace codon
@@ -1,8 +1,11 @@
 // Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
 
 #include "codon/runtime/lib.h"
+#include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <re2/re2.h>
+#include <re2/set.h>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -110,20 +113,39 @@ struct KeyHash {
   }
 };
 
-static thread_local std::unordered_map<const Key, Regex, KeyHash, KeyEqual,
-                                       GCMapAllocator<std::pair<const Key, Regex>>>
+// Compiled patterns live in an append-only process-wide store; each thread
+// keeps its own view of pointers into the store, so the common case (a
+// pattern this thread has seen before) takes no lock, and each pattern is
+// compiled at most once per process rather than once per thread. Regex
+// objects are never destroyed, so handed-out pointers stay valid.
+static std::mutex storeLock;
+static std::unordered_map<const Key, Regex *, KeyHash, KeyEqual,
+                          GCMapAllocator<std::pair<const Key, Regex *>>>
+    store;
+
+static thread_local std::unordered_map<const Key, Regex *, KeyHash, KeyEqual,
+                                       GCMapAllocator<std::pair<const Key, Regex *>>>
     cache;
 
 static inline Regex *get(const seq_str_t &p, seq_int_t flags) {
   auto key = std::make_pair(p, flags);
   auto it = cache.find(key);
-  if (it == cache.end()) {
-    auto result = cache.emplace(std::piecewise_construct, std::forward_as_tuple(key),
-                                std::forward_as_tuple(str2sp(p), flags2opt(flags)));
-    return &result.first->second;
-  } else {
-    return &it->second;
+  if (it != cache.end())
+    return it->second;
+
+  Regex *re = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(storeLock);
+    auto stored = store.find(key);
+    if (stored != store.end()) {
+      re = stored->second;
+    } else {
+      re = new Regex(str2sp(p), flags2opt(flags));
+      store.emplace(key, re);
+    }
   }
+  cache.emplace(key, re);
+  return re;
 }
 
 /*
@@ -178,7 +200,44 @@ SEQ_FUNC seq_str_t seq_re_escape(seq_str_t p) {
 
 SEQ_FUNC Regex *seq_re_compile(seq_str_t p, seq_int_t flags) { return get(p, flags); }
 
-SEQ_FUNC void seq_re_purge() { cache.clear(); }
+SEQ_FUNC void seq_re_purge() {
+  // Drop this thread's view only; compiled patterns in the shared store may
+  // still be referenced by Pattern objects or other threads' views.
+  cache.clear();
+}
+
+/*
+ * Pattern sets
+ */
+
+SEQ_FUNC re2::RE2::Set *seq_re_set_new(seq_int_t flags, seq_int_t anchor) {
+  return new re2::RE2::Set(flags2opt(flags), static_cast<Regex::Anchor>(anchor));
+}
+
+SEQ_FUNC seq_int_t seq_re_set_add(re2::RE2::Set *set, seq_str_t p, seq_str_t *error) {
+  std::string e;
+  int index = set->Add(str2sp(p), &e);
+  if (index < 0)
+    *error = convert(e);
+  return index;
+}
+
+SEQ_FUNC bool seq_re_set_compile(re2::RE2::Set *set) { return set->Compile(); }
+
+SEQ_FUNC seq_int_t seq_re_set_match(re2::RE2::Set *set, seq_str_t s, seq_int_t *out,
+                                    seq_int_t n) {
+  std::vector<int> matched;
+  if (!set->Match(str2sp(s), &matched))
+    return 0;
+  std::sort(matched.begin(), matched.end());
+  seq_int_t count = 0;
+  for (int index : matched) {
+    if (count >= n)
+      break;
+    out[count++] = index;
+  }
+  return count;
+}
 
 /*
  * Pattern methods
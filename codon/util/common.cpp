@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <sys/resource.h>
 #include <vector>
 
 namespace codon {
@@ -93,6 +94,71 @@ codon::Logger &codon::getLogger() {
   return loggers.back();
 }
 
+void codon::Profiler::record(const std::string &category, const std::string &name,
+                             double seconds) {
+  if (!enabled)
+    return;
+  for (auto &r : records)
+    if (r.category == category && r.name == name) {
+      r.time += seconds;
+      r.runs++;
+      return;
+    }
+  records.push_back({category, name, seconds, 1});
+}
+
+void codon::Profiler::count(const std::string &name, int64_t value) {
+  if (!enabled)
+    return;
+  for (auto &c : counters)
+    if (c.first == name) {
+      c.second = value;
+      return;
+    }
+  counters.emplace_back(name, value);
+}
+
+int64_t codon::Profiler::peakRSS() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return int64_t(usage.ru_maxrss); // bytes
+#else
+  return int64_t(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+}
+
+std::string codon::Profiler::json() const {
+  auto escape = [](const std::string &s) {
+    std::string r;
+    for (char c : s) {
+      if (c == '"' || c == '\\')
+        r += '\\';
+      r += c;
+    }
+    return r;
+  };
+  std::string timings;
+  for (auto &r : records)
+    timings += fmt::format("{}    {{\"category\": \"{}\", \"name\": \"{}\", "
+                           "\"seconds\": {:.6f}, \"runs\": {}}}",
+                           timings.empty() ? "" : ",\n", escape(r.category),
+                           escape(r.name), r.time, r.runs);
+  std::string counts;
+  for (auto &c : counters)
+    counts += fmt::format("{}    \"{}\": {}", counts.empty() ? "" : ",\n",
+                          escape(c.first), c.second);
+  return fmt::format("{{\n  \"version\": \"{}\",\n  \"peak_rss_bytes\": {},\n"
+                     "  \"timings\": [\n{}\n  ],\n  \"counters\": {{\n{}\n  }}\n}}\n",
+                     CODON_VERSION, peakRSS(), timings, counts);
+}
+
+codon::Profiler &codon::getProfiler() {
+  static codon::Profiler profiler;
+  return profiler;
+}
+
 void codon::pushLogger() { loggers.emplace_back(); }
 
 bool codon::popLogger() {
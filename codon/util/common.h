@@ -3,6 +3,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <fmt/ranges.h>
@@ -93,6 +94,40 @@ Logger &getLogger();
 void pushLogger();
 bool popLogger();
 
+/// Structured compile-time instrumentation. When enabled, frontend phases and
+/// CIR passes record wall times and node counts here, and the accumulated
+/// profile can be serialized as JSON (see the `-profile-compile` option) so
+/// that compile-time regressions can be tracked across releases.
+struct Profiler {
+  struct Record {
+    /// Record category ("phase", "pass" or "analysis").
+    std::string category;
+    /// Phase or pass name.
+    std::string name;
+    /// Accumulated wall time (seconds).
+    double time;
+    /// Number of times the record was hit.
+    int64_t runs;
+  };
+
+  bool enabled = false;
+  /// Timing records in first-hit order.
+  std::vector<Record> records;
+  /// Named counters (e.g. import, realization and IR node counts).
+  std::vector<std::pair<std::string, int64_t>> counters;
+
+  /// Accumulate a timing record (no-op unless enabled).
+  void record(const std::string &category, const std::string &name, double seconds);
+  /// Set a named counter (no-op unless enabled).
+  void count(const std::string &name, int64_t value);
+  /// Peak resident set size in bytes (0 if unavailable).
+  static int64_t peakRSS();
+  /// Serialize the collected profile as JSON.
+  std::string json() const;
+};
+
+Profiler &getProfiler();
+
 class Timer {
 private:
   using clock_type = std::chrono::high_resolution_clock;
@@ -0,0 +1,56 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace codon {
+namespace util {
+
+/// @return the number of worker threads compile-time parallel loops may use;
+///         honors the CODON_COMPILE_THREADS environment variable
+inline size_t compileThreadCount() {
+  static size_t count = []() -> size_t {
+    if (const char *env = std::getenv("CODON_COMPILE_THREADS")) {
+      auto n = std::atoi(env);
+      if (n >= 1)
+        return size_t(n);
+    }
+    auto hw = std::thread::hardware_concurrency();
+    return hw ? size_t(hw) : 1;
+  }();
+  return count;
+}
+
+/// Runs body(0) ... body(n - 1) across a pool of threads and joins before
+/// returning. Iterations must be independent; bodies may allocate IR nodes
+/// (node IDs are atomic) but must not mutate shared structures. Falls back to
+/// a plain serial loop for small n or single-threaded configurations.
+template <typename F> void parallelFor(size_t n, F body, size_t minPerThread = 4) {
+  size_t threads = std::min(compileThreadCount(), n / minPerThread);
+  if (threads <= 1) {
+    for (size_t i = 0; i < n; i++)
+      body(i);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+  pool.reserve(threads);
+  for (size_t t = 0; t < threads; t++) {
+    pool.emplace_back([&]() {
+      for (size_t i = next++; i < n; i = next++)
+        body(i);
+    });
+  }
+  for (auto &worker : pool)
+    worker.join();
+}
+
+} // namespace util
+} // namespace codon
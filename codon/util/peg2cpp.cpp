@@ -160,6 +160,17 @@ int main(int argc, char **argv) {
       g.c_str(), g.size(), dummy, start, enablePackratParsing, preamble, log);
   assert(grammar);
 
+  // Intern all rule names up front so that the generated initializer can address
+  // definitions through a static table instead of repeated string-keyed lookups.
+  vector<string> ruleNames;
+  unordered_map<string, int> ruleIndex;
+  for (auto &[name, def] : *grammar) {
+    if (dummy.find(name) != dummy.end())
+      continue;
+    ruleIndex[name] = ruleNames.size();
+    ruleNames.push_back(name);
+  }
+
   string rules, actions, actionFns;
   string action_preamble = "  auto &CTX = any_cast<ParseContext &>(DT);\n";
   string const_action_preamble =
@@ -175,18 +186,18 @@ int main(int argc, char **argv) {
     if (dummy.find(name) != dummy.end())
       continue;
 
-    rules += fmt::format("  {}P[\"{}\"] <= {};\n", def.ignoreSemanticValue ? "~" : "",
-                         name, PrintVisitor::parse(op));
-    rules += fmt::format("  P[\"{}\"].name = \"{}\";\n", name, escape(name));
+    auto R = fmt::format("(*R[{}])", ruleIndex[name]);
+    rules += fmt::format("  {}{} <= {};\n", def.ignoreSemanticValue ? "~" : "", R,
+                         PrintVisitor::parse(op));
     if (def.is_macro)
-      rules += fmt::format("  P[\"{}\"].is_macro = true;\n", name);
+      rules += fmt::format("  {}.is_macro = true;\n", R);
     if (!def.enable_memoize)
-      rules += fmt::format("  P[\"{}\"].enable_memoize = false;\n", name);
+      rules += fmt::format("  {}.enable_memoize = false;\n", R);
     if (!def.params.empty()) {
       vector<string> params;
       for (auto &p : def.params)
         params.push_back(fmt::format("\"{}\"", escape(p)));
-      rules += fmt::format("  P[\"{}\"].params = {{{}}};\n", name, join(params, ", "));
+      rules += fmt::format("  {}.params = {{{}}};\n", R, join(params, ", "));
     }
 
     string code = op->code;
@@ -236,9 +247,22 @@ int main(int argc, char **argv) {
   fmt::print(fout, "#pragma clang diagnostic ignored \"-Wreturn-type\"\n");
   if (!preamble.empty())
     fmt::print(fout, "{}\n", preamble.substr(1, preamble.size() - 2));
-  string rules_preamble = "  using namespace peg;\n"
-                          "  using peg::seq;\n"
-                          "  using vc = vector<pair<char32_t, char32_t>>;\n";
+  vector<string> quotedNames;
+  for (auto &name : ruleNames)
+    quotedNames.push_back(fmt::format("\"{}\"", escape(name)));
+  fmt::print(fout, "static const char *{}_rule_names[{}] = {{{}}};\n", argv[3],
+             ruleNames.size(), join(quotedNames, ", "));
+  string rules_preamble =
+      fmt::format("  using namespace peg;\n"
+                  "  using peg::seq;\n"
+                  "  using vc = vector<pair<char32_t, char32_t>>;\n"
+                  "  std::vector<peg::Definition *> R;\n"
+                  "  R.reserve({});\n"
+                  "  for (auto *name : {}_rule_names) {{\n"
+                  "    R.push_back(&P[name]);\n"
+                  "    R.back()->name = name;\n"
+                  "  }}\n",
+                  ruleNames.size(), argv[3]);
   fmt::print(fout, "void init_{}_rules(peg::Grammar &P) {{\n{}\n{}\n}}\n", argv[3],
              rules_preamble, rules);
   fmt::print(fout, "{}\n", actionFns);
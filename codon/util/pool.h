@@ -0,0 +1,79 @@
+// Copyright (C) 2022-2024 Exaloop Inc. <https://exaloop.io>
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace codon {
+namespace util {
+
+/// Thread-local size-class slab pool used for compiler node allocation (AST
+/// nodes via ast::make_node and CIR nodes via Node::operator new). Objects are
+/// carved out of large slabs and recycled through per-class free lists, which
+/// removes general-purpose allocator overhead from hot construction/teardown
+/// paths and keeps nodes allocated together for cache locality. Slabs are
+/// registered globally and released only at process exit, so an object may be
+/// freed from a different thread than the one that allocated it.
+class MemoryPool {
+  static constexpr size_t ALIGN = alignof(std::max_align_t);
+  static constexpr size_t MAX_CLASS = 512 / ALIGN;
+  static constexpr size_t SLAB_SIZE = 256 * 1024;
+
+  std::vector<void *> freeLists[MAX_CLASS + 1];
+  char *slab = nullptr;
+  size_t slabLeft = 0;
+
+  /// Keeps every slab alive until process exit (see above).
+  static std::vector<void *> &slabRegistry() {
+    static std::vector<void *> registry;
+    return registry;
+  }
+  static std::mutex &slabRegistryLock() {
+    static std::mutex lock;
+    return lock;
+  }
+
+public:
+  void *allocate(size_t bytes) {
+    size_t cls = (bytes + ALIGN - 1) / ALIGN;
+    if (!cls || cls > MAX_CLASS)
+      return ::operator new(bytes);
+    auto &fl = freeLists[cls];
+    if (!fl.empty()) {
+      auto *p = fl.back();
+      fl.pop_back();
+      return p;
+    }
+    size_t size = cls * ALIGN;
+    if (slabLeft < size) {
+      slab = static_cast<char *>(::operator new(SLAB_SIZE));
+      slabLeft = SLAB_SIZE;
+      std::lock_guard<std::mutex> guard(slabRegistryLock());
+      slabRegistry().push_back(slab);
+    }
+    auto *p = slab;
+    slab += size;
+    slabLeft -= size;
+    return p;
+  }
+
+  void deallocate(void *p, size_t bytes) {
+    size_t cls = (bytes + ALIGN - 1) / ALIGN;
+    if (!cls || cls > MAX_CLASS) {
+      ::operator delete(p);
+      return;
+    }
+    freeLists[cls].push_back(p);
+  }
+
+  static MemoryPool &get() {
+    static thread_local MemoryPool pool;
+    return pool;
+  }
+};
+
+} // namespace util
+} // namespace codon
@@ -0,0 +1,5 @@
+__version__         = "0.2.0"
+CODON_VERSION       = "0.17.0"
+CODON_VERSION_MAJOR = 0
+CODON_VERSION_MINOR = 17
+CODON_VERSION_PATCH = 0
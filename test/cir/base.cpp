@@ -42,7 +42,8 @@ TEST_F(CIRCoreTest, NodeNoReplacementAttributes) {
 
   ASSERT_TRUE(node->hasAttribute<SrcInfoAttribute>());
   ASSERT_TRUE(node->getAttribute<SrcInfoAttribute>());
-  ASSERT_EQ(1, std::distance(node->attributes_begin(), node->attributes_end()));
+  // built-in attributes live in fixed slots, not the key-value store
+  ASSERT_EQ(0, std::distance(node->attributes_begin(), node->attributes_end()));
 }
 
 TEST_F(CIRCoreTest, NodeReplacementRTTI) {
@@ -66,13 +67,11 @@ TEST_F(CIRCoreTest, NodeReplacementDelegates) {
   newNode->setAttribute(std::make_unique<KeyValueAttribute>());
 
   ASSERT_EQ(0, originalNode->getName().size());
-  ASSERT_EQ(1, std::distance(originalNode->attributes_begin(),
-                             originalNode->attributes_end()));
+  ASSERT_FALSE(originalNode->hasAttribute<KeyValueAttribute>());
 
   originalNode->replaceAll(newNode);
   ASSERT_EQ(NODE_NAME, originalNode->getName());
-  ASSERT_EQ(2, std::distance(originalNode->attributes_begin(),
-                             originalNode->attributes_end()));
+  ASSERT_TRUE(originalNode->hasAttribute<KeyValueAttribute>());
 
   TestVisitor v;
   originalNode->accept(v);
@@ -0,0 +1,77 @@
+#include "test.h"
+
+#include "codon/cir/transform/parallel/fusion.h"
+#include "codon/cir/transform/parallel/schedule.h"
+
+using namespace codon::ir;
+
+namespace {
+ImperativeForFlow *makeLoop(Module *module, Value *start, Value *end, bool gpu) {
+  auto *var = module->Nr<Var>(module->getIntType());
+  auto *body = module->Nr<SeriesFlow>();
+  body->push_back(module->Nr<VarValue>(var));
+  auto sched = std::make_unique<transform::parallel::OMPSched>();
+  sched->gpu = gpu;
+  return module->Nr<ImperativeForFlow>(start, 1, end, body, var, std::move(sched));
+}
+} // namespace
+
+TEST_F(CIRCoreTest, GPUKernelFusionAdjacentLoops) {
+  auto *n = module->Nr<Var>(module->getIntType());
+  auto *loop1 =
+      makeLoop(module.get(), module->getInt(0), module->Nr<VarValue>(n), /*gpu=*/true);
+  auto *loop2 =
+      makeLoop(module.get(), module->getInt(0), module->Nr<VarValue>(n), /*gpu=*/true);
+  auto *series = module->Nr<SeriesFlow>();
+  series->push_back(loop1);
+  series->push_back(loop2);
+
+  transform::parallel::GPUKernelFusionPass pass;
+  pass.handle(series);
+
+  std::vector<Value *> contents(series->begin(), series->end());
+  ASSERT_EQ(1, contents.size());
+  auto *fused = cast<ImperativeForFlow>(contents[0]);
+  ASSERT_TRUE(fused);
+
+  // original statement, loop-var assignment, then the second body
+  std::vector<Value *> body(cast<SeriesFlow>(fused->getBody())->begin(),
+                            cast<SeriesFlow>(fused->getBody())->end());
+  ASSERT_EQ(3, body.size());
+  auto *assign = cast<AssignInstr>(body[1]);
+  ASSERT_TRUE(assign);
+  ASSERT_EQ(loop2->getVar(), assign->getLhs());
+  ASSERT_EQ(loop2->getBody(), body[2]);
+}
+
+TEST_F(CIRCoreTest, GPUKernelFusionDifferentBoundsNotFused) {
+  auto *loop1 =
+      makeLoop(module.get(), module->getInt(0), module->getInt(10), /*gpu=*/true);
+  auto *loop2 =
+      makeLoop(module.get(), module->getInt(0), module->getInt(20), /*gpu=*/true);
+  auto *series = module->Nr<SeriesFlow>();
+  series->push_back(loop1);
+  series->push_back(loop2);
+
+  transform::parallel::GPUKernelFusionPass pass;
+  pass.handle(series);
+
+  std::vector<Value *> contents(series->begin(), series->end());
+  ASSERT_EQ(2, contents.size());
+}
+
+TEST_F(CIRCoreTest, GPUKernelFusionCPULoopsNotFused) {
+  auto *loop1 =
+      makeLoop(module.get(), module->getInt(0), module->getInt(10), /*gpu=*/false);
+  auto *loop2 =
+      makeLoop(module.get(), module->getInt(0), module->getInt(10), /*gpu=*/false);
+  auto *series = module->Nr<SeriesFlow>();
+  series->push_back(loop1);
+  series->push_back(loop2);
+
+  transform::parallel::GPUKernelFusionPass pass;
+  pass.handle(series);
+
+  std::vector<Value *> contents(series->begin(), series->end());
+  ASSERT_EQ(2, contents.size());
+}
@@ -0,0 +1,110 @@
+#include "test.h"
+
+#include "codon/cir/util/matching.h"
+#include "codon/cir/util/serialize.h"
+
+using namespace codon::ir;
+
+TEST_F(CIRCoreTest, SerializeRoundTripRecursiveType) {
+  auto *contents = module->Nr<types::RecordType>("node.contents");
+  auto *node = module->Nr<types::RefType>("node", contents);
+  contents->realize({module->getIntType(), module->unsafeGetPointerType(node)},
+                    {"value", "next"});
+
+  auto data = util::serializeModule(module.get());
+  ASSERT_FALSE(data.empty());
+  auto restored = util::deserializeModule(data);
+  ASSERT_TRUE(restored);
+
+  auto *newNode = cast<types::RefType>(restored->getType("node"));
+  ASSERT_TRUE(newNode);
+  auto *newContents = newNode->getContents();
+  ASSERT_TRUE(newContents);
+  ASSERT_EQ(2, std::distance(newContents->begin(), newContents->end()));
+  ASSERT_EQ("value", newContents->front().getName());
+  ASSERT_TRUE(newContents->front().getType()->is(restored->getIntType()));
+  // the "next" field must close the cycle back to the restored type itself
+  auto *next = cast<types::PointerType>(newContents->back().getType());
+  ASSERT_TRUE(next);
+  ASSERT_EQ(newNode, next->getBase());
+}
+
+TEST_F(CIRCoreTest, SerializeRoundTripFuncArgs) {
+  auto *f = module->Nr<BodiedFunc>("f");
+  f->realize(module->unsafeGetFuncType("f_type", module->getIntType(),
+                                       {module->getIntType(), module->getFloatType()}),
+             {"a", "b"});
+  auto *body = module->Nr<SeriesFlow>();
+  body->push_back(module->Nr<ReturnInstr>(module->Nr<VarValue>(f->arg_front())));
+  f->setBody(body);
+
+  auto data = util::serializeModule(module.get());
+  ASSERT_FALSE(data.empty());
+  auto restored = util::deserializeModule(data);
+  ASSERT_TRUE(restored);
+
+  BodiedFunc *newF = nullptr;
+  for (auto *v : *restored)
+    if (v->getName() == f->getName())
+      newF = cast<BodiedFunc>(v);
+  ASSERT_TRUE(newF);
+  ASSERT_EQ(2, std::distance(newF->arg_begin(), newF->arg_end()));
+  ASSERT_TRUE(newF->getArgVar("a"));
+  ASSERT_TRUE(newF->getArgVar("b"));
+  ASSERT_TRUE(util::match(f, newF, /*checkNames=*/true));
+}
+
+TEST_F(CIRCoreTest, SerializeRoundTripLoopJumps) {
+  auto *f = cast<BodiedFunc>(module->getMainFunc());
+  auto *innerSeries = module->Nr<SeriesFlow>();
+  auto *inner = module->Nr<WhileFlow>(module->getBool(true), innerSeries);
+  auto *outerSeries = module->Nr<SeriesFlow>();
+  outerSeries->push_back(inner);
+  auto *outer = module->Nr<WhileFlow>(module->getBool(true), outerSeries);
+  innerSeries->push_back(module->Nr<BreakInstr>(outer));
+  innerSeries->push_back(module->Nr<ContinueInstr>(outer));
+  auto *body = module->Nr<SeriesFlow>();
+  body->push_back(outer);
+  f->setBody(body);
+
+  auto data = util::serializeModule(module.get());
+  ASSERT_FALSE(data.empty());
+  auto restored = util::deserializeModule(data);
+  ASSERT_TRUE(restored);
+
+  auto *newBody = cast<SeriesFlow>(cast<BodiedFunc>(restored->getMainFunc())->getBody());
+  ASSERT_TRUE(newBody);
+  auto *newOuter = cast<WhileFlow>(newBody->front());
+  ASSERT_TRUE(newOuter);
+  auto *newInner = cast<WhileFlow>(cast<SeriesFlow>(newOuter->getBody())->front());
+  ASSERT_TRUE(newInner);
+  auto *newInnerSeries = cast<SeriesFlow>(newInner->getBody());
+  ASSERT_TRUE(newInnerSeries);
+  auto it = newInnerSeries->begin();
+  auto *brk = cast<BreakInstr>(*it++);
+  auto *cnt = cast<ContinueInstr>(*it);
+  ASSERT_TRUE(brk);
+  ASSERT_TRUE(cnt);
+  // both jumps targeted the outer loop, not the enclosing inner one
+  ASSERT_EQ(newOuter, brk->getLoop());
+  ASSERT_EQ(newOuter, cnt->getLoop());
+}
+
+TEST_F(CIRCoreTest, SerializeMalformedInput) {
+  auto data = util::serializeModule(module.get());
+  ASSERT_FALSE(data.empty());
+  ASSERT_TRUE(util::deserializeModule(data));
+
+  ASSERT_FALSE(util::deserializeModule(""));
+
+  auto badMagic = data;
+  badMagic[0] = 'X';
+  ASSERT_FALSE(util::deserializeModule(badMagic));
+
+  auto badVersion = data;
+  badVersion[4] = char(badVersion[4] + 1);
+  ASSERT_FALSE(util::deserializeModule(badVersion));
+
+  ASSERT_FALSE(util::deserializeModule(data.substr(0, data.size() - 1)));
+  ASSERT_FALSE(util::deserializeModule(data.substr(0, data.size() / 2)));
+}
@@ -91,7 +91,9 @@ class TestInliner : public ir::transform::OperatorPass {
     auto name = f->getUnmangledName();
     if (name.find("inline_me") != std::string::npos) {
       auto aggressive = name.find("aggressive") != std::string::npos;
-      auto res = ir::util::inlineCall(v, aggressive);
+      auto partial = name.find("partial") != std::string::npos;
+      auto res = partial ? ir::util::partialInlineCall(v, aggressive)
+                         : ir::util::inlineCall(v, aggressive);
       if (!res)
         return;
       for (auto *var : res.newVars)
@@ -473,8 +475,11 @@ INSTANTIATE_TEST_SUITE_P(
         "stdlib/random_test.codon",
         "stdlib/statistics_test.codon",
         "stdlib/sort_test.codon",
+        "stdlib/sortedlist_test.codon",
         "stdlib/heapq_test.codon",
         "stdlib/operator_test.codon",
+        "stdlib/csv_test.codon",
+        "stdlib/json_test.codon",
         "python/pybridge.codon"
       ),
       testing::Values(true, false),
@@ -500,6 +505,7 @@ INSTANTIATE_TEST_SUITE_P(
             "transform/list_opt.codon",
             "transform/omp.codon",
             "transform/outlining.codon",
+            "transform/soa.codon",
             "transform/str_opt.codon"
         ),
         testing::Values(true, false),